@@ -73,6 +73,9 @@ inline const char *GetConfigurationString()
 #else
 		"(16-bit ObjectLayer) "
 #endif
+#ifdef JPH_COMPACT_CONTACT_CONSTRAINTS
+		"(Compact Contacts) "
+#endif
 #ifdef JPH_ENABLE_ASSERTS
 		"(Assertions) "
 #endif
@@ -16,7 +16,7 @@ public:
 	/// Destructor
 	inline					~LFHMAllocator();
 
-	/// Initialize the allocator
+	/// Initialize the allocator, can be called again to resize the allocator (this frees all previous allocations)
 	/// @param inObjectStoreSizeBytes Number of bytes to reserve for all key value pairs
 	inline void				Init(uint inObjectStoreSizeBytes);
 
@@ -77,7 +77,7 @@ public:
 	explicit				LockFreeHashMap(LFHMAllocator &inAllocator) : mAllocator(inAllocator) { }
 							~LockFreeHashMap();
 
-	/// Initialization
+	/// Initialization, can be called again to resize the map (this removes all elements)
 	/// @param inMaxBuckets Max amount of buckets to use in the hashmap. Must be power of 2.
 	void					Init(uint32 inMaxBuckets);
 
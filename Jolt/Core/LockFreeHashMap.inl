@@ -17,9 +17,11 @@ inline LFHMAllocator::~LFHMAllocator()
 
 inline void LFHMAllocator::Init(uint inObjectStoreSizeBytes)
 {
-	JPH_ASSERT(mObjectStore == nullptr);
+	// Free memory of a previous call to Init
+	AlignedFree(mObjectStore);
 
 	mObjectStoreSizeBytes = inObjectStoreSizeBytes;
+	mWriteOffset = 0;
 	mObjectStore = reinterpret_cast<uint8 *>(JPH::AlignedAllocate(inObjectStoreSizeBytes, 16));
 }
 
@@ -119,7 +121,9 @@ template <class Key, class Value>
 void LockFreeHashMap<Key, Value>::Init(uint32 inMaxBuckets)
 {
 	JPH_ASSERT(inMaxBuckets >= 4 && IsPowerOf2(inMaxBuckets));
-	JPH_ASSERT(mBuckets == nullptr);
+
+	// Free memory of a previous call to Init
+	AlignedFree(mBuckets);
 
 	mNumBuckets = inMaxBuckets;
 	mMaxBuckets = inMaxBuckets;
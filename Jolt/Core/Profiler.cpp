@@ -59,6 +59,39 @@ void Profiler::NextFrame()
 {
 	std::lock_guard lock(mLock);
 
+	// Store the samples of this frame in the frame history (before DumpInternal modifies them)
+	if (!mFrameHistory.empty())
+	{
+		CaptureFrame(mFrameHistory[mNextFrame]);
+		mNextFrame = (mNextFrame + 1) % uint(mFrameHistory.size());
+		mNumFramesInHistory = min(mNumFramesInHistory + 1, uint(mFrameHistory.size()));
+	}
+
+	if (mDumpChromeTrace)
+	{
+		// Determine tag of this trace
+		String tag;
+		if (mChromeTraceTag.empty())
+		{
+			// Next sequence number
+			static int number = 0;
+			++number;
+			tag = ConvertToString(number);
+		}
+		else
+		{
+			// Take provided tag
+			tag = mChromeTraceTag;
+			mChromeTraceTag.clear();
+		}
+
+		std::ofstream f;
+		f.open(StringFormat("profile_trace_%s.json", tag.c_str()).c_str(), std::ofstream::out | std::ofstream::trunc);
+		if (f.is_open())
+			WriteChromeTraceInternal(f);
+		mDumpChromeTrace = false;
+	}
+
 	if (mDump)
 	{
 		DumpInternal();
@@ -77,6 +110,29 @@ void Profiler::Dump(const string_view &inTag)
 	mDumpTag = inTag;
 }
 
+void Profiler::SetFrameHistory(uint inNumFrames)
+{
+	std::lock_guard lock(mLock);
+
+	mFrameHistory.clear();
+	mFrameHistory.resize(inNumFrames);
+	mNextFrame = 0;
+	mNumFramesInHistory = 0;
+}
+
+void Profiler::DumpChromeTrace(const string_view &inTag)
+{
+	mDumpChromeTrace = true;
+	mChromeTraceTag = inTag;
+}
+
+void Profiler::WriteChromeTrace(std::ostream &outStream)
+{
+	std::lock_guard lock(mLock);
+
+	WriteChromeTraceInternal(outStream);
+}
+
 void Profiler::AddThread(ProfileThread *inThread)
 {
 	std::lock_guard lock(mLock);
@@ -193,6 +249,139 @@ void Profiler::DumpInternal()
 	DumpChart(tag.c_str(), threads, key_to_aggregators, aggregators);
 }
 
+void Profiler::CaptureFrame(Frame &outFrame) const
+{
+	// Note that, just like DumpInternal, this is not completely thread safe (see comment there).
+	// The arrays are reused from the frame that was previously stored in this slot so that we don't allocate every frame.
+	outFrame.mThreads.resize(mThreads.size());
+	for (size_t t = 0; t < mThreads.size(); ++t)
+	{
+		const ProfileThread *in_thread = mThreads[t];
+		FrameThread &out_thread = outFrame.mThreads[t];
+		out_thread.mThreadName = in_thread->mThreadName;
+		out_thread.mSamples.resize(in_thread->mCurrentSample);
+		for (uint s = 0; s < in_thread->mCurrentSample; ++s)
+		{
+			const ProfileSample &in_sample = in_thread->mSamples[s];
+			FrameSample &out_sample = out_thread.mSamples[s];
+			out_sample.mName = in_sample.mName;
+			out_sample.mColor = in_sample.mColor;
+			out_sample.mStartCycle = in_sample.mStartCycle;
+			out_sample.mEndCycle = in_sample.mEndCycle;
+		}
+	}
+}
+
+static String sJSONEncode(const char *inString)
+{
+	String str;
+	for (const char *c = inString; *c != 0; ++c)
+		if (*c == '"' || *c == '\\')
+		{
+			str += '\\';
+			str += *c;
+		}
+		else if (uint8(*c) < 0x20)
+			str += ' '; // Control characters are not allowed in JSON strings
+		else
+			str += *c;
+	return str;
+}
+
+void Profiler::WriteChromeTraceInternal(std::ostream &outStream)
+{
+	// Collect the frames to write, oldest first
+	Array<const Frame *> frames;
+	Frame current_frame;
+	if (mNumFramesInHistory == 0)
+	{
+		CaptureFrame(current_frame);
+		frames.push_back(&current_frame);
+	}
+	else
+	{
+		uint first_frame = mNextFrame + uint(mFrameHistory.size()) - mNumFramesInHistory;
+		for (uint f = 0; f < mNumFramesInHistory; ++f)
+			frames.push_back(&mFrameHistory[(first_frame + f) % mFrameHistory.size()]);
+	}
+
+	// Make all times relative to the first sample
+	uint64 min_cycle = ~uint64(0);
+	for (const Frame *frame : frames)
+		for (const FrameThread &t : frame->mThreads)
+			if (!t.mSamples.empty())
+				min_cycle = min(min_cycle, t.mSamples[0].mStartCycle);
+	double us_per_cycle = 1.0e6 / double(GetProcessorTicksPerSecond());
+
+	// Threads come and go, so identify them by name
+	Array<String> thread_names;
+	auto get_thread_id = [&thread_names](const String &inName) {
+		Array<String>::const_iterator i = std::find(thread_names.begin(), thread_names.end(), inName);
+		if (i != thread_names.end())
+			return int(i - thread_names.begin());
+		thread_names.push_back(inName);
+		return int(thread_names.size()) - 1;
+	};
+
+	outStream << R"({"displayTimeUnit":"ms","traceEvents":[)";
+	bool first_event = true;
+	auto begin_event = [&outStream, &first_event]() -> std::ostream & {
+		if (!first_event)
+			outStream << ",";
+		first_event = false;
+		return outStream << "\n";
+	};
+
+	// Stack of end cycle and color of the parents of the current sample
+	struct Parent
+	{
+		uint64				mEndCycle;
+		uint32				mColor;
+	};
+	Array<Parent> parents;
+
+	for (size_t f = 0; f < frames.size(); ++f)
+	{
+		uint64 frame_start = ~uint64(0);
+
+		for (const FrameThread &t : frames[f]->mThreads)
+		{
+			int tid = get_thread_id(t.mThreadName);
+
+			parents.clear();
+			for (const FrameSample &s : t.mSamples)
+			{
+				// Skip samples that were still being recorded when the frame was captured
+				if (s.mEndCycle < s.mStartCycle || s.mStartCycle < min_cycle)
+					continue;
+				frame_start = min(frame_start, s.mStartCycle);
+
+				// Samples are sorted on start time, pop all parents that ended before this sample started
+				while (!parents.empty() && parents.back().mEndCycle <= s.mStartCycle)
+					parents.pop_back();
+
+				// A color of 0 means inherit the color of the parent
+				uint32 color = s.mColor != 0? s.mColor : (parents.empty()? Color::sGetDistinctColor(0).GetUInt32() : parents.back().mColor);
+				parents.push_back({ s.mEndCycle, color });
+
+				Color c(color);
+				begin_event() << StringFormat(R"({"name":"%s","ph":"X","pid":0,"tid":%d,"ts":%.3f,"dur":%.3f,"args":{"color":"#%02x%02x%02x"}})",
+					sJSONEncode(s.mName).c_str(), tid, double(s.mStartCycle - min_cycle) * us_per_cycle, double(s.mEndCycle - s.mStartCycle) * us_per_cycle, c.r, c.g, c.b);
+			}
+		}
+
+		// Mark the start of the frame
+		if (frame_start != ~uint64(0))
+			begin_event() << StringFormat(R"({"name":"Frame %d","ph":"i","s":"g","pid":0,"tid":0,"ts":%.3f})", int(f), double(frame_start - min_cycle) * us_per_cycle);
+	}
+
+	// Name the threads
+	for (size_t t = 0; t < thread_names.size(); ++t)
+		begin_event() << StringFormat(R"({"name":"thread_name","ph":"M","pid":0,"tid":%d,"args":{"name":"%s"}})", int(t), sJSONEncode(thread_names[t].c_str()).c_str());
+
+	outStream << "\n]}\n";
+}
+
 static String sHTMLEncode(const char *inString)
 {
 	String str(inString);
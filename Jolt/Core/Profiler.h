@@ -7,6 +7,7 @@
 JPH_SUPPRESS_WARNINGS_STD_BEGIN
 #include <mutex>
 #include <chrono>
+#include <iosfwd>
 JPH_SUPPRESS_WARNINGS_STD_END
 
 #include <Jolt/Core/NonCopyable.h>
@@ -46,6 +47,7 @@ JPH_CLANG_SUPPRESS_WARNING("-Wc++98-compat-pedantic")
 #define JPH_PROFILE_THREAD_END()
 #define JPH_PROFILE_NEXTFRAME()
 #define JPH_PROFILE_DUMP(...)
+#define JPH_PROFILE_DUMP_CHROME_TRACE(...)
 
 // Scope profiling measurement
 #define JPH_PROFILE_TAG2(line)		profile##line
@@ -90,6 +92,19 @@ public:
 	/// @param inTag If not empty, this overrides the auto incrementing number in the filename of the dump file
 	void						Dump(const string_view &inTag = string_view());
 
+	/// Keep the samples of the last inNumFrames frames in a ring buffer so that they can be written after something interesting happened (e.g. a spike in the frame time).
+	/// This copies the samples of all threads every frame, pass 0 to turn the frame history off again.
+	void						SetFrameHistory(uint inNumFrames);
+
+	/// Write the frame history to a Chrome Trace Event file at the start of the next frame, the file can be opened in chrome://tracing or https://ui.perfetto.dev.
+	/// When there is no frame history, only the current frame is written.
+	/// @param inTag If not empty, this overrides the auto incrementing number in the filename of the dump file
+	void						DumpChromeTrace(const string_view &inTag = string_view());
+
+	/// Write the frame history (or the current frame when there is no frame history) in Chrome Trace Event JSON format to outStream.
+	/// Other threads should not be adding samples while this function runs, so usually you want to call this between frames.
+	void						WriteChromeTrace(std::ostream &outStream);
+
 	/// Add a thread to be instrumented
 	void						AddThread(ProfileThread *inThread);
 
@@ -140,6 +155,28 @@ private:
 		uint64					mMaxCyclesInCallWithChildren = 0;									///< Maximum amount of cycles spent per call
 	};
 
+	/// Copy of a ProfileSample that is kept in the frame history
+	struct FrameSample
+	{
+		const char *			mName;
+		uint32					mColor;
+		uint64					mStartCycle;
+		uint64					mEndCycle;
+	};
+
+	/// Samples of a single thread in the frame history
+	struct FrameThread
+	{
+		String					mThreadName;
+		Array<FrameSample>		mSamples;
+	};
+
+	/// Samples of all threads for a single frame in the frame history
+	struct Frame
+	{
+		Array<FrameThread>		mThreads;
+	};
+
 	using Threads = Array<ThreadSamples>;
 	using Aggregators = Array<Aggregator>;
 	using KeyToAggregator = UnorderedMap<const char *, size_t>;
@@ -157,12 +194,23 @@ private:
 	void						DumpInternal();
 	void						DumpChart(const char *inTag, const Threads &inThreads, const KeyToAggregator &inKeyToAggregators, const Aggregators &inAggregators);
 
+	/// Copy the samples of the current frame
+	void						CaptureFrame(Frame &outFrame) const;
+
+	/// Write the frame history or the current frame in Chrome Trace Event format
+	void						WriteChromeTraceInternal(std::ostream &outStream);
+
 	std::mutex					mLock;																///< Lock that protects mThreads
 	uint64						mReferenceTick;														///< Tick count at the start of the frame
 	std::chrono::high_resolution_clock::time_point mReferenceTime;									///< Time at the start of the frame
 	Array<ProfileThread *>		mThreads;															///< List of all active threads
 	bool						mDump = false;														///< When true, the samples are dumped next frame
 	String						mDumpTag;															///< When not empty, this overrides the auto incrementing number of the dump filename
+	Array<Frame>				mFrameHistory;														///< Ring buffer of the samples of the last frames
+	uint						mNextFrame = 0;														///< Index in mFrameHistory where the next frame will be stored
+	uint						mNumFramesInHistory = 0;											///< Number of valid frames in mFrameHistory
+	bool						mDumpChromeTrace = false;											///< When true, a Chrome trace is written next frame
+	String						mChromeTraceTag;													///< When not empty, this overrides the auto incrementing number of the Chrome trace filename
 };
 
 // Class that contains the information of a single scoped measurement
@@ -259,6 +307,9 @@ JPH_CLANG_SUPPRESS_WARNING("-Wc++98-compat-pedantic")
 /// Dump profiling info
 #define JPH_PROFILE_DUMP(...)			Profiler::sInstance->Dump(__VA_ARGS__)
 
+/// Dump the frame history as a Chrome trace
+#define JPH_PROFILE_DUMP_CHROME_TRACE(...)	Profiler::sInstance->DumpChromeTrace(__VA_ARGS__)
+
 JPH_SUPPRESS_WARNING_POP
 
 #else
@@ -278,6 +329,7 @@ JPH_CLANG_SUPPRESS_WARNING("-Wc++98-compat-pedantic")
 #define JPH_PROFILE_FUNCTION()
 #define JPH_PROFILE_NEXTFRAME()
 #define JPH_PROFILE_DUMP(...)
+#define JPH_PROFILE_DUMP_CHROME_TRACE(...)
 
 JPH_SUPPRESS_WARNING_POP
 
@@ -491,6 +491,64 @@ namespace ClosestPoint
 		outSet = closest_set;
 		return closest_point;
 	}
+
+	/// Get the closest points between line segment (inP1, inQ1) and line segment (inP2, inQ2), see: Real-Time Collision Detection - Christer Ericson (Section: Closest Points of Two Line Segments)
+	/// When the segments are parallel, an arbitrary pair of closest points is returned
+	inline void GetClosestPointsOnSegments(Vec3Arg inP1, Vec3Arg inQ1, Vec3Arg inP2, Vec3Arg inQ2, Vec3 &outClosest1, Vec3 &outClosest2)
+	{
+		Vec3 d1 = inQ1 - inP1;
+		Vec3 d2 = inQ2 - inP2;
+		Vec3 r = inP1 - inP2;
+		float a = d1.LengthSq();
+		float e = d2.LengthSq();
+		float f = d2.Dot(r);
+
+		float s, t;
+		if (a <= Square(FLT_EPSILON) && e <= Square(FLT_EPSILON))
+		{
+			// Both segments degenerate into points
+			s = t = 0.0f;
+		}
+		else if (a <= Square(FLT_EPSILON))
+		{
+			// First segment degenerates into a point
+			s = 0.0f;
+			t = Clamp(f / e, 0.0f, 1.0f);
+		}
+		else
+		{
+			float c = d1.Dot(r);
+			if (e <= Square(FLT_EPSILON))
+			{
+				// Second segment degenerates into a point
+				t = 0.0f;
+				s = Clamp(-c / a, 0.0f, 1.0f);
+			}
+			else
+			{
+				// Compute closest point on line 1 to line 2 and clamp to segment 1, if the lines are parallel pick the start of segment 1
+				float b = d1.Dot(d2);
+				float denominator = a * e - b * b;
+				s = denominator > 0.0f? Clamp((b * f - c * e) / denominator, 0.0f, 1.0f) : 0.0f;
+
+				// Compute the closest point on segment 2 to that point, if it lies outside the segment clamp it and recompute the point on segment 1
+				t = (b * s + f) / e;
+				if (t < 0.0f)
+				{
+					t = 0.0f;
+					s = Clamp(-c / a, 0.0f, 1.0f);
+				}
+				else if (t > 1.0f)
+				{
+					t = 1.0f;
+					s = Clamp((b - c) / a, 0.0f, 1.0f);
+				}
+			}
+		}
+
+		outClosest1 = inP1 + s * d1;
+		outClosest2 = inP2 + t * d2;
+	}
 };
 
 JPH_PRECISE_MATH_OFF
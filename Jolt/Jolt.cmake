@@ -175,6 +175,10 @@ set(JOLT_PHYSICS_SRC_FILES
 	${JOLT_PHYSICS_ROOT}/Physics/Character/CharacterBase.h
 	${JOLT_PHYSICS_ROOT}/Physics/Character/CharacterVirtual.cpp
 	${JOLT_PHYSICS_ROOT}/Physics/Character/CharacterVirtual.h
+	${JOLT_PHYSICS_ROOT}/Physics/Character/CharacterVirtualBatchUpdater.cpp
+	${JOLT_PHYSICS_ROOT}/Physics/Character/CharacterVirtualBatchUpdater.h
+	${JOLT_PHYSICS_ROOT}/Physics/Character/CharacterVsCharacterGrid.cpp
+	${JOLT_PHYSICS_ROOT}/Physics/Character/CharacterVsCharacterGrid.h
 	${JOLT_PHYSICS_ROOT}/Physics/Collision/AABoxCast.h
 	${JOLT_PHYSICS_ROOT}/Physics/Collision/ActiveEdgeMode.h
 	${JOLT_PHYSICS_ROOT}/Physics/Collision/ActiveEdges.h
@@ -189,6 +193,8 @@ set(JOLT_PHYSICS_SRC_FILES
 	${JOLT_PHYSICS_ROOT}/Physics/Collision/BroadPhase/BroadPhaseQuadTree.cpp
 	${JOLT_PHYSICS_ROOT}/Physics/Collision/BroadPhase/BroadPhaseQuadTree.h
 	${JOLT_PHYSICS_ROOT}/Physics/Collision/BroadPhase/BroadPhaseQuery.h
+	${JOLT_PHYSICS_ROOT}/Physics/Collision/BroadPhase/BroadPhaseSAP.cpp
+	${JOLT_PHYSICS_ROOT}/Physics/Collision/BroadPhase/BroadPhaseSAP.h
 	${JOLT_PHYSICS_ROOT}/Physics/Collision/BroadPhase/ObjectVsBroadPhaseLayerFilterMask.h
 	${JOLT_PHYSICS_ROOT}/Physics/Collision/BroadPhase/ObjectVsBroadPhaseLayerFilterTable.h
 	${JOLT_PHYSICS_ROOT}/Physics/Collision/BroadPhase/QuadTree.cpp
@@ -212,6 +218,7 @@ set(JOLT_PHYSICS_SRC_FILES
 	${JOLT_PHYSICS_ROOT}/Physics/Collision/CollisionDispatch.h
 	${JOLT_PHYSICS_ROOT}/Physics/Collision/CollisionGroup.cpp
 	${JOLT_PHYSICS_ROOT}/Physics/Collision/CollisionGroup.h
+	${JOLT_PHYSICS_ROOT}/Physics/Collision/ContactEvent.h
 	${JOLT_PHYSICS_ROOT}/Physics/Collision/ContactListener.h
 	${JOLT_PHYSICS_ROOT}/Physics/Collision/EstimateCollisionResponse.cpp
 	${JOLT_PHYSICS_ROOT}/Physics/Collision/EstimateCollisionResponse.h
@@ -291,6 +298,7 @@ set(JOLT_PHYSICS_SRC_FILES
 	${JOLT_PHYSICS_ROOT}/Physics/Constraints/ConstraintManager.h
 	${JOLT_PHYSICS_ROOT}/Physics/Constraints/ConstraintPart/AngleConstraintPart.h
 	${JOLT_PHYSICS_ROOT}/Physics/Constraints/ConstraintPart/AxisConstraintPart.h
+	${JOLT_PHYSICS_ROOT}/Physics/Constraints/ConstraintPart/CompactAxisConstraintPart.h
 	${JOLT_PHYSICS_ROOT}/Physics/Constraints/ConstraintPart/DualAxisConstraintPart.h
 	${JOLT_PHYSICS_ROOT}/Physics/Constraints/ConstraintPart/GearConstraintPart.h
 	${JOLT_PHYSICS_ROOT}/Physics/Constraints/ConstraintPart/HingeRotationConstraintPart.h
@@ -353,6 +361,7 @@ set(JOLT_PHYSICS_SRC_FILES
 	${JOLT_PHYSICS_ROOT}/Physics/PhysicsSystem.h
 	${JOLT_PHYSICS_ROOT}/Physics/PhysicsUpdateContext.cpp
 	${JOLT_PHYSICS_ROOT}/Physics/PhysicsUpdateContext.h
+	${JOLT_PHYSICS_ROOT}/Physics/PhysicsUpdateStats.h
 	${JOLT_PHYSICS_ROOT}/Physics/Ragdoll/Ragdoll.cpp
 	${JOLT_PHYSICS_ROOT}/Physics/Ragdoll/Ragdoll.h
 	${JOLT_PHYSICS_ROOT}/Physics/SoftBody/SoftBodyContactListener.h
@@ -405,6 +414,8 @@ set(JOLT_PHYSICS_SRC_FILES
 	${JOLT_PHYSICS_ROOT}/Renderer/DebugRendererSimple.h
 	${JOLT_PHYSICS_ROOT}/Skeleton/SkeletalAnimation.cpp
 	${JOLT_PHYSICS_ROOT}/Skeleton/SkeletalAnimation.h
+	${JOLT_PHYSICS_ROOT}/Skeleton/SkeletalAnimationSampler.cpp
+	${JOLT_PHYSICS_ROOT}/Skeleton/SkeletalAnimationSampler.h
 	${JOLT_PHYSICS_ROOT}/Skeleton/Skeleton.cpp
 	${JOLT_PHYSICS_ROOT}/Skeleton/Skeleton.h
 	${JOLT_PHYSICS_ROOT}/Skeleton/SkeletonMapper.cpp
@@ -538,6 +549,11 @@ if (OBJECT_LAYER_BITS)
 	target_compile_definitions(Jolt PUBLIC JPH_OBJECT_LAYER_BITS=${OBJECT_LAYER_BITS})
 endif()
 
+# Setting to store contact constraints in a compact form
+if (COMPACT_CONTACT_CONSTRAINTS)
+	target_compile_definitions(Jolt PUBLIC JPH_COMPACT_CONTACT_CONSTRAINTS)
+endif()
+
 if (USE_STD_VECTOR)
 	target_compile_definitions(Jolt PUBLIC JPH_USE_STD_VECTOR)
 endif()
@@ -339,6 +339,7 @@ BodyCreationSettings Body::GetBodyCreationSettings() const
 	result.mApplyGyroscopicForce = GetApplyGyroscopicForce();
 	result.mMotionQuality = mMotionProperties != nullptr? mMotionProperties->GetMotionQuality() : EMotionQuality::Discrete;
 	result.mEnhancedInternalEdgeRemoval = GetEnhancedInternalEdgeRemoval();
+	result.mReportContacts = GetReportContacts();
 	result.mAllowSleeping = mMotionProperties != nullptr? GetAllowSleeping() : true;
 	result.mFriction = GetFriction();
 	result.mRestitution = GetRestitution();
@@ -114,6 +114,19 @@ public:
 	/// Checks if the combination of this body and inBody2 should use enhanced internal edge removal
 	inline bool				GetEnhancedInternalEdgeRemovalWithBody(const Body &inBody2) const { return ((mFlags.load(memory_order_relaxed) | inBody2.mFlags.load(memory_order_relaxed)) & uint8(EFlags::EnhancedInternalEdgeRemoval)) != 0; }
 
+	/// Set to indicate that the ContactListener (and the contact event stream, see PhysicsSystem::SetMaxContactEvents) should be notified of contacts involving this body.
+	/// Contacts are reported when at least one of the two bodies reports contacts. For a pair of bodies that both don't report contacts, the OnContactAdded, OnContactPersisted and OnContactRemoved callbacks
+	/// and the contact events are skipped, this saves the cost of converting the contact manifold to world space and calling the listener. Note that this also means that the contact settings cannot be modified for these pairs.
+	/// ContactListener::OnContactValidate is still called for these pairs, so it can still be used to filter out contacts.
+	/// Consider using BodyInterface::SetReportContacts if the body could already be in contact with other bodies to ensure that the contact cache is invalidated.
+	inline void				SetReportContacts(bool inReport)								{ if (inReport) mFlags.fetch_or(uint8(EFlags::ReportContacts), memory_order_relaxed); else mFlags.fetch_and(uint8(~uint8(EFlags::ReportContacts)), memory_order_relaxed); }
+
+	/// Check if contacts involving this body are reported
+	inline bool				GetReportContacts() const										{ return (mFlags.load(memory_order_relaxed) & uint8(EFlags::ReportContacts)) != 0; }
+
+	/// Checks if contacts between this body and inBody2 should be reported
+	inline bool				GetReportContactsWithBody(const Body &inBody2) const			{ return ((mFlags.load(memory_order_relaxed) | inBody2.mFlags.load(memory_order_relaxed)) & uint8(EFlags::ReportContacts)) != 0; }
+
 	/// Get the bodies motion type.
 	inline EMotionType		GetMotionType() const											{ return mMotionType; }
 
@@ -350,6 +363,7 @@ private:
 		UseManifoldReduction			= 1 << 4,											///< Set this bit to indicate that this body can use manifold reduction (if PhysicsSettings::mUseManifoldReduction is true)
 		ApplyGyroscopicForce			= 1 << 5,											///< Set this bit to indicate that the gyroscopic force should be applied to this body (aka Dzhanibekov effect, see https://en.wikipedia.org/wiki/Tennis_racket_theorem)
 		EnhancedInternalEdgeRemoval		= 1 << 6,											///< Set this bit to indicate that enhanced internal edge removal should be used for this body (see BodyCreationSettings::mEnhancedInternalEdgeRemoval)
+		ReportContacts					= 1 << 7,											///< Set this bit to indicate that contacts involving this body should be reported to the contact listener (see Body::SetReportContacts)
 	};
 
 	// 16 byte aligned
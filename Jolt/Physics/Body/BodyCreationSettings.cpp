@@ -30,6 +30,7 @@ JPH_IMPLEMENT_SERIALIZABLE_NON_VIRTUAL(BodyCreationSettings)
 	JPH_ADD_ATTRIBUTE(BodyCreationSettings, mApplyGyroscopicForce)
 	JPH_ADD_ENUM_ATTRIBUTE(BodyCreationSettings, mMotionQuality)
 	JPH_ADD_ATTRIBUTE(BodyCreationSettings, mEnhancedInternalEdgeRemoval)
+	JPH_ADD_ATTRIBUTE(BodyCreationSettings, mReportContacts)
 	JPH_ADD_ATTRIBUTE(BodyCreationSettings, mAllowSleeping)
 	JPH_ADD_ATTRIBUTE(BodyCreationSettings, mFriction)
 	JPH_ADD_ATTRIBUTE(BodyCreationSettings, mRestitution)
@@ -62,6 +63,7 @@ void BodyCreationSettings::SaveBinaryState(StreamOut &inStream) const
 	inStream.Write(mApplyGyroscopicForce);
 	inStream.Write(mMotionQuality);
 	inStream.Write(mEnhancedInternalEdgeRemoval);
+	inStream.Write(mReportContacts);
 	inStream.Write(mAllowSleeping);
 	inStream.Write(mFriction);
 	inStream.Write(mRestitution);
@@ -94,6 +96,7 @@ void BodyCreationSettings::RestoreBinaryState(StreamIn &inStream)
 	inStream.Read(mApplyGyroscopicForce);
 	inStream.Read(mMotionQuality);
 	inStream.Read(mEnhancedInternalEdgeRemoval);
+	inStream.Read(mReportContacts);
 	inStream.Read(mAllowSleeping);
 	inStream.Read(mFriction);
 	inStream.Read(mRestitution);
@@ -182,6 +182,11 @@ BodyInterface::AddState BodyInterface::AddBodiesPrepare(BodyID *ioBodies, int in
 	return mBroadPhase->AddBodiesPrepare(ioBodies, inNumber);
 }
 
+BodyInterface::AddState BodyInterface::AddBodiesPrepare(BodyID *ioBodies, int inNumber, JobSystem *inJobSystem)
+{
+	return mBroadPhase->AddBodiesPrepare(ioBodies, inNumber, inJobSystem);
+}
+
 void BodyInterface::AddBodiesFinalize(BodyID *ioBodies, int inNumber, AddState inAddState, EActivation inActivationMode)
 {
 	BodyLockMultiWrite lock(*mBodyLockInterface, ioBodies, inNumber);
@@ -990,6 +995,31 @@ bool BodyInterface::GetUseManifoldReduction(const BodyID &inBodyID) const
 		return true;
 }
 
+void BodyInterface::SetReportContacts(const BodyID &inBodyID, bool inReport)
+{
+	BodyLockWrite lock(*mBodyLockInterface, inBodyID);
+	if (lock.Succeeded())
+	{
+		Body &body = lock.GetBody();
+		if (body.GetReportContacts() != inReport)
+		{
+			body.SetReportContacts(inReport);
+
+			// Flag collision cache invalid for this body
+			mBodyManager->InvalidateContactCacheForBody(body);
+		}
+	}
+}
+
+bool BodyInterface::GetReportContacts(const BodyID &inBodyID) const
+{
+	BodyLockRead lock(*mBodyLockInterface, inBodyID);
+	if (lock.Succeeded())
+		return lock.GetBody().GetReportContacts();
+	else
+		return true;
+}
+
 TransformedShape BodyInterface::GetTransformedShape(const BodyID &inBodyID) const
 {
 	BodyLockRead lock(*mBodyLockInterface, inBodyID);
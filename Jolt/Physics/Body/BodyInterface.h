@@ -28,6 +28,7 @@ class TwoBodyConstraintSettings;
 class TwoBodyConstraint;
 class BroadPhaseLayerFilter;
 class AABox;
+class JobSystem;
 
 /// Class that provides operations on bodies using a body ID. Note that if you need to do multiple operations on a single body, it is more efficient to lock the body once and combine the operations.
 /// All quantities are in world space unless otherwise specified.
@@ -116,6 +117,7 @@ public:
 	/// Note that ioBodies array must be kept constant while the add is in progress.
 	///@{
 	AddState					AddBodiesPrepare(BodyID *ioBodies, int inNumber);
+	AddState					AddBodiesPrepare(BodyID *ioBodies, int inNumber, JobSystem *inJobSystem);
 	void						AddBodiesFinalize(BodyID *ioBodies, int inNumber, AddState inAddState, EActivation inActivationMode);
 	void						AddBodiesAbort(BodyID *ioBodies, int inNumber, AddState inAddState);
 	void						RemoveBodies(BodyID *ioBodies, int inNumber);
@@ -258,6 +260,12 @@ public:
 	bool						GetUseManifoldReduction(const BodyID &inBodyID) const;
 	///@}
 
+	///@name Contact reporting (see Body::SetReportContacts)
+	///@{
+	void						SetReportContacts(const BodyID &inBodyID, bool inReport);
+	bool						GetReportContacts(const BodyID &inBodyID) const;
+	///@}
+
 	/// Get transform and shape for this body, used to perform collision detection
 	TransformedShape			GetTransformedShape(const BodyID &inBodyID) const;
 
@@ -206,6 +206,8 @@ Body *BodyManager::AllocateBody(const BodyCreationSettings &inBodyCreationSettin
 		body->SetApplyGyroscopicForce(true);
 	if (inBodyCreationSettings.mEnhancedInternalEdgeRemoval)
 		body->SetEnhancedInternalEdgeRemoval(true);
+	if (inBodyCreationSettings.mReportContacts)
+		body->SetReportContacts(true);
 	SetBodyObjectLayerInternal(*body, inBodyCreationSettings.mObjectLayer);
 	body->mObjectLayer = inBodyCreationSettings.mObjectLayer;
 	body->mCollisionGroup = inBodyCreationSettings.mCollisionGroup;
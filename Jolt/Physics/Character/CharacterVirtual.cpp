@@ -5,10 +5,12 @@
 #include <Jolt/Jolt.h>
 
 #include <Jolt/Physics/Character/CharacterVirtual.h>
+#include <Jolt/Physics/Character/CharacterVsCharacterGrid.h>
 #include <Jolt/Physics/Body/Body.h>
 #include <Jolt/Physics/PhysicsSystem.h>
 #include <Jolt/Physics/Collision/ShapeCast.h>
 #include <Jolt/Physics/Collision/CollideShape.h>
+#include <Jolt/Physics/Collision/CollisionCollectorImpl.h>
 #include <Jolt/Physics/Collision/Shape/RotatedTranslatedShape.h>
 #include <Jolt/Physics/Collision/InternalEdgeRemovingCollector.h>
 #include <Jolt/Core/QuickSort.h>
@@ -33,6 +35,7 @@ CharacterVirtual::CharacterVirtual(const CharacterVirtualSettings *inSettings, R
 	mHitReductionCosMaxAngle(inSettings->mHitReductionCosMaxAngle),
 	mPenetrationRecoverySpeed(inSettings->mPenetrationRecoverySpeed),
 	mEnhancedInternalEdgeRemoval(inSettings->mEnhancedInternalEdgeRemoval),
+	mRestingTolerance(inSettings->mRestingTolerance),
 	mShapeOffset(inSettings->mShapeOffset),
 	mPosition(inPosition),
 	mRotation(inRotation),
@@ -97,6 +100,8 @@ void CharacterVirtual::sFillContactProperties(const CharacterVirtual *inCharacte
 		outContact.mSurfaceNormal = outContact.mContactNormal; // Replace surface normal with contact normal if the contact normal is pointing more upwards
 	outContact.mDistance = -inResult.mPenetrationDepth;
 	outContact.mBodyB = inResult.mBodyID2;
+	outContact.mCharacterB = nullptr;
+	outContact.mCharacterIDB = 0;
 	outContact.mSubShapeIDB = inResult.mSubShapeID2;
 	outContact.mMotionTypeB = inBody.GetMotionType();
 	outContact.mIsSensorB = inBody.IsSensor();
@@ -104,6 +109,28 @@ void CharacterVirtual::sFillContactProperties(const CharacterVirtual *inCharacte
 	outContact.mMaterial = inCollector.GetContext()->GetMaterial(inResult.mSubShapeID2);
 }
 
+template <class taCollector>
+void CharacterVirtual::sFillCharacterContactProperties(Contact &outContact, const CharacterVirtual *inOtherCharacter, Vec3Arg inOtherCharacterVelocity, Vec3Arg inUp, RVec3Arg inBaseOffset, const taCollector &inCollector, const CollideShapeResult &inResult)
+{
+	outContact.mPosition = inBaseOffset + inResult.mContactPointOn2;
+	outContact.mLinearVelocity = inOtherCharacterVelocity;
+	outContact.mContactNormal = -inResult.mPenetrationAxis.NormalizedOr(Vec3::sZero());
+	outContact.mSurfaceNormal = inCollector.GetContext()->GetWorldSpaceSurfaceNormal(inResult.mSubShapeID2, outContact.mPosition);
+	if (outContact.mContactNormal.Dot(outContact.mSurfaceNormal) < 0.0f)
+		outContact.mSurfaceNormal = -outContact.mSurfaceNormal; // Flip surface normal if we're hitting a back face
+	if (outContact.mContactNormal.Dot(inUp) > outContact.mSurfaceNormal.Dot(inUp))
+		outContact.mSurfaceNormal = outContact.mContactNormal; // Replace surface normal with contact normal if the contact normal is pointing more upwards
+	outContact.mDistance = -inResult.mPenetrationDepth;
+	outContact.mBodyB = BodyID();
+	outContact.mSubShapeIDB = inResult.mSubShapeID2;
+	outContact.mCharacterB = inOtherCharacter;
+	outContact.mCharacterIDB = inOtherCharacter->GetID();
+	outContact.mMotionTypeB = EMotionType::Kinematic; // Other characters move by themselves and cannot be pushed
+	outContact.mIsSensorB = false;
+	outContact.mUserData = inOtherCharacter->GetUserData();
+	outContact.mMaterial = inCollector.GetContext()->GetMaterial(inResult.mSubShapeID2);
+}
+
 void CharacterVirtual::ContactCollector::AddHit(const CollideShapeResult &inResult)
 {
 	// If we exceed our contact limit, try to clean up near-duplicate contacts
@@ -122,7 +149,7 @@ void CharacterVirtual::ContactCollector::AddHit(const CollideShapeResult &inResu
 				for (int j = i - 1; j >= 0; --j)
 				{
 					Contact &contact_j = mContacts[j];
-					if (contact_i.mBodyB == contact_j.mBodyB // Same body
+					if (contact_i.IsSameBody(contact_j) // Same body
 						&& contact_i.mContactNormal.Dot(contact_j.mContactNormal) > mHitReductionCosMaxAngle) // Very similar contact normals
 					{
 						// Remove the contact with the biggest distance
@@ -160,6 +187,16 @@ void CharacterVirtual::ContactCollector::AddHit(const CollideShapeResult &inResu
 		}
 	}
 
+	if (mOtherCharacter != nullptr)
+	{
+		// Hit another character
+		mContacts.emplace_back();
+		Contact &contact = mContacts.back();
+		sFillCharacterContactProperties(contact, mOtherCharacter, mOtherCharacterVelocity, mUp, mBaseOffset, *this, inResult);
+		contact.mFraction = 0.0f;
+		return;
+	}
+
 	BodyLockRead lock(mSystem->GetBodyLockInterface(), inResult.mBodyID2);
 	if (lock.SucceededAndIsInBroadPhase())
 	{
@@ -180,13 +217,19 @@ void CharacterVirtual::ContactCastCollector::AddHit(const ShapeCastResult &inRes
 	{
 		// Test if this contact should be ignored
 		for (const IgnoredContact &c : mIgnoredContacts)
-			if (c.mBodyID == inResult.mBodyID2 && c.mSubShapeID == inResult.mSubShapeID2)
+			if (c.mBodyID == inResult.mBodyID2 && c.mSubShapeID == inResult.mSubShapeID2 && c.mCharacter == mOtherCharacter)
 				return;
 
 		Contact contact;
 
-		// Lock body only while we fetch contact properties
+		if (mOtherCharacter != nullptr)
 		{
+			// Hit another character
+			sFillCharacterContactProperties(contact, mOtherCharacter, mOtherCharacterVelocity, mUp, mBaseOffset, *this, inResult);
+		}
+		else
+		{
+			// Lock body only while we fetch contact properties
 			BodyLockRead lock(mSystem->GetBodyLockInterface(), inResult.mBodyID2);
 			if (!lock.SucceededAndIsInBroadPhase())
 				return;
@@ -303,6 +346,30 @@ void CharacterVirtual::GetContactsAtPosition(RVec3Arg inPosition, Vec3Arg inMove
 	ContactCollector collector(mSystem, this, mMaxNumHits, mHitReductionCosMaxAngle, mUp, mPosition, outContacts);
 	CheckCollision(inPosition, mRotation, inMovementDirection, mPredictiveContactDistance, inShape, mPosition, collector, inBroadPhaseLayerFilter, inObjectLayerFilter, inBodyFilter, inShapeFilter);
 
+	// Collide with other characters
+	if (mCharacterVsCharacterGrid != nullptr)
+	{
+		// Settings for collide shape, see CheckCollision
+		CollideShapeSettings settings;
+		settings.mActiveEdgeMode = EActiveEdgeMode::CollideOnlyWithActive;
+		settings.mBackFaceMode = mBackFaceMode;
+		settings.mActiveEdgeMovementDirection = inMovementDirection;
+		settings.mMaxSeparationDistance = mCharacterPadding + mPredictiveContactDistance;
+
+		RMat44 transform = GetCenterOfMassTransform(inPosition, mRotation, inShape);
+		AABox bounds = inShape->GetWorldSpaceBounds(transform, Vec3::sReplicate(1.0f));
+		bounds.ExpandBy(Vec3::sReplicate(settings.mMaxSeparationDistance));
+		mCharacterVsCharacterGrid->VisitCharacters(bounds, this, [this, inShape, &transform, &settings, &collector](const CharacterVsCharacterGrid::Entry &inEntry) {
+			if (collector.ShouldEarlyOut())
+				return;
+
+			collector.mOtherCharacter = inEntry.mCharacter;
+			collector.mOtherCharacterVelocity = inEntry.mLinearVelocity;
+			inEntry.GetTransformedShape().CollideShape(inShape, Vec3::sReplicate(1.0f), transform, settings, mPosition, collector);
+		});
+		collector.mOtherCharacter = nullptr;
+	}
+
 	// The broadphase bounding boxes will not be deterministic, which means that the order in which the contacts are received by the collector is not deterministic.
 	// Therefore we need to sort the contacts to preserve determinism. Note that currently this will fail if we exceed mMaxNumHits hits.
 	QuickSort(outContacts.begin(), outContacts.end(), ContactOrderingPredicate());
@@ -330,7 +397,7 @@ void CharacterVirtual::RemoveConflictingContacts(TempContactList &ioContacts, Ig
 			for (size_t c2 = c1 + 1; c2 < ioContacts.size(); c2++)
 			{
 				Contact &contact2 = ioContacts[c2];
-				if (contact1.mBodyB == contact2.mBodyB // Only same body
+				if (contact1.IsSameBody(contact2) // Only same body
 					&& contact2.mDistance <= -cMinRequiredPenetration // Only for penetrations
 					&& contact1.mContactNormal.Dot(contact2.mContactNormal) < 0.0f) // Only opposing normals
 				{
@@ -338,14 +405,14 @@ void CharacterVirtual::RemoveConflictingContacts(TempContactList &ioContacts, Ig
 					if (contact1.mDistance < contact2.mDistance)
 					{
 						// Discard the 2nd contact
-						outIgnoredContacts.emplace_back(contact2.mBodyB, contact2.mSubShapeIDB);
+						outIgnoredContacts.emplace_back(contact2);
 						ioContacts.erase(ioContacts.begin() + c2);
 						c2--;
 					}
 					else
 					{
 						// Discard the first contact
-						outIgnoredContacts.emplace_back(contact1.mBodyB, contact1.mSubShapeIDB);
+						outIgnoredContacts.emplace_back(contact1);
 						ioContacts.erase(ioContacts.begin() + c1);
 						c1--;
 						break;
@@ -360,6 +427,9 @@ bool CharacterVirtual::ValidateContact(const Contact &inContact) const
 	if (mListener == nullptr)
 		return true;
 
+	if (inContact.mCharacterB != nullptr)
+		return mListener->OnCharacterContactValidate(this, inContact.mCharacterB, inContact.mSubShapeIDB);
+
 	return mListener->OnContactValidate(this, inContact.mBodyB, inContact.mSubShapeIDB);
 }
 
@@ -417,14 +487,30 @@ bool CharacterVirtual::GetFirstContactForSweep(RVec3Arg inPosition, Vec3Arg inDi
 	collector.ResetEarlyOutFraction(contact.mFraction);
 	RShapeCast shape_cast(mShape, Vec3::sReplicate(1.0f), start, inDisplacement);
 	mSystem->GetNarrowPhaseQuery().CastShape(shape_cast, settings, start.GetTranslation(), collector, inBroadPhaseLayerFilter, inObjectLayerFilter, inBodyFilter, inShapeFilter);
-	if (contact.mBodyB.IsInvalid())
+
+	// Cast against other characters
+	const CharacterVsCharacterGrid::Entry *hit_character = nullptr;
+	if (mCharacterVsCharacterGrid != nullptr)
+	{
+		AABox bounds = shape_cast.mShapeWorldBounds;
+		bounds.Encapsulate(bounds.mMin + inDisplacement);
+		bounds.Encapsulate(bounds.mMax + inDisplacement);
+		mCharacterVsCharacterGrid->VisitCharacters(bounds, this, [&shape_cast, &settings, &start, &collector, &contact, &hit_character](const CharacterVsCharacterGrid::Entry &inEntry) {
+			collector.mOtherCharacter = inEntry.mCharacter;
+			collector.mOtherCharacterVelocity = inEntry.mLinearVelocity;
+			inEntry.GetTransformedShape().CastShape(shape_cast, settings, start.GetTranslation(), collector);
+			if (contact.mCharacterB == inEntry.mCharacter)
+				hit_character = &inEntry;
+		});
+	}
+	if (contact.mBodyB.IsInvalid() && contact.mCharacterB == nullptr)
 		return false;
 
 	// Store contact
 	outContact = contact;
 
 	// Fetch the face we're colliding with
-	TransformedShape ts = mSystem->GetBodyInterface().GetTransformedShape(outContact.mBodyB);
+	TransformedShape ts = hit_character != nullptr? hit_character->GetTransformedShape() : mSystem->GetBodyInterface().GetTransformedShape(outContact.mBodyB);
 	Shape::SupportingFace face;
 	ts.GetSupportingFace(outContact.mSubShapeIDB, -outContact.mContactNormal, start.GetTranslation(), face);
 
@@ -504,7 +590,12 @@ bool CharacterVirtual::HandleContact(Vec3Arg inVelocity, Constraint &ioConstrain
 	// Send contact added event
 	CharacterContactSettings settings;
 	if (mListener != nullptr)
-		mListener->OnContactAdded(this, contact.mBodyB, contact.mSubShapeIDB, contact.mPosition, -contact.mContactNormal, settings);
+	{
+		if (contact.mCharacterB != nullptr)
+			mListener->OnCharacterContactAdded(this, contact.mCharacterB, contact.mSubShapeIDB, contact.mPosition, -contact.mContactNormal, settings);
+		else
+			mListener->OnContactAdded(this, contact.mBodyB, contact.mSubShapeIDB, contact.mPosition, -contact.mContactNormal, settings);
+	}
 	contact.mCanPushCharacter = settings.mCanPushCharacter;
 
 	// We don't have any further interaction with sensors beyond an OnContactAdded notification
@@ -515,53 +606,72 @@ bool CharacterVirtual::HandleContact(Vec3Arg inVelocity, Constraint &ioConstrain
 	if (!settings.mCanReceiveImpulses || contact.mMotionTypeB != EMotionType::Dynamic)
 		return true;
 
-	// Lock the body we're colliding with
-	BodyLockWrite lock(mSystem->GetBodyLockInterface(), contact.mBodyB);
-	if (!lock.SucceededAndIsInBroadPhase())
-		return false; // Body has been removed, we should not collide with it anymore
-	const Body &body = lock.GetBody();
-
-	// Calculate the velocity that we want to apply at B so that it will start moving at the character's speed at the contact point
-	constexpr float cDamping = 0.9f;
-	constexpr float cPenetrationResolution = 0.4f;
-	Vec3 relative_velocity = inVelocity - contact.mLinearVelocity;
-	float projected_velocity = relative_velocity.Dot(contact.mContactNormal);
-	float delta_velocity = -projected_velocity * cDamping - min(contact.mDistance, 0.0f) * cPenetrationResolution / inDeltaTime;
-
-	// Don't apply impulses if we're separating
-	if (delta_velocity < 0.0f)
-		return true;
+	// Calculate the impulse while holding a read lock on the body we're colliding with
+	Vec3 world_impulse;
+	{
+		BodyLockRead lock(mSystem->GetBodyLockInterface(), contact.mBodyB);
+		if (!lock.SucceededAndIsInBroadPhase())
+			return false; // Body has been removed, we should not collide with it anymore
+		const Body &body = lock.GetBody();
+
+		// Calculate the velocity that we want to apply at B so that it will start moving at the character's speed at the contact point
+		constexpr float cDamping = 0.9f;
+		constexpr float cPenetrationResolution = 0.4f;
+		Vec3 relative_velocity = inVelocity - contact.mLinearVelocity;
+		float projected_velocity = relative_velocity.Dot(contact.mContactNormal);
+		float delta_velocity = -projected_velocity * cDamping - min(contact.mDistance, 0.0f) * cPenetrationResolution / inDeltaTime;
 
-	// Determine mass properties of the body we're colliding with
-	const MotionProperties *motion_properties = body.GetMotionProperties();
-	RVec3 center_of_mass = body.GetCenterOfMassPosition();
-	Mat44 inverse_inertia = body.GetInverseInertia();
-	float inverse_mass = motion_properties->GetInverseMass();
+		// Don't apply impulses if we're separating
+		if (delta_velocity < 0.0f)
+			return true;
 
-	// Calculate the inverse of the mass of body B as seen at the contact point in the direction of the contact normal
-	Vec3 jacobian = Vec3(contact.mPosition - center_of_mass).Cross(contact.mContactNormal);
-	float inv_effective_mass = inverse_inertia.Multiply3x3(jacobian).Dot(jacobian) + inverse_mass;
+		// Determine mass properties of the body we're colliding with
+		const MotionProperties *motion_properties = body.GetMotionProperties();
+		RVec3 center_of_mass = body.GetCenterOfMassPosition();
+		Mat44 inverse_inertia = body.GetInverseInertia();
+		float inverse_mass = motion_properties->GetInverseMass();
 
-	// Impulse P = M dv
-	float impulse = delta_velocity / inv_effective_mass;
+		// Calculate the inverse of the mass of body B as seen at the contact point in the direction of the contact normal
+		Vec3 jacobian = Vec3(contact.mPosition - center_of_mass).Cross(contact.mContactNormal);
+		float inv_effective_mass = inverse_inertia.Multiply3x3(jacobian).Dot(jacobian) + inverse_mass;
 
-	// Clamp the impulse according to the character strength, character strength is a force in newtons, P = F dt
-	float max_impulse = mMaxStrength * inDeltaTime;
-	impulse = min(impulse, max_impulse);
+		// Impulse P = M dv
+		float impulse = delta_velocity / inv_effective_mass;
 
-	// Calculate the world space impulse to apply
-	Vec3 world_impulse = -impulse * contact.mContactNormal;
+		// Clamp the impulse according to the character strength, character strength is a force in newtons, P = F dt
+		float max_impulse = mMaxStrength * inDeltaTime;
+		impulse = min(impulse, max_impulse);
 
-	// Cancel impulse in down direction (we apply gravity later)
-	float impulse_dot_up = world_impulse.Dot(mUp);
-	if (impulse_dot_up < 0.0f)
-		world_impulse -= impulse_dot_up * mUp;
+		// Calculate the world space impulse to apply
+		world_impulse = -impulse * contact.mContactNormal;
 
-	// Now apply the impulse (body is already locked so we use the no-lock interface)
-	mSystem->GetBodyInterfaceNoLock().AddImpulse(contact.mBodyB, world_impulse, contact.mPosition);
+		// Cancel impulse in down direction (we apply gravity later)
+		float impulse_dot_up = world_impulse.Dot(mUp);
+		if (impulse_dot_up < 0.0f)
+			world_impulse -= impulse_dot_up * mUp;
+	}
+
+	// Now apply the impulse
+	AddImpulse(contact.mBodyB, world_impulse, contact.mPosition);
 	return true;
 }
 
+void CharacterVirtual::AddImpulse(const BodyID &inBodyID, Vec3Arg inImpulse, RVec3Arg inPosition) const
+{
+	if (mDeferImpulses)
+		mDeferredImpulses.push_back({ inBodyID, inImpulse, inPosition });
+	else
+		mSystem->GetBodyInterface().AddImpulse(inBodyID, inImpulse, inPosition);
+}
+
+void CharacterVirtual::ApplyDeferredImpulses()
+{
+	BodyInterface &bi = mSystem->GetBodyInterface();
+	for (const DeferredImpulse &i : mDeferredImpulses)
+		bi.AddImpulse(i.mBodyID, i.mImpulse, i.mPosition);
+	mDeferredImpulses.clear();
+}
+
 void CharacterVirtual::SolveConstraints(Vec3Arg inVelocity, float inDeltaTime, float inTimeRemaining, ConstraintList &ioConstraints, IgnoredContactList &ioIgnoredContacts, float &outTimeSimulated, Vec3 &outDisplacement, TempAllocator &inAllocator
 #ifdef JPH_DEBUG_RENDERER
 	, bool inDrawConstraints
@@ -669,7 +779,7 @@ void CharacterVirtual::SolveConstraints(Vec3Arg inVelocity, float inDeltaTime, f
 					c->mContact->mWasDiscarded = true;
 
 					// Mark it as ignored for GetFirstContactForSweep
-					ioIgnoredContacts.emplace_back(c->mContact->mBodyB, c->mContact->mSubShapeIDB);
+					ioIgnoredContacts.emplace_back(*c->mContact);
 					continue;
 				}
 
@@ -776,7 +886,13 @@ void CharacterVirtual::SolveConstraints(Vec3Arg inVelocity, float inDeltaTime, f
 
 		// Allow application to modify calculated velocity
 		if (mListener != nullptr)
-			mListener->OnContactSolve(this, constraint->mContact->mBodyB, constraint->mContact->mSubShapeIDB, constraint->mContact->mPosition, constraint->mContact->mContactNormal, constraint->mContact->mLinearVelocity, constraint->mContact->mMaterial, velocity, new_velocity);
+		{
+			const Contact *contact = constraint->mContact;
+			if (contact->mCharacterB != nullptr)
+				mListener->OnCharacterContactSolve(this, contact->mCharacterB, contact->mSubShapeIDB, contact->mPosition, contact->mContactNormal, contact->mLinearVelocity, contact->mMaterial, velocity, new_velocity);
+			else
+				mListener->OnContactSolve(this, contact->mBodyB, contact->mSubShapeIDB, contact->mPosition, contact->mContactNormal, contact->mLinearVelocity, contact->mMaterial, velocity, new_velocity);
+		}
 
 #ifdef JPH_DEBUG_RENDERER
 		if (inDrawConstraints)
@@ -997,6 +1113,9 @@ void CharacterVirtual::UpdateSupportingContact(bool inSkipContactVelocityCheck,
 
 void CharacterVirtual::StoreActiveContacts(const TempContactList &inContacts, TempAllocator &inAllocator)
 {
+	// The contacts changed, we can't reuse them in the next update
+	mIsResting = false;
+
 	mActiveContacts.assign(inContacts.begin(), inContacts.end());
 
 	UpdateSupportingContact(true, inAllocator);
@@ -1115,6 +1234,81 @@ Vec3 CharacterVirtual::CancelVelocityTowardsSteepSlopes(Vec3Arg inDesiredVelocit
 	return desired_velocity;
 }
 
+bool CharacterVirtual::GetRestingBodies(Array<BodyID> &outBodies, const BroadPhaseLayerFilter &inBroadPhaseLayerFilter, const ObjectLayerFilter &inObjectLayerFilter, const BodyFilter &inBodyFilter) const
+{
+	// Get the bounds of the character, expanded by the distance over which we detect contacts
+	AABox bounds = mShape->GetWorldSpaceBounds(GetCenterOfMassTransform(mPosition, mRotation, mShape), Vec3::sReplicate(1.0f));
+	bounds.ExpandBy(Vec3::sReplicate(mPredictiveContactDistance + mCharacterPadding + mRestingTolerance));
+
+	// Other characters can move at any time, so we can't be resting when there are characters nearby
+	if (mCharacterVsCharacterGrid != nullptr)
+	{
+		bool character_nearby = false;
+		mCharacterVsCharacterGrid->VisitCharacters(bounds, this, [&character_nearby](const CharacterVsCharacterGrid::Entry &) { character_nearby = true; });
+		if (character_nearby)
+			return false;
+	}
+
+	// Collect the bodies in the bounds
+	AllHitCollisionCollector<CollideShapeBodyCollector> collector;
+	mSystem->GetBroadPhaseQuery().CollideAABox(bounds, collector, inBroadPhaseLayerFilter, inObjectLayerFilter);
+
+	// Check that none of them can move
+	outBodies.clear();
+	outBodies.reserve(collector.mHits.size());
+	for (const BodyID &body_id : collector.mHits)
+		if (inBodyFilter.ShouldCollide(body_id))
+		{
+			BodyLockRead lock(mSystem->GetBodyLockInterface(), body_id);
+			if (lock.SucceededAndIsInBroadPhase() && inBodyFilter.ShouldCollideLocked(lock.GetBody()))
+			{
+				if (lock.GetBody().IsActive())
+					return false;
+				outBodies.push_back(body_id);
+			}
+		}
+
+	// Sort so that we can compare the lists
+	QuickSort(outBodies.begin(), outBodies.end());
+	return true;
+}
+
+bool CharacterVirtual::CanReuseContacts(float inDeltaTime, const BroadPhaseLayerFilter &inBroadPhaseLayerFilter, const ObjectLayerFilter &inObjectLayerFilter, const BodyFilter &inBodyFilter) const
+{
+	// Check that the character was resting in the previous update, has not been moved since and wants to move in the same way.
+	// A different desired displacement needs a collision query, even when the difference is small, as otherwise a character that slowly starts moving would never move.
+	if (!mIsResting
+		|| mPosition != mRestingPosition
+		|| mRotation != mRestingRotation
+		|| !(mLinearVelocity * inDeltaTime).IsClose(mRestingDisplacement))
+		return false;
+
+	// Check that moving the character like in the previous update keeps it within mRestingTolerance of the position where the contacts were determined
+	if (Vec3(mPosition + mRestingMovement - mRestingContactsPosition).LengthSq() > Square(mRestingTolerance))
+		return false;
+
+	// Check that the same bodies are around the character and that they're still not moving
+	Array<BodyID> bodies;
+	return GetRestingBodies(bodies, inBroadPhaseLayerFilter, inObjectLayerFilter, inBodyFilter)
+		&& bodies == mRestingBodies;
+}
+
+void CharacterVirtual::StoreRestingState(RVec3Arg inPreviousPosition, float inDeltaTime, const BroadPhaseLayerFilter &inBroadPhaseLayerFilter, const ObjectLayerFilter &inObjectLayerFilter, const BodyFilter &inBodyFilter)
+{
+	Vec3 movement = Vec3(mPosition - inPreviousPosition);
+	mIsResting = mRestingTolerance > 0.0f
+		&& movement.LengthSq() <= Square(mRestingTolerance)
+		&& GetRestingBodies(mRestingBodies, inBroadPhaseLayerFilter, inObjectLayerFilter, inBodyFilter);
+	if (mIsResting)
+	{
+		mRestingPosition = mPosition;
+		mRestingContactsPosition = mPosition;
+		mRestingRotation = mRotation;
+		mRestingDisplacement = mLinearVelocity * inDeltaTime;
+		mRestingMovement = movement;
+	}
+}
+
 void CharacterVirtual::Update(float inDeltaTime, Vec3Arg inGravity, const BroadPhaseLayerFilter &inBroadPhaseLayerFilter, const ObjectLayerFilter &inObjectLayerFilter, const BodyFilter &inBodyFilter, const ShapeFilter &inShapeFilter, TempAllocator &inAllocator)
 {
 	// If there's no delta time, we don't need to do anything
@@ -1124,15 +1318,30 @@ void CharacterVirtual::Update(float inDeltaTime, Vec3Arg inGravity, const BroadP
 	// Remember delta time for checking if we're supported by the ground
 	mLastDeltaTime = inDeltaTime;
 
-	// Slide the shape through the world
-	MoveShape(mPosition, mLinearVelocity, inDeltaTime, &mActiveContacts, inBroadPhaseLayerFilter, inObjectLayerFilter, inBodyFilter, inShapeFilter, inAllocator
-	#ifdef JPH_DEBUG_RENDERER
-		, sDrawConstraints
-	#endif // JPH_DEBUG_RENDERER
-		);
+	// If nothing changed since the last update, moving the character would give the same result so we can skip the collision queries
+	mReusedContacts = CanReuseContacts(inDeltaTime, inBroadPhaseLayerFilter, inObjectLayerFilter, inBodyFilter);
+	if (mReusedContacts)
+	{
+		// Move the character in the same way as in the update that determined the contacts
+		mPosition += mRestingMovement;
+		mRestingPosition = mPosition;
+	}
+	else
+	{
+		// Slide the shape through the world
+		RVec3 previous_position = mPosition;
+		MoveShape(mPosition, mLinearVelocity, inDeltaTime, &mActiveContacts, inBroadPhaseLayerFilter, inObjectLayerFilter, inBodyFilter, inShapeFilter, inAllocator
+		#ifdef JPH_DEBUG_RENDERER
+			, sDrawConstraints
+		#endif // JPH_DEBUG_RENDERER
+			);
 
-	// Determine the object that we're standing on
-	UpdateSupportingContact(false, inAllocator);
+		// Determine the object that we're standing on
+		UpdateSupportingContact(false, inAllocator);
+
+		// Check if we can skip the collision queries next update
+		StoreRestingState(previous_position, inDeltaTime, inBroadPhaseLayerFilter, inObjectLayerFilter, inBodyFilter);
+	}
 
 	// If we're on the ground
 	if (!mGroundBodyID.IsInvalid() && mMass > 0.0f)
@@ -1142,7 +1351,7 @@ void CharacterVirtual::Update(float inDeltaTime, Vec3Arg inGravity, const BroadP
 		if (normal_dot_gravity < 0.0f)
 		{
 			Vec3 world_impulse = -(mMass * normal_dot_gravity / inGravity.Length() * inDeltaTime) * inGravity;
-			mSystem->GetBodyInterface().AddImpulse(mGroundBodyID, world_impulse, mGroundPosition);
+			AddImpulse(mGroundBodyID, world_impulse, mGroundPosition);
 		}
 	}
 }
@@ -1186,7 +1395,7 @@ void CharacterVirtual::MoveToContact(RVec3Arg inPosition, const Contact &inConta
 	// Ensure that we mark inContact as colliding
 	bool found_contact = false;
 	for (Contact &c : contacts)
-		if (c.mBodyB == inContact.mBodyB
+		if (c.IsSameBody(inContact)
 			&& c.mSubShapeIDB == inContact.mSubShapeIDB)
 		{
 			c.mHadCollision = true;
@@ -1508,12 +1717,13 @@ void CharacterVirtual::Contact::SaveState(StateRecorder &inStream) const
 	inStream.Write(mDistance);
 	inStream.Write(mFraction);
 	inStream.Write(mBodyB);
+	inStream.Write(mCharacterIDB);
 	inStream.Write(mSubShapeIDB);
 	inStream.Write(mMotionTypeB);
 	inStream.Write(mHadCollision);
 	inStream.Write(mWasDiscarded);
 	inStream.Write(mCanPushCharacter);
-	// Cannot store user data (may be a pointer) and material
+	// Cannot store user data (may be a pointer) and material, mCharacterB is restored from mCharacterIDB by CharacterVirtual::RestoreState
 }
 
 void CharacterVirtual::Contact::RestoreState(StateRecorder &inStream)
@@ -1525,11 +1735,13 @@ void CharacterVirtual::Contact::RestoreState(StateRecorder &inStream)
 	inStream.Read(mDistance);
 	inStream.Read(mFraction);
 	inStream.Read(mBodyB);
+	inStream.Read(mCharacterIDB);
 	inStream.Read(mSubShapeIDB);
 	inStream.Read(mMotionTypeB);
 	inStream.Read(mHadCollision);
 	inStream.Read(mWasDiscarded);
 	inStream.Read(mCanPushCharacter);
+	mCharacterB = nullptr; // Needs to be looked up by CharacterVirtual::RestoreState
 	mUserData = 0; // Cannot restore user data
 	mMaterial = PhysicsMaterial::sDefault; // Cannot restore material
 }
@@ -1538,6 +1750,7 @@ void CharacterVirtual::SaveState(StateRecorder &inStream) const
 {
 	CharacterBase::SaveState(inStream);
 
+	inStream.Write(mID);
 	inStream.Write(mPosition);
 	inStream.Write(mRotation);
 	inStream.Write(mLinearVelocity);
@@ -1559,12 +1772,16 @@ void CharacterVirtual::RestoreState(StateRecorder &inStream)
 {
 	CharacterBase::RestoreState(inStream);
 
+	inStream.Read(mID);
 	inStream.Read(mPosition);
 	inStream.Read(mRotation);
 	inStream.Read(mLinearVelocity);
 	inStream.Read(mLastDeltaTime);
 	inStream.Read(mMaxHitsExceeded);
 
+	// The restored state may not match the state that was used to determine if we're resting
+	mIsResting = false;
+
 	// When validating remove contacts that don't have collision since we didn't save them
 	if (inStream.IsValidating())
 		for (int i = (int)mActiveContacts.size() - 1; i >= 0; --i)
@@ -1576,6 +1793,28 @@ void CharacterVirtual::RestoreState(StateRecorder &inStream)
 	mActiveContacts.resize(num_contacts);
 	for (Contact &c : mActiveContacts)
 		c.RestoreState(inStream);
+
+	// Look up the characters that we're in contact with, contacts with characters that are no longer in the grid are removed
+	for (int i = (int)mActiveContacts.size() - 1; i >= 0; --i)
+	{
+		Contact &c = mActiveContacts[i];
+		if (c.mCharacterIDB != 0)
+		{
+			c.mCharacterB = mCharacterVsCharacterGrid != nullptr? mCharacterVsCharacterGrid->FindCharacter(c.mCharacterIDB) : nullptr;
+			if (c.mCharacterB == nullptr)
+				mActiveContacts.erase(mActiveContacts.begin() + i);
+		}
+	}
+}
+
+void CharacterVirtual::RemoveContactsWithCharacterInternal(const CharacterVirtual *inCharacter)
+{
+	for (int i = (int)mActiveContacts.size() - 1; i >= 0; --i)
+		if (mActiveContacts[i].mCharacterB == inCharacter)
+			mActiveContacts.erase(mActiveContacts.begin() + i);
+
+	// The contacts changed, so we can't reuse them
+	mIsResting = false;
 }
 
 JPH_NAMESPACE_END
@@ -14,6 +14,7 @@
 JPH_NAMESPACE_BEGIN
 
 class CharacterVirtual;
+class CharacterVsCharacterGrid;
 
 /// Contains the configuration of a character
 class JPH_EXPORT CharacterVirtualSettings : public CharacterBaseSettings
@@ -41,6 +42,7 @@ public:
 	uint								mMaxNumHits = 256;										///< Max num hits to collect in order to avoid excess of contact points collection
 	float								mHitReductionCosMaxAngle = 0.999f;						///< Cos(angle) where angle is the maximum angle between two hits contact normals that are allowed to be merged during hit reduction. Default is around 2.5 degrees. Set to -1 to turn off.
 	float								mPenetrationRecoverySpeed = 1.0f;						///< This value governs how fast a penetration will be resolved, 0 = nothing is resolved, 1 = everything in one update
+	float								mRestingTolerance = 0.0f;								///< When > 0, Update will reuse the contacts of the previous update instead of doing collision queries when the character moved less than this distance (m) in the previous update, its desired displacement didn't change and all bodies around it are static or sleeping. The character then moves by the same amount as in the previous update until it has moved more than this distance since the last collision query. Note that in this case no contact callbacks are sent. Set to 0 to turn off.
 };
 
 /// This class contains settings that allow you to override the behavior of a character's collision response
@@ -85,6 +87,15 @@ public:
 	/// @param inCharacterVelocity World space velocity of the character prior to hitting this contact
 	/// @param ioNewCharacterVelocity Contains the calculated world space velocity of the character after hitting this contact, this velocity slides along the surface of the contact. Can be modified by the listener to provide an alternative velocity.
 	virtual void						OnContactSolve(const CharacterVirtual *inCharacter, const BodyID &inBodyID2, const SubShapeID &inSubShapeID2, RVec3Arg inContactPosition, Vec3Arg inContactNormal, Vec3Arg inContactVelocity, const PhysicsMaterial *inContactMaterial, Vec3Arg inCharacterVelocity, Vec3 &ioNewCharacterVelocity) { /* Default do nothing */ }
+
+	/// Same as OnContactValidate but when colliding with another character, see CharacterVsCharacterGrid
+	virtual bool						OnCharacterContactValidate(const CharacterVirtual *inCharacter, const CharacterVirtual *inOtherCharacter, const SubShapeID &inSubShapeID2) { return true; }
+
+	/// Same as OnContactAdded but when colliding with another character, see CharacterVsCharacterGrid. Note that ioSettings.mCanReceiveImpulses is ignored as characters cannot push each other.
+	virtual void						OnCharacterContactAdded(const CharacterVirtual *inCharacter, const CharacterVirtual *inOtherCharacter, const SubShapeID &inSubShapeID2, RVec3Arg inContactPosition, Vec3Arg inContactNormal, CharacterContactSettings &ioSettings) { /* Default do nothing */ }
+
+	/// Same as OnContactSolve but when colliding with another character, see CharacterVsCharacterGrid
+	virtual void						OnCharacterContactSolve(const CharacterVirtual *inCharacter, const CharacterVirtual *inOtherCharacter, const SubShapeID &inSubShapeID2, RVec3Arg inContactPosition, Vec3Arg inContactNormal, Vec3Arg inContactVelocity, const PhysicsMaterial *inContactMaterial, Vec3Arg inCharacterVelocity, Vec3 &ioNewCharacterVelocity) { /* Default do nothing */ }
 };
 
 /// Runtime character object.
@@ -114,6 +125,15 @@ public:
 	/// Get the current contact listener
 	CharacterContactListener *			GetListener() const										{ return mListener; }
 
+	/// Set the grid that contains the other characters that this character collides with (can be nullptr to not collide with other characters)
+	void								SetCharacterVsCharacterGrid(const CharacterVsCharacterGrid *inGrid) { mCharacterVsCharacterGrid = inGrid; mIsResting = false; }
+	const CharacterVsCharacterGrid *	GetCharacterVsCharacterGrid() const						{ return mCharacterVsCharacterGrid; }
+
+	/// ID of this character, 0 until it is assigned by CharacterVsCharacterGrid::Add or by the caller.
+	/// The ID is used to sort the contacts with other characters and to find the character again when restoring the contacts of other characters, so it should be non-zero and unique within a CharacterVsCharacterGrid.
+	uint32								GetID() const											{ return mID; }
+	void								SetID(uint32 inID)										{ mID = inID; }
+
 	/// Get the linear velocity of the character (m / s)
 	Vec3								GetLinearVelocity() const								{ return mLinearVelocity; }
 
@@ -150,6 +170,13 @@ public:
 	float								GetPenetrationRecoverySpeed() const						{ return mPenetrationRecoverySpeed; }
 	void								SetPenetrationRecoverySpeed(float inSpeed)				{ mPenetrationRecoverySpeed = inSpeed; }
 
+	/// Distance (m) below which a resting character reuses the contacts of the previous update instead of doing collision queries, see CharacterVirtualSettings::mRestingTolerance
+	float								GetRestingTolerance() const								{ return mRestingTolerance; }
+	void								SetRestingTolerance(float inTolerance)					{ mRestingTolerance = inTolerance; mIsResting = false; }
+
+	/// Returns true if the last call to Update reused the contacts of the previous update because the character was resting
+	bool								GetReusedContacts() const								{ return mReusedContacts; }
+
 	/// Set to indicate that extra effort should be made to try to remove ghost contacts (collisions with internal edges of a mesh). This is more expensive but makes bodies move smoother over a mesh with convex edges.
 	bool								GetEnhancedInternalEdgeRemoval() const					{ return mEnhancedInternalEdgeRemoval; }
 	void								SetEnhancedInternalEdgeRemoval(bool inApply)			{ mEnhancedInternalEdgeRemoval = inApply; }
@@ -253,6 +280,14 @@ public:
 	/// @param inAllocator An allocator for temporary allocations. All memory will be freed by the time this function returns.
 	void								ExtendedUpdate(float inDeltaTime, Vec3Arg inGravity, const ExtendedUpdateSettings &inSettings, const BroadPhaseLayerFilter &inBroadPhaseLayerFilter, const ObjectLayerFilter &inObjectLayerFilter, const BodyFilter &inBodyFilter, const ShapeFilter &inShapeFilter, TempAllocator &inAllocator);
 
+	/// When enabled, the impulses that the character applies to dynamic bodies (when pushing them or standing on them) are stored instead of being applied immediately.
+	/// This makes it safe to update multiple characters in parallel and ensures that all characters see the same body velocities regardless of update order. See CharacterVirtualBatchUpdater.
+	void								SetDeferImpulses(bool inDeferImpulses)					{ mDeferImpulses = inDeferImpulses; }
+	bool								GetDeferImpulses() const								{ return mDeferImpulses; }
+
+	/// Apply the impulses that were stored while impulses were deferred to the bodies
+	void								ApplyDeferredImpulses();
+
 	/// This function can be used after a character has teleported to determine the new contacts with the world.
 	void								RefreshContacts(const BroadPhaseLayerFilter &inBroadPhaseLayerFilter, const ObjectLayerFilter &inObjectLayerFilter, const BodyFilter &inBodyFilter, const ShapeFilter &inShapeFilter, TempAllocator &inAllocator);
 
@@ -317,6 +352,11 @@ public:
 		bool							mHadCollision = false;									///< If the character actually collided with the contact (can be false if a predictive contact never becomes a real one)
 		bool							mWasDiscarded = false;									///< If the contact validate callback chose to discard this contact
 		bool							mCanPushCharacter = true;								///< When true, the velocity of the contact point can push the character
+		const CharacterVirtual *		mCharacterB = nullptr;									///< Character we're colliding with (when not null, mBodyB is invalid), see CharacterVsCharacterGrid
+		uint32							mCharacterIDB = 0;										///< ID of mCharacterB, used to restore mCharacterB in CharacterVirtual::RestoreState
+
+		/// Check if this contact is with the same body or character as inOther
+		inline bool						IsSameBody(const Contact &inOther) const				{ return mBodyB == inOther.mBodyB && mCharacterB == inOther.mCharacterB; }
 	};
 
 	using TempContactList = Array<Contact, STLTempAllocator<Contact>>;
@@ -325,6 +365,9 @@ public:
 	/// Access to the internal list of contacts that the character has found.
 	const ContactList &					GetActiveContacts() const								{ return mActiveContacts; }
 
+	/// Remove all contacts with inCharacter, called by CharacterVsCharacterGrid::Remove so that no contacts point to a character that is no longer in the grid
+	void								RemoveContactsWithCharacterInternal(const CharacterVirtual *inCharacter);
+
 private:
 	// Sorting predicate for making contact order deterministic
 	struct ContactOrderingPredicate
@@ -334,6 +377,10 @@ private:
 			if (inLHS.mBodyB != inRHS.mBodyB)
 				return inLHS.mBodyB < inRHS.mBodyB;
 
+			// Compare the IDs rather than the pointers to be deterministic
+			if (inLHS.mCharacterIDB != inRHS.mCharacterIDB)
+				return inLHS.mCharacterIDB < inRHS.mCharacterIDB;
+
 			return inLHS.mSubShapeIDB.GetValue() < inRHS.mSubShapeIDB.GetValue();
 		}
 	};
@@ -342,10 +389,11 @@ private:
 	struct IgnoredContact
 	{
 										IgnoredContact() = default;
-										IgnoredContact(const BodyID &inBodyID, const SubShapeID &inSubShapeID) : mBodyID(inBodyID), mSubShapeID(inSubShapeID) { }
+										IgnoredContact(const Contact &inContact) : mBodyID(inContact.mBodyB), mSubShapeID(inContact.mSubShapeIDB), mCharacter(inContact.mCharacterB) { }
 
 		BodyID							mBodyID;												///< ID of body we're colliding with
 		SubShapeID						mSubShapeID;											///< Sub shape of body we're colliding with
+		const CharacterVirtual *		mCharacter = nullptr;									///< Character we're colliding with
 	};
 
 	using IgnoredContactList = Array<IgnoredContact, STLTempAllocator<IgnoredContact>>;
@@ -379,6 +427,8 @@ private:
 		uint							mMaxHits;
 		float							mHitReductionCosMaxAngle;
 		bool							mMaxHitsExceeded = false;
+		const CharacterVirtual *		mOtherCharacter = nullptr;								///< When colliding with another character, the character that is being hit
+		Vec3							mOtherCharacterVelocity = Vec3::sZero();				///< Velocity of mOtherCharacter
 	};
 
 	// A collision collector that collects hits for CastShape
@@ -396,12 +446,18 @@ private:
 		const CharacterVirtual *		mCharacter;
 		const IgnoredContactList &		mIgnoredContacts;
 		Contact &						mContact;
+		const CharacterVirtual *		mOtherCharacter = nullptr;								///< When casting against another character, the character that is being hit
+		Vec3							mOtherCharacterVelocity = Vec3::sZero();				///< Velocity of mOtherCharacter
 	};
 
 	// Helper function to convert a Jolt collision result into a contact
 	template <class taCollector>
 	inline static void					sFillContactProperties(const CharacterVirtual *inCharacter, Contact &outContact, const Body &inBody, Vec3Arg inUp, RVec3Arg inBaseOffset, const taCollector &inCollector, const CollideShapeResult &inResult);
 
+	// Helper function to convert a collision result with another character into a contact
+	template <class taCollector>
+	inline static void					sFillCharacterContactProperties(Contact &outContact, const CharacterVirtual *inOtherCharacter, Vec3Arg inOtherCharacterVelocity, Vec3Arg inUp, RVec3Arg inBaseOffset, const taCollector &inCollector, const CollideShapeResult &inResult);
+
 	// Move the shape from ioPosition and try to displace it by inVelocity * inDeltaTime, this will try to slide the shape along the world geometry
 	void								MoveShape(RVec3 &ioPosition, Vec3Arg inVelocity, float inDeltaTime, ContactList *outActiveContacts, const BroadPhaseLayerFilter &inBroadPhaseLayerFilter, const ObjectLayerFilter &inObjectLayerFilter, const BodyFilter &inBodyFilter, const ShapeFilter &inShapeFilter, TempAllocator &inAllocator
 	#ifdef JPH_DEBUG_RENDERER
@@ -439,9 +495,21 @@ private:
 	// Handle contact with physics object that we're colliding against
 	bool								HandleContact(Vec3Arg inVelocity, Constraint &ioConstraint, float inDeltaTime) const;
 
+	// Apply an impulse to a body, or store it when impulses are deferred
+	void								AddImpulse(const BodyID &inBodyID, Vec3Arg inImpulse, RVec3Arg inPosition) const;
+
 	// Does a swept test of the shape from inPosition with displacement inDisplacement, returns true if there was a collision
 	bool								GetFirstContactForSweep(RVec3Arg inPosition, Vec3Arg inDisplacement, Contact &outContact, const IgnoredContactList &inIgnoredContacts, const BroadPhaseLayerFilter &inBroadPhaseLayerFilter, const ObjectLayerFilter &inObjectLayerFilter, const BodyFilter &inBodyFilter, const ShapeFilter &inShapeFilter) const;
 
+	// Collect the bodies around the character that could be touched when moving less than mRestingTolerance, returns false if any of them is active
+	bool								GetRestingBodies(Array<BodyID> &outBodies, const BroadPhaseLayerFilter &inBroadPhaseLayerFilter, const ObjectLayerFilter &inObjectLayerFilter, const BodyFilter &inBodyFilter) const;
+
+	// Check if the character is still resting and the contacts of the previous update can be reused
+	bool								CanReuseContacts(float inDeltaTime, const BroadPhaseLayerFilter &inBroadPhaseLayerFilter, const ObjectLayerFilter &inObjectLayerFilter, const BodyFilter &inBodyFilter) const;
+
+	// Remember the state of a character that moved less than mRestingTolerance so that the next update can reuse its contacts
+	void								StoreRestingState(RVec3Arg inPreviousPosition, float inDeltaTime, const BroadPhaseLayerFilter &inBroadPhaseLayerFilter, const ObjectLayerFilter &inObjectLayerFilter, const BodyFilter &inBodyFilter);
+
 	// Store contacts so that we have proper ground information
 	void								StoreActiveContacts(const TempContactList &inContacts, TempAllocator &inAllocator);
 
@@ -460,6 +528,12 @@ private:
 	// Our main listener for contacts
 	CharacterContactListener *			mListener = nullptr;
 
+	// Grid with the other characters that we collide with
+	const CharacterVsCharacterGrid *	mCharacterVsCharacterGrid = nullptr;
+
+	// ID of this character, see GetID
+	uint32								mID = 0;
+
 	// Movement settings
 	EBackFaceMode						mBackFaceMode;											// When colliding with back faces, the character will not be able to move through back facing triangles. Use this if you have triangles that need to collide on both sides.
 	float								mPredictiveContactDistance;								// How far to scan outside of the shape for predictive contacts. A value of 0 will most likely cause the character to get stuck as it cannot properly calculate a sliding direction anymore. A value that's too high will cause ghost collisions.
@@ -472,6 +546,7 @@ private:
 	float								mHitReductionCosMaxAngle;								// Cos(angle) where angle is the maximum angle between two hits contact normals that are allowed to be merged during hit reduction. Default is around 2.5 degrees. Set to -1 to turn off.
 	float								mPenetrationRecoverySpeed;								// This value governs how fast a penetration will be resolved, 0 = nothing is resolved, 1 = everything in one update
 	bool								mEnhancedInternalEdgeRemoval;							// Set to indicate that extra effort should be made to try to remove ghost contacts (collisions with internal edges of a mesh). This is more expensive but makes bodies move smoother over a mesh with convex edges.
+	float								mRestingTolerance;										// Distance below which a resting character reuses the contacts of the previous update
 
 	// Character mass (kg)
 	float								mMass;
@@ -502,6 +577,30 @@ private:
 
 	// User data, can be used for anything by the application
 	uint64								mUserData = 0;
+
+	// State of the last update that moved the character less than mRestingTolerance
+	bool								mIsResting = false;										// If the fields below are valid
+	bool								mReusedContacts = false;								// If the last update reused the contacts of the previous update
+	RVec3								mRestingPosition = RVec3::sZero();						// Position of the character after the update
+	RVec3								mRestingContactsPosition = RVec3::sZero();				// Position of the character when the contacts were determined
+	Quat								mRestingRotation = Quat::sIdentity();					// Rotation of the character during the update
+	Vec3								mRestingDisplacement = Vec3::sZero();					// Desired displacement (velocity * delta time) of the update
+	Vec3								mRestingMovement = Vec3::sZero();						// Actual displacement of the character during the update that determined the contacts
+	Array<BodyID>						mRestingBodies;											// Sorted list of bodies around the character, all of which were inactive
+
+	// An impulse that is waiting to be applied to a body
+	struct DeferredImpulse
+	{
+		BodyID							mBodyID;
+		Vec3							mImpulse;
+		RVec3							mPosition;
+	};
+
+	// If impulses are stored in mDeferredImpulses instead of being applied immediately
+	bool								mDeferImpulses = false;
+
+	// Impulses that are waiting for ApplyDeferredImpulses
+	mutable Array<DeferredImpulse>		mDeferredImpulses;
 };
 
 JPH_NAMESPACE_END
@@ -0,0 +1,81 @@
+// Jolt Physics Library (https://github.com/jrouwe/JoltPhysics)
+// SPDX-FileCopyrightText: 2024 Jorrit Rouwe
+// SPDX-License-Identifier: MIT
+
+#include <Jolt/Jolt.h>
+
+#include <Jolt/Physics/Character/CharacterVirtualBatchUpdater.h>
+#include <Jolt/Core/JobSystem.h>
+
+JPH_SUPPRESS_WARNINGS_STD_BEGIN
+#include <atomic>
+JPH_SUPPRESS_WARNINGS_STD_END
+
+JPH_NAMESPACE_BEGIN
+
+CharacterVirtualBatchUpdater::CharacterVirtualBatchUpdater(uint inMaxJobs, uint inTempAllocatorSize)
+{
+	JPH_ASSERT(inMaxJobs > 0);
+
+	mAllocators.reserve(inMaxJobs);
+	for (uint i = 0; i < inMaxJobs; ++i)
+		mAllocators.push_back(new TempAllocatorImpl(inTempAllocatorSize));
+}
+
+CharacterVirtualBatchUpdater::~CharacterVirtualBatchUpdater()
+{
+	for (TempAllocatorImpl *allocator : mAllocators)
+		delete allocator;
+}
+
+void CharacterVirtualBatchUpdater::ExtendedUpdate(CharacterVirtual *const *inCharacters, uint inNumCharacters, float inDeltaTime, Vec3Arg inGravity, const CharacterVirtual::ExtendedUpdateSettings &inSettings, const BroadPhaseLayerFilter &inBroadPhaseLayerFilter, const ObjectLayerFilter &inObjectLayerFilter, const BodyFilter &inBodyFilter, const ShapeFilter &inShapeFilter, JobSystem &inJobSystem)
+{
+	JPH_PROFILE_FUNCTION();
+
+	if (inNumCharacters == 0)
+		return;
+
+	// Store impulses so that all characters see the same body velocities, no matter which job updates them first
+	for (uint i = 0; i < inNumCharacters; ++i)
+	{
+		JPH_ASSERT(!inCharacters[i]->GetDeferImpulses());
+		inCharacters[i]->SetDeferImpulses(true);
+	}
+
+	// Determine the number of jobs
+	uint num_batches = (inNumCharacters + cBatchSize - 1) / cBatchSize;
+	uint max_concurrency = uint(max(inJobSystem.GetMaxConcurrency(), 1));
+	uint num_jobs = min(min(uint(mAllocators.size()), max_concurrency), num_batches);
+
+	// Start the jobs, each job takes batches of characters until all characters have been updated
+	atomic<uint> next_batch = 0;
+	JobSystem::Barrier *barrier = inJobSystem.CreateBarrier();
+	for (uint job = 0; job < num_jobs; ++job)
+	{
+		JobHandle handle = inJobSystem.CreateJob("UpdateCharacters", Color::sGreen, [&, allocator = mAllocators[job]]() {
+			for (;;)
+			{
+				uint batch = next_batch.fetch_add(1, memory_order_relaxed);
+				if (batch >= num_batches)
+					break;
+
+				uint end = min((batch + 1) * cBatchSize, inNumCharacters);
+				for (uint i = batch * cBatchSize; i < end; ++i)
+					inCharacters[i]->ExtendedUpdate(inDeltaTime, inGravity, inSettings, inBroadPhaseLayerFilter, inObjectLayerFilter, inBodyFilter, inShapeFilter, *allocator);
+			}
+		});
+		barrier->AddJob(handle);
+	}
+	inJobSystem.WaitForJobs(barrier);
+	inJobSystem.DestroyBarrier(barrier);
+
+	// Apply the impulses in a deterministic order
+	for (uint i = 0; i < inNumCharacters; ++i)
+	{
+		CharacterVirtual *character = inCharacters[i];
+		character->SetDeferImpulses(false);
+		character->ApplyDeferredImpulses();
+	}
+}
+
+JPH_NAMESPACE_END
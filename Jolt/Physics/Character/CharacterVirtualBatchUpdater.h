@@ -0,0 +1,53 @@
+// Jolt Physics Library (https://github.com/jrouwe/JoltPhysics)
+// SPDX-FileCopyrightText: 2024 Jorrit Rouwe
+// SPDX-License-Identifier: MIT
+
+#pragma once
+
+#include <Jolt/Physics/Character/CharacterVirtual.h>
+#include <Jolt/Core/TempAllocator.h>
+
+JPH_NAMESPACE_BEGIN
+
+class JobSystem;
+
+/// Updates a batch of virtual characters in parallel using the job system.
+///
+/// Each job has its own temp allocator and takes characters from the batch in groups of cBatchSize.
+/// While the batch is updating, the impulses that the characters apply to dynamic bodies are deferred (see CharacterVirtual::SetDeferImpulses),
+/// so every character sees the bodies as they were at the start of the batch. When all jobs are done, the impulses are applied in the order in which the
+/// characters were passed in. This makes the outcome independent of the number of threads and of the order in which the jobs execute.
+/// Note that the result can differ slightly from calling CharacterVirtual::ExtendedUpdate on each character in sequence,
+/// as in that case a character sees the impulses of the characters that were updated before it.
+///
+/// The filters and the CharacterContactListener of the characters are called from multiple threads so they need to be thread safe.
+/// The PhysicsSystem should not be modified while the batch is updating.
+class JPH_EXPORT CharacterVirtualBatchUpdater : public NonCopyable
+{
+public:
+	JPH_OVERRIDE_NEW_DELETE
+
+	/// Number of characters that a job takes from the batch at a time
+	static constexpr uint				cBatchSize = 16;
+
+	/// Constructor
+	/// @param inMaxJobs Maximum number of jobs to spread the characters over, the actual number is also limited by the max concurrency of the job system
+	/// @param inTempAllocatorSize Size of the temp allocator of each job (in bytes), must be large enough to update a single character
+										CharacterVirtualBatchUpdater(uint inMaxJobs, uint inTempAllocatorSize);
+
+	/// Destructor
+										~CharacterVirtualBatchUpdater();
+
+	/// Calls CharacterVirtual::ExtendedUpdate for all characters, see that function for a description of the parameters.
+	/// Characters that need different filters should be updated in separate batches.
+	/// @param inCharacters The characters to update
+	/// @param inNumCharacters Number of characters in inCharacters
+	/// @param inJobSystem The job system to use for the update
+	void								ExtendedUpdate(CharacterVirtual *const *inCharacters, uint inNumCharacters, float inDeltaTime, Vec3Arg inGravity, const CharacterVirtual::ExtendedUpdateSettings &inSettings, const BroadPhaseLayerFilter &inBroadPhaseLayerFilter, const ObjectLayerFilter &inObjectLayerFilter, const BodyFilter &inBodyFilter, const ShapeFilter &inShapeFilter, JobSystem &inJobSystem);
+
+private:
+	/// One temp allocator for every job
+	Array<TempAllocatorImpl *>			mAllocators;
+};
+
+JPH_NAMESPACE_END
@@ -0,0 +1,116 @@
+// Jolt Physics Library (https://github.com/jrouwe/JoltPhysics)
+// SPDX-FileCopyrightText: 2024 Jorrit Rouwe
+// SPDX-License-Identifier: MIT
+
+#include <Jolt/Jolt.h>
+
+#include <Jolt/Physics/Character/CharacterVsCharacterGrid.h>
+#include <Jolt/Core/QuickSort.h>
+#include <Jolt/Core/Profiler.h>
+
+JPH_NAMESPACE_BEGIN
+
+void CharacterVsCharacterGrid::Add(CharacterVirtual *inCharacter)
+{
+	JPH_ASSERT(std::find(mCharacters.begin(), mCharacters.end(), inCharacter) == mCharacters.end());
+
+	if (inCharacter->GetID() == 0)
+		inCharacter->SetID(mNextCharacterID++);
+	JPH_ASSERT(FindCharacter(inCharacter->GetID()) == nullptr, "Character IDs should be unique");
+
+	mCharacters.push_back(inCharacter);
+}
+
+void CharacterVsCharacterGrid::Remove(const CharacterVirtual *inCharacter)
+{
+	// Keep the order of the characters so that the grid is built in the same way every time
+	Array<CharacterVirtual *>::iterator i = std::find(mCharacters.begin(), mCharacters.end(), inCharacter);
+	JPH_ASSERT(i != mCharacters.end());
+	mCharacters.erase(i);
+
+	// Remove the snapshot too so that other characters no longer collide with it
+	for (uint32 index = 0; index < (uint32)mEntries.size(); ++index)
+		if (mEntries[index].mCharacter == inCharacter)
+		{
+			// Entries are sorted by cell, so removing an entry shifts the entries of the cells that come after it
+			uint64 cell_key = mEntries[index].mCellKey;
+			mEntries.erase(mEntries.begin() + index);
+			for (UnorderedMap<uint64, Cell>::iterator cell = mCells.begin(); cell != mCells.end(); )
+			{
+				if (cell->first == cell_key && --cell->second.mCount == 0)
+				{
+					cell = mCells.erase(cell);
+					continue;
+				}
+				if (cell->second.mFirst > index)
+					--cell->second.mFirst;
+				++cell;
+			}
+			break;
+		}
+
+	// Other characters should no longer have contacts with it
+	for (CharacterVirtual *character : mCharacters)
+		character->RemoveContactsWithCharacterInternal(inCharacter);
+}
+
+const CharacterVirtual *CharacterVsCharacterGrid::FindCharacter(uint32 inID) const
+{
+	for (const CharacterVirtual *character : mCharacters)
+		if (character->GetID() == inID)
+			return character;
+	return nullptr;
+}
+
+void CharacterVsCharacterGrid::Update()
+{
+	JPH_PROFILE_FUNCTION();
+
+	// Take a snapshot of all characters
+	mEntries.resize(mCharacters.size());
+	mMaxHalfExtent = Vec3::sZero();
+	for (size_t i = 0; i < mCharacters.size(); ++i)
+	{
+		CharacterVirtual *character = mCharacters[i];
+		const Shape *shape = character->GetShape();
+		RMat44 com = character->GetCenterOfMassTransform();
+
+		Entry &e = mEntries[i];
+		e.mCharacter = character;
+		e.mShape = shape;
+		e.mPositionCOM = com.GetTranslation();
+		e.mRotation = character->GetRotation();
+		e.mLinearVelocity = character->GetLinearVelocity();
+		e.mBounds = shape->GetWorldSpaceBounds(com, Vec3::sReplicate(1.0f));
+		mMaxHalfExtent = Vec3::sMax(mMaxHalfExtent, e.mBounds.GetExtent());
+
+		int x, y, z;
+		GetCellCoordinates(e.mBounds.GetCenter(), x, y, z);
+		e.mCellKey = sGetCellKey(x, y, z);
+	}
+
+	// Sort the characters by cell, characters in the same cell stay in the order in which they were added
+	Array<uint32> order;
+	order.resize(mEntries.size());
+	for (uint32 i = 0; i < (uint32)order.size(); ++i)
+		order[i] = i;
+	QuickSort(order.begin(), order.end(), [this](uint32 inLHS, uint32 inRHS) {
+		uint64 lhs_key = mEntries[inLHS].mCellKey, rhs_key = mEntries[inRHS].mCellKey;
+		return lhs_key != rhs_key? lhs_key < rhs_key : inLHS < inRHS;
+	});
+	Array<Entry> sorted;
+	sorted.reserve(mEntries.size());
+	for (uint32 i : order)
+		sorted.push_back(std::move(mEntries[i]));
+	mEntries.swap(sorted);
+
+	// Build the cells
+	mCells.clear();
+	for (uint32 i = 0; i < (uint32)mEntries.size(); ++i)
+	{
+		Cell &cell = mCells.try_emplace(mEntries[i].mCellKey, Cell { i, 0 }).first->second;
+		cell.mCount++;
+	}
+}
+
+JPH_NAMESPACE_END
@@ -0,0 +1,138 @@
+// Jolt Physics Library (https://github.com/jrouwe/JoltPhysics)
+// SPDX-FileCopyrightText: 2024 Jorrit Rouwe
+// SPDX-License-Identifier: MIT
+
+#pragma once
+
+#include <Jolt/Physics/Character/CharacterVirtual.h>
+#include <Jolt/Physics/Collision/TransformedShape.h>
+#include <Jolt/Core/UnorderedMap.h>
+
+JPH_NAMESPACE_BEGIN
+
+/// A uniform grid of virtual characters that allows characters to collide with each other.
+///
+/// Add the characters to the grid and assign the grid to the characters using CharacterVirtual::SetCharacterVsCharacterGrid.
+/// Call Update once per frame before updating the characters. The grid takes a snapshot of the characters, so all characters see
+/// each other where they were when Update was called. This makes the outcome independent of the order in which characters are updated
+/// and allows updating them in parallel (see CharacterVirtualBatchUpdater).
+///
+/// A character sees other characters as kinematic objects that move with the velocity of the other character, so it will not push them.
+/// Each character is stored in the cell that contains the center of its bounding box, the cell size should be in the order of a couple of character widths.
+///
+/// The grid stores pointers to the characters, so a character needs to be removed from the grid before it is destroyed.
+/// Add, Remove and Update should not be called while characters are being updated.
+class JPH_EXPORT CharacterVsCharacterGrid : public NonCopyable
+{
+public:
+	JPH_OVERRIDE_NEW_DELETE
+
+	/// Snapshot of a character as taken by Update
+	struct Entry
+	{
+		/// Get the shape of the character in world space
+		TransformedShape				GetTransformedShape() const								{ return TransformedShape(mPositionCOM, mRotation, mShape, BodyID()); }
+
+		CharacterVirtual *				mCharacter;												///< The character
+		RefConst<Shape>					mShape;													///< Shape of the character
+		RVec3							mPositionCOM;											///< Position of the center of mass of the shape
+		Quat							mRotation;												///< Rotation of the shape
+		Vec3							mLinearVelocity;										///< Velocity of the character
+		AABox							mBounds;												///< World space bounds of the shape
+		uint64							mCellKey;												///< Key of the cell that the character is in
+	};
+
+	/// Constructor
+	/// @param inCellSize Size of a cell of the grid (m)
+	explicit							CharacterVsCharacterGrid(float inCellSize = 4.0f)		: mCellSize(inCellSize) { JPH_ASSERT(inCellSize > 0.0f); }
+
+	/// Add a character to the grid, it will be part of the grid after the next call to Update.
+	/// If the character doesn't have an ID yet (see CharacterVirtual::GetID), the grid assigns one. Characters that are added in the same order get the same IDs.
+	void								Add(CharacterVirtual *inCharacter);
+
+	/// Remove a character from the grid, other characters will no longer collide with it and their contacts with it are removed
+	void								Remove(const CharacterVirtual *inCharacter);
+
+	/// Find a character in the grid by its ID (see CharacterVirtual::GetID), returns nullptr if not found
+	const CharacterVirtual *			FindCharacter(uint32 inID) const;
+
+	/// Number of characters in the grid
+	uint								GetNumCharacters() const								{ return (uint)mCharacters.size(); }
+
+	/// Take a snapshot of all characters and rebuild the grid
+	void								Update();
+
+	/// Call inVisitor(const Entry &) for all characters (except inSkip) of which the bounds (as snapshot at the last Update) overlap with inBounds
+	template <class Visitor>
+	void								VisitCharacters(const AABox &inBounds, const CharacterVirtual *inSkip, const Visitor &inVisitor) const;
+
+private:
+	/// Get the key of the cell with integer coordinates (inX, inY, inZ)
+	static inline uint64				sGetCellKey(int inX, int inY, int inZ)
+	{
+		constexpr uint64 cMask = (uint64(1) << 21) - 1;
+		return ((uint64(inX) & cMask) << 42) | ((uint64(inY) & cMask) << 21) | (uint64(inZ) & cMask);
+	}
+
+	/// Get the integer coordinates of the cell that contains inPosition
+	inline void							GetCellCoordinates(Vec3Arg inPosition, int &outX, int &outY, int &outZ) const
+	{
+		Vec3 cell = inPosition / mCellSize;
+		outX = int(floor(cell.GetX()));
+		outY = int(floor(cell.GetY()));
+		outZ = int(floor(cell.GetZ()));
+	}
+
+	/// First entry and number of entries of a cell
+	struct Cell
+	{
+		uint32							mFirst;
+		uint32							mCount;
+	};
+
+	float								mCellSize;
+	uint32								mNextCharacterID = 1;									///< Next ID to assign to a character that doesn't have one
+	Array<CharacterVirtual *>			mCharacters;											///< All characters in the order they were added
+	Array<Entry>						mEntries;												///< Snapshots of the characters, sorted by cell
+	UnorderedMap<uint64, Cell>			mCells;													///< Maps the cell key to a range in mEntries
+	Vec3								mMaxHalfExtent = Vec3::sZero();							///< Largest half extent of the bounds of all characters, used to expand queries because characters are only stored in the cell that contains their center
+};
+
+template <class Visitor>
+void CharacterVsCharacterGrid::VisitCharacters(const AABox &inBounds, const CharacterVirtual *inSkip, const Visitor &inVisitor) const
+{
+	if (mEntries.empty())
+		return;
+
+	// Determine the range of cells that can contain the center of a character that overlaps with inBounds
+	int min_x, min_y, min_z, max_x, max_y, max_z;
+	GetCellCoordinates(inBounds.mMin - mMaxHalfExtent, min_x, min_y, min_z);
+	GetCellCoordinates(inBounds.mMax + mMaxHalfExtent, max_x, max_y, max_z);
+	uint64 num_cells = uint64(max_x - min_x + 1) * uint64(max_y - min_y + 1) * uint64(max_z - min_z + 1);
+
+	auto visit_entry = [&inBounds, inSkip, &inVisitor](const Entry &inEntry) {
+		if (inEntry.mCharacter != inSkip && inEntry.mBounds.Overlaps(inBounds))
+			inVisitor(inEntry);
+	};
+
+	if (num_cells > mEntries.size())
+	{
+		// It's cheaper to test all characters than to look up all cells
+		for (const Entry &e : mEntries)
+			visit_entry(e);
+	}
+	else
+	{
+		for (int x = min_x; x <= max_x; ++x)
+			for (int y = min_y; y <= max_y; ++y)
+				for (int z = min_z; z <= max_z; ++z)
+				{
+					typename UnorderedMap<uint64, Cell>::const_iterator cell = mCells.find(sGetCellKey(x, y, z));
+					if (cell != mCells.end())
+						for (uint32 i = cell->second.mFirst, end = cell->second.mFirst + cell->second.mCount; i < end; ++i)
+							visit_entry(mEntries[i]);
+				}
+	}
+}
+
+JPH_NAMESPACE_END
@@ -17,10 +17,19 @@ JPH_NAMESPACE_BEGIN
 #endif // JPH_TRACK_BROADPHASE_STATS
 
 class BodyManager;
+class JobSystem;
 struct BodyPair;
 
 using BodyPairCollector = CollisionCollector<BodyPair, CollisionCollectorTraitsCollideShape>;
 
+/// Which broadphase implementation the PhysicsSystem should create
+enum class EBroadPhaseType : uint8
+{
+	QuadTree,				///< BroadPhaseQuadTree, a good general purpose broadphase
+	SweepAndPrune,			///< BroadPhaseSAP, usually faster for worlds with many moving bodies that are spread out over a plane
+	BruteForce,				///< BroadPhaseBruteForce, tests against all bodies, only useful as reference implementation
+};
+
 /// Used to do coarse collision detection operations to quickly prune out bodies that will not collide.
 class JPH_EXPORT BroadPhase : public BroadPhaseQuery
 {
@@ -34,6 +43,10 @@ public:
 	/// Should be called after many objects have been inserted to make the broadphase more efficient, usually done on startup only
 	virtual void		Optimize()															{ /* Optionally overridden by implementation */ }
 
+	/// Same as Optimize but uses inJobSystem to rebuild the internal structures in parallel.
+	/// This function waits for the jobs to complete, so it should not be called from a job of inJobSystem.
+	virtual void		Optimize([[maybe_unused]] JobSystem *inJobSystem)					{ Optimize(); }
+
 	/// Must be called just before updating the broadphase when none of the body mutexes are locked
 	virtual void		FrameSync()															{ /* Optionally overridden by implementation */ }
 
@@ -47,6 +60,13 @@ public:
 	/// The UpdatePrepare() function can run in a background thread without influencing the broadphase
 	virtual	UpdateState	UpdatePrepare()														{ return UpdateState(); }
 
+	/// Alternative to UpdatePrepare that allows the work to be split up over multiple threads.
+	/// UpdatePrepareBegin returns the number of batches. When this is 0 the update has been fully prepared, otherwise UpdatePrepareBatch needs to be called for every batch
+	/// (this can be done from multiple threads) followed by a single call to UpdatePrepareEnd. After this outUpdateState can be passed to UpdateFinalize.
+	virtual uint		UpdatePrepareBegin(UpdateState &outUpdateState)						{ outUpdateState = UpdatePrepare(); return 0; }
+	virtual void		UpdatePrepareBatch([[maybe_unused]] const UpdateState &inUpdateState, [[maybe_unused]] uint inBatch) { JPH_ASSERT(false); }
+	virtual void		UpdatePrepareEnd([[maybe_unused]] UpdateState &ioUpdateState)		{ JPH_ASSERT(false); }
+
 	/// Finalizing the update will quickly apply the changes
 	virtual void		UpdateFinalize([[maybe_unused]] const UpdateState &inUpdateState)	{ /* Optionally overridden by implementation */ }
 
@@ -61,6 +81,10 @@ public:
 	/// ioBodies may be shuffled around by this function and should be kept that way until AddBodiesFinalize/Abort is called.
 	virtual AddState	AddBodiesPrepare([[maybe_unused]] BodyID *ioBodies, [[maybe_unused]] int inNumber) { return nullptr; } // By default the broadphase doesn't support this
 
+	/// Same as AddBodiesPrepare but uses inJobSystem to build the internal structures for large batches of bodies in parallel.
+	/// This function waits for the jobs to complete, so it should not be called from a job of inJobSystem.
+	virtual AddState	AddBodiesPrepare(BodyID *ioBodies, int inNumber, [[maybe_unused]] JobSystem *inJobSystem) { return AddBodiesPrepare(ioBodies, inNumber); } // By default the broadphase doesn't use the job system
+
 	/// Finalize adding bodies to the broadphase, supply the return value of AddBodiesPrepare in inAddState.
 	/// Please ensure that the ioBodies array passed to AddBodiesPrepare is unmodified and passed again to this function.
 	virtual void		AddBodiesFinalize(BodyID *ioBodies, int inNumber, AddState inAddState) = 0;
@@ -8,6 +8,7 @@
 #include <Jolt/Physics/Collision/AABoxCast.h>
 #include <Jolt/Physics/Collision/CastResult.h>
 #include <Jolt/Core/QuickSort.h>
+#include <Jolt/Core/JobSystem.h>
 
 JPH_NAMESPACE_BEGIN
 
@@ -70,6 +71,11 @@ void BroadPhaseQuadTree::FrameSync()
 }
 
 void BroadPhaseQuadTree::Optimize()
+{
+	Optimize(nullptr);
+}
+
+void BroadPhaseQuadTree::Optimize(JobSystem *inJobSystem)
 {
 	JPH_PROFILE_FUNCTION();
 
@@ -77,15 +83,58 @@ void BroadPhaseQuadTree::Optimize()
 
 	LockModifications();
 
-	for (uint l = 0; l < mNumLayers; ++l)
+	if (inJobSystem == nullptr)
 	{
-		QuadTree &tree = mLayers[l];
-		if (tree.HasBodies())
+		for (uint l = 0; l < mNumLayers; ++l)
+		{
+			QuadTree &tree = mLayers[l];
+			if (tree.HasBodies())
+			{
+				QuadTree::UpdateState update_state;
+				tree.UpdatePrepare(mBodyManager->GetBodies(), mTracking, update_state, true);
+				tree.UpdateFinalize(mBodyManager->GetBodies(), mTracking, update_state);
+			}
+		}
+	}
+	else
+	{
+		const BodyVector &bodies = mBodyManager->GetBodies();
+
+		// Split the trees of all layers into batches and start a job to build each batch
+		QuadTree::BatchedUpdateState *batched_states = new QuadTree::BatchedUpdateState [mNumLayers];
+		JobSystem::Barrier *barrier = inJobSystem->CreateBarrier();
+		for (uint l = 0; l < mNumLayers; ++l)
+		{
+			QuadTree &tree = mLayers[l];
+			if (tree.HasBodies())
+			{
+				QuadTree::BatchedUpdateState &batched_state = batched_states[l];
+				tree.UpdatePrepareBegin(bodies, mTracking, batched_state, true);
+				for (int i = 0; i < QuadTree::cNumAddBatches; ++i)
+					if (batched_state.mSplit[i + 1] > batched_state.mSplit[i])
+					{
+						JobHandle handle = inJobSystem->CreateJob("OptimizeBroadPhase", Color::sGreen, [this, &tree, &bodies, &batched_state, i]() {
+							tree.UpdatePrepareBatch(bodies, mTracking, batched_state, i);
+						});
+						barrier->AddJob(handle);
+					}
+			}
+		}
+		inJobSystem->WaitForJobs(barrier);
+		inJobSystem->DestroyBarrier(barrier);
+
+		// Combine the batches and swap the trees
+		for (uint l = 0; l < mNumLayers; ++l)
 		{
-			QuadTree::UpdateState update_state;
-			tree.UpdatePrepare(mBodyManager->GetBodies(), mTracking, update_state, true);
-			tree.UpdateFinalize(mBodyManager->GetBodies(), mTracking, update_state);
+			QuadTree &tree = mLayers[l];
+			if (tree.HasBodies())
+			{
+				QuadTree::UpdateState update_state;
+				tree.UpdatePrepareEnd(bodies, mTracking, batched_states[l], update_state);
+				tree.UpdateFinalize(bodies, mTracking, update_state);
+			}
 		}
+		delete [] batched_states;
 	}
 
 	UnlockModifications();
@@ -100,13 +149,25 @@ void BroadPhaseQuadTree::LockModifications()
 }
 
 BroadPhase::UpdateState BroadPhaseQuadTree::UpdatePrepare()
+{
+	// Build all batches on this thread
+	UpdateState update_state;
+	uint num_batches = UpdatePrepareBegin(update_state);
+	if (num_batches > 0)
+	{
+		for (uint batch = 0; batch < num_batches; ++batch)
+			UpdatePrepareBatch(update_state, batch);
+		UpdatePrepareEnd(update_state);
+	}
+	return update_state;
+}
+
+uint BroadPhaseQuadTree::UpdatePrepareBegin(UpdateState &outUpdateState)
 {
 	// LockModifications should have been called
 	JPH_ASSERT(mUpdateMutex.is_locked());
 
-	// Create update state
-	UpdateState update_state;
-	UpdateStateImpl *update_state_impl = reinterpret_cast<UpdateStateImpl *>(&update_state);
+	UpdateStateImpl *update_state_impl = reinterpret_cast<UpdateStateImpl *>(&outUpdateState);
 
 	// Loop until we've seen all layers
 	for (uint iteration = 0; iteration < mNumLayers; ++iteration)
@@ -119,14 +180,33 @@ BroadPhase::UpdateState BroadPhaseQuadTree::UpdatePrepare()
 		if (tree.HasBodies() && tree.IsDirty() && tree.CanBeUpdated())
 		{
 			update_state_impl->mTree = &tree;
-			tree.UpdatePrepare(mBodyManager->GetBodies(), mTracking, update_state_impl->mUpdateState, false);
-			return update_state;
+			const BodyVector &bodies = mBodyManager->GetBodies();
+			tree.UpdatePrepareBegin(bodies, mTracking, mBatchedUpdateState, false);
+			if (!mBatchedUpdateState.IsSingleBatch())
+				return QuadTree::cNumAddBatches;
+
+			// Tree is too small to split up, build it right away
+			tree.UpdatePrepareBatch(bodies, mTracking, mBatchedUpdateState, 0);
+			tree.UpdatePrepareEnd(bodies, mTracking, mBatchedUpdateState, update_state_impl->mUpdateState);
+			return 0;
 		}
 	}
 
 	// Nothing to update
 	update_state_impl->mTree = nullptr;
-	return update_state;
+	return 0;
+}
+
+void BroadPhaseQuadTree::UpdatePrepareBatch(const UpdateState &inUpdateState, uint inBatch)
+{
+	const UpdateStateImpl *update_state_impl = reinterpret_cast<const UpdateStateImpl *>(&inUpdateState);
+	update_state_impl->mTree->UpdatePrepareBatch(mBodyManager->GetBodies(), mTracking, mBatchedUpdateState, int(inBatch));
+}
+
+void BroadPhaseQuadTree::UpdatePrepareEnd(UpdateState &ioUpdateState)
+{
+	UpdateStateImpl *update_state_impl = reinterpret_cast<UpdateStateImpl *>(&ioUpdateState);
+	update_state_impl->mTree->UpdatePrepareEnd(mBodyManager->GetBodies(), mTracking, mBatchedUpdateState, update_state_impl->mUpdateState);
 }
 
 void BroadPhaseQuadTree::UpdateFinalize(const UpdateState &inUpdateState)
@@ -152,6 +232,11 @@ void BroadPhaseQuadTree::UnlockModifications()
 }
 
 BroadPhase::AddState BroadPhaseQuadTree::AddBodiesPrepare(BodyID *ioBodies, int inNumber)
+{
+	return AddBodiesPrepare(ioBodies, inNumber, nullptr);
+}
+
+BroadPhase::AddState BroadPhaseQuadTree::AddBodiesPrepare(BodyID *ioBodies, int inNumber, JobSystem *inJobSystem)
 {
 	JPH_PROFILE_FUNCTION();
 
@@ -166,6 +251,15 @@ BroadPhase::AddState BroadPhaseQuadTree::AddBodiesPrepare(BodyID *ioBodies, int
 	Body * const * const bodies_ptr = bodies.data(); // C pointer or else sort is incredibly slow in debug mode
 	QuickSort(ioBodies, ioBodies + inNumber, [bodies_ptr](BodyID inLHS, BodyID inRHS) { return bodies_ptr[inLHS.GetIndex()]->GetBroadPhaseLayer() < bodies_ptr[inRHS.GetIndex()]->GetBroadPhaseLayer(); });
 
+	// When we have a job system, we build the trees in batches
+	Array<QuadTree::AddState> batch_states;
+	JobSystem::Barrier *barrier = nullptr;
+	if (inJobSystem != nullptr)
+	{
+		batch_states.resize(size_t(mNumLayers) * QuadTree::cNumAddBatches);
+		barrier = inJobSystem->CreateBarrier();
+	}
+
 	BodyID *b_start = ioBodies, *b_end = ioBodies + inNumber;
 	while (b_start < b_end)
 	{
@@ -175,32 +269,86 @@ BroadPhase::AddState BroadPhaseQuadTree::AddBodiesPrepare(BodyID *ioBodies, int
 
 		// Find first body with different layer
 		BodyID *b_mid = std::upper_bound(b_start, b_end, broadphase_layer, [bodies_ptr](BroadPhaseLayer::Type inLayer, BodyID inBodyID) { return inLayer < (BroadPhaseLayer::Type)bodies_ptr[inBodyID.GetIndex()]->GetBroadPhaseLayer(); });
+		int num_bodies = int(b_mid - b_start);
 
 		// Keep track of state for this layer
 		LayerState &layer_state = state[broadphase_layer];
 		layer_state.mBodyStart = b_start;
 		layer_state.mBodyEnd = b_mid;
 
-		// Insert all bodies of the same layer
-		mLayers[broadphase_layer].AddBodiesPrepare(bodies, mTracking, b_start, int(b_mid - b_start), layer_state.mAddState);
-
-		// Keep track in which tree we placed the object
-		for (const BodyID *b = b_start; b < b_mid; ++b)
+		QuadTree &tree = mLayers[broadphase_layer];
+		if (barrier == nullptr)
 		{
-			uint32 index = b->GetIndex();
-			JPH_ASSERT(bodies[index]->GetID() == *b, "Provided BodyID doesn't match BodyID in body manager");
-			JPH_ASSERT(!bodies[index]->IsInBroadPhase());
-			Tracking &t = mTracking[index];
-			JPH_ASSERT(t.mBroadPhaseLayer == (BroadPhaseLayer::Type)cBroadPhaseLayerInvalid);
-			t.mBroadPhaseLayer = broadphase_layer;
-			JPH_ASSERT(t.mObjectLayer == cObjectLayerInvalid);
-			t.mObjectLayer = bodies[index]->GetObjectLayer();
+			// Insert all bodies of the same layer
+			tree.AddBodiesPrepare(bodies, mTracking, b_start, num_bodies, layer_state.mAddState);
+		}
+		else
+		{
+			// Split large layers into batches, small layers are processed as a single batch
+			int split[QuadTree::cNumAddBatches + 1];
+			if (num_bodies >= QuadTree::cMinBodiesPerAddBatch * QuadTree::cNumAddBatches)
+				tree.AddBodiesPartition(bodies, b_start, num_bodies, split);
+			else
+			{
+				split[0] = 0;
+				for (int i = 1; i <= QuadTree::cNumAddBatches; ++i)
+					split[i] = num_bodies;
+			}
+
+			// Start a job for each batch
+			QuadTree::AddState *layer_batch_states = &batch_states[size_t(broadphase_layer) * QuadTree::cNumAddBatches];
+			for (int i = 0; i < QuadTree::cNumAddBatches; ++i)
+			{
+				BodyID *batch_start = b_start + split[i];
+				int batch_size = split[i + 1] - split[i];
+				if (batch_size > 0)
+				{
+					QuadTree::AddState *batch_state = &layer_batch_states[i];
+					JobHandle handle = inJobSystem->CreateJob("AddBodiesPrepare", Color::sGreen, [this, &tree, &bodies, batch_start, batch_size, batch_state]() {
+						tree.AddBodiesPrepare(bodies, mTracking, batch_start, batch_size, *batch_state);
+					});
+					barrier->AddJob(handle);
+				}
+			}
 		}
 
 		// Repeat
 		b_start = b_mid;
 	}
 
+	if (barrier != nullptr)
+	{
+		// Wait for all batches to be built
+		inJobSystem->WaitForJobs(barrier);
+		inJobSystem->DestroyBarrier(barrier);
+
+		// Combine the batches of each layer into a single tree
+		for (BroadPhaseLayer::Type broadphase_layer = 0; broadphase_layer < mNumLayers; broadphase_layer++)
+		{
+			LayerState &layer_state = state[broadphase_layer];
+			if (layer_state.mBodyStart != nullptr)
+				mLayers[broadphase_layer].AddBodiesCombine(bodies, mTracking, &batch_states[size_t(broadphase_layer) * QuadTree::cNumAddBatches], QuadTree::cNumAddBatches, layer_state.mAddState);
+		}
+	}
+
+	// Keep track in which tree we placed the object
+	for (BroadPhaseLayer::Type broadphase_layer = 0; broadphase_layer < mNumLayers; broadphase_layer++)
+	{
+		const LayerState &layer_state = state[broadphase_layer];
+		if (layer_state.mBodyStart != nullptr)
+			for (const BodyID *b = layer_state.mBodyStart; b < layer_state.mBodyEnd; ++b)
+			{
+				uint32 index = b->GetIndex();
+				JPH_ASSERT(bodies[index]->GetID() == *b, "Provided BodyID doesn't match BodyID in body manager");
+				JPH_ASSERT(!bodies[index]->IsInBroadPhase());
+				Tracking &t = mTracking[index];
+				JPH_ASSERT(t.mBroadPhaseLayer == (BroadPhaseLayer::Type)cBroadPhaseLayerInvalid);
+				t.mBroadPhaseLayer = broadphase_layer;
+				JPH_ASSERT(t.mObjectLayer == cObjectLayerInvalid);
+				t.mObjectLayer = bodies[index]->GetObjectLayer();
+			}
+	}
+
 	return state;
 }
 
@@ -22,12 +22,17 @@ public:
 	// Implementing interface of BroadPhase (see BroadPhase for documentation)
 	virtual void			Init(BodyManager *inBodyManager, const BroadPhaseLayerInterface &inLayerInterface) override;
 	virtual void			Optimize() override;
+	virtual void			Optimize(JobSystem *inJobSystem) override;
 	virtual void			FrameSync() override;
 	virtual void			LockModifications() override;
 	virtual	UpdateState		UpdatePrepare() override;
+	virtual uint			UpdatePrepareBegin(UpdateState &outUpdateState) override;
+	virtual void			UpdatePrepareBatch(const UpdateState &inUpdateState, uint inBatch) override;
+	virtual void			UpdatePrepareEnd(UpdateState &ioUpdateState) override;
 	virtual void			UpdateFinalize(const UpdateState &inUpdateState) override;
 	virtual void			UnlockModifications() override;
 	virtual AddState		AddBodiesPrepare(BodyID *ioBodies, int inNumber) override;
+	virtual AddState		AddBodiesPrepare(BodyID *ioBodies, int inNumber, JobSystem *inJobSystem) override;
 	virtual void			AddBodiesFinalize(BodyID *ioBodies, int inNumber, AddState inAddState) override;
 	virtual void			AddBodiesAbort(BodyID *ioBodies, int inNumber, AddState inAddState) override;
 	virtual void			RemoveBodies(BodyID *ioBodies, int inNumber) override;
@@ -91,6 +96,9 @@ private:
 	static_assert(sizeof(UpdateStateImpl) <= sizeof(UpdateState));
 	static_assert(alignof(UpdateStateImpl) <= alignof(UpdateState));
 
+	/// Batches of the tree that is being rebuilt between UpdatePrepareBegin and UpdatePrepareEnd
+	QuadTree::BatchedUpdateState mBatchedUpdateState;
+
 	/// Mutex that prevents object modification during UpdatePrepare/Finalize()
 	SharedMutex				mUpdateMutex;
 
@@ -0,0 +1,819 @@
+// Jolt Physics Library (https://github.com/jrouwe/JoltPhysics)
+// SPDX-FileCopyrightText: 2024 Jorrit Rouwe
+// SPDX-License-Identifier: MIT
+
+#include <Jolt/Jolt.h>
+
+#include <Jolt/Physics/Collision/BroadPhase/BroadPhaseSAP.h>
+#include <Jolt/Physics/Collision/RayCast.h>
+#include <Jolt/Physics/Collision/AABoxCast.h>
+#include <Jolt/Physics/Collision/CastResult.h>
+#include <Jolt/Physics/Body/BodyManager.h>
+#include <Jolt/Physics/Body/BodyPair.h>
+#include <Jolt/Geometry/RayAABox.h>
+#include <Jolt/Geometry/OrientedBox.h>
+#include <Jolt/Core/InsertionSort.h>
+#include <Jolt/Core/QuickSort.h>
+
+JPH_NAMESPACE_BEGIN
+
+BroadPhaseSAP::~BroadPhaseSAP()
+{
+	for (BroadPhaseLayer::Type l = 0; l < mNumLayers; ++l)
+	{
+		delete mLayers[l].mData.load(memory_order_relaxed);
+		delete mLayers[l].mNextData;
+	}
+	delete [] mLayers;
+
+	for (LayerData *data : mRetiredData)
+		delete data;
+}
+
+void BroadPhaseSAP::Init(BodyManager *inBodyManager, const BroadPhaseLayerInterface &inLayerInterface)
+{
+	BroadPhase::Init(inBodyManager, inLayerInterface);
+
+	// Store input parameters
+	mNumLayers = inLayerInterface.GetNumBroadPhaseLayers();
+	JPH_ASSERT(mNumLayers < (BroadPhaseLayer::Type)cBroadPhaseLayerInvalid);
+
+#ifdef JPH_ENABLE_ASSERTS
+	// Store lock context
+	mLockContext = inBodyManager;
+#endif // JPH_ENABLE_ASSERTS
+
+	// Initialize tracking data
+	mTracking.resize(inBodyManager->GetMaxBodies());
+
+	// Init layers
+	mLayers = new Layer [mNumLayers];
+}
+
+void BroadPhaseSAP::CreateEntry(const Body &inBody, Entry &outEntry) const
+{
+	outEntry.mBounds = inBody.GetWorldSpaceBounds();
+	outEntry.mSortKey = 0.0f;
+	outEntry.mBodyID = inBody.GetID();
+	outEntry.mVersion = mTracking[inBody.GetID().GetIndex()].mVersion.load(memory_order_relaxed) + 1;
+	outEntry.mObjectLayer = inBody.GetObjectLayer();
+}
+
+void BroadPhaseSAP::SortOnBroadPhaseLayer(BodyID *ioBodies, int inNumber) const
+{
+	const Body * const *bodies = mBodyManager->GetBodies().data(); // C pointer or else sort is incredibly slow in debug mode
+	QuickSort(ioBodies, ioBodies + inNumber, [bodies](BodyID inLHS, BodyID inRHS) { return bodies[inLHS.GetIndex()]->GetBroadPhaseLayer() < bodies[inRHS.GetIndex()]->GetBroadPhaseLayer(); });
+}
+
+BroadPhaseSAP::LayerData *BroadPhaseSAP::BuildLayer(const LayerData *inOldData, const Entry *inNewEntries, uint inNumNewEntries) const
+{
+	JPH_PROFILE_FUNCTION();
+
+	LayerData *data = new LayerData;
+	Array<Entry> &sorted = data->mSortedEntries;
+
+	// Collect all entries that are still valid, the entries that were previously sorted are kept in order
+	Array<Entry> unsorted;
+	if (inOldData != nullptr)
+	{
+		uint32 num_old_sorted = (uint32)inOldData->mSortedEntries.size();
+		uint32 num_old_unsorted = inOldData->mNumUnsortedEntries.load(memory_order_relaxed);
+
+		// The new entries only become current in SwapLayerData, so the current entries of the same bodies in inOldData need to be skipped explicitly.
+		// If we would keep them, SwapLayerData could make the old entry current again and the body would be stuck at its old bounds.
+		Array<uint32> replaced_sorted, replaced_unsorted;
+		for (const Entry *n = inNewEntries, *n_end = inNewEntries + inNumNewEntries; n < n_end; ++n)
+		{
+			uint32 index = mTracking[n->mBodyID.GetIndex()].mIndex;
+			if (index & Tracking::cUnsortedBit)
+			{
+				index &= ~Tracking::cUnsortedBit;
+				if (index < num_old_unsorted && inOldData->mUnsortedEntries[index].mBodyID == n->mBodyID && IsCurrent(inOldData->mUnsortedEntries[index]))
+					replaced_unsorted.push_back(index);
+			}
+			else if (index < num_old_sorted && inOldData->mSortedEntries[index].mBodyID == n->mBodyID && IsCurrent(inOldData->mSortedEntries[index]))
+				replaced_sorted.push_back(index);
+		}
+		QuickSort(replaced_sorted.begin(), replaced_sorted.end());
+		QuickSort(replaced_unsorted.begin(), replaced_unsorted.end());
+
+		sorted.reserve(num_old_sorted + num_old_unsorted + inNumNewEntries);
+		const uint32 *r = replaced_sorted.data(), *r_end = r + replaced_sorted.size();
+		for (uint32 i = 0; i < num_old_sorted; ++i)
+		{
+			const Entry &e = inOldData->mSortedEntries[i];
+			bool replaced = false;
+			for (; r < r_end && *r == i; ++r) // A body can be in inNewEntries multiple times
+				replaced = true;
+			if (!replaced && IsCurrent(e))
+				sorted.push_back(e);
+		}
+		r = replaced_unsorted.data();
+		r_end = r + replaced_unsorted.size();
+		for (uint32 i = 0; i < num_old_unsorted; ++i)
+		{
+			const Entry &e = inOldData->mUnsortedEntries[i];
+			bool replaced = false;
+			for (; r < r_end && *r == i; ++r) // A body can be in inNewEntries multiple times
+				replaced = true;
+			if (!replaced && IsCurrent(e))
+				unsorted.push_back(e);
+		}
+	}
+	unsorted.insert(unsorted.end(), inNewEntries, inNewEntries + inNumNewEntries);
+
+	// Allocate the unsorted list, it grows with the size of the layer so that the amount of rebuilds stays small when bodies are added one by one
+	size_t num_entries = sorted.size() + unsorted.size();
+	uint unsorted_capacity = max(cMinUnsortedEntries, uint(num_entries / cUnsortedEntriesDivisor));
+	data->mUnsortedEntries.resize(unsorted_capacity);
+	if (num_entries == 0)
+		return data;
+
+	// Determine the spread of the bodies along each axis
+	Vec3 sum = Vec3::sZero(), sum_sq = Vec3::sZero();
+	for (const Array<Entry> *entries : { &sorted, &unsorted })
+		for (const Entry &e : *entries)
+		{
+			Vec3 center = e.mBounds.GetCenter();
+			sum += center;
+			sum_sq += center * center;
+		}
+	Vec3 mean = sum / float(num_entries);
+	Vec3 variance = sum_sq / float(num_entries) - mean * mean;
+
+	// Sort along the axis with the largest spread, only switch axis when the new axis is significantly better
+	uint best_axis = (uint)variance.GetHighestComponentIndex();
+	bool keep_axis = inOldData != nullptr && cAxisSwitchFactor * variance[inOldData->mAxis] >= variance[best_axis];
+	uint axis = keep_axis? inOldData->mAxis : best_axis;
+	data->mAxis = axis;
+
+	// Update the sort keys
+	for (Entry &e : sorted)
+		e.mSortKey = e.mBounds.mMin[axis];
+	for (Entry &e : unsorted)
+		e.mSortKey = e.mBounds.mMin[axis];
+
+	// Ordering of entries, ties are broken by body ID to make the order deterministic
+	auto compare = [](const Entry &inLHS, const Entry &inRHS) { return inLHS.mSortKey < inRHS.mSortKey || (inLHS.mSortKey == inRHS.mSortKey && inLHS.mBodyID < inRHS.mBodyID); };
+
+	if (keep_axis)
+	{
+		// Bodies will only have moved a little bit since the last time we sorted, so insertion sort is very efficient
+		InsertionSort(sorted.begin(), sorted.end(), compare);
+
+		// Merge in the entries that were not sorted yet
+		if (!unsorted.empty())
+		{
+			QuickSort(unsorted.begin(), unsorted.end(), compare);
+			Array<Entry> merged;
+			merged.resize(num_entries);
+			std::merge(sorted.begin(), sorted.end(), unsorted.begin(), unsorted.end(), merged.begin(), compare);
+			sorted.swap(merged);
+		}
+	}
+	else
+	{
+		// Order will be completely different, do a full sort
+		sorted.insert(sorted.end(), unsorted.begin(), unsorted.end());
+		QuickSort(sorted.begin(), sorted.end(), compare);
+	}
+
+	// Move big bodies to the unsorted list so they don't need to be taken into account in mMaxExtent
+	float total_size = 0.0f;
+	for (const Entry &e : sorted)
+		total_size += e.mBounds.mMax[axis] - e.mBounds.mMin[axis];
+	float big_size = cBigBodyFactor * total_size / float(num_entries);
+	uint num_big = 0;
+	Array<Entry>::iterator out = sorted.begin();
+	for (const Entry &e : sorted)
+		if (num_big < unsorted_capacity / 2 && e.mBounds.mMax[axis] - e.mBounds.mMin[axis] > big_size)
+			data->mUnsortedEntries[num_big++] = e;
+		else
+			*out++ = e;
+	sorted.erase(out, sorted.end());
+	data->mNumUnsortedEntries.store(num_big, memory_order_relaxed);
+
+	// Determine how far the bounds of the sorted entries extend beyond their sort key
+	float max_extent = 0.0f;
+	for (const Entry &e : sorted)
+		max_extent = max(max_extent, e.mBounds.mMax[axis] - e.mSortKey);
+	data->mMaxExtent.store(max_extent, memory_order_relaxed);
+
+	return data;
+}
+
+void BroadPhaseSAP::SwapLayerData(Layer &ioLayer, LayerData *inNewData)
+{
+	// Update tracking information, this also makes new entries valid
+	for (uint32 i = 0, n = (uint32)inNewData->mSortedEntries.size(); i < n; ++i)
+	{
+		const Entry &e = inNewData->mSortedEntries[i];
+		Tracking &t = mTracking[e.mBodyID.GetIndex()];
+		t.mIndex = i;
+		t.mVersion.store(e.mVersion, memory_order_relaxed);
+	}
+	for (uint32 i = 0, n = inNewData->mNumUnsortedEntries.load(memory_order_relaxed); i < n; ++i)
+	{
+		const Entry &e = inNewData->mUnsortedEntries[i];
+		Tracking &t = mTracking[e.mBodyID.GetIndex()];
+		t.mIndex = i | Tracking::cUnsortedBit;
+		t.mVersion.store(e.mVersion, memory_order_relaxed);
+	}
+
+	// Make the new data visible to queries
+	LayerData *old_data = ioLayer.mData.exchange(inNewData, memory_order_release);
+	ioLayer.mIsDirty.store(false, memory_order_relaxed);
+
+	// Queries may still be using the old data, so we free it in FrameSync
+	if (old_data != nullptr)
+		mRetiredData.push_back(old_data);
+}
+
+void BroadPhaseSAP::AddToLayers(const BodyID *inBodies, int inNumber)
+{
+	const BodyVector &bodies = mBodyManager->GetBodies();
+
+	const BodyID *b_start = inBodies, *b_end = inBodies + inNumber;
+	while (b_start < b_end)
+	{
+		// Get broadphase layer
+		BroadPhaseLayer::Type broadphase_layer = (BroadPhaseLayer::Type)bodies[b_start->GetIndex()]->GetBroadPhaseLayer();
+		JPH_ASSERT(broadphase_layer < mNumLayers);
+
+		// Find first body with different layer
+		const BodyID *b_mid = b_start + 1;
+		while (b_mid < b_end && (BroadPhaseLayer::Type)bodies[b_mid->GetIndex()]->GetBroadPhaseLayer() == broadphase_layer)
+			++b_mid;
+		uint num_bodies = uint(b_mid - b_start);
+
+		// Update tracking information
+		for (const BodyID *b = b_start; b < b_mid; ++b)
+		{
+			const Body &body = *bodies[b->GetIndex()];
+			JPH_ASSERT(body.GetID() == *b, "Provided BodyID doesn't match BodyID in body manager");
+			Tracking &t = mTracking[b->GetIndex()];
+			t.mBroadPhaseLayer = broadphase_layer;
+			t.mObjectLayer = body.GetObjectLayer();
+		}
+
+		Layer &layer = mLayers[broadphase_layer];
+		LayerData *data = layer.mData.load(memory_order_relaxed);
+		uint32 num_unsorted = data != nullptr? data->mNumUnsortedEntries.load(memory_order_relaxed) : 0;
+		if (data != nullptr && num_unsorted + num_bodies <= data->mUnsortedEntries.size())
+		{
+			// Append the bodies to the unsorted list
+			for (const BodyID *b = b_start; b < b_mid; ++b)
+				CreateEntry(*bodies[b->GetIndex()], data->mUnsortedEntries[num_unsorted++]);
+
+			// Make the entries visible to queries, queries only read up to mNumUnsortedEntries so the entries are fully written at this point
+			data->mNumUnsortedEntries.store(num_unsorted, memory_order_release);
+
+			// Make the new entries valid, this invalidates old entries of the same bodies
+			for (uint32 i = num_unsorted - num_bodies; i < num_unsorted; ++i)
+			{
+				const Entry &e = data->mUnsortedEntries[i];
+				Tracking &t = mTracking[e.mBodyID.GetIndex()];
+				t.mIndex = i | Tracking::cUnsortedBit;
+				t.mVersion.store(e.mVersion, memory_order_release);
+			}
+
+			// The layer needs to be sorted during the next update
+			layer.mIsDirty.store(true, memory_order_relaxed);
+		}
+		else
+		{
+			// Unsorted list is full, rebuild the layer
+			Array<Entry> new_entries;
+			new_entries.resize(num_bodies);
+			for (uint i = 0; i < num_bodies; ++i)
+				CreateEntry(*bodies[b_start[i].GetIndex()], new_entries[i]);
+			SwapLayerData(layer, BuildLayer(data, new_entries.data(), num_bodies));
+		}
+
+		// Repeat
+		b_start = b_mid;
+	}
+}
+
+void BroadPhaseSAP::Optimize()
+{
+	JPH_PROFILE_FUNCTION();
+
+	LockModifications();
+
+	for (BroadPhaseLayer::Type l = 0; l < mNumLayers; ++l)
+	{
+		Layer &layer = mLayers[l];
+		LayerData *data = layer.mData.load(memory_order_relaxed);
+		if (data != nullptr)
+			SwapLayerData(layer, BuildLayer(data, nullptr, 0));
+	}
+
+	UnlockModifications();
+
+	// Free the layer data that we just replaced and any data that was replaced while adding bodies
+	FrameSync();
+}
+
+void BroadPhaseSAP::FrameSync()
+{
+	JPH_PROFILE_FUNCTION();
+
+	// Take the layer data that has been replaced since the last sync and make queries from now on use the other lock
+	Array<LayerData *> retired_data;
+	{
+		UniqueLock lock(mUpdateMutex JPH_IF_ENABLE_ASSERTS(, mLockContext, EPhysicsLockTypes::BroadPhaseUpdate));
+		retired_data.swap(mRetiredData);
+		mQueryLockIdx = mQueryLockIdx ^ 1;
+	}
+
+	if (!retired_data.empty())
+	{
+		// Take a unique lock on the old query lock so that we know no one is using the old data anymore.
+		// Note that nothing should be locked at this point to avoid risking a lock inversion deadlock (see BroadPhaseQuadTree::FrameSync).
+		UniqueLock root_lock(mQueryLocks[mQueryLockIdx ^ 1] JPH_IF_ENABLE_ASSERTS(, mLockContext, EPhysicsLockTypes::BroadPhaseQuery));
+
+		for (LayerData *data : retired_data)
+			delete data;
+	}
+}
+
+size_t BroadPhaseSAP::GetRetiredDataSize() const
+{
+	size_t size = 0;
+	for (const LayerData *data : mRetiredData)
+		size += sizeof(LayerData) + (data->mSortedEntries.capacity() + data->mUnsortedEntries.capacity()) * sizeof(Entry);
+	return size;
+}
+
+void BroadPhaseSAP::LockModifications()
+{
+	// From this point on we prevent modifications to the layers
+	PhysicsLock::sLock(mUpdateMutex JPH_IF_ENABLE_ASSERTS(, mLockContext, EPhysicsLockTypes::BroadPhaseUpdate));
+}
+
+BroadPhase::UpdateState BroadPhaseSAP::UpdatePrepare()
+{
+	JPH_PROFILE_FUNCTION();
+
+	// LockModifications should have been called
+	JPH_ASSERT(mUpdateMutex.is_locked());
+
+	// Build new versions of all layers that have changed, this does not modify the current data so can run in parallel with FindCollidingPairs
+	bool any_updated = false;
+	for (BroadPhaseLayer::Type l = 0; l < mNumLayers; ++l)
+	{
+		Layer &layer = mLayers[l];
+		JPH_ASSERT(layer.mNextData == nullptr);
+		if (layer.mIsDirty.load(memory_order_relaxed))
+		{
+			layer.mNextData = BuildLayer(layer.mData.load(memory_order_relaxed), nullptr, 0);
+			any_updated = true;
+		}
+	}
+
+	UpdateState update_state;
+	update_state.mData[0] = any_updated? this : nullptr;
+	return update_state;
+}
+
+void BroadPhaseSAP::UpdateFinalize(const UpdateState &inUpdateState)
+{
+	JPH_PROFILE_FUNCTION();
+
+	// LockModifications should have been called
+	JPH_ASSERT(mUpdateMutex.is_locked());
+
+	// Test if a layer was updated
+	if (inUpdateState.mData[0] == nullptr)
+		return;
+
+	for (BroadPhaseLayer::Type l = 0; l < mNumLayers; ++l)
+	{
+		Layer &layer = mLayers[l];
+		if (layer.mNextData != nullptr)
+		{
+			SwapLayerData(layer, layer.mNextData);
+			layer.mNextData = nullptr;
+		}
+	}
+}
+
+void BroadPhaseSAP::UnlockModifications()
+{
+	// From this point on we allow modifications to the layers again
+	PhysicsLock::sUnlock(mUpdateMutex JPH_IF_ENABLE_ASSERTS(, mLockContext, EPhysicsLockTypes::BroadPhaseUpdate));
+}
+
+BroadPhase::AddState BroadPhaseSAP::AddBodiesPrepare(BodyID *ioBodies, int inNumber)
+{
+	// Group the bodies per layer so that AddBodiesFinalize can add them in one go
+	SortOnBroadPhaseLayer(ioBodies, inNumber);
+	return nullptr;
+}
+
+void BroadPhaseSAP::AddBodiesFinalize(BodyID *ioBodies, int inNumber, AddState inAddState)
+{
+	JPH_PROFILE_FUNCTION();
+
+	if (inNumber <= 0)
+		return;
+
+	// This cannot run concurrently with UpdatePrepare()/UpdateFinalize()
+	UniqueLock lock(mUpdateMutex JPH_IF_ENABLE_ASSERTS(, mLockContext, EPhysicsLockTypes::BroadPhaseUpdate));
+
+	AddToLayers(ioBodies, inNumber);
+
+	// Mark added to broadphase
+	BodyVector &bodies = mBodyManager->GetBodies();
+	for (const BodyID *b = ioBodies, *b_end = ioBodies + inNumber; b < b_end; ++b)
+	{
+		Body &body = *bodies[b->GetIndex()];
+		JPH_ASSERT(!body.IsInBroadPhase());
+		body.SetInBroadPhaseInternal(true);
+	}
+}
+
+void BroadPhaseSAP::RemoveBodies(BodyID *ioBodies, int inNumber)
+{
+	JPH_PROFILE_FUNCTION();
+
+	// This cannot run concurrently with UpdatePrepare()/UpdateFinalize()
+	UniqueLock lock(mUpdateMutex JPH_IF_ENABLE_ASSERTS(, mLockContext, EPhysicsLockTypes::BroadPhaseUpdate));
+
+	BodyVector &bodies = mBodyManager->GetBodies();
+
+	for (const BodyID *b = ioBodies, *b_end = ioBodies + inNumber; b < b_end; ++b)
+	{
+		uint32 index = b->GetIndex();
+		Body &body = *bodies[index];
+		JPH_ASSERT(body.GetID() == *b, "Provided BodyID doesn't match BodyID in body manager");
+		JPH_ASSERT(body.IsInBroadPhase());
+
+		// Invalidate the entry, it will be removed from the layer during the next update
+		Tracking &t = mTracking[index];
+		JPH_ASSERT(t.mBroadPhaseLayer < mNumLayers);
+		t.mVersion.fetch_add(1, memory_order_release);
+		mLayers[t.mBroadPhaseLayer].mIsDirty.store(true, memory_order_relaxed);
+
+		// Reset bookkeeping
+		t.mBroadPhaseLayer = (BroadPhaseLayer::Type)cBroadPhaseLayerInvalid;
+		t.mObjectLayer = cObjectLayerInvalid;
+
+		// Mark removed from broadphase
+		body.SetInBroadPhaseInternal(false);
+	}
+}
+
+void BroadPhaseSAP::NotifyBodiesAABBChanged(BodyID *ioBodies, int inNumber, bool inTakeLock)
+{
+	JPH_PROFILE_FUNCTION();
+
+	const BodyVector &bodies = mBodyManager->GetBodies();
+
+	if (inTakeLock)
+	{
+		// Queries can be running, so we cannot modify existing entries. Add new entries instead.
+		UniqueLock lock(mUpdateMutex JPH_IF_ENABLE_ASSERTS(, mLockContext, EPhysicsLockTypes::BroadPhaseUpdate));
+
+		SortOnBroadPhaseLayer(ioBodies, inNumber);
+		AddToLayers(ioBodies, inNumber);
+	}
+	else
+	{
+		// We're inside the physics update, no queries can run at the same time as this so we can update the bounds in place.
+		// Note that this function can be called from multiple threads at the same time, but always for different bodies.
+		JPH_ASSERT(mUpdateMutex.is_locked());
+
+		for (const BodyID *b = ioBodies, *b_end = ioBodies + inNumber; b < b_end; ++b)
+		{
+			const Body &body = *bodies[b->GetIndex()];
+			JPH_ASSERT(body.IsInBroadPhase());
+			const Tracking &t = mTracking[b->GetIndex()];
+			Layer &layer = mLayers[t.mBroadPhaseLayer];
+			LayerData *data = layer.mData.load(memory_order_relaxed);
+			const AABox &bounds = body.GetWorldSpaceBounds();
+			if (t.mIndex & Tracking::cUnsortedBit)
+			{
+				// Unsorted entries have no constraints on their bounds
+				data->mUnsortedEntries[t.mIndex & ~Tracking::cUnsortedBit].mBounds = bounds;
+			}
+			else
+			{
+				// Entry is no longer sorted correctly, widen the search range of queries to compensate
+				Entry &e = data->mSortedEntries[t.mIndex];
+				e.mBounds = bounds;
+				AtomicMax(data->mMaxKeyDecrease, e.mSortKey - bounds.mMin[data->mAxis], memory_order_relaxed);
+				AtomicMax(data->mMaxExtent, bounds.mMax[data->mAxis] - e.mSortKey, memory_order_relaxed);
+			}
+
+			// The layer needs to be sorted during the next update
+			if (!layer.mIsDirty.load(memory_order_relaxed))
+				layer.mIsDirty.store(true, memory_order_relaxed);
+		}
+	}
+}
+
+void BroadPhaseSAP::NotifyBodiesLayerChanged(BodyID *ioBodies, int inNumber)
+{
+	JPH_PROFILE_FUNCTION();
+
+	// This cannot run concurrently with UpdatePrepare()/UpdateFinalize()
+	UniqueLock lock(mUpdateMutex JPH_IF_ENABLE_ASSERTS(, mLockContext, EPhysicsLockTypes::BroadPhaseUpdate));
+
+	// The old layers will contain invalid entries after this operation
+	for (const BodyID *b = ioBodies, *b_end = ioBodies + inNumber; b < b_end; ++b)
+	{
+		BroadPhaseLayer::Type broadphase_layer = mTracking[b->GetIndex()].mBroadPhaseLayer;
+		JPH_ASSERT(broadphase_layer < mNumLayers);
+		mLayers[broadphase_layer].mIsDirty.store(true, memory_order_relaxed);
+	}
+
+	// Changing layer is equivalent to adding a new entry to the new layer, which invalidates the old entry
+	SortOnBroadPhaseLayer(ioBodies, inNumber);
+	AddToLayers(ioBodies, inNumber);
+}
+
+template <class Visitor>
+void BroadPhaseSAP::WalkLayer(const LayerData &inData, Vec3Arg inMin, Vec3Arg inMax, Visitor &ioVisitor) const
+{
+	// Determine the range of sort keys that can overlap with the box
+	uint axis = inData.mAxis;
+	float first_key = inMin[axis] - inData.mMaxExtent.load(memory_order_relaxed);
+	float last_key = inMax[axis] + inData.mMaxKeyDecrease.load(memory_order_relaxed);
+
+	// Visit sorted entries
+	const Entry *e = std::lower_bound(inData.mSortedEntries.begin(), inData.mSortedEntries.end(), first_key, [](const Entry &inEntry, float inKey) { return inEntry.mSortKey < inKey; });
+	for (const Entry *e_end = inData.mSortedEntries.end(); e < e_end && e->mSortKey <= last_key; ++e)
+		if (!ioVisitor(*e))
+			return;
+
+	// Visit unsorted entries
+	for (const Entry *u = inData.mUnsortedEntries.data(), *u_end = u + inData.mNumUnsortedEntries.load(memory_order_acquire); u < u_end; ++u)
+		if (!ioVisitor(*u))
+			return;
+}
+
+template <class Collector, class Visitor>
+void BroadPhaseSAP::WalkLayers(Vec3Arg inMin, Vec3Arg inMax, const BroadPhaseLayerFilter &inBroadPhaseLayerFilter, const Collector &inCollector, Visitor &ioVisitor) const
+{
+	// Loop over all layers and test the ones that could hit
+	for (BroadPhaseLayer::Type l = 0; l < mNumLayers; ++l)
+	{
+		const LayerData *data = mLayers[l].mData.load(memory_order_acquire);
+		if (data != nullptr && inBroadPhaseLayerFilter.ShouldCollide(BroadPhaseLayer(l)))
+		{
+			WalkLayer(*data, inMin, inMax, ioVisitor);
+			if (inCollector.ShouldEarlyOut())
+				break;
+		}
+	}
+}
+
+void BroadPhaseSAP::CastRay(const RayCast &inRay, RayCastBodyCollector &ioCollector, const BroadPhaseLayerFilter &inBroadPhaseLayerFilter, const ObjectLayerFilter &inObjectLayerFilter) const
+{
+	JPH_PROFILE_FUNCTION();
+
+	// Prevent this from running in parallel with deleting old layer data in FrameSync()
+	shared_lock lock(mQueryLocks[mQueryLockIdx]);
+
+	// Load ray
+	Vec3 origin(inRay.mOrigin);
+	Vec3 end = origin + inRay.mDirection;
+	RayInvDirection inv_direction(inRay.mDirection);
+
+	auto visitor = [this, origin, &inv_direction, &ioCollector, &inObjectLayerFilter](const Entry &inEntry)
+	{
+		// Test intersection with ray
+		float fraction = RayAABox(origin, inv_direction, inEntry.mBounds.mMin, inEntry.mBounds.mMax);
+		if (fraction < ioCollector.GetEarlyOutFraction()
+			&& inObjectLayerFilter.ShouldCollide(inEntry.mObjectLayer)
+			&& IsCurrent(inEntry))
+		{
+			// Store hit
+			BroadPhaseCastResult result { inEntry.mBodyID, fraction };
+			ioCollector.AddHit(result);
+			return !ioCollector.ShouldEarlyOut();
+		}
+		return true;
+	};
+	WalkLayers(Vec3::sMin(origin, end), Vec3::sMax(origin, end), inBroadPhaseLayerFilter, ioCollector, visitor);
+}
+
+void BroadPhaseSAP::CollideAABox(const AABox &inBox, CollideShapeBodyCollector &ioCollector, const BroadPhaseLayerFilter &inBroadPhaseLayerFilter, const ObjectLayerFilter &inObjectLayerFilter) const
+{
+	JPH_PROFILE_FUNCTION();
+
+	// Prevent this from running in parallel with deleting old layer data in FrameSync()
+	shared_lock lock(mQueryLocks[mQueryLockIdx]);
+
+	auto visitor = [this, &inBox, &ioCollector, &inObjectLayerFilter](const Entry &inEntry)
+	{
+		// Test intersection with box
+		if (inEntry.mBounds.Overlaps(inBox)
+			&& inObjectLayerFilter.ShouldCollide(inEntry.mObjectLayer)
+			&& IsCurrent(inEntry))
+		{
+			// Store hit
+			ioCollector.AddHit(inEntry.mBodyID);
+			return !ioCollector.ShouldEarlyOut();
+		}
+		return true;
+	};
+	WalkLayers(inBox.mMin, inBox.mMax, inBroadPhaseLayerFilter, ioCollector, visitor);
+}
+
+void BroadPhaseSAP::CollideSphere(Vec3Arg inCenter, float inRadius, CollideShapeBodyCollector &ioCollector, const BroadPhaseLayerFilter &inBroadPhaseLayerFilter, const ObjectLayerFilter &inObjectLayerFilter) const
+{
+	JPH_PROFILE_FUNCTION();
+
+	// Prevent this from running in parallel with deleting old layer data in FrameSync()
+	shared_lock lock(mQueryLocks[mQueryLockIdx]);
+
+	float radius_sq = Square(inRadius);
+
+	auto visitor = [this, inCenter, radius_sq, &ioCollector, &inObjectLayerFilter](const Entry &inEntry)
+	{
+		// Test intersection with sphere
+		if (inEntry.mBounds.GetSqDistanceTo(inCenter) <= radius_sq
+			&& inObjectLayerFilter.ShouldCollide(inEntry.mObjectLayer)
+			&& IsCurrent(inEntry))
+		{
+			// Store hit
+			ioCollector.AddHit(inEntry.mBodyID);
+			return !ioCollector.ShouldEarlyOut();
+		}
+		return true;
+	};
+	Vec3 radius = Vec3::sReplicate(inRadius);
+	WalkLayers(inCenter - radius, inCenter + radius, inBroadPhaseLayerFilter, ioCollector, visitor);
+}
+
+void BroadPhaseSAP::CollidePoint(Vec3Arg inPoint, CollideShapeBodyCollector &ioCollector, const BroadPhaseLayerFilter &inBroadPhaseLayerFilter, const ObjectLayerFilter &inObjectLayerFilter) const
+{
+	JPH_PROFILE_FUNCTION();
+
+	// Prevent this from running in parallel with deleting old layer data in FrameSync()
+	shared_lock lock(mQueryLocks[mQueryLockIdx]);
+
+	auto visitor = [this, inPoint, &ioCollector, &inObjectLayerFilter](const Entry &inEntry)
+	{
+		// Test if point is inside box
+		if (inEntry.mBounds.Contains(inPoint)
+			&& inObjectLayerFilter.ShouldCollide(inEntry.mObjectLayer)
+			&& IsCurrent(inEntry))
+		{
+			// Store hit
+			ioCollector.AddHit(inEntry.mBodyID);
+			return !ioCollector.ShouldEarlyOut();
+		}
+		return true;
+	};
+	WalkLayers(inPoint, inPoint, inBroadPhaseLayerFilter, ioCollector, visitor);
+}
+
+void BroadPhaseSAP::CollideOrientedBox(const OrientedBox &inBox, CollideShapeBodyCollector &ioCollector, const BroadPhaseLayerFilter &inBroadPhaseLayerFilter, const ObjectLayerFilter &inObjectLayerFilter) const
+{
+	JPH_PROFILE_FUNCTION();
+
+	// Prevent this from running in parallel with deleting old layer data in FrameSync()
+	shared_lock lock(mQueryLocks[mQueryLockIdx]);
+
+	auto visitor = [this, &inBox, &ioCollector, &inObjectLayerFilter](const Entry &inEntry)
+	{
+		// Test intersection with oriented box
+		if (inBox.Overlaps(inEntry.mBounds)
+			&& inObjectLayerFilter.ShouldCollide(inEntry.mObjectLayer)
+			&& IsCurrent(inEntry))
+		{
+			// Store hit
+			ioCollector.AddHit(inEntry.mBodyID);
+			return !ioCollector.ShouldEarlyOut();
+		}
+		return true;
+	};
+	AABox bounds = AABox(-inBox.mHalfExtents, inBox.mHalfExtents).Transformed(inBox.mOrientation);
+	WalkLayers(bounds.mMin, bounds.mMax, inBroadPhaseLayerFilter, ioCollector, visitor);
+}
+
+void BroadPhaseSAP::CastAABoxNoLock(const AABoxCast &inBox, CastShapeBodyCollector &ioCollector, const BroadPhaseLayerFilter &inBroadPhaseLayerFilter, const ObjectLayerFilter &inObjectLayerFilter) const
+{
+	JPH_PROFILE_FUNCTION();
+
+	// Load box
+	Vec3 origin(inBox.mBox.GetCenter());
+	Vec3 extent(inBox.mBox.GetExtent());
+	RayInvDirection inv_direction(inBox.mDirection);
+
+	auto visitor = [this, origin, extent, &inv_direction, &ioCollector, &inObjectLayerFilter](const Entry &inEntry)
+	{
+		// Test intersection with the swept box
+		float fraction = RayAABox(origin, inv_direction, inEntry.mBounds.mMin - extent, inEntry.mBounds.mMax + extent);
+		if (fraction < ioCollector.GetPositiveEarlyOutFraction()
+			&& inObjectLayerFilter.ShouldCollide(inEntry.mObjectLayer)
+			&& IsCurrent(inEntry))
+		{
+			// Store hit
+			BroadPhaseCastResult result { inEntry.mBodyID, fraction };
+			ioCollector.AddHit(result);
+			return !ioCollector.ShouldEarlyOut();
+		}
+		return true;
+	};
+	Vec3 zero = Vec3::sZero();
+	WalkLayers(inBox.mBox.mMin + Vec3::sMin(inBox.mDirection, zero), inBox.mBox.mMax + Vec3::sMax(inBox.mDirection, zero), inBroadPhaseLayerFilter, ioCollector, visitor);
+}
+
+void BroadPhaseSAP::CastAABox(const AABoxCast &inBox, CastShapeBodyCollector &ioCollector, const BroadPhaseLayerFilter &inBroadPhaseLayerFilter, const ObjectLayerFilter &inObjectLayerFilter) const
+{
+	// Prevent this from running in parallel with deleting old layer data in FrameSync()
+	shared_lock lock(mQueryLocks[mQueryLockIdx]);
+
+	CastAABoxNoLock(inBox, ioCollector, inBroadPhaseLayerFilter, inObjectLayerFilter);
+}
+
+void BroadPhaseSAP::FindCollidingPairs(BodyID *ioActiveBodies, int inNumActiveBodies, float inSpeculativeContactDistance, const ObjectVsBroadPhaseLayerFilter &inObjectVsBroadPhaseLayerFilter, const ObjectLayerPairFilter &inObjectLayerPairFilter, BodyPairCollector &ioPairCollector) const
+{
+	JPH_PROFILE_FUNCTION();
+
+	const BodyVector &bodies = mBodyManager->GetBodies();
+
+	// Note that we don't take any locks at this point. We know that the layer data is not going to be swapped or deleted while finding collision pairs due to the way the jobs are scheduled in the PhysicsSystem::Update.
+
+	// Sort bodies on layer
+	const Tracking *tracking = mTracking.data(); // C pointer or else sort is incredibly slow in debug mode
+	QuickSort(ioActiveBodies, ioActiveBodies + inNumActiveBodies, [tracking](BodyID inLHS, BodyID inRHS) { return tracking[inLHS.GetIndex()].mObjectLayer < tracking[inRHS.GetIndex()].mObjectLayer; });
+
+	BodyID *b_start = ioActiveBodies, *b_end = ioActiveBodies + inNumActiveBodies;
+	while (b_start < b_end)
+	{
+		// Get object layer
+		ObjectLayer object_layer = tracking[b_start->GetIndex()].mObjectLayer;
+		JPH_ASSERT(object_layer != cObjectLayerInvalid);
+
+		// Find first body with different layer
+		BodyID *b_mid = std::upper_bound(b_start, b_end, object_layer, [tracking](ObjectLayer inLayer, BodyID inBodyID) { return inLayer < tracking[inBodyID.GetIndex()].mObjectLayer; });
+
+		// Loop over all layers and test the ones that could hit
+		for (BroadPhaseLayer::Type l = 0; l < mNumLayers; ++l)
+		{
+			const LayerData *data = mLayers[l].mData.load(memory_order_relaxed);
+			if (data != nullptr && inObjectVsBroadPhaseLayerFilter.ShouldCollide(object_layer, BroadPhaseLayer(l)))
+			{
+				for (const BodyID *b1 = b_start; b1 < b_mid; ++b1)
+				{
+					const Body &body1 = *bodies[b1->GetIndex()];
+
+					// Expand the bounding box by the speculative contact distance
+					AABox bounds1 = body1.GetWorldSpaceBounds();
+					bounds1.ExpandBy(Vec3::sReplicate(inSpeculativeContactDistance));
+
+					auto visitor = [this, &bodies, &body1, &bounds1, object_layer, &inObjectLayerPairFilter, &ioPairCollector](const Entry &inEntry)
+					{
+						if (inEntry.mBounds.Overlaps(bounds1)
+							&& inObjectLayerPairFilter.ShouldCollide(object_layer, inEntry.mObjectLayer)
+							&& IsCurrent(inEntry))
+						{
+							// Check if bodies can collide
+							const Body &body2 = *bodies[inEntry.mBodyID.GetIndex()];
+							if (Body::sFindCollidingPairsCanCollide(body1, body2))
+							{
+								// Store overlapping pair
+								ioPairCollector.AddHit({ body1.GetID(), inEntry.mBodyID });
+							}
+						}
+						return true;
+					};
+					WalkLayer(*data, bounds1.mMin, bounds1.mMax, visitor);
+				}
+			}
+		}
+
+		// Repeat
+		b_start = b_mid;
+	}
+}
+
+AABox BroadPhaseSAP::GetBounds() const
+{
+	// Prevent this from running in parallel with deleting old layer data in FrameSync()
+	shared_lock lock(mQueryLocks[mQueryLockIdx]);
+
+	AABox bounds;
+	for (BroadPhaseLayer::Type l = 0; l < mNumLayers; ++l)
+	{
+		const LayerData *data = mLayers[l].mData.load(memory_order_acquire);
+		if (data != nullptr)
+		{
+			for (const Entry &e : data->mSortedEntries)
+				if (IsCurrent(e))
+					bounds.Encapsulate(e.mBounds);
+			for (const Entry *e = data->mUnsortedEntries.data(), *e_end = e + data->mNumUnsortedEntries.load(memory_order_acquire); e < e_end; ++e)
+				if (IsCurrent(*e))
+					bounds.Encapsulate(e->mBounds);
+		}
+	}
+	return bounds;
+}
+
+JPH_NAMESPACE_END
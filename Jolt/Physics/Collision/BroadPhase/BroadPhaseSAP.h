@@ -0,0 +1,179 @@
+// Jolt Physics Library (https://github.com/jrouwe/JoltPhysics)
+// SPDX-FileCopyrightText: 2024 Jorrit Rouwe
+// SPDX-License-Identifier: MIT
+
+#pragma once
+
+#include <Jolt/Physics/Collision/BroadPhase/BroadPhase.h>
+#include <Jolt/Physics/PhysicsLock.h>
+#include <Jolt/Geometry/AABox.h>
+#include <Jolt/Core/Atomics.h>
+
+JPH_NAMESPACE_BEGIN
+
+/// Sweep and prune broadphase.
+///
+/// For every broadphase layer it keeps an array of bodies sorted by the minimum of their bounding box along the axis in which the bodies are spread out the most
+/// (this axis is re-evaluated every time the layer is rebuilt, so in a mostly planar world the sort axis will be one of the two horizontal axes).
+/// Because bodies move only a little bit every step the array stays almost sorted and can be re-sorted with an insertion sort in (almost) linear time.
+/// This makes it a good fit for worlds that have many moving bodies spread out over a plane, for other scenes BroadPhaseQuadTree is usually faster.
+///
+/// Bodies that are added, removed or moved outside of PhysicsSystem::Update are not inserted in the sorted array directly. They are appended to an unsorted
+/// list that is merged into the sorted array during the next update, this means that queries never need to wait for modifications.
+/// The capacity of the unsorted list grows with the size of the layer, so adding bodies one by one only rebuilds the layer a logarithmic amount of times.
+/// The unsorted list is also used for bodies that are much bigger than the average body (e.g. a floor) as these would otherwise make all queries scan a large part of the sorted array.
+/// Note that while PhysicsSystem::Update is running the bounding boxes of moving bodies are updated in place, so, as with reading bodies, it is not safe to query
+/// this broadphase from other threads while the update is running.
+class JPH_EXPORT BroadPhaseSAP final : public BroadPhase
+{
+public:
+	JPH_OVERRIDE_NEW_DELETE
+
+	/// Destructor
+	virtual					~BroadPhaseSAP() override;
+
+	// The JobSystem overloads of BroadPhase are not overridden, this broadphase does its work on the calling thread
+	using BroadPhase::Optimize;
+	using BroadPhase::AddBodiesPrepare;
+
+	// Implementing interface of BroadPhase (see BroadPhase for documentation)
+	virtual void			Init(BodyManager *inBodyManager, const BroadPhaseLayerInterface &inLayerInterface) override;
+	virtual void			Optimize() override;
+	virtual void			FrameSync() override;
+	virtual void			LockModifications() override;
+	virtual UpdateState		UpdatePrepare() override;
+	virtual void			UpdateFinalize(const UpdateState &inUpdateState) override;
+	virtual void			UnlockModifications() override;
+	virtual AddState		AddBodiesPrepare(BodyID *ioBodies, int inNumber) override;
+	virtual void			AddBodiesFinalize(BodyID *ioBodies, int inNumber, AddState inAddState) override;
+	virtual void			RemoveBodies(BodyID *ioBodies, int inNumber) override;
+	virtual void			NotifyBodiesAABBChanged(BodyID *ioBodies, int inNumber, bool inTakeLock) override;
+	virtual void			NotifyBodiesLayerChanged(BodyID *ioBodies, int inNumber) override;
+	virtual void			CastRay(const RayCast &inRay, RayCastBodyCollector &ioCollector, const BroadPhaseLayerFilter &inBroadPhaseLayerFilter, const ObjectLayerFilter &inObjectLayerFilter) const override;
+	virtual void			CollideAABox(const AABox &inBox, CollideShapeBodyCollector &ioCollector, const BroadPhaseLayerFilter &inBroadPhaseLayerFilter, const ObjectLayerFilter &inObjectLayerFilter) const override;
+	virtual void			CollideSphere(Vec3Arg inCenter, float inRadius, CollideShapeBodyCollector &ioCollector, const BroadPhaseLayerFilter &inBroadPhaseLayerFilter, const ObjectLayerFilter &inObjectLayerFilter) const override;
+	virtual void			CollidePoint(Vec3Arg inPoint, CollideShapeBodyCollector &ioCollector, const BroadPhaseLayerFilter &inBroadPhaseLayerFilter, const ObjectLayerFilter &inObjectLayerFilter) const override;
+	virtual void			CollideOrientedBox(const OrientedBox &inBox, CollideShapeBodyCollector &ioCollector, const BroadPhaseLayerFilter &inBroadPhaseLayerFilter, const ObjectLayerFilter &inObjectLayerFilter) const override;
+	virtual void			CastAABoxNoLock(const AABoxCast &inBox, CastShapeBodyCollector &ioCollector, const BroadPhaseLayerFilter &inBroadPhaseLayerFilter, const ObjectLayerFilter &inObjectLayerFilter) const override;
+	virtual void			CastAABox(const AABoxCast &inBox, CastShapeBodyCollector &ioCollector, const BroadPhaseLayerFilter &inBroadPhaseLayerFilter, const ObjectLayerFilter &inObjectLayerFilter) const override;
+	virtual void			FindCollidingPairs(BodyID *ioActiveBodies, int inNumActiveBodies, float inSpeculativeContactDistance, const ObjectVsBroadPhaseLayerFilter &inObjectVsBroadPhaseLayerFilter, const ObjectLayerPairFilter &inObjectLayerPairFilter, BodyPairCollector &ioPairCollector) const override;
+	virtual AABox			GetBounds() const override;
+
+	/// Get the amount of memory (in bytes) used by layer data that has been replaced but that is kept alive until the next FrameSync() / Optimize() because queries may still be using it.
+	/// Should not be called while bodies are being added, removed or moved.
+	size_t					GetRetiredDataSize() const;
+
+	/// Min amount of bodies that can be in the unsorted list of a layer, when more bodies are added the layer is rebuilt
+	static constexpr uint	cMinUnsortedEntries = 256;
+
+	/// The unsorted list of a layer can hold 1 / cUnsortedEntriesDivisor times the amount of bodies in the layer (but at least cMinUnsortedEntries)
+	static constexpr uint	cUnsortedEntriesDivisor = 2;
+
+	/// A body is considered big when its size along the sort axis is more than this factor times the average size, big bodies are stored in the unsorted list
+	static constexpr float	cBigBodyFactor = 16.0f;
+
+	/// The sort axis is only changed when the spread along the new axis is this factor bigger than along the current axis (to avoid switching back and forth)
+	static constexpr float	cAxisSwitchFactor = 1.5f;
+
+private:
+	/// A body in one of the layers
+	struct Entry
+	{
+		AABox				mBounds;										///< World space bounds of the body
+		float				mSortKey;										///< Minimum of mBounds along the sort axis at the time the layer was sorted
+		BodyID				mBodyID;										///< Body that this entry belongs to
+		uint32				mVersion;										///< Entry is only valid if this matches Tracking::mVersion
+		ObjectLayer			mObjectLayer;									///< Object layer of the body
+	};
+
+	/// Snapshot of a layer, entries are only appended to this while queries are using it (except for the bounds of moving bodies during PhysicsSystem::Update)
+	struct LayerData
+	{
+		JPH_OVERRIDE_NEW_DELETE
+
+		Array<Entry>		mSortedEntries;									///< Entries sorted on mSortKey
+		uint				mAxis = 0;										///< Axis along which mSortedEntries is sorted
+		atomic<float>		mMaxKeyDecrease { 0.0f };						///< How much the minimum of a sorted entry has moved below its sort key since sorting
+		atomic<float>		mMaxExtent { 0.0f };							///< Max distance between the maximum of the bounds of a sorted entry and its sort key
+		atomic<uint32>		mNumUnsortedEntries { 0 };						///< Number of entries in mUnsortedEntries that are in use
+		Array<Entry>		mUnsortedEntries;								///< Big bodies and bodies that were added after the layer was built, this array is sized when the layer is built and never resized so entries can be appended while queries are running
+	};
+
+	/// A broadphase layer
+	struct Layer
+	{
+		atomic<LayerData *>	mData { nullptr };								///< Current data of the layer, nullptr if the layer has never had bodies
+		LayerData *			mNextData = nullptr;							///< Data built by UpdatePrepare that will become active in UpdateFinalize
+		atomic<bool>		mIsDirty { false };								///< If the layer needs to be rebuilt
+	};
+
+	/// Bookkeeping per body
+	struct Tracking
+	{
+		/// Constructor to satisfy the vector class
+							Tracking() = default;
+							Tracking(const Tracking &inRHS) : mVersion(inRHS.mVersion.load()), mIndex(inRHS.mIndex), mBroadPhaseLayer(inRHS.mBroadPhaseLayer), mObjectLayer(inRHS.mObjectLayer) { }
+
+		/// Bit that is set in mIndex when the body is in the unsorted list
+		static constexpr uint32 cUnsortedBit = 0x80000000;
+
+		atomic<uint32>		mVersion { 0 };									///< Version of the entry that currently represents this body
+		uint32				mIndex = 0;										///< Index of the entry in LayerData::mSortedEntries or LayerData::mUnsortedEntries (when cUnsortedBit is set)
+		BroadPhaseLayer::Type mBroadPhaseLayer = (BroadPhaseLayer::Type)cBroadPhaseLayerInvalid; ///< Layer that the body is in
+		ObjectLayer			mObjectLayer = cObjectLayerInvalid;				///< Object layer of the body
+	};
+
+	/// Check if an entry still represents its body
+	inline bool				IsCurrent(const Entry &inEntry) const			{ return mTracking[inEntry.mBodyID.GetIndex()].mVersion.load(memory_order_relaxed) == inEntry.mVersion; }
+
+	/// Create a new entry for a body, the entry becomes valid when Tracking::mVersion is updated to the version of the entry
+	void					CreateEntry(const Body &inBody, Entry &outEntry) const;
+
+	/// Add new entries for bodies to the layers that they belong to, this invalidates any old entries. Must be called with mUpdateMutex locked.
+	/// This is most efficient when inBodies is sorted on broadphase layer.
+	void					AddToLayers(const BodyID *inBodies, int inNumber);
+
+	/// Build a new version of a layer by merging the valid entries of inOldData and inNewEntries
+	LayerData *				BuildLayer(const LayerData *inOldData, const Entry *inNewEntries, uint inNumNewEntries) const;
+
+	/// Replace the data of a layer with inNewData and update the tracking information
+	void					SwapLayerData(Layer &ioLayer, LayerData *inNewData);
+
+	/// Sort ioBodies on broadphase layer of the body
+	void					SortOnBroadPhaseLayer(BodyID *ioBodies, int inNumber) const;
+
+	/// Visit all entries in a layer that could overlap with the box [inMin, inMax] along the sort axis of the layer.
+	/// ioVisitor should return false to stop visiting.
+	template <class Visitor>
+	void					WalkLayer(const LayerData &inData, Vec3Arg inMin, Vec3Arg inMax, Visitor &ioVisitor) const;
+
+	/// Visit all entries in layers that pass inBroadPhaseLayerFilter that could overlap with the box [inMin, inMax]
+	template <class Collector, class Visitor>
+	void					WalkLayers(Vec3Arg inMin, Vec3Arg inMax, const BroadPhaseLayerFilter &inBroadPhaseLayerFilter, const Collector &inCollector, Visitor &ioVisitor) const;
+
+#ifdef JPH_ENABLE_ASSERTS
+	/// Context used to lock a physics lock
+	PhysicsLockContext		mLockContext = nullptr;
+#endif // JPH_ENABLE_ASSERTS
+
+	/// Array that for each BodyID keeps track of where it is located
+	Array<Tracking>			mTracking;
+
+	/// One sorted array per broadphase layer
+	Layer *					mLayers = nullptr;
+	uint					mNumLayers = 0;
+
+	/// Layer data that has been replaced but may still be in use by queries, these are freed in FrameSync() and Optimize()
+	Array<LayerData *>		mRetiredData;
+
+	/// Mutex that prevents object modification during UpdatePrepare/Finalize()
+	SharedMutex				mUpdateMutex;
+
+	/// We keep replaced layer data alive until the next FrameSync(), this structure ensures that we wait for queries that are still using the old data.
+	mutable SharedMutex		mQueryLocks[2];
+
+	/// This index indicates which lock is currently active, it alternates between 0 and 1
+	atomic<uint32>			mQueryLockIdx { 0 };
+};
+
+JPH_NAMESPACE_END
@@ -234,13 +234,8 @@ AABox QuadTree::GetBounds() const
 	return bounds;
 }
 
-void QuadTree::UpdatePrepare(const BodyVector &inBodies, TrackingVector &ioTracking, UpdateState &outUpdateState, bool inFullRebuild)
+uint32 QuadTree::CollectNodesForRebuild(const BodyVector &inBodies, const TrackingVector &inTracking, bool inFullRebuild, NodeID *&outNodeIDs)
 {
-#ifdef JPH_ENABLE_ASSERTS
-	// We only read positions
-	BodyAccess::Grant grant(BodyAccess::EAccess::None, BodyAccess::EAccess::Read);
-#endif
-
 	// Assert we have no nodes pending deletion, this means DiscardOldTree wasn't called yet
 	JPH_ASSERT(mFreeNodeBatch.mNumObjects == 0);
 
@@ -256,7 +251,7 @@ void QuadTree::UpdatePrepare(const BodyVector &inBodies, TrackingVector &ioTrack
 
 	// Assert sane data
 #ifdef JPH_DEBUG
-	ValidateTree(inBodies, ioTracking, root_node.mIndex, mNumBodies);
+	ValidateTree(inBodies, inTracking, root_node.mIndex, mNumBodies);
 #endif
 
 	// Create space for all body ID's
@@ -277,7 +272,7 @@ void QuadTree::UpdatePrepare(const BodyVector &inBodies, TrackingVector &ioTrack
 			// Validate that we're still in the right layer
 		#ifdef JPH_ENABLE_ASSERTS
 			uint32 body_index = node_id.GetBodyID().GetIndex();
-			JPH_ASSERT(ioTracking[body_index].mObjectLayer == inBodies[body_index]->GetObjectLayer());
+			JPH_ASSERT(inTracking[body_index].mObjectLayer == inBodies[body_index]->GetObjectLayer());
 		#endif
 
 			// Store body
@@ -329,43 +324,112 @@ void QuadTree::UpdatePrepare(const BodyVector &inBodies, TrackingVector &ioTrack
 	uint32 num_node_ids = uint32(cur_node_id - node_ids);
 	JPH_ASSERT(inFullRebuild? num_node_ids == mNumBodies : num_node_ids <= mNumBodies);
 
-	// This will be the new root node id
-	NodeID root_node_id;
+	outNodeIDs = node_ids;
+	return num_node_ids;
+}
 
-	if (num_node_ids > 0)
+QuadTree::NodeID QuadTree::FinalizeRebuildRoot(TrackingVector &ioTracking, NodeID inRootNodeID, const AABox &inRootBounds)
+{
+	if (!inRootNodeID.IsValid())
 	{
-		// We mark the first 5 levels (max 1024 nodes) of the newly built tree as 'changed' so that
-		// those nodes get recreated every time when we rebuild the tree. This balances the amount of
-		// time we spend on rebuilding the tree ('unchanged' nodes will be put in the new tree as a whole)
-		// vs the quality of the built tree.
-		constexpr uint cMaxDepthMarkChanged = 5;
-
-		// Build new tree
-		AABox root_bounds;
-		root_node_id = BuildTree(inBodies, ioTracking, node_ids, num_node_ids, cMaxDepthMarkChanged, root_bounds);
-
-		if (root_node_id.IsBody())
-		{
-			// For a single body we need to allocate a new root node
-			uint32 root_idx = AllocateNode(false);
-			Node &root = mAllocator->Get(root_idx);
-			root.SetChildBounds(0, root_bounds);
-			root.mChildNodeID[0] = root_node_id;
-			SetBodyLocation(ioTracking, root_node_id.GetBodyID(), root_idx, 0);
-			root_node_id = NodeID::sFromNodeIndex(root_idx);
-		}
+		// Empty tree, create root node
+		uint32 root_idx = AllocateNode(false);
+		return NodeID::sFromNodeIndex(root_idx);
 	}
-	else
+
+	if (inRootNodeID.IsBody())
 	{
-		// Empty tree, create root node
+		// For a single body we need to allocate a new root node
 		uint32 root_idx = AllocateNode(false);
-		root_node_id = NodeID::sFromNodeIndex(root_idx);
+		Node &root = mAllocator->Get(root_idx);
+		root.SetChildBounds(0, inRootBounds);
+		root.mChildNodeID[0] = inRootNodeID;
+		SetBodyLocation(ioTracking, inRootNodeID.GetBodyID(), root_idx, 0);
+		return NodeID::sFromNodeIndex(root_idx);
 	}
 
+	return inRootNodeID;
+}
+
+void QuadTree::UpdatePrepare(const BodyVector &inBodies, TrackingVector &ioTracking, UpdateState &outUpdateState, bool inFullRebuild)
+{
+#ifdef JPH_ENABLE_ASSERTS
+	// We only read positions
+	BodyAccess::Grant grant(BodyAccess::EAccess::None, BodyAccess::EAccess::Read);
+#endif
+
+	// Collect bodies and nodes that need to go in the new tree
+	NodeID *node_ids;
+	uint32 num_node_ids = CollectNodesForRebuild(inBodies, ioTracking, inFullRebuild, node_ids);
+
+	// Build new tree
+	AABox root_bounds;
+	NodeID root_node_id = BuildTree(inBodies, ioTracking, node_ids, num_node_ids, cMaxDepthMarkChanged, root_bounds);
+	outUpdateState.mRootNodeID = FinalizeRebuildRoot(ioTracking, root_node_id, root_bounds);
+
 	// Delete temporary data
 	delete [] node_ids;
+}
 
-	outUpdateState.mRootNodeID = root_node_id;
+void QuadTree::UpdatePrepareBegin(const BodyVector &inBodies, TrackingVector &ioTracking, BatchedUpdateState &outState, bool inFullRebuild)
+{
+#ifdef JPH_ENABLE_ASSERTS
+	// We only read positions
+	BodyAccess::Grant grant(BodyAccess::EAccess::None, BodyAccess::EAccess::Read);
+#endif
+
+	// Collect bodies and nodes that need to go in the new tree
+	int num_node_ids = (int)CollectNodesForRebuild(inBodies, ioTracking, inFullRebuild, outState.mNodeIDs);
+
+	// Split into batches, small trees are built as a single batch
+	if (num_node_ids >= cMinBodiesPerAddBatch * cNumAddBatches)
+		PartitionIntoBatches(inBodies, outState.mNodeIDs, num_node_ids, outState.mSplit);
+	else
+	{
+		outState.mSplit[0] = 0;
+		for (int i = 1; i <= cNumAddBatches; ++i)
+			outState.mSplit[i] = num_node_ids;
+	}
+}
+
+void QuadTree::UpdatePrepareBatch(const BodyVector &inBodies, TrackingVector &ioTracking, BatchedUpdateState &ioState, int inBatch)
+{
+#ifdef JPH_ENABLE_ASSERTS
+	// We only read positions
+	BodyAccess::Grant grant(BodyAccess::EAccess::None, BodyAccess::EAccess::Read);
+#endif
+
+	// When the tree was split, the subtree of a batch starts 2 levels below the root of the tree
+	bool is_single_batch = ioState.IsSingleBatch();
+	uint max_depth_mark_changed = is_single_batch? cMaxDepthMarkChanged : cMaxDepthMarkChanged - 2;
+
+	int begin = ioState.mSplit[inBatch];
+	AABox bounds;
+	ioState.mBatchRootIDs[inBatch] = BuildTree(inBodies, ioTracking, ioState.mNodeIDs + begin, ioState.mSplit[inBatch + 1] - begin, max_depth_mark_changed, bounds);
+}
+
+void QuadTree::UpdatePrepareEnd(const BodyVector &inBodies, TrackingVector &ioTracking, BatchedUpdateState &ioState, UpdateState &outUpdateState)
+{
+#ifdef JPH_ENABLE_ASSERTS
+	// We only read positions
+	BodyAccess::Grant grant(BodyAccess::EAccess::None, BodyAccess::EAccess::Read);
+#endif
+
+	// Collect the roots of all non-empty batches
+	NodeID batch_root_ids[cNumAddBatches];
+	int num_batch_roots = 0;
+	for (int i = 0; i < cNumAddBatches; ++i)
+		if (ioState.mSplit[i + 1] > ioState.mSplit[i])
+			batch_root_ids[num_batch_roots++] = ioState.mBatchRootIDs[i];
+
+	// Build the top of the tree
+	AABox root_bounds;
+	NodeID root_node_id = BuildTree(inBodies, ioTracking, batch_root_ids, num_batch_roots, cMaxDepthMarkChanged, root_bounds);
+	outUpdateState.mRootNodeID = FinalizeRebuildRoot(ioTracking, root_node_id, root_bounds);
+
+	// Delete temporary data
+	delete [] ioState.mNodeIDs;
+	ioState.mNodeIDs = nullptr;
 }
 
 void QuadTree::UpdateFinalize([[maybe_unused]] const BodyVector &inBodies, [[maybe_unused]] const TrackingVector &inTracking, const UpdateState &inUpdateState)
@@ -809,6 +873,52 @@ void QuadTree::AddBodiesPrepare(const BodyVector &inBodies, TrackingVector &ioTr
 #endif
 }
 
+void QuadTree::PartitionIntoBatches(const BodyVector &inBodies, NodeID *ioNodeIDs, int inNumber, int *outSplit) const
+{
+	static_assert(cNumAddBatches == 16, "Partitioning below assumes 2 levels of 4 children");
+
+	// Calculate centers of all bodies / nodes
+	Vec3 *centers = new Vec3 [inNumber];
+	JPH_ASSERT(IsAligned(centers, JPH_VECTOR_ALIGNMENT));
+	Vec3 *c = centers;
+	for (const NodeID *n = ioNodeIDs, *n_end = ioNodeIDs + inNumber; n < n_end; ++n, ++c)
+		*c = GetNodeOrBodyBounds(inBodies, *n).GetCenter();
+
+	// Partition the same way as the top 2 levels of BuildTree, note that the last split of a group is the first split of the next group
+	int split[5];
+	sPartition4(ioNodeIDs, centers, 0, inNumber, split);
+	for (int i = 0; i < 4; ++i)
+		sPartition4(ioNodeIDs, centers, split[i], split[i + 1], outSplit + 4 * i);
+
+	// Delete temporary data
+	delete [] centers;
+}
+
+void QuadTree::AddBodiesPartition(const BodyVector &inBodies, BodyID *ioBodyIDs, int inNumber, int *outSplit) const
+{
+	// Assert sane input
+	JPH_ASSERT(ioBodyIDs != nullptr);
+	JPH_ASSERT(inNumber > 0);
+
+	PartitionIntoBatches(inBodies, (NodeID *)ioBodyIDs, inNumber, outSplit);
+}
+
+void QuadTree::AddBodiesCombine(const BodyVector &inBodies, TrackingVector &ioTracking, const AddState *inBatchStates, int inNumBatches, AddState &outState)
+{
+	JPH_ASSERT(inNumBatches <= cNumAddBatches);
+
+	// Collect the roots of all non-empty batches
+	NodeID leaf_ids[cNumAddBatches];
+	int num_leafs = 0;
+	for (const AddState *s = inBatchStates, *s_end = inBatchStates + inNumBatches; s < s_end; ++s)
+		if (s->mLeafID.IsValid())
+			leaf_ids[num_leafs++] = s->mLeafID;
+	JPH_ASSERT(num_leafs > 0);
+
+	// Build the top of the tree
+	outState.mLeafID = BuildTree(inBodies, ioTracking, leaf_ids, num_leafs, 0, outState.mLeafBounds);
+}
+
 void QuadTree::AddBodiesFinalize(TrackingVector &ioTracking, int inNumberBodies, const AddState &inState)
 {
 	// Assert sane input
@@ -205,6 +205,31 @@ public:
 	void						UpdatePrepare(const BodyVector &inBodies, TrackingVector &ioTracking, UpdateState &outUpdateState, bool inFullRebuild);
 	void						UpdateFinalize(const BodyVector &inBodies, const TrackingVector &inTracking, const UpdateState &inUpdateState);
 
+	/// Number of batches that AddBodiesPartition and UpdatePrepareBegin split the bodies into, so that the batches can be built on different threads
+	static constexpr int		cNumAddBatches = 16;
+
+	/// Minimum number of bodies per batch before it is worth splitting up a tree build
+	static constexpr int		cMinBodiesPerAddBatch = 128;
+
+	/// Temporary data structure used when building the tree in batches
+	struct BatchedUpdateState
+	{
+		JPH_OVERRIDE_NEW_DELETE
+
+		NodeID *				mNodeIDs = nullptr;					///< Bodies and nodes that will be put in the new tree
+		int						mSplit[cNumAddBatches + 1];			///< Each batch runs from mNodeIDs + mSplit[i] to (but excluding) mNodeIDs + mSplit[i + 1]
+		NodeID					mBatchRootIDs[cNumAddBatches];		///< Root of the subtree that was built for each batch
+
+		/// If the tree was too small to be split up, in this case all bodies / nodes are in the first batch
+		bool					IsSingleBatch() const				{ return mSplit[1] == mSplit[cNumAddBatches]; }
+	};
+
+	/// Alternative for UpdatePrepare that builds the new tree in batches. UpdatePrepareBegin collects the bodies / nodes that need to go in the new tree and splits them into batches.
+	/// After that UpdatePrepareBatch should be called for every batch (this can be done from multiple threads), and finally UpdatePrepareEnd creates the state that needs to be passed to UpdateFinalize.
+	void						UpdatePrepareBegin(const BodyVector &inBodies, TrackingVector &ioTracking, BatchedUpdateState &outState, bool inFullRebuild);
+	void						UpdatePrepareBatch(const BodyVector &inBodies, TrackingVector &ioTracking, BatchedUpdateState &ioState, int inBatch);
+	void						UpdatePrepareEnd(const BodyVector &inBodies, TrackingVector &ioTracking, BatchedUpdateState &ioState, UpdateState &outUpdateState);
+
 	/// Temporary data structure to pass information between AddBodiesPrepare and AddBodiesFinalize/Abort
 	struct AddState
 	{
@@ -217,6 +242,15 @@ public:
 	/// ioBodyIDs may be shuffled around by this function.
 	void						AddBodiesPrepare(const BodyVector &inBodies, TrackingVector &ioTracking, BodyID *ioBodyIDs, int inNumber, AddState &outState);
 
+	/// Split inNumber bodies at ioBodyIDs into cNumAddBatches spatially coherent batches, so that AddBodiesPrepare can be called for every batch from a different thread.
+	/// outSplit receives cNumAddBatches + 1 indices that mark the start and end of each batch (batches can be empty).
+	/// ioBodyIDs may be shuffled around by this function.
+	void						AddBodiesPartition(const BodyVector &inBodies, BodyID *ioBodyIDs, int inNumber, int *outSplit) const;
+
+	/// Combine the states of batches that were prepared by AddBodiesPrepare into a single state that can be passed to AddBodiesFinalize/Abort.
+	/// AddBodiesFinalize should be called with the total number of bodies in all batches.
+	void						AddBodiesCombine(const BodyVector &inBodies, TrackingVector &ioTracking, const AddState *inBatchStates, int inNumBatches, AddState &outState);
+
 	/// Finalize adding bodies to the quadtree, supply the same number of bodies as in AddBodiesPrepare.
 	void						AddBodiesFinalize(TrackingVector &ioTracking, int inNumberBodies, const AddState &inState);
 
@@ -302,6 +336,19 @@ private:
 	/// Try to replace the existing root with a new root that contains both the existing root and the new leaf
 	inline bool					TryCreateNewRoot(TrackingVector &ioTracking, atomic<uint32> &ioRootNodeIndex, NodeID inLeafID, const AABox &inLeafBounds, int inLeafNumBodies);
 
+	/// We mark the first 5 levels (max 1024 nodes) of a rebuilt tree as 'changed' so that those nodes get recreated every time when we rebuild the tree.
+	/// This balances the amount of time we spend on rebuilding the tree ('unchanged' nodes will be put in the new tree as a whole) vs the quality of the built tree.
+	static constexpr uint		cMaxDepthMarkChanged = 5;
+
+	/// Collect all bodies and nodes that need to be put in a new tree, returns the number of entries in outNodeIDs (which needs to be freed with delete [])
+	uint32						CollectNodesForRebuild(const BodyVector &inBodies, const TrackingVector &inTracking, bool inFullRebuild, NodeID *&outNodeIDs);
+
+	/// Turn the root of a newly built tree into a valid root node
+	NodeID						FinalizeRebuildRoot(TrackingVector &ioTracking, NodeID inRootNodeID, const AABox &inRootBounds);
+
+	/// Split inNumber bodies / nodes in ioNodeIDs into cNumAddBatches spatially coherent batches, see AddBodiesPartition
+	void						PartitionIntoBatches(const BodyVector &inBodies, NodeID *ioNodeIDs, int inNumber, int *outSplit) const;
+
 	/// Build a tree for ioBodyIDs, returns the NodeID of the root (which will be the ID of a single body if inNumber = 1). All tree levels up to inMaxDepthMarkChanged will be marked as 'changed'.
 	NodeID						BuildTree(const BodyVector &inBodies, TrackingVector &ioTracking, NodeID *ioNodeIDs, int inNumber, uint inMaxDepthMarkChanged, AABox &outBounds);
 
@@ -89,6 +89,16 @@ public:
 	Vec3						mActiveEdgeMovementDirection = Vec3::sZero();
 };
 
+/// Data that is stored between collision queries of the same pair of objects to speed up the next query.
+/// The PhysicsSystem keeps one of these per body pair in the contact cache. Any value is valid, it only affects performance.
+class CollideShapeWarmStart
+{
+public:
+	Float3						mPenetrationAxis			= { 0, 0, 0 };	///< Separating / penetration axis found by the last GJK / EPA run in the space of shape 1 (normalized), zero if unknown. Used as initial axis for GJK.
+	uint8						mSupportHint1				= 0;		///< Where the support function of shape 1 starts its search, see ConvexShape::Support::GetSupportHint
+	uint8						mSupportHint2				= 0;		///< Where the support function of shape 2 starts its search
+};
+
 /// Settings to be passed with a collision query
 class CollideShapeSettings : public CollideSettingsBase
 {
@@ -100,6 +110,10 @@ public:
 
 	/// How backfacing triangles should be treated
 	EBackFaceMode				mBackFaceMode				= EBackFaceMode::IgnoreBackFaces;
+
+	/// Optional data that is read at the start of the query and updated at the end, used to exploit temporal coherence between queries of the same pair.
+	/// Note that when colliding compound shapes all sub shape pairs share the same data.
+	CollideShapeWarmStart *		mWarmStart					= nullptr;
 };
 
 JPH_NAMESPACE_END
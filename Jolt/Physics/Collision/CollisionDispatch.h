@@ -80,6 +80,9 @@ public:
 	/// Register a collide shape function in the collision table
 	static void				sRegisterCollideShape(EShapeSubType inType1, EShapeSubType inType2, CollideShape inFunction)	{ sCollideShape[(int)inType1][(int)inType2] = inFunction; }
 
+	/// Get the collide shape function that is registered for a pair of shape types
+	static CollideShape		sGetCollideShape(EShapeSubType inType1, EShapeSubType inType2)								{ return sCollideShape[(int)inType1][(int)inType2]; }
+
 	/// Register a cast shape function in the collision table
 	static void				sRegisterCastShape(EShapeSubType inType1, EShapeSubType inType2, CastShape inFunction)			{ sCastShape[(int)inType1][(int)inType2] = inFunction; }
 
@@ -0,0 +1,57 @@
+// Jolt Physics Library (https://github.com/jrouwe/JoltPhysics)
+// SPDX-FileCopyrightText: 2024 Jorrit Rouwe
+// SPDX-License-Identifier: MIT
+
+#pragma once
+
+#include <Jolt/Physics/Collision/Shape/SubShapeIDPair.h>
+#include <Jolt/Math/Real.h>
+
+JPH_NAMESPACE_BEGIN
+
+/// Type of a ContactEvent
+enum class EContactEventType : uint8
+{
+	Added,														///< Contact between the sub shapes started this collision step (see ContactListener::OnContactAdded)
+	Persisted,													///< Contact between the sub shapes existed in the previous collision step and still exists (see ContactListener::OnContactPersisted)
+	Removed,													///< Contact between the sub shapes existed in the previous collision step but no longer exists (see ContactListener::OnContactRemoved)
+};
+
+/// Compact record of a contact that was added, persisted or removed during PhysicsSystem::Update.
+/// Contact events are an alternative to a ContactListener: instead of calling virtual functions from within the collision detection jobs,
+/// the events are recorded in a buffer that can be read after PhysicsSystem::Update returns (see PhysicsSystem::SetMaxContactEvents).
+/// Because of this, contact events cannot be used to modify the ContactSettings of a contact.
+class ContactEvent
+{
+public:
+	/// Get / set the world space contact position
+#ifdef JPH_DOUBLE_PRECISION
+	inline RVec3			GetPosition() const					{ return RVec3::sLoadDouble3Unsafe(mPosition); }
+	inline void				SetPosition(RVec3Arg inPosition)	{ inPosition.StoreDouble3(&mPosition); }
+#else
+	inline RVec3			GetPosition() const					{ return RVec3::sLoadFloat3Unsafe(mPosition); }
+	inline void				SetPosition(RVec3Arg inPosition)	{ inPosition.StoreFloat3(&mPosition); }
+#endif // JPH_DOUBLE_PRECISION
+
+	/// Get the world space contact normal
+	inline Vec3				GetWorldSpaceNormal() const			{ return Vec3::sLoadFloat3Unsafe(mWorldSpaceNormal); }
+
+	/// Comparison operator, orders events on body pair, sub shape pair and then on collision step
+	inline bool				operator < (const ContactEvent &inRHS) const
+	{
+		if (!(mSubShapePair == inRHS.mSubShapePair))
+			return mSubShapePair < inRHS.mSubShapePair;
+		if (mCollisionStep != inRHS.mCollisionStep)
+			return mCollisionStep < inRHS.mCollisionStep;
+		return mType < inRHS.mType;
+	}
+
+	SubShapeIDPair			mSubShapePair;						///< Bodies and sub shapes that are in contact, this is the same key that is passed to ContactListener::OnContactRemoved
+	Real3					mPosition;							///< Average of the world space contact points on body 2 (zero for Removed events)
+	Float3					mWorldSpaceNormal;					///< World space normal, direction along which to move body 2 out of collision along the shortest path (zero for Removed events)
+	float					mPenetrationDepth;					///< Penetration depth of the deepest contact point (zero for Removed events)
+	uint8					mCollisionStep;						///< Collision step of PhysicsSystem::Update in which the event was generated
+	EContactEventType		mType;								///< Type of event
+};
+
+JPH_NAMESPACE_END
@@ -13,6 +13,10 @@ JPH_NAMESPACE_BEGIN
 NarrowPhaseStat	NarrowPhaseStat::sCollideShape[NumSubShapeTypes][NumSubShapeTypes];
 NarrowPhaseStat	NarrowPhaseStat::sCastShape[NumSubShapeTypes][NumSubShapeTypes];
 
+atomic<uint64>	CCDSweptVolumeStat::sNumCacheHits { 0 };
+atomic<uint64>	CCDSweptVolumeStat::sNumProbes { 0 };
+atomic<uint64>	CCDSweptVolumeStat::sNumProbeMisses { 0 };
+
 thread_local TrackNarrowPhaseStat *TrackNarrowPhaseStat::sRoot = nullptr;
 
 void NarrowPhaseStat::ReportStats(const char *inName, EShapeSubType inType1, EShapeSubType inType2, uint64 inTicks100Pct) const
@@ -55,6 +59,20 @@ void NarrowPhaseStat::sReportStats()
 			if (stat.mNumQueries > 0)
 				stat.ReportStats("CastShape", t1, t2, total_ticks);
 		}
+
+	CCDSweptVolumeStat::sReportStats();
+}
+
+void CCDSweptVolumeStat::sReportStats()
+{
+	if (sNumCacheHits == 0 && sNumProbes == 0)
+		return;
+
+	Trace("CCD Swept Volume Cache Hits, Probes, Probe Misses");
+
+	std::stringstream str;
+	str << sNumCacheHits << ", " << sNumProbes << ", " << sNumProbeMisses;
+	Trace(str.str().c_str());
 }
 
 JPH_NAMESPACE_END
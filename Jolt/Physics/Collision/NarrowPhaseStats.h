@@ -43,6 +43,18 @@ public:
 	static NarrowPhaseStat	sCastShape[NumSubShapeTypes][NumSubShapeTypes];
 };
 
+/// Structure that tracks how effective the swept volume cache for LinearCast bodies is (see PhysicsSettings::mUseCCDSweptVolumeCache)
+class CCDSweptVolumeStat
+{
+public:
+	/// Trace the collected stats
+	static void				sReportStats();
+
+	static atomic<uint64>	sNumCacheHits;				///< Number of narrow phase casts that were skipped because a previous step found that the body was clear
+	static atomic<uint64>	sNumProbes;					///< Number of casts against the full swept volume
+	static atomic<uint64>	sNumProbeMisses;			///< Number of casts against the full swept volume that didn't hit anything
+};
+
 /// Object that tracks the start and end of a narrow phase operation
 class TrackNarrowPhaseStat
 {
@@ -10,12 +10,16 @@
 #include <Jolt/Physics/Collision/RayCast.h>
 #include <Jolt/Physics/Collision/CastResult.h>
 #include <Jolt/Physics/Collision/CollidePointResult.h>
+#include <Jolt/Physics/Collision/CollideShape.h>
+#include <Jolt/Physics/Collision/CollisionDispatch.h>
 #include <Jolt/Physics/Collision/TransformedShape.h>
 #include <Jolt/Physics/SoftBody/SoftBodyVertex.h>
 #include <Jolt/Geometry/RayAABox.h>
+#include <Jolt/Geometry/ClosestPoint.h>
 #include <Jolt/ObjectStream/TypeDeclarations.h>
 #include <Jolt/Core/StreamIn.h>
 #include <Jolt/Core/StreamOut.h>
+#include <Jolt/Core/Profiler.h>
 #ifdef JPH_DEBUG_RENDERER
 	#include <Jolt/Renderer/DebugRenderer.h>
 #endif // JPH_DEBUG_RENDERER
@@ -308,11 +312,180 @@ void BoxShape::RestoreBinaryState(StreamIn &inStream)
 	inStream.Read(mConvexRadius);
 }
 
+/// Separating axis test between two sharp boxes, box 2 is specified in the space of box 1.
+/// Returns false if the boxes are separated by more than inMaxSeparation. Otherwise returns the axis of least penetration (pointing from box 1 to box 2),
+/// the separation along that axis (negative when penetrating) and a point on each box where outPoint1 - outPoint2 = -outSeparation * outAxis.
+static bool sBoxVsBoxSeparatingAxisTest(Vec3Arg inHalfExtent1, Vec3Arg inHalfExtent2, Mat44Arg inTransform2To1, float inMaxSeparation, Vec3 &outAxis, float &outSeparation, Vec3 &outPoint1, Vec3 &outPoint2)
+{
+	Vec3 translation = inTransform2To1.GetTranslation();
+	Vec3 axis1[] = { Vec3::sAxisX(), Vec3::sAxisY(), Vec3::sAxisZ() };
+	Vec3 axis2[] = { inTransform2To1.GetAxisX(), inTransform2To1.GetAxisY(), inTransform2To1.GetAxisZ() };
+
+	// Edge axis need to be this much better than the face axis before we select them, this avoids flip flopping between a face and an edge for (almost) parallel boxes
+	constexpr float cEdgeTolerance = 1.0e-3f;
+
+	// Separating axis test, we look for the axis with the least penetration (biggest separation)
+	enum class EFeature { Face1, Face2, Edge };
+	EFeature best_feature = EFeature::Face1;
+	uint best_index1 = 0, best_index2 = 0;
+	float best_separation = -FLT_MAX;
+	Vec3 best_axis = Vec3::sZero();
+	auto test_axis = [translation, inHalfExtent1, inHalfExtent2, &inTransform2To1, inMaxSeparation, &best_feature, &best_index1, &best_index2, &best_separation, &best_axis](Vec3Arg inAxis, EFeature inFeature, uint inIndex1, uint inIndex2, float inTolerance) {
+		// Project both boxes on the axis and calculate the separation
+		float separation = abs(translation.Dot(inAxis)) - inAxis.Abs().Dot(inHalfExtent1) - inTransform2To1.Multiply3x3Transposed(inAxis).Abs().Dot(inHalfExtent2);
+		if (separation > inMaxSeparation)
+			return false; // Separated, no hit
+
+		if (separation > best_separation + inTolerance)
+		{
+			best_feature = inFeature;
+			best_index1 = inIndex1;
+			best_index2 = inIndex2;
+			best_separation = separation;
+			best_axis = inAxis;
+		}
+		return true;
+	};
+
+	// Face normals of box 1
+	for (uint i = 0; i < 3; ++i)
+		if (!test_axis(axis1[i], EFeature::Face1, i, 0, 0.0f))
+			return false;
+
+	// Face normals of box 2
+	for (uint i = 0; i < 3; ++i)
+		if (!test_axis(axis2[i], EFeature::Face2, 0, i, 0.0f))
+			return false;
+
+	// Cross products of the edges of both boxes
+	for (uint i = 0; i < 3; ++i)
+		for (uint j = 0; j < 3; ++j)
+		{
+			Vec3 axis = axis1[i].Cross(axis2[j]);
+			float axis_len_sq = axis.LengthSq();
+			if (axis_len_sq > 1.0e-6f) // Parallel edges are covered by the face normals
+				if (!test_axis(axis / sqrt(axis_len_sq), EFeature::Edge, i, j, cEdgeTolerance))
+					return false;
+		}
+
+	// Make the axis point from box 1 to box 2
+	if (translation.Dot(best_axis) < 0.0f)
+		best_axis = -best_axis;
+	float penetration_depth = -best_separation;
+	outAxis = best_axis;
+	outSeparation = best_separation;
+
+	// Find the deepest points on both boxes
+	switch (best_feature)
+	{
+	case EFeature::Face1:
+		// Deepest vertex of box 2 against the face of box 1
+		outPoint2 = inTransform2To1 * (-inTransform2To1.Multiply3x3Transposed(best_axis).GetSign() * inHalfExtent2);
+		outPoint1 = outPoint2 + penetration_depth * best_axis;
+		break;
+
+	case EFeature::Face2:
+		// Deepest vertex of box 1 against the face of box 2
+		outPoint1 = best_axis.GetSign() * inHalfExtent1;
+		outPoint2 = outPoint1 - penetration_depth * best_axis;
+		break;
+
+	case EFeature::Edge:
+	default:
+		{
+			// Get the supporting edge of box 1
+			Vec3 edge1_center = best_axis.GetSign() * inHalfExtent1;
+			Vec3 edge1_dir = axis1[best_index1] * inHalfExtent1[best_index1];
+			edge1_center.SetComponent(best_index1, 0.0f);
+
+			// Get the supporting edge of box 2
+			Vec3 edge2_center_local = -inTransform2To1.Multiply3x3Transposed(best_axis).GetSign() * inHalfExtent2;
+			edge2_center_local.SetComponent(best_index2, 0.0f);
+			Vec3 edge2_center = inTransform2To1 * edge2_center_local;
+			Vec3 edge2_dir = axis2[best_index2] * inHalfExtent2[best_index2];
+
+			// The contact point is the closest point between the edges
+			Vec3 closest2;
+			ClosestPoint::GetClosestPointsOnSegments(edge1_center - edge1_dir, edge1_center + edge1_dir, edge2_center - edge2_dir, edge2_center + edge2_dir, outPoint1, closest2);
+			outPoint2 = outPoint1 - penetration_depth * best_axis;
+			break;
+		}
+	}
+
+	return true;
+}
+
+void BoxShape::sCollideBoxVsBox(const Shape *inShape1, const Shape *inShape2, Vec3Arg inScale1, Vec3Arg inScale2, Mat44Arg inCenterOfMassTransform1, Mat44Arg inCenterOfMassTransform2, const SubShapeIDCreator &inSubShapeIDCreator1, const SubShapeIDCreator &inSubShapeIDCreator2, const CollideShapeSettings &inCollideShapeSettings, CollideShapeCollector &ioCollector, const ShapeFilter &inShapeFilter)
+{
+	JPH_PROFILE_FUNCTION();
+
+	JPH_ASSERT(inShape1->GetSubType() == EShapeSubType::Box);
+	const BoxShape *shape1 = static_cast<const BoxShape *>(inShape1);
+	JPH_ASSERT(inShape2->GetSubType() == EShapeSubType::Box);
+	const BoxShape *shape2 = static_cast<const BoxShape *>(inShape2);
+
+	// Scale our half extents and convex radii
+	Vec3 half_extent1 = inScale1.Abs() * shape1->mHalfExtent;
+	Vec3 half_extent2 = inScale2.Abs() * shape2->mHalfExtent;
+	float convex_radius1 = ScaleHelpers::ScaleConvexRadius(shape1->mConvexRadius, inScale1);
+	float convex_radius2 = ScaleHelpers::ScaleConvexRadius(shape2->mConvexRadius, inScale2);
+
+	// Do the test in the space of box 1
+	Mat44 transform_2_to_1 = inCenterOfMassTransform1.InversedRotationTranslation() * inCenterOfMassTransform2;
+	float max_separation = inCollideShapeSettings.mMaxSeparationDistance;
+
+	// A box with a convex radius is a box that is shrunk by the convex radius and then rounded by the convex radius.
+	// Like GJK / EPA in sCollideConvexVsConvex we first test the shrunk boxes, if they don't overlap the contact is between the rounded parts.
+	Vec3 reduced_half_extent1 = half_extent1 - Vec3::sReplicate(convex_radius1);
+	Vec3 reduced_half_extent2 = half_extent2 - Vec3::sReplicate(convex_radius2);
+	Vec3 axis, point1, point2;
+	float separation;
+	if (!sBoxVsBoxSeparatingAxisTest(reduced_half_extent1, reduced_half_extent2, transform_2_to_1, max_separation + convex_radius1 + convex_radius2, axis, separation, point1, point2))
+		return;
+
+	if (separation > 0.0f)
+	{
+		// The separating axis test only gives a lower bound for the distance between the shrunk boxes.
+		// Alternately find the closest point on box 1 to the point on box 2 and the closest point on box 2 to that point, if these are as far apart as the separation, we have found the closest points.
+		Mat44 transform_1_to_2 = transform_2_to_1.InversedRotationTranslation();
+		float max_distance = separation + inCollideShapeSettings.mCollisionTolerance;
+		bool found = false;
+		for (int iteration = 0; iteration < 4 && !found; ++iteration)
+		{
+			point1 = Vec3::sMin(Vec3::sMax(point2, -reduced_half_extent1), reduced_half_extent1);
+			point2 = transform_2_to_1 * Vec3::sMin(Vec3::sMax(transform_1_to_2 * point1, -reduced_half_extent2), reduced_half_extent2);
+			found = (point2 - point1).Length() <= max_distance;
+		}
+		if (!found)
+		{
+			// The closest points are not on the features that the separating axis test found (e.g. two corners pointing at each other), let GJK find them
+			sCollideConvexVsConvex(inShape1, inShape2, inScale1, inScale2, inCenterOfMassTransform1, inCenterOfMassTransform2, inSubShapeIDCreator1, inSubShapeIDCreator2, inCollideShapeSettings, ioCollector, inShapeFilter);
+			return;
+		}
+
+		// Move the points to the surface of the rounded boxes
+		point1 += convex_radius1 * axis;
+		point2 -= convex_radius2 * axis;
+	}
+	else if (convex_radius1 > 0.0f || convex_radius2 > 0.0f)
+	{
+		// The shrunk boxes overlap, like EPA we find the penetration of the sharp boxes (the box support function includes the convex radius by returning the sharp box)
+		if (!sBoxVsBoxSeparatingAxisTest(half_extent1, half_extent2, transform_2_to_1, max_separation, axis, separation, point1, point2))
+			return;
+	}
+
+	// Expand point 1 by the max separation distance so the result is the same as that of EPAPenetrationDepth
+	sAddConvexVsConvexHit(shape1, shape2, inScale1, inScale2, inCenterOfMassTransform1, inCenterOfMassTransform2, transform_2_to_1, inSubShapeIDCreator1, inSubShapeIDCreator2, inCollideShapeSettings, axis, point1 + max_separation * axis, point2, ioCollector);
+}
+
 void BoxShape::sRegister()
 {
 	ShapeFunctions &f = ShapeFunctions::sGet(EShapeSubType::Box);
 	f.mConstruct = []() -> Shape * { return new BoxShape; };
 	f.mColor = Color::sGreen;
+
+	// Specialized collision functions
+	CollisionDispatch::sRegisterCollideShape(EShapeSubType::Box, EShapeSubType::Box, sCollideBoxVsBox);
 }
 
 JPH_NAMESPACE_END
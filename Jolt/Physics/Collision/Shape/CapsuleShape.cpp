@@ -11,12 +11,16 @@
 #include <Jolt/Physics/Collision/RayCast.h>
 #include <Jolt/Physics/Collision/CastResult.h>
 #include <Jolt/Physics/Collision/CollidePointResult.h>
+#include <Jolt/Physics/Collision/CollideShape.h>
+#include <Jolt/Physics/Collision/CollisionDispatch.h>
 #include <Jolt/Physics/Collision/TransformedShape.h>
 #include <Jolt/Physics/SoftBody/SoftBodyVertex.h>
 #include <Jolt/Geometry/RayCapsule.h>
+#include <Jolt/Geometry/ClosestPoint.h>
 #include <Jolt/ObjectStream/TypeDeclarations.h>
 #include <Jolt/Core/StreamIn.h>
 #include <Jolt/Core/StreamOut.h>
+#include <Jolt/Core/Profiler.h>
 #ifdef JPH_DEBUG_RENDERER
 	#include <Jolt/Renderer/DebugRenderer.h>
 #endif // JPH_DEBUG_RENDERER
@@ -436,11 +440,71 @@ bool CapsuleShape::IsValidScale(Vec3Arg inScale) const
 	return ConvexShape::IsValidScale(inScale) && ScaleHelpers::IsUniformScale(inScale.Abs());
 }
 
+void CapsuleShape::sCollideCapsuleVsCapsule(const Shape *inShape1, const Shape *inShape2, Vec3Arg inScale1, Vec3Arg inScale2, Mat44Arg inCenterOfMassTransform1, Mat44Arg inCenterOfMassTransform2, const SubShapeIDCreator &inSubShapeIDCreator1, const SubShapeIDCreator &inSubShapeIDCreator2, const CollideShapeSettings &inCollideShapeSettings, CollideShapeCollector &ioCollector, [[maybe_unused]] const ShapeFilter &inShapeFilter)
+{
+	JPH_PROFILE_FUNCTION();
+
+	JPH_ASSERT(inShape1->GetSubType() == EShapeSubType::Capsule);
+	const CapsuleShape *shape1 = static_cast<const CapsuleShape *>(inShape1);
+	JPH_ASSERT(inShape2->GetSubType() == EShapeSubType::Capsule);
+	const CapsuleShape *shape2 = static_cast<const CapsuleShape *>(inShape2);
+
+	// Get scaled capsules (see GetSupportFunction)
+	JPH_ASSERT(shape1->IsValidScale(inScale1));
+	JPH_ASSERT(shape2->IsValidScale(inScale2));
+	float scale1 = abs(inScale1.GetX());
+	float scale2 = abs(inScale2.GetX());
+	float radius1 = scale1 * shape1->mRadius;
+	float radius2 = scale2 * shape2->mRadius;
+	Vec3 half_height1(0, scale1 * shape1->mHalfHeightOfCylinder, 0);
+	Vec3 half_height2(0, scale2 * shape2->mHalfHeightOfCylinder, 0);
+
+	// Get the line segment of capsule 2 in the space of capsule 1
+	Mat44 transform_2_to_1 = inCenterOfMassTransform1.InversedRotationTranslation() * inCenterOfMassTransform2;
+	Vec3 top2 = transform_2_to_1 * half_height2;
+	Vec3 bottom2 = transform_2_to_1 * -half_height2;
+
+	// Get the closest points between the line segments
+	Vec3 closest1, closest2;
+	ClosestPoint::GetClosestPointsOnSegments(-half_height1, half_height1, bottom2, top2, closest1, closest2);
+
+	// Check if the capsules are within the max separation distance
+	Vec3 delta = closest2 - closest1;
+	float distance_sq = delta.LengthSq();
+	float radius_sum = radius1 + radius2;
+	float max_separation = inCollideShapeSettings.mMaxSeparationDistance;
+	if (distance_sq > Square(radius_sum + max_separation))
+		return;
+
+	// Determine the penetration axis, pointing from capsule 1 to capsule 2
+	float distance = sqrt(distance_sq);
+	Vec3 penetration_axis;
+	if (distance > 1.0e-6f)
+		penetration_axis = delta / distance;
+	else
+	{
+		// The line segments intersect, push the capsules apart perpendicular to both segments
+		penetration_axis = Vec3::sAxisY().Cross(top2 - bottom2);
+		float len = penetration_axis.Length();
+		penetration_axis = len > 1.0e-6f? penetration_axis / len : Vec3::sAxisX();
+	}
+
+	// Calculate the deepest points on the capsules
+	Vec3 point1 = closest1 + radius1 * penetration_axis;
+	Vec3 point2 = closest2 - radius2 * penetration_axis;
+
+	// Expand point 1 by the max separation distance so the result is the same as that of EPAPenetrationDepth
+	sAddConvexVsConvexHit(shape1, shape2, inScale1, inScale2, inCenterOfMassTransform1, inCenterOfMassTransform2, transform_2_to_1, inSubShapeIDCreator1, inSubShapeIDCreator2, inCollideShapeSettings, penetration_axis, point1 + max_separation * penetration_axis, point2, ioCollector);
+}
+
 void CapsuleShape::sRegister()
 {
 	ShapeFunctions &f = ShapeFunctions::sGet(EShapeSubType::Capsule);
 	f.mConstruct = []() -> Shape * { return new CapsuleShape; };
 	f.mColor = Color::sGreen;
+
+	// Specialized collision functions
+	CollisionDispatch::sRegisterCollideShape(EShapeSubType::Capsule, EShapeSubType::Capsule, sCollideCapsuleVsCapsule);
 }
 
 JPH_NAMESPACE_END
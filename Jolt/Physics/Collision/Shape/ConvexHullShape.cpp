@@ -16,6 +16,7 @@
 #include <Jolt/Geometry/ClosestPoint.h>
 #include <Jolt/ObjectStream/TypeDeclarations.h>
 #include <Jolt/Core/StringTools.h>
+#include <Jolt/Core/QuickSort.h>
 #include <Jolt/Core/StreamIn.h>
 #include <Jolt/Core/StreamOut.h>
 #include <Jolt/Core/UnorderedMap.h>
@@ -350,9 +351,84 @@ ConvexHullShape::ConvexHullShape(const ConvexHullShapeSettings &inSettings, Shap
 		mInnerRadius = min(mInnerRadius, -p.GetConstant());
 	mInnerRadius = max(0.0f, mInnerRadius); // Clamp against zero, this should do nothing as the shape is centered around the center of mass but for flat convex hulls there may be numerical round off issues
 
+	// Calculate the vertex neighbors for the support function
+	CalculateVertexNeighbors();
+
 	outResult.Set(this);
 }
 
+void ConvexHullShape::CalculateVertexNeighbors()
+{
+	mNeighborStart.clear();
+	mNeighbors.clear();
+
+	// For small hulls testing all points is faster
+	if (mPoints.size() < cMinPointsForHillClimbing)
+		return;
+
+	// Collect all edges of all faces in both directions, encoded as (start vertex << 8) | end vertex
+	Array<uint16> edges;
+	edges.reserve(2 * mVertexIdx.size());
+	for (const Face &f : mFaces)
+	{
+		const uint8 *first_vtx = mVertexIdx.data() + f.mFirstVertex;
+		for (uint i = 0, j = f.mNumVertices - 1; i < f.mNumVertices; j = i++)
+		{
+			edges.push_back(uint16((first_vtx[j] << 8) | first_vtx[i]));
+			edges.push_back(uint16((first_vtx[i] << 8) | first_vtx[j]));
+		}
+	}
+
+	// Sort so that all edges that start at the same vertex are consecutive
+	QuickSort(edges.begin(), edges.end());
+
+	// Store the unique neighbors of each vertex
+	mNeighborStart.resize(mPoints.size() + 1);
+	mNeighbors.reserve(edges.size() / 2);
+	Array<uint16>::const_iterator e = edges.begin();
+	for (uint v = 0; v < mPoints.size(); ++v)
+	{
+		mNeighborStart[v] = uint16(mNeighbors.size());
+		for (uint16 prev_edge = 0xffff; e != edges.end() && (*e >> 8) == v; ++e)
+			if (*e != prev_edge)
+			{
+				mNeighbors.push_back(uint8(*e));
+				prev_edge = *e;
+			}
+	}
+	mNeighborStart[mPoints.size()] = uint16(mNeighbors.size());
+}
+
+template <class GetPosition>
+inline uint ConvexHullShape::FindSupportVertex(uint inStartVertex, Vec3Arg inDirection, const GetPosition &inGetPosition) const
+{
+	JPH_ASSERT(UseHillClimbing());
+
+	JPH_ASSERT(inStartVertex < mPoints.size());
+	uint vertex = inStartVertex;
+	float best_dot = inGetPosition(vertex).Dot(inDirection);
+
+	for (;;)
+	{
+		// Find the neighbor with the highest projection on inDirection
+		uint best_vertex = vertex;
+		for (const uint8 *n = mNeighbors.data() + mNeighborStart[vertex], *n_end = mNeighbors.data() + mNeighborStart[vertex + 1]; n < n_end; ++n)
+		{
+			float dot = inGetPosition(*n).Dot(inDirection);
+			if (dot > best_dot)
+			{
+				best_dot = dot;
+				best_vertex = *n;
+			}
+		}
+
+		// If no neighbor is better, we've found the support vertex
+		if (best_vertex == vertex)
+			return vertex;
+		vertex = best_vertex;
+	}
+}
+
 MassProperties ConvexHullShape::GetMassProperties() const
 {
 	MassProperties p;
@@ -457,6 +533,13 @@ public:
 
 	virtual Vec3			GetSupport(Vec3Arg inDirection) const override
 	{
+		// Walk over the edges of the hull, starting at the vertex that we returned last time
+		if (mShape->UseHillClimbing())
+		{
+			mLastVertex = mShape->FindSupportVertex(mLastVertex, inDirection, [this](uint inIndex) { return mShape->mPoints[inIndex].mPosition; });
+			return mShape->mPoints[mLastVertex].mPosition;
+		}
+
 		// Find the point with the highest projection on inDirection
 		float best_dot = -FLT_MAX;
 		Vec3 best_point = Vec3::sZero();
@@ -480,8 +563,21 @@ public:
 		return 0.0f;
 	}
 
+	virtual uint			GetSupportHint() const override
+	{
+		return mShape->UseHillClimbing()? mLastVertex : cNoSupportHint;
+	}
+
+	virtual void			SetSupportHint(uint inHint) const override
+	{
+		// The hint may come from another hull, only accept it if it is a valid vertex
+		if (inHint < mShape->mPoints.size())
+			mLastVertex = inHint;
+	}
+
 private:
 	const ConvexHullShape *	mShape;
+	mutable uint			mLastVertex = 0;
 };
 
 class ConvexHullShape::HullWithConvexScaled final : public Support
@@ -497,6 +593,13 @@ public:
 
 	virtual Vec3			GetSupport(Vec3Arg inDirection) const override
 	{
+		// Walk over the edges of the unscaled hull, (scale * point) . direction = point . (scale * direction)
+		if (mShape->UseHillClimbing())
+		{
+			mLastVertex = mShape->FindSupportVertex(mLastVertex, mScale * inDirection, [this](uint inIndex) { return mShape->mPoints[inIndex].mPosition; });
+			return mScale * mShape->mPoints[mLastVertex].mPosition;
+		}
+
 		// Find the point with the highest projection on inDirection
 		float best_dot = -FLT_MAX;
 		Vec3 best_point = Vec3::sZero();
@@ -523,9 +626,22 @@ public:
 		return 0.0f;
 	}
 
+	virtual uint			GetSupportHint() const override
+	{
+		return mShape->UseHillClimbing()? mLastVertex : cNoSupportHint;
+	}
+
+	virtual void			SetSupportHint(uint inHint) const override
+	{
+		// The hint may come from another hull, only accept it if it is a valid vertex
+		if (inHint < mShape->mPoints.size())
+			mLastVertex = inHint;
+	}
+
 private:
 	const ConvexHullShape *	mShape;
 	Vec3					mScale;
+	mutable uint			mLastVertex = 0;
 };
 
 const ConvexShape::Support *ConvexHullShape::GetSupportFunction(ESupportMode inMode, SupportBuffer &inBuffer, Vec3Arg inScale) const
@@ -1283,6 +1399,8 @@ void ConvexHullShape::RestoreBinaryState(StreamIn &inStream)
 	inStream.Read(mConvexRadius);
 	inStream.Read(mVolume);
 	inStream.Read(mInnerRadius);
+
+	CalculateVertexNeighbors();
 }
 
 Shape::Stats ConvexHullShape::GetStats() const
@@ -1297,7 +1415,9 @@ Shape::Stats ConvexHullShape::GetStats() const
 			+ mPoints.size() * sizeof(Point)
 			+ mFaces.size() * sizeof(Face)
 			+ mPlanes.size() * sizeof(Plane)
-			+ mVertexIdx.size() * sizeof(uint8),
+			+ mVertexIdx.size() * sizeof(uint8)
+			+ mNeighborStart.size() * sizeof(uint16)
+			+ mNeighbors.size() * sizeof(uint8),
 		triangle_count);
 }
 
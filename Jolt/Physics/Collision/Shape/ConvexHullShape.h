@@ -164,6 +164,20 @@ private:
 	class					HullWithConvex;
 	class					HullWithConvexScaled;
 
+	/// Hulls with at least this many points find their support point by walking over the edges of the hull instead of testing all points
+	static constexpr uint	cMinPointsForHillClimbing = 32;
+
+	/// Fill mNeighborStart and mNeighbors from the faces of the hull (only for hulls with at least cMinPointsForHillClimbing points)
+	void					CalculateVertexNeighbors();
+
+	/// Check if the support point is found by walking over the edges of the hull
+	inline bool				UseHillClimbing() const		{ return !mNeighborStart.empty(); }
+
+	/// Find the vertex with the highest projection on inDirection by repeatedly moving to the neighboring vertex with the highest projection, starting at inStartVertex.
+	/// Because the hull is convex, the vertex where this stops is the support vertex. inGetPosition(index) returns the position of a vertex.
+	template <class GetPosition>
+	inline uint				FindSupportVertex(uint inStartVertex, Vec3Arg inDirection, const GetPosition &inGetPosition) const;
+
 	struct Face
 	{
 		uint16				mFirstVertex;				///< First index in mVertexIdx to use
@@ -190,6 +204,8 @@ private:
 	Array<Face>				mFaces;						///< Faces of the convex hull surface
 	Array<Plane>			mPlanes;					///< Planes for the faces (1-on-1 with mFaces array, separate because they need to be 16 byte aligned)
 	Array<uint8>			mVertexIdx;					///< A list of vertex indices (indexing in mPoints) for each of the faces
+	Array<uint16>			mNeighborStart;				///< For each point the first index in mNeighbors (+ 1 extra entry to mark the end), empty when hill climbing is not used. Not serialized but recalculated.
+	Array<uint8>			mNeighbors;					///< Indices of the points that share an edge with a point (indexing in mPoints)
 	float					mConvexRadius = 0.0f;		///< Convex radius
 	float					mVolume;					///< Total volume of the convex hull
 	float					mInnerRadius = FLT_MAX;		///< Radius of the biggest sphere that fits entirely in the convex hull
@@ -25,6 +25,30 @@
 
 JPH_NAMESPACE_BEGIN
 
+/// Start the search for support points where the previous query between the same pair of shapes left off
+static inline void sLoadSupportHints(const CollideShapeWarmStart *inWarmStart, const ConvexShape::Support *inSupport1, const ConvexShape::Support *inSupport2)
+{
+	if (inWarmStart != nullptr)
+	{
+		inSupport1->SetSupportHint(inWarmStart->mSupportHint1);
+		inSupport2->SetSupportHint(inWarmStart->mSupportHint2);
+	}
+}
+
+/// Remember where the search for support points ended, only for support functions that use a hint so that we don't overwrite the hint of the other support mode
+static inline void sStoreSupportHints(const ConvexShape::Support *inSupport1, const ConvexShape::Support *inSupport2, CollideShapeWarmStart *ioWarmStart)
+{
+	if (ioWarmStart != nullptr)
+	{
+		uint hint1 = inSupport1->GetSupportHint();
+		if (hint1 != ConvexShape::Support::cNoSupportHint)
+			ioWarmStart->mSupportHint1 = uint8(hint1);
+		uint hint2 = inSupport2->GetSupportHint();
+		if (hint2 != ConvexShape::Support::cNoSupportHint)
+			ioWarmStart->mSupportHint2 = uint8(hint2);
+	}
+}
+
 JPH_IMPLEMENT_SERIALIZABLE_ABSTRACT(ConvexShapeSettings)
 {
 	JPH_ADD_BASE_CLASS(ConvexShapeSettings, ShapeSettings)
@@ -65,14 +89,8 @@ void ConvexShape::sCollideConvexVsConvex(const Shape *inShape1, const Shape *inS
 	if (!OrientedBox(transform_2_to_1, shape2_bbox).Overlaps(shape1_bbox))
 		return;
 
-	// Note: As we don't remember the penetration axis from the last iteration, and it is likely that shape2 is pushed out of
-	// collision relative to shape1 by comparing their COM's, we use that as an initial penetration axis: shape2.com - shape1.com
-	// This has been seen to improve performance by approx. 1% over using a fixed axis like (1, 0, 0).
-	Vec3 penetration_axis = transform_2_to_1.GetTranslation();
-
-	// Ensure that we do not pass in a near zero penetration axis
-	if (penetration_axis.IsNearZero())
-		penetration_axis = Vec3::sAxisX();
+	// Get the axis to start GJK with
+	Vec3 penetration_axis = sGetInitialPenetrationAxis(transform_2_to_1, inCollideShapeSettings);
 
 	Vec3 point1, point2;
 	EPAPenetrationDepth pen_depth;
@@ -85,11 +103,18 @@ void ConvexShape::sCollideConvexVsConvex(const Shape *inShape1, const Shape *inS
 		const Support *shape1_excl_cvx_radius = shape1->GetSupportFunction(ConvexShape::ESupportMode::ExcludeConvexRadius, buffer1_excl_cvx_radius, inScale1);
 		const Support *shape2_excl_cvx_radius = shape2->GetSupportFunction(ConvexShape::ESupportMode::ExcludeConvexRadius, buffer2_excl_cvx_radius, inScale2);
 
+		// Continue searching for support points where the previous query left off
+		sLoadSupportHints(inCollideShapeSettings.mWarmStart, shape1_excl_cvx_radius, shape2_excl_cvx_radius);
+
 		// Transform shape 2 in the space of shape 1
 		TransformedConvexObject<Support> transformed2_excl_cvx_radius(transform_2_to_1, *shape2_excl_cvx_radius);
 
 		// Perform GJK step
 		status = pen_depth.GetPenetrationDepthStepGJK(*shape1_excl_cvx_radius, shape1_excl_cvx_radius->GetConvexRadius() + inCollideShapeSettings.mMaxSeparationDistance, transformed2_excl_cvx_radius, shape2_excl_cvx_radius->GetConvexRadius(), inCollideShapeSettings.mCollisionTolerance, penetration_axis, point1, point2);
+
+		// Remember the axis and where the search ended for the next query
+		sStorePenetrationAxis(penetration_axis, inCollideShapeSettings.mWarmStart);
+		sStoreSupportHints(shape1_excl_cvx_radius, shape2_excl_cvx_radius, inCollideShapeSettings.mWarmStart);
 	}
 
 	// Check result of collision detection
@@ -110,6 +135,9 @@ void ConvexShape::sCollideConvexVsConvex(const Shape *inShape1, const Shape *inS
 			const Support *shape1_incl_cvx_radius = shape1->GetSupportFunction(ConvexShape::ESupportMode::IncludeConvexRadius, buffer1_incl_cvx_radius, inScale1);
 			const Support *shape2_incl_cvx_radius = shape2->GetSupportFunction(ConvexShape::ESupportMode::IncludeConvexRadius, buffer2_incl_cvx_radius, inScale2);
 
+			// Start searching for support points where the GJK step or the previous query left off
+			sLoadSupportHints(inCollideShapeSettings.mWarmStart, shape1_incl_cvx_radius, shape2_incl_cvx_radius);
+
 			// Add separation distance
 			AddConvexRadius<Support> shape1_add_max_separation_distance(*shape1_incl_cvx_radius, inCollideShapeSettings.mMaxSeparationDistance);
 
@@ -119,24 +147,63 @@ void ConvexShape::sCollideConvexVsConvex(const Shape *inShape1, const Shape *inS
 			// Perform EPA step
 			if (!pen_depth.GetPenetrationDepthStepEPA(shape1_add_max_separation_distance, transformed2_incl_cvx_radius, inCollideShapeSettings.mPenetrationTolerance, penetration_axis, point1, point2))
 				return;
+
+			// Remember the axis and where the search ended for the next query
+			sStorePenetrationAxis(penetration_axis, inCollideShapeSettings.mWarmStart);
+			sStoreSupportHints(shape1_incl_cvx_radius, shape2_incl_cvx_radius, inCollideShapeSettings.mWarmStart);
 			break;
 		}
 	}
 
+	sAddConvexVsConvexHit(shape1, shape2, inScale1, inScale2, inCenterOfMassTransform1, inCenterOfMassTransform2, transform_2_to_1, inSubShapeIDCreator1, inSubShapeIDCreator2, inCollideShapeSettings, penetration_axis, point1, point2, ioCollector);
+}
+
+Vec3 ConvexShape::sGetInitialPenetrationAxis(Mat44Arg inTransform2To1, const CollideShapeSettings &inCollideShapeSettings)
+{
+	// If a previous query between these shapes found an axis, start with that. For shapes that rest on each other GJK will often terminate after the first iteration.
+	if (inCollideShapeSettings.mWarmStart != nullptr)
+	{
+		Vec3 axis(inCollideShapeSettings.mWarmStart->mPenetrationAxis);
+		if (!axis.IsNearZero())
+			return axis;
+	}
+
+	// It is likely that shape2 is pushed out of collision relative to shape1 by comparing their COM's, so we use that as an initial penetration axis: shape2.com - shape1.com
+	// This has been seen to improve performance by approx. 1% over using a fixed axis like (1, 0, 0).
+	Vec3 penetration_axis = inTransform2To1.GetTranslation();
+
+	// Ensure that we do not pass in a near zero penetration axis
+	if (penetration_axis.IsNearZero())
+		penetration_axis = Vec3::sAxisX();
+
+	return penetration_axis;
+}
+
+void ConvexShape::sStorePenetrationAxis(Vec3Arg inPenetrationAxis, CollideShapeWarmStart *ioWarmStart)
+{
+	// Only store a valid axis, the magnitude of the axis is meaningless so we normalize it
+	float len_sq = inPenetrationAxis.LengthSq();
+	if (ioWarmStart != nullptr && len_sq > 1.0e-12f && len_sq < FLT_MAX)
+		(inPenetrationAxis / sqrt(len_sq)).StoreFloat3(&ioWarmStart->mPenetrationAxis);
+}
+
+void ConvexShape::sAddConvexVsConvexHit(const ConvexShape *inShape1, const ConvexShape *inShape2, Vec3Arg inScale1, Vec3Arg inScale2, Mat44Arg inCenterOfMassTransform1, Mat44Arg inCenterOfMassTransform2, Mat44Arg inTransform2To1, const SubShapeIDCreator &inSubShapeIDCreator1, const SubShapeIDCreator &inSubShapeIDCreator2, const CollideShapeSettings &inCollideShapeSettings, Vec3Arg inPenetrationAxis, Vec3Arg inPoint1, Vec3Arg inPoint2, CollideShapeCollector &ioCollector)
+{
 	// Check if the penetration is bigger than the early out fraction
-	float penetration_depth = (point2 - point1).Length() - inCollideShapeSettings.mMaxSeparationDistance;
+	float penetration_depth = (inPoint2 - inPoint1).Length() - inCollideShapeSettings.mMaxSeparationDistance;
 	if (-penetration_depth >= ioCollector.GetEarlyOutFraction())
 		return;
 
 	// Correct point1 for the added separation distance
-	float penetration_axis_len = penetration_axis.Length();
+	Vec3 point1 = inPoint1;
+	float penetration_axis_len = inPenetrationAxis.Length();
 	if (penetration_axis_len > 0.0f)
-		point1 -= penetration_axis * (inCollideShapeSettings.mMaxSeparationDistance / penetration_axis_len);
+		point1 -= inPenetrationAxis * (inCollideShapeSettings.mMaxSeparationDistance / penetration_axis_len);
 
 	// Convert to world space
 	point1 = inCenterOfMassTransform1 * point1;
-	point2 = inCenterOfMassTransform1 * point2;
-	Vec3 penetration_axis_world = inCenterOfMassTransform1.Multiply3x3(penetration_axis);
+	Vec3 point2 = inCenterOfMassTransform1 * inPoint2;
+	Vec3 penetration_axis_world = inCenterOfMassTransform1.Multiply3x3(inPenetrationAxis);
 
 	// Create collision result
 	CollideShapeResult result(point1, point2, penetration_axis_world, penetration_depth, inSubShapeIDCreator1.GetID(), inSubShapeIDCreator2.GetID(), TransformedShape::sGetBodyID(ioCollector.GetContext()));
@@ -145,10 +212,10 @@ void ConvexShape::sCollideConvexVsConvex(const Shape *inShape1, const Shape *inS
 	if (inCollideShapeSettings.mCollectFacesMode == ECollectFacesMode::CollectFaces)
 	{
 		// Get supporting face of shape 1
-		shape1->GetSupportingFace(SubShapeID(), -penetration_axis, inScale1, inCenterOfMassTransform1, result.mShape1Face);
+		inShape1->GetSupportingFace(SubShapeID(), -inPenetrationAxis, inScale1, inCenterOfMassTransform1, result.mShape1Face);
 
 		// Get supporting face of shape 2
-		shape2->GetSupportingFace(SubShapeID(), transform_2_to_1.Multiply3x3Transposed(penetration_axis), inScale2, inCenterOfMassTransform2, result.mShape2Face);
+		inShape2->GetSupportingFace(SubShapeID(), inTransform2To1.Multiply3x3Transposed(inPenetrationAxis), inScale2, inCenterOfMassTransform2, result.mShape2Face);
 	}
 
 	// Notify the collector
@@ -12,6 +12,7 @@
 JPH_NAMESPACE_BEGIN
 
 class CollideShapeSettings;
+class CollideShapeWarmStart;
 
 /// Class that constructs a ConvexShape (abstract)
 class JPH_EXPORT ConvexShapeSettings : public ShapeSettings
@@ -78,6 +79,14 @@ public:
 		/// Convex radius of shape. Collision detection on penetrating shapes is much more expensive,
 		/// so you can add a radius around objects to increase the shape. This makes it far less likely that they will actually penetrate.
 		virtual float				GetConvexRadius() const = 0;
+
+		/// Shapes with many vertices can walk from vertex to vertex to find the support point. Because subsequent calls to GetSupport
+		/// usually use similar directions, the walk starts at the vertex that was returned last. These functions get / set that vertex
+		/// so that a query can continue where the previous query of the same pair left off (see CollideShapeWarmStart).
+		/// Any value is allowed as hint, shapes that don't walk ignore it and return cNoSupportHint.
+		static constexpr uint		cNoSupportHint = ~uint(0);
+		virtual uint				GetSupportHint() const									{ return cNoSupportHint; }
+		virtual void				SetSupportHint([[maybe_unused]] uint inHint) const		{ }
 	};
 
 	/// Buffer to hold a Support object, used to avoid dynamic memory allocations
@@ -134,14 +143,24 @@ protected:
 	/// Vertex list that forms a unit sphere
 	static const StaticArray<Vec3, 384> sUnitSphereTriangles;
 
+	/// Report a hit for a pair of convex shapes to ioCollector, used by sCollideConvexVsConvex and by specialized collision functions of derived classes.
+	/// inPenetrationAxis, inPoint1 and inPoint2 are in the space of shape 1, where inPoint1 is expanded by the max separation distance along inPenetrationAxis (see EPAPenetrationDepth::GetPenetrationDepth).
+	static void						sAddConvexVsConvexHit(const ConvexShape *inShape1, const ConvexShape *inShape2, Vec3Arg inScale1, Vec3Arg inScale2, Mat44Arg inCenterOfMassTransform1, Mat44Arg inCenterOfMassTransform2, Mat44Arg inTransform2To1, const SubShapeIDCreator &inSubShapeIDCreator1, const SubShapeIDCreator &inSubShapeIDCreator2, const CollideShapeSettings &inCollideShapeSettings, Vec3Arg inPenetrationAxis, Vec3Arg inPoint1, Vec3Arg inPoint2, CollideShapeCollector &ioCollector);
+
+	/// Generic convex vs convex collision function using GJK / EPA. Registered in CollisionDispatch for all pairs of convex shapes and used as fallback by specialized collision functions of derived classes.
+	static void						sCollideConvexVsConvex(const Shape *inShape1, const Shape *inShape2, Vec3Arg inScale1, Vec3Arg inScale2, Mat44Arg inCenterOfMassTransform1, Mat44Arg inCenterOfMassTransform2, const SubShapeIDCreator &inSubShapeIDCreator1, const SubShapeIDCreator &inSubShapeIDCreator2, const CollideShapeSettings &inCollideShapeSettings, CollideShapeCollector &ioCollector, const ShapeFilter &inShapeFilter);
+
 private:
 	// Class for GetTrianglesStart/Next
 	class							CSGetTrianglesContext;
 
 	// Helper functions called by CollisionDispatch
-	static void						sCollideConvexVsConvex(const Shape *inShape1, const Shape *inShape2, Vec3Arg inScale1, Vec3Arg inScale2, Mat44Arg inCenterOfMassTransform1, Mat44Arg inCenterOfMassTransform2, const SubShapeIDCreator &inSubShapeIDCreator1, const SubShapeIDCreator &inSubShapeIDCreator2, const CollideShapeSettings &inCollideShapeSettings, CollideShapeCollector &ioCollector, const ShapeFilter &inShapeFilter);
 	static void						sCastConvexVsConvex(const ShapeCast &inShapeCast, const ShapeCastSettings &inShapeCastSettings, const Shape *inShape, Vec3Arg inScale, const ShapeFilter &inShapeFilter, Mat44Arg inCenterOfMassTransform2, const SubShapeIDCreator &inSubShapeIDCreator1, const SubShapeIDCreator &inSubShapeIDCreator2, CastShapeCollector &ioCollector);
 
+	// Helper functions for sCollideConvexVsConvex
+	static Vec3						sGetInitialPenetrationAxis(Mat44Arg inTransform2To1, const CollideShapeSettings &inCollideShapeSettings);
+	static void						sStorePenetrationAxis(Vec3Arg inPenetrationAxis, CollideShapeWarmStart *ioWarmStart);
+
 	// Properties
 	RefConst<PhysicsMaterial>		mMaterial;													///< Material assigned to this shape
 	float							mDensity = 1000.0f;											///< Uniform density of the interior of the convex object (kg / m^3)
@@ -0,0 +1,173 @@
+// Jolt Physics Library (https://github.com/jrouwe/JoltPhysics)
+// SPDX-FileCopyrightText: 2024 Jorrit Rouwe
+// SPDX-License-Identifier: MIT
+
+#pragma once
+
+#include <Jolt/Physics/Body/MotionProperties.h>
+#include <Jolt/Physics/DeterminismLog.h>
+
+JPH_NAMESPACE_BEGIN
+
+/// Memory efficient version of AxisConstraintPart that only supports a velocity bias (no springs).
+///
+/// AxisConstraintPart stores r1 x n, r2 x n, I1^-1 (r1 x n) and I2^-1 (r2 x n) for every axis, which takes 48 bytes.
+/// This part only stores the effective mass, bias and accumulated lambda and recalculates the other quantities from
+/// r1, r2, I1^-1 and I2^-1 when they're needed. These are passed in by the caller so that they can be shared between
+/// multiple axis (e.g. the non-penetration and friction axis of a contact point). All calculations are done in exactly
+/// the same way as in AxisConstraintPart, so both give bit-identical results.
+///
+/// See AxisConstraintPart for the equations and the meaning of the terms.
+class CompactAxisConstraintPart
+{
+	/// Internal helper function to update velocities of bodies after Lagrange multiplier is calculated
+	template <EMotionType Type1, EMotionType Type2>
+	JPH_INLINE static bool		sApplyVelocityStep(MotionProperties *ioMotionProperties1, float inInvMass1, Mat44Arg inInvI1, Vec3Arg inR1PlusU, MotionProperties *ioMotionProperties2, float inInvMass2, Mat44Arg inInvI2, Vec3Arg inR2, Vec3Arg inWorldSpaceAxis, float inLambda)
+	{
+		// Apply impulse if delta is not zero
+		if (inLambda != 0.0f)
+		{
+			if constexpr (Type1 == EMotionType::Dynamic)
+			{
+				ioMotionProperties1->SubLinearVelocityStep((inLambda * inInvMass1) * inWorldSpaceAxis);
+				ioMotionProperties1->SubAngularVelocityStep(inLambda * inInvI1.Multiply3x3(inR1PlusU.Cross(inWorldSpaceAxis)));
+			}
+			if constexpr (Type2 == EMotionType::Dynamic)
+			{
+				ioMotionProperties2->AddLinearVelocityStep((inLambda * inInvMass2) * inWorldSpaceAxis);
+				ioMotionProperties2->AddAngularVelocityStep(inLambda * inInvI2.Multiply3x3(inR2.Cross(inWorldSpaceAxis)));
+			}
+			return true;
+		}
+
+		return false;
+	}
+
+public:
+	/// Calculate properties used during the functions below, has the same signature as AxisConstraintPart::TemplatedCalculateConstraintProperties
+	template <EMotionType Type1, EMotionType Type2>
+	JPH_INLINE void				TemplatedCalculateConstraintProperties(float inInvMass1, Mat44Arg inInvI1, Vec3Arg inR1PlusU, float inInvMass2, Mat44Arg inInvI2, Vec3Arg inR2, Vec3Arg inWorldSpaceAxis, float inBias = 0.0f)
+	{
+		JPH_ASSERT(inWorldSpaceAxis.IsNormalized(1.0e-5f));
+
+		// Calculate inverse effective mass: K = J M^-1 J^T
+		float inv_effective_mass;
+
+		if constexpr (Type1 == EMotionType::Dynamic)
+		{
+			Vec3 r1_plus_u_x_axis = inR1PlusU.Cross(inWorldSpaceAxis);
+			inv_effective_mass = inInvMass1 + inInvI1.Multiply3x3(r1_plus_u_x_axis).Dot(r1_plus_u_x_axis);
+		}
+		else
+			inv_effective_mass = 0.0f;
+
+		if constexpr (Type2 == EMotionType::Dynamic)
+		{
+			Vec3 r2_x_axis = inR2.Cross(inWorldSpaceAxis);
+			inv_effective_mass += inInvMass2 + inInvI2.Multiply3x3(r2_x_axis).Dot(r2_x_axis);
+		}
+
+		if (inv_effective_mass == 0.0f)
+			Deactivate();
+		else
+		{
+			mEffectiveMass = 1.0f / inv_effective_mass;
+			mBias = inBias;
+		}
+
+		JPH_DET_LOG("TemplatedCalculateConstraintProperties: invM1: " << inInvMass1 << " invI1: " << inInvI1 << " r1PlusU: " << inR1PlusU << " invM2: " << inInvMass2 << " invI2: " << inInvI2 << " r2: " << inR2 << " bias: " << inBias << " effectiveMass: " << mEffectiveMass << " totalLambda: " << mTotalLambda);
+	}
+
+	/// Deactivate this constraint
+	inline void					Deactivate()
+	{
+		mEffectiveMass = 0.0f;
+		mTotalLambda = 0.0f;
+	}
+
+	/// Check if constraint is active
+	inline bool					IsActive() const
+	{
+		return mEffectiveMass != 0.0f;
+	}
+
+	/// Templated form of WarmStart with the motion types baked in
+	template <EMotionType Type1, EMotionType Type2>
+	inline void					TemplatedWarmStart(MotionProperties *ioMotionProperties1, float inInvMass1, Mat44Arg inInvI1, Vec3Arg inR1PlusU, MotionProperties *ioMotionProperties2, float inInvMass2, Mat44Arg inInvI2, Vec3Arg inR2, Vec3Arg inWorldSpaceAxis, float inWarmStartImpulseRatio)
+	{
+		mTotalLambda *= inWarmStartImpulseRatio;
+
+		sApplyVelocityStep<Type1, Type2>(ioMotionProperties1, inInvMass1, inInvI1, inR1PlusU, ioMotionProperties2, inInvMass2, inInvI2, inR2, inWorldSpaceAxis, mTotalLambda);
+	}
+
+	/// Templated form of SolveVelocityConstraint with the motion types baked in, part 1: get the total lambda
+	template <EMotionType Type1, EMotionType Type2>
+	JPH_INLINE float			TemplatedSolveVelocityConstraintGetTotalLambda(const MotionProperties *ioMotionProperties1, Vec3Arg inR1PlusU, const MotionProperties *ioMotionProperties2, Vec3Arg inR2, Vec3Arg inWorldSpaceAxis) const
+	{
+		// Calculate jacobian multiplied by linear velocity
+		float jv;
+		if constexpr (Type1 != EMotionType::Static && Type2 != EMotionType::Static)
+			jv = inWorldSpaceAxis.Dot(ioMotionProperties1->GetLinearVelocity() - ioMotionProperties2->GetLinearVelocity());
+		else if constexpr (Type1 != EMotionType::Static)
+			jv = inWorldSpaceAxis.Dot(ioMotionProperties1->GetLinearVelocity());
+		else if constexpr (Type2 != EMotionType::Static)
+			jv = inWorldSpaceAxis.Dot(-ioMotionProperties2->GetLinearVelocity());
+		else
+			JPH_ASSERT(false); // Static vs static is nonsensical!
+
+		// Calculate jacobian multiplied by angular velocity
+		if constexpr (Type1 != EMotionType::Static)
+			jv += inR1PlusU.Cross(inWorldSpaceAxis).Dot(ioMotionProperties1->GetAngularVelocity());
+		if constexpr (Type2 != EMotionType::Static)
+			jv -= inR2.Cross(inWorldSpaceAxis).Dot(ioMotionProperties2->GetAngularVelocity());
+
+		// Lagrange multiplier is:
+		//
+		// lambda = -K^-1 (J v + b)
+		float lambda = mEffectiveMass * (jv - mBias);
+
+		// Return the total accumulated lambda
+		return mTotalLambda + lambda;
+	}
+
+	/// Templated form of SolveVelocityConstraint with the motion types baked in, part 2: apply new lambda
+	template <EMotionType Type1, EMotionType Type2>
+	JPH_INLINE bool				TemplatedSolveVelocityConstraintApplyLambda(MotionProperties *ioMotionProperties1, float inInvMass1, Mat44Arg inInvI1, Vec3Arg inR1PlusU, MotionProperties *ioMotionProperties2, float inInvMass2, Mat44Arg inInvI2, Vec3Arg inR2, Vec3Arg inWorldSpaceAxis, float inTotalLambda)
+	{
+		float delta_lambda = inTotalLambda - mTotalLambda; // Calculate change in lambda
+		mTotalLambda = inTotalLambda; // Store accumulated impulse
+
+		return sApplyVelocityStep<Type1, Type2>(ioMotionProperties1, inInvMass1, inInvI1, inR1PlusU, ioMotionProperties2, inInvMass2, inInvI2, inR2, inWorldSpaceAxis, delta_lambda);
+	}
+
+	/// Templated form of SolveVelocityConstraint with the motion types baked in
+	template <EMotionType Type1, EMotionType Type2>
+	inline bool					TemplatedSolveVelocityConstraint(MotionProperties *ioMotionProperties1, float inInvMass1, Mat44Arg inInvI1, Vec3Arg inR1PlusU, MotionProperties *ioMotionProperties2, float inInvMass2, Mat44Arg inInvI2, Vec3Arg inR2, Vec3Arg inWorldSpaceAxis, float inMinLambda, float inMaxLambda)
+	{
+		float total_lambda = TemplatedSolveVelocityConstraintGetTotalLambda<Type1, Type2>(ioMotionProperties1, inR1PlusU, ioMotionProperties2, inR2, inWorldSpaceAxis);
+
+		// Clamp impulse to specified range
+		total_lambda = Clamp(total_lambda, inMinLambda, inMaxLambda);
+
+		return TemplatedSolveVelocityConstraintApplyLambda<Type1, Type2>(ioMotionProperties1, inInvMass1, inInvI1, inR1PlusU, ioMotionProperties2, inInvMass2, inInvI2, inR2, inWorldSpaceAxis, total_lambda);
+	}
+
+	/// Override total lagrange multiplier, can be used to set the initial value for warm starting
+	inline void					SetTotalLambda(float inLambda)
+	{
+		mTotalLambda = inLambda;
+	}
+
+	/// Return lagrange multiplier
+	inline float				GetTotalLambda() const
+	{
+		return mTotalLambda;
+	}
+
+private:
+	float						mEffectiveMass = 0.0f;
+	float						mBias = 0.0f;
+	float						mTotalLambda = 0.0f;
+};
+
+JPH_NAMESPACE_END
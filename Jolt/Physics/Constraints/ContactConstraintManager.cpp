@@ -34,14 +34,14 @@ bool ContactConstraintManager::sDrawContactManifolds = false;
 // ContactConstraintManager::WorldContactPoint
 ////////////////////////////////////////////////////////////////////////////////////////////////////////
 
-void ContactConstraintManager::WorldContactPoint::CalculateNonPenetrationConstraintProperties(const Body &inBody1, float inInvMass1, float inInvInertiaScale1, const Body &inBody2, float inInvMass2, float inInvInertiaScale2, RVec3Arg inWorldSpacePosition1, RVec3Arg inWorldSpacePosition2, Vec3Arg inWorldSpaceNormal)
+void ContactConstraintManager::WorldContactPoint::sCalculateNonPenetrationConstraintProperties(AxisConstraintPart &outConstraintPart, const Body &inBody1, float inInvMass1, float inInvInertiaScale1, const Body &inBody2, float inInvMass2, float inInvInertiaScale2, RVec3Arg inWorldSpacePosition1, RVec3Arg inWorldSpacePosition2, Vec3Arg inWorldSpaceNormal)
 {
 	// Calculate collision points relative to body
 	RVec3 p = 0.5_r * (inWorldSpacePosition1 + inWorldSpacePosition2);
 	Vec3 r1 = Vec3(p - inBody1.GetCenterOfMassPosition());
 	Vec3 r2 = Vec3(p - inBody2.GetCenterOfMassPosition());
 
-	mNonPenetrationConstraint.CalculateConstraintPropertiesWithMassOverride(inBody1, inInvMass1, inInvInertiaScale1, r1, inBody2, inInvMass2, inInvInertiaScale2, r2, inWorldSpaceNormal);
+	outConstraintPart.CalculateConstraintPropertiesWithMassOverride(inBody1, inInvMass1, inInvInertiaScale1, r1, inBody2, inInvMass2, inInvInertiaScale2, r2, inWorldSpaceNormal);
 }
 
 template <EMotionType Type1, EMotionType Type2>
@@ -105,6 +105,12 @@ JPH_INLINE void ContactConstraintManager::WorldContactPoint::TemplatedCalculateF
 		normal_velocity_bias = speculative_contact_velocity_bias;
 	}
 
+#ifdef JPH_COMPACT_CONTACT_CONSTRAINTS
+	// Store the lever arms so that the solver can recalculate the quantities that AxisConstraintPart would store
+	r1.StoreFloat3(&mR1);
+	r2.StoreFloat3(&mR2);
+#endif // JPH_COMPACT_CONTACT_CONSTRAINTS
+
 	mNonPenetrationConstraint.TemplatedCalculateConstraintProperties<Type1, Type2>(inInvM1, inInvI1, r1, inInvM2, inInvI2, r2, inWorldSpaceNormal, normal_velocity_bias);
 
 	// Calculate friction part
@@ -214,25 +220,39 @@ void ContactConstraintManager::CachedBodyPair::SaveState(StateRecorder &inStream
 {
 	inStream.Write(mDeltaPosition);
 	inStream.Write(mDeltaRotation);
+	inStream.Write(mWarmStart);
 }
 
 void ContactConstraintManager::CachedBodyPair::RestoreState(StateRecorder &inStream)
 {
 	inStream.Read(mDeltaPosition);
 	inStream.Read(mDeltaRotation);
+	inStream.Read(mWarmStart);
 }
 
 ////////////////////////////////////////////////////////////////////////////////////////////////////////
 // ContactConstraintManager::ManifoldCache
 ////////////////////////////////////////////////////////////////////////////////////////////////////////
 
-void ContactConstraintManager::ManifoldCache::Init(uint inMaxBodyPairs, uint inMaxContactConstraints, uint inCachedManifoldsSize)
+void ContactConstraintManager::ManifoldCache::Init(uint inMaxBodyPairs, uint inMaxManifolds)
 {
-	mAllocator.Init(inMaxBodyPairs * sizeof(BodyPairMap::KeyValue) + inCachedManifoldsSize);
-	mCachedManifolds.Init(GetNextPowerOf2(inMaxContactConstraints));
+	mMaxBodyPairs = inMaxBodyPairs;
+	mMaxManifolds = inMaxManifolds;
+
+	// Calculate worst case cache usage
+	uint cached_manifolds_size = inMaxManifolds * (sizeof(CachedManifold) + (MaxContactPoints - 1) * sizeof(CachedContactPoint));
+	mAllocatorSize = inMaxBodyPairs * sizeof(BodyPairMap::KeyValue) + cached_manifolds_size;
+
+	mAllocator.Init(mAllocatorSize);
+	mCachedManifolds.Init(GetNextPowerOf2(inMaxManifolds));
 	mCachedBodyPairs.Init(GetNextPowerOf2(inMaxBodyPairs));
 }
 
+uint64 ContactConstraintManager::ManifoldCache::GetMemoryUsage() const
+{
+	return uint64(mAllocatorSize) + uint64(mCachedManifolds.GetMaxBuckets() + mCachedBodyPairs.GetMaxBuckets()) * sizeof(uint32);
+}
+
 void ContactConstraintManager::ManifoldCache::Clear()
 {
 	JPH_PROFILE_FUNCTION();
@@ -367,10 +387,30 @@ void ContactConstraintManager::ManifoldCache::ContactPointRemovedCallbacks(Conta
 	JPH_PROFILE_FUNCTION();
 
 	for (MKeyValue &kv : mCachedManifolds)
-		if ((kv.GetValue().mFlags & uint16(CachedManifold::EFlags::ContactPersisted)) == 0)
+		if ((kv.GetValue().mFlags & uint16(uint16(CachedManifold::EFlags::ContactPersisted) | uint16(CachedManifold::EFlags::NoContactCallbacks))) == 0)
 			inListener->OnContactRemoved(kv.GetKey());
 }
 
+void ContactConstraintManager::ManifoldCache::ContactPointRemovedEvents(ContactConstraintManager &ioManager, ContactAllocator &ioContactAllocator)
+{
+	JPH_PROFILE_FUNCTION();
+
+	for (MKeyValue &kv : mCachedManifolds)
+		if ((kv.GetValue().mFlags & uint16(uint16(CachedManifold::EFlags::ContactPersisted) | uint16(CachedManifold::EFlags::NoContactCallbacks))) == 0)
+		{
+			ContactEvent *event = ioManager.AllocateContactEvent(ioContactAllocator);
+			if (event == nullptr)
+				break; // Event buffer full
+
+			event->mSubShapePair = kv.GetKey();
+			event->SetPosition(RVec3::sZero());
+			event->mWorldSpaceNormal = { 0, 0, 0 };
+			event->mPenetrationDepth = 0.0f;
+			event->mCollisionStep = ioManager.mContactEventStep;
+			event->mType = EContactEventType::Removed;
+		}
+}
+
 #ifdef JPH_ENABLE_ASSERTS
 
 void ContactConstraintManager::ManifoldCache::Finalize()
@@ -622,18 +662,221 @@ ContactConstraintManager::ContactConstraintManager(const PhysicsSettings &inPhys
 ContactConstraintManager::~ContactConstraintManager()
 {
 	JPH_ASSERT(mConstraints == nullptr);
+
+	// Free contact event buffer
+	SetMaxContactEvents(0);
 }
 
 void ContactConstraintManager::Init(uint inMaxBodyPairs, uint inMaxContactConstraints)
 {
+	mMaxBodyPairs = inMaxBodyPairs;
+	mMaxManifolds = inMaxContactConstraints;
 	mMaxConstraints = inMaxContactConstraints;
 
-	// Calculate worst case cache usage
-	uint cached_manifolds_size = inMaxContactConstraints * (sizeof(CachedManifold) + (MaxContactPoints - 1) * sizeof(CachedContactPoint));
-
 	// Init the caches
-	mCache[0].Init(inMaxBodyPairs, inMaxContactConstraints, cached_manifolds_size);
-	mCache[1].Init(inMaxBodyPairs, inMaxContactConstraints, cached_manifolds_size);
+	mCache[0].Init(inMaxBodyPairs, inMaxContactConstraints);
+	mCache[1].Init(inMaxBodyPairs, inMaxContactConstraints);
+}
+
+uint ContactConstraintManager::sGetAdaptedCapacity(uint inCapacity, uint inPeak, uint inWindowPeak, bool inOverflowed, bool inEndOfWindow, const PhysicsSettings &inSettings)
+{
+	// Grow when the capacity was exceeded or when the usage is getting close to the capacity.
+	// When the capacity was exceeded we may not know the real usage, so we grow relative to the capacity.
+	if (inOverflowed || float(inPeak) > inSettings.mContactCacheGrowThreshold * float(inCapacity))
+	{
+		float usage = float(inOverflowed? max(inPeak, inCapacity) : inPeak);
+		return max(inCapacity, min(uint(usage * inSettings.mContactCacheHeadroom), cMaxAdaptiveCapacity));
+	}
+
+	// Shrink when the usage stayed low for mContactCacheShrinkDelay updates
+	if (inEndOfWindow && float(inWindowPeak) < inSettings.mContactCacheShrinkThreshold * float(inCapacity))
+		return min(inCapacity, max(uint(float(inWindowPeak) * inSettings.mContactCacheHeadroom), cMinAdaptiveCapacity));
+
+	return inCapacity;
+}
+
+void ContactConstraintManager::AdaptCapacity(EPhysicsUpdateError inErrors)
+{
+	// Store the usage of this update
+	mLastUpdateStats.mPeakNumBodyPairs = mPeakNumBodyPairs;
+	mLastUpdateStats.mPeakNumManifolds = mPeakNumManifolds;
+	mLastUpdateStats.mPeakNumContactConstraints = mPeakNumConstraints;
+	mWindowPeakNumBodyPairs = max(mWindowPeakNumBodyPairs, mPeakNumBodyPairs);
+	mWindowPeakNumManifolds = max(mWindowPeakNumManifolds, mPeakNumManifolds);
+	mWindowPeakNumConstraints = max(mWindowPeakNumConstraints, mPeakNumConstraints);
+	mPeakNumBodyPairs = 0;
+	mPeakNumManifolds = 0;
+	mPeakNumConstraints = 0;
+
+	if (!mPhysicsSettings.mUseAdaptiveContactCache)
+		return;
+
+	JPH_PROFILE_FUNCTION();
+
+	// Calculate the new capacity
+	bool end_of_window = ++mNumUpdatesInWindow >= mPhysicsSettings.mContactCacheShrinkDelay;
+	uint max_body_pairs = sGetAdaptedCapacity(mMaxBodyPairs, mLastUpdateStats.mPeakNumBodyPairs, mWindowPeakNumBodyPairs, (inErrors & EPhysicsUpdateError::BodyPairCacheFull) != EPhysicsUpdateError::None, end_of_window, mPhysicsSettings);
+	uint max_manifolds = sGetAdaptedCapacity(mMaxManifolds, mLastUpdateStats.mPeakNumManifolds, mWindowPeakNumManifolds, (inErrors & EPhysicsUpdateError::ManifoldCacheFull) != EPhysicsUpdateError::None, end_of_window, mPhysicsSettings);
+	uint max_constraints = sGetAdaptedCapacity(mMaxConstraints, mLastUpdateStats.mPeakNumContactConstraints, mWindowPeakNumConstraints, (inErrors & EPhysicsUpdateError::ContactConstraintsFull) != EPhysicsUpdateError::None, end_of_window, mPhysicsSettings);
+	bool changed = max_body_pairs != mMaxBodyPairs || max_manifolds != mMaxManifolds || max_constraints != mMaxConstraints;
+
+	// Start a new window after a change so that we don't shrink right after growing
+	if (end_of_window || changed)
+	{
+		mWindowPeakNumBodyPairs = 0;
+		mWindowPeakNumManifolds = 0;
+		mWindowPeakNumConstraints = 0;
+		mNumUpdatesInWindow = 0;
+	}
+
+	if (!changed)
+		return;
+
+	++mNumResizes;
+
+	// The constraint buffer is allocated at the start of every update, so it can be resized immediately
+	JPH_ASSERT(mConstraints == nullptr);
+	mMaxConstraints = max_constraints;
+
+	if (max_body_pairs != mMaxBodyPairs || max_manifolds != mMaxManifolds)
+	{
+		mMaxBodyPairs = max_body_pairs;
+		mMaxManifolds = max_manifolds;
+
+		// The write cache is empty in between updates so we can resize it now.
+		// The read cache is still needed by the next update and will be resized in FinalizeContactCacheAndCallContactPointRemovedCallbacks when it is empty.
+		ManifoldCache &write_cache = mCache[mCacheWriteIdx];
+		JPH_ASSERT(write_cache.GetNumBodyPairs() == 0 && write_cache.GetNumManifolds() == 0);
+		write_cache.Init(mMaxBodyPairs, mMaxManifolds);
+		write_cache.Prepare(mLastNumBodyPairs, mLastNumManifolds);
+	}
+}
+
+ContactCacheStats ContactConstraintManager::GetCacheStats() const
+{
+	ContactCacheStats stats = mLastUpdateStats;
+	stats.mMaxBodyPairs = mMaxBodyPairs;
+	stats.mMaxManifolds = mMaxManifolds;
+	stats.mMaxContactConstraints = mMaxConstraints;
+	stats.mCacheMemory = mCache[0].GetMemoryUsage() + mCache[1].GetMemoryUsage();
+	stats.mConstraintBufferMemory = uint64(mReorderConstraints? 2 : 1) * mMaxConstraints * sizeof(ContactConstraint);
+	stats.mNumResizes = mNumResizes;
+	return stats;
+}
+
+void ContactConstraintManager::SetMaxContactEvents(uint inMaxContactEvents)
+{
+	mMaxContactEvents = inMaxContactEvents;
+
+	// Allocate enough blocks for a single contact allocator, ResetContactEvents will add blocks for the other allocators
+	AllocateContactEventBlocks(inMaxContactEvents > 0? (inMaxContactEvents + cContactEventBlockSize - 1) / cContactEventBlockSize + 1 : 0);
+}
+
+void ContactConstraintManager::AllocateContactEventBlocks(uint inNumBlocks)
+{
+	// Free the old buffer
+	if (mContactEvents != nullptr)
+	{
+		Free(mContactEvents);
+		Free(mContactEventBlockCounts);
+		mContactEvents = nullptr;
+		mContactEventBlockCounts = nullptr;
+	}
+	mMaxContactEventBlocks = 0;
+	mNumContactEventBlocks = 0;
+	mNumContactEvents = 0;
+
+	// Allocate the new buffer
+	if (inNumBlocks > 0)
+	{
+		mMaxContactEventBlocks = inNumBlocks;
+		mContactEvents = reinterpret_cast<ContactEvent *>(Allocate(mMaxContactEventBlocks * cContactEventBlockSize * sizeof(ContactEvent)));
+		mContactEventBlockCounts = reinterpret_cast<uint32 *>(Allocate(mMaxContactEventBlocks * sizeof(uint32)));
+	}
+}
+
+void ContactConstraintManager::ResetContactEvents(uint inMaxContactAllocators)
+{
+	// Every contact allocator reserves its own blocks and can leave its last block partially filled.
+	// Reserve an extra block per allocator so that mMaxContactEvents events always fit, no matter how they are spread over the allocators.
+	if (mMaxContactEvents > 0)
+	{
+		uint num_blocks = (mMaxContactEvents + cContactEventBlockSize - 1) / cContactEventBlockSize + inMaxContactAllocators;
+		if (num_blocks > mMaxContactEventBlocks)
+			AllocateContactEventBlocks(num_blocks);
+	}
+
+	mNumContactEventBlocks.store(0, memory_order_relaxed);
+	mNumContactEvents = 0;
+	mContactEventStep = 0;
+}
+
+bool ContactConstraintManager::FinalizeContactEvents()
+{
+	if (mContactEvents == nullptr)
+		return true;
+
+	JPH_PROFILE_FUNCTION();
+
+	// Move the events of all blocks to the front of the buffer, blocks are usually only partially filled
+	uint32 num_blocks = mNumContactEventBlocks.load(memory_order_relaxed);
+	bool overflow = num_blocks > mMaxContactEventBlocks;
+	num_blocks = min<uint32>(num_blocks, mMaxContactEventBlocks);
+	ContactEvent *dest = mContactEvents;
+	for (uint32 b = 0; b < num_blocks; ++b)
+	{
+		const ContactEvent *src = mContactEvents + b * cContactEventBlockSize;
+		uint32 count = mContactEventBlockCounts[b];
+		if (dest != src)
+			memmove(dest, src, count * sizeof(ContactEvent));
+		dest += count;
+	}
+	mNumContactEvents = uint(dest - mContactEvents);
+
+	// Blocks are filled by multiple threads, sort the events to make the order deterministic
+	QuickSort(mContactEvents, dest, [](const ContactEvent &inLHS, const ContactEvent &inRHS) { return inLHS < inRHS; });
+
+	return !overflow;
+}
+
+inline ContactEvent *ContactConstraintManager::AllocateContactEvent(ContactAllocator &ioContactAllocator)
+{
+	// Reserve a new block if we don't have one or if it is full
+	if (ioContactAllocator.mContactEvents == nullptr || *ioContactAllocator.mNumContactEvents == cContactEventBlockSize)
+	{
+		uint32 block = mNumContactEventBlocks.fetch_add(1, memory_order_relaxed);
+		if (block >= mMaxContactEventBlocks)
+		{
+			ioContactAllocator.mContactEvents = nullptr;
+			return nullptr;
+		}
+		ioContactAllocator.mContactEvents = mContactEvents + block * cContactEventBlockSize;
+		ioContactAllocator.mNumContactEvents = mContactEventBlockCounts + block;
+		*ioContactAllocator.mNumContactEvents = 0;
+	}
+
+	return ioContactAllocator.mContactEvents + (*ioContactAllocator.mNumContactEvents)++;
+}
+
+void ContactConstraintManager::AddContactEvent(ContactAllocator &ioContactAllocator, EContactEventType inType, const SubShapeIDPair &inKey, const ContactManifold &inManifold)
+{
+	ContactEvent *event = AllocateContactEvent(ioContactAllocator);
+	if (event == nullptr)
+		return; // Event buffer full
+
+	// Average the contact points on body 2
+	Vec3 position = Vec3::sZero();
+	for (Vec3 p : inManifold.mRelativeContactPointsOn2)
+		position += p;
+	if (!inManifold.mRelativeContactPointsOn2.empty())
+		position /= float(inManifold.mRelativeContactPointsOn2.size());
+
+	event->mSubShapePair = inKey;
+	event->SetPosition(inManifold.mBaseOffset + position);
+	inManifold.mWorldSpaceNormal.StoreFloat3(&event->mWorldSpaceNormal);
+	event->mPenetrationDepth = inManifold.mPenetrationDepth;
+	event->mCollisionStep = mContactEventStep;
+	event->mType = inType;
 }
 
 void ContactConstraintManager::PrepareConstraintBuffer(PhysicsUpdateContext *inContext)
@@ -641,9 +884,10 @@ void ContactConstraintManager::PrepareConstraintBuffer(PhysicsUpdateContext *inC
 	// Store context
 	mUpdateContext = inContext;
 
-	// Allocate temporary constraint buffer
+	// Allocate temporary constraint buffer, when reordering we need space for a copy of every constraint
 	JPH_ASSERT(mConstraints == nullptr);
-	mConstraints = (ContactConstraint *)inContext->mTempAllocator->Allocate(mMaxConstraints * sizeof(ContactConstraint));
+	mReorderConstraints = mPhysicsSettings.mReorderContactConstraints;
+	mConstraints = (ContactConstraint *)inContext->mTempAllocator->Allocate((mReorderConstraints? 2 : 1) * mMaxConstraints * sizeof(ContactConstraint));
 }
 
 template <EMotionType Type1, EMotionType Type2>
@@ -672,6 +916,14 @@ JPH_INLINE void ContactConstraintManager::TemplatedCalculateFrictionAndNonPenetr
 		inv_i2 = Mat44::sZero();
 	}
 
+#ifdef JPH_COMPACT_CONTACT_CONSTRAINTS
+	// Store the inverse inertia so the solver can recalculate the quantities that AxisConstraintPart would store
+	if constexpr (Type1 == EMotionType::Dynamic)
+		ioConstraint.SetInvInertia1(inv_i1);
+	if constexpr (Type2 == EMotionType::Dynamic)
+		ioConstraint.SetInvInertia2(inv_i2);
+#endif // JPH_COMPACT_CONTACT_CONSTRAINTS
+
 	// Calculate tangents
 	Vec3 t1, t2;
 	ioConstraint.GetTangents(t1, t2);
@@ -806,6 +1058,9 @@ void ContactConstraintManager::GetContactsFromCache(ContactAllocator &ioContactA
 	// Get time step
 	float delta_time = mUpdateContext->mStepDeltaTime;
 
+	// Check if we need to report contacts for this body pair
+	bool report_contact = body1->GetReportContactsWithBody(*body2);
+
 	// Copy manifolds
 	uint32 output_handle = ManifoldMap::cInvalidHandle;
 	uint32 input_handle = input_cbp.mFirstCachedManifold;
@@ -831,6 +1086,10 @@ void ContactConstraintManager::GetContactsFromCache(ContactAllocator &ioContactA
 		output_cm->mNextWithSameBodyPair = output_handle;
 		output_handle = write_cache.ToHandle(output_kv);
 
+		// If contact callbacks were skipped for the old manifold, we need to report it as a new contact
+		bool was_reported = (input_cm.mFlags.load(memory_order_relaxed) & uint16(CachedManifold::EFlags::NoContactCallbacks)) == 0;
+		output_cm->mFlags.store(report_contact? 0 : uint16(CachedManifold::EFlags::NoContactCallbacks), memory_order_relaxed);
+
 		// Calculate default contact settings
 		ContactSettings settings;
 		settings.mCombinedFriction = mCombineFriction(*body1, input_key.GetSubShapeID1(), *body2, input_key.GetSubShapeID2());
@@ -841,7 +1100,7 @@ void ContactConstraintManager::GetContactsFromCache(ContactAllocator &ioContactA
 		Vec3 world_space_normal = transform_body2.Multiply3x3(Vec3::sLoadFloat3Unsafe(output_cm->mContactNormal)).Normalized();
 
 		// Call contact listener to update settings
-		if (mContactListener != nullptr)
+		if (report_contact && mContactListener != nullptr)
 		{
 			// Convert constraint to manifold structure for callback
 			ContactManifold manifold;
@@ -863,7 +1122,37 @@ void ContactConstraintManager::GetContactsFromCache(ContactAllocator &ioContactA
 			manifold.mPenetrationDepth = penetration_depth; // We don't have the penetration depth anymore, estimate it
 
 			// Notify callback
-			mContactListener->OnContactPersisted(*body1, *body2, manifold, settings);
+			if (was_reported)
+				mContactListener->OnContactPersisted(*body1, *body2, manifold, settings);
+			else
+				mContactListener->OnContactAdded(*body1, *body2, manifold, settings);
+		}
+
+		// Record contact event
+		if (report_contact && mContactEvents != nullptr)
+		{
+			ContactEvent *event = AllocateContactEvent(ioContactAllocator);
+			if (event != nullptr)
+			{
+				// Average the contact points on body 2 and estimate the penetration depth
+				RVec3 position = RVec3::sZero();
+				float penetration_depth = -FLT_MAX;
+				for (uint32 i = 0; i < output_cm->mNumContactPoints; ++i)
+				{
+					const CachedContactPoint &ccp = output_cm->mContactPoints[i];
+					RVec3 p1 = transform_body1 * Vec3::sLoadFloat3Unsafe(ccp.mPosition1);
+					RVec3 p2 = transform_body2 * Vec3::sLoadFloat3Unsafe(ccp.mPosition2);
+					position += p2;
+					penetration_depth = max(penetration_depth, Vec3(p1 - p2).Dot(world_space_normal));
+				}
+
+				event->mSubShapePair = input_key;
+				event->SetPosition(position / Real(output_cm->mNumContactPoints));
+				world_space_normal.StoreFloat3(&event->mWorldSpaceNormal);
+				event->mPenetrationDepth = penetration_depth;
+				event->mCollisionStep = mContactEventStep;
+				event->mType = was_reported? EContactEventType::Persisted : EContactEventType::Added;
+			}
 		}
 
 		JPH_ASSERT(settings.mIsSensor || !(body1->IsSensor() || body2->IsSensor()), "Sensors cannot be converted into regular bodies by a contact callback!");
@@ -920,7 +1209,9 @@ void ContactConstraintManager::GetContactsFromCache(ContactAllocator &ioContactA
 		}
 
 		// Mark contact as persisted so that we won't fire OnContactRemoved callbacks
-		input_cm.mFlags |= (uint16)CachedManifold::EFlags::ContactPersisted;
+		// (if the contact is no longer reported we don't mark it so that the contact listener receives an OnContactRemoved callback)
+		if (report_contact)
+			input_cm.mFlags |= (uint16)CachedManifold::EFlags::ContactPersisted;
 
 		// Fetch the next manifold
 		input_handle = input_cm.mNextWithSameBodyPair;
@@ -955,6 +1246,10 @@ ContactConstraintManager::BodyPairHandle ContactConstraintManager::AddBodyPair(C
 	CachedBodyPair *cbp = &body_pair_kv->GetValue();
 	cbp->mFirstCachedManifold = ManifoldMap::cInvalidHandle;
 
+	// Carry over the collision warm start data from the previous frame
+	const BPKeyValue *prev_body_pair_kv = mCache[mCacheWriteIdx ^ 1].Find(body_pair_key, body_pair_hash);
+	cbp->mWarmStart = prev_body_pair_kv != nullptr? prev_body_pair_kv->GetValue().mWarmStart : CollideShapeWarmStart();
+
 	// Get relative translation
 	Quat inv_r1 = body1->GetRotation().Conjugated();
 	Vec3 delta_position = inv_r1 * Vec3(body2->GetCenterOfMassPosition() - body1->GetCenterOfMassPosition());
@@ -1002,6 +1297,11 @@ bool ContactConstraintManager::TemplatedAddContactConstraint(ContactAllocator &i
 	settings.mCombinedRestitution = mCombineRestitution(inBody1, inManifold.mSubShapeID1, inBody2, inManifold.mSubShapeID2);
 	settings.mIsSensor = inBody1.IsSensor() || inBody2.IsSensor();
 
+	// Check if we need to report this contact, if not we skip the callbacks and flag the manifold so that we won't fire OnContactRemoved callbacks for it
+	bool report_contact = inBody1.GetReportContactsWithBody(inBody2);
+	if (!report_contact)
+		new_manifold->mFlags |= (uint16)CachedManifold::EFlags::NoContactCallbacks;
+
 	// Get the contact points for the old cache entry
 	const ManifoldCache &read_cache = mCache[mCacheWriteIdx ^ 1];
 	const MKeyValue *old_manifold_kv = read_cache.Find(key, key_hash);
@@ -1009,23 +1309,42 @@ bool ContactConstraintManager::TemplatedAddContactConstraint(ContactAllocator &i
 	const CachedContactPoint *ccp_end;
 	if (old_manifold_kv != nullptr)
 	{
-		// Call point persisted listener
-		if (mContactListener != nullptr)
-			mContactListener->OnContactPersisted(inBody1, inBody2, inManifold, settings);
+		const CachedManifold *old_manifold = &old_manifold_kv->GetValue();
+		if (report_contact)
+		{
+			// If contact callbacks were skipped for the old manifold, we need to report it as a new contact
+			bool was_reported = (old_manifold->mFlags.load(memory_order_relaxed) & uint16(CachedManifold::EFlags::NoContactCallbacks)) == 0;
+
+			// Call point persisted listener
+			if (mContactListener != nullptr)
+			{
+				if (was_reported)
+					mContactListener->OnContactPersisted(inBody1, inBody2, inManifold, settings);
+				else
+					mContactListener->OnContactAdded(inBody1, inBody2, inManifold, settings);
+			}
+			if (mContactEvents != nullptr)
+				AddContactEvent(ioContactAllocator, was_reported? EContactEventType::Persisted : EContactEventType::Added, key, inManifold);
+
+			// Mark contact as persisted so that we won't fire OnContactRemoved callbacks
+			// (if the contact is no longer reported we don't mark it so that the contact listener receives an OnContactRemoved callback)
+			old_manifold->mFlags |= (uint16)CachedManifold::EFlags::ContactPersisted;
+		}
 
 		// Fetch the contact points from the old manifold
-		const CachedManifold *old_manifold = &old_manifold_kv->GetValue();
 		ccp_start = old_manifold->mContactPoints;
 		ccp_end = ccp_start + old_manifold->mNumContactPoints;
-
-		// Mark contact as persisted so that we won't fire OnContactRemoved callbacks
-		old_manifold->mFlags |= (uint16)CachedManifold::EFlags::ContactPersisted;
 	}
 	else
 	{
 		// Call point added listener
-		if (mContactListener != nullptr)
-			mContactListener->OnContactAdded(inBody1, inBody2, inManifold, settings);
+		if (report_contact)
+		{
+			if (mContactListener != nullptr)
+				mContactListener->OnContactAdded(inBody1, inBody2, inManifold, settings);
+			if (mContactEvents != nullptr)
+				AddContactEvent(ioContactAllocator, EContactEventType::Added, key, inManifold);
+		}
 
 		// No contact points available from old manifold
 		ccp_start = nullptr;
@@ -1107,6 +1426,14 @@ bool ContactConstraintManager::TemplatedAddContactConstraint(ContactAllocator &i
 			inv_i2 = Mat44::sZero();
 		}
 
+	#ifdef JPH_COMPACT_CONTACT_CONSTRAINTS
+		// Store the inverse inertia so the solver can recalculate the quantities that AxisConstraintPart would store
+		if constexpr (Type1 == EMotionType::Dynamic)
+			constraint.SetInvInertia1(inv_i1);
+		if constexpr (Type2 == EMotionType::Dynamic)
+			constraint.SetInvInertia2(inv_i2);
+	#endif // JPH_COMPACT_CONTACT_CONSTRAINTS
+
 		// Calculate tangents
 		Vec3 t1, t2;
 		constraint.GetTangents(t1, t2);
@@ -1292,8 +1619,8 @@ void ContactConstraintManager::OnCCDContactAdded(ContactAllocator &ioContactAllo
 	outSettings.mCombinedRestitution = mCombineRestitution(inBody1, inManifold.mSubShapeID1, inBody2, inManifold.mSubShapeID2);
 	outSettings.mIsSensor = false; // For now, no sensors are supported during CCD
 
-	// The remainder of this function only deals with calling contact callbacks, if there's no contact callback we also don't need to do this work
-	if (mContactListener != nullptr)
+	// The remainder of this function only deals with calling contact callbacks and recording contact events, if there's no contact callback and no event buffer we also don't need to do this work
+	if ((mContactListener != nullptr || mContactEvents != nullptr) && inBody1.GetReportContactsWithBody(inBody2))
 	{
 		// Swap bodies so that body 1 id < body 2 id
 		const ContactManifold *manifold;
@@ -1325,15 +1652,21 @@ void ContactConstraintManager::OnCCDContactAdded(ContactAllocator &ioContactAllo
 			// This contact is new for this physics update, check if previous update we already had this contact.
 			const ManifoldCache &read_cache = mCache[mCacheWriteIdx ^ 1];
 			const MKeyValue *old_manifold_kv = read_cache.Find(key, key_hash);
-			if (old_manifold_kv == nullptr)
+			if (old_manifold_kv == nullptr || (old_manifold_kv->GetValue().mFlags.load(memory_order_relaxed) & uint16(CachedManifold::EFlags::NoContactCallbacks)) != 0)
 			{
-				// New contact
-				mContactListener->OnContactAdded(*body1, *body2, *manifold, outSettings);
+				// New contact (or a contact for which the callbacks were skipped last update)
+				if (mContactListener != nullptr)
+					mContactListener->OnContactAdded(*body1, *body2, *manifold, outSettings);
+				if (mContactEvents != nullptr)
+					AddContactEvent(ioContactAllocator, EContactEventType::Added, key, *manifold);
 			}
 			else
 			{
 				// Existing contact
-				mContactListener->OnContactPersisted(*body1, *body2, *manifold, outSettings);
+				if (mContactListener != nullptr)
+					mContactListener->OnContactPersisted(*body1, *body2, *manifold, outSettings);
+				if (mContactEvents != nullptr)
+					AddContactEvent(ioContactAllocator, EContactEventType::Persisted, key, *manifold);
 
 				// Mark contact as persisted so that we won't fire OnContactRemoved callbacks
 				old_manifold_kv->GetValue().mFlags |= (uint16)CachedManifold::EFlags::ContactPersisted;
@@ -1351,8 +1684,10 @@ void ContactConstraintManager::OnCCDContactAdded(ContactAllocator &ioContactAllo
 		else
 		{
 			// Already found this contact this physics update.
-			// Note that we can trigger OnContactPersisted multiple times per physics update, but otherwise we have no way of obtaining the settings
-			mContactListener->OnContactPersisted(*body1, *body2, *manifold, outSettings);
+			// Note that we can trigger OnContactPersisted multiple times per physics update, but otherwise we have no way of obtaining the settings.
+			// We only record a single contact event per physics update.
+			if (mContactListener != nullptr)
+				mContactListener->OnContactPersisted(*body1, *body2, *manifold, outSettings);
 		}
 
 		// If we swapped body1 and body2 we need to swap the mass scales back
@@ -1392,6 +1727,23 @@ void ContactConstraintManager::SortContacts(uint32 *inConstraintIdxBegin, uint32
 	});
 }
 
+void ContactConstraintManager::ReorderConstraints(uint32 *ioConstraintIdxBegin, uint32 *ioConstraintIdxEnd, uint32 inFirstSlot)
+{
+	JPH_PROFILE_FUNCTION();
+
+	JPH_ASSERT(mReorderConstraints);
+	JPH_ASSERT(inFirstSlot + uint32(ioConstraintIdxEnd - ioConstraintIdxBegin) <= GetNumConstraints());
+
+	// The copies are stored in the second half of the buffer
+	uint32 dest_idx = mMaxConstraints + inFirstSlot;
+	for (uint32 *constraint_idx = ioConstraintIdxBegin; constraint_idx < ioConstraintIdxEnd; ++constraint_idx, ++dest_idx)
+	{
+		JPH_ASSERT(*constraint_idx < mMaxConstraints, "Constraint was already reordered");
+		new (&mConstraints[dest_idx]) ContactConstraint(mConstraints[*constraint_idx]);
+		*constraint_idx = dest_idx;
+	}
+}
+
 void ContactConstraintManager::FinalizeContactCacheAndCallContactPointRemovedCallbacks(uint inExpectedNumBodyPairs, uint inExpectedNumManifolds)
 {
 	JPH_PROFILE_FUNCTION();
@@ -1416,9 +1768,26 @@ void ContactConstraintManager::FinalizeContactCacheAndCallContactPointRemovedCal
 	if (mContactListener != nullptr)
 		old_read_cache.ContactPointRemovedCallbacks(mContactListener);
 
+	// Record the contact removed events
+	if (mContactEvents != nullptr)
+	{
+		ContactAllocator contact_allocator(old_read_cache.GetContactAllocator());
+		old_read_cache.ContactPointRemovedEvents(*this, contact_allocator);
+	}
+
 	// We're done with the old read cache now
 	old_read_cache.Clear();
 
+	// If the capacity changed since this cache was allocated, reallocate it now that it is empty
+	if (old_read_cache.GetMaxBodyPairs() != mMaxBodyPairs || old_read_cache.GetMaxManifolds() != mMaxManifolds)
+		old_read_cache.Init(mMaxBodyPairs, mMaxManifolds);
+
+	// Track the usage of the cache
+	mLastNumBodyPairs = inExpectedNumBodyPairs;
+	mLastNumManifolds = inExpectedNumManifolds;
+	mPeakNumBodyPairs = max(mPeakNumBodyPairs, inExpectedNumBodyPairs);
+	mPeakNumManifolds = max(mPeakNumManifolds, inExpectedNumManifolds);
+
 	// Use the amount of contacts from the last iteration to determine the amount of buckets to use in the hash map for the next iteration
 	old_read_cache.Prepare(inExpectedNumBodyPairs, inExpectedNumManifolds);
 }
@@ -1446,6 +1815,24 @@ JPH_INLINE void ContactConstraintManager::sWarmStartConstraint(ContactConstraint
 
 	Vec3 ws_normal = ioConstraint.GetWorldSpaceNormal();
 
+#ifdef JPH_COMPACT_CONTACT_CONSTRAINTS
+	Mat44 inv_i1 = Type1 == EMotionType::Dynamic? ioConstraint.GetInvInertia1() : Mat44::sZero();
+	Mat44 inv_i2 = Type2 == EMotionType::Dynamic? ioConstraint.GetInvInertia2() : Mat44::sZero();
+
+	for (WorldContactPoint &wcp : ioConstraint.mContactPoints)
+	{
+		Vec3 r1 = wcp.GetR1();
+		Vec3 r2 = wcp.GetR2();
+
+		// Warm starting: Apply impulse from last frame
+		if (wcp.mFrictionConstraint1.IsActive() || wcp.mFrictionConstraint2.IsActive())
+		{
+			wcp.mFrictionConstraint1.TemplatedWarmStart<Type1, Type2>(ioMotionProperties1, ioConstraint.mInvMass1, inv_i1, r1, ioMotionProperties2, ioConstraint.mInvMass2, inv_i2, r2, t1, inWarmStartImpulseRatio);
+			wcp.mFrictionConstraint2.TemplatedWarmStart<Type1, Type2>(ioMotionProperties1, ioConstraint.mInvMass1, inv_i1, r1, ioMotionProperties2, ioConstraint.mInvMass2, inv_i2, r2, t2, inWarmStartImpulseRatio);
+		}
+		wcp.mNonPenetrationConstraint.TemplatedWarmStart<Type1, Type2>(ioMotionProperties1, ioConstraint.mInvMass1, inv_i1, r1, ioMotionProperties2, ioConstraint.mInvMass2, inv_i2, r2, ws_normal, inWarmStartImpulseRatio);
+	}
+#else
 	for (WorldContactPoint &wcp : ioConstraint.mContactPoints)
 	{
 		// Warm starting: Apply impulse from last frame
@@ -1456,6 +1843,7 @@ JPH_INLINE void ContactConstraintManager::sWarmStartConstraint(ContactConstraint
 		}
 		wcp.mNonPenetrationConstraint.TemplatedWarmStart<Type1, Type2>(ioMotionProperties1, ioConstraint.mInvMass1, ioMotionProperties2, ioConstraint.mInvMass2, ws_normal, inWarmStartImpulseRatio);
 	}
+#endif // JPH_COMPACT_CONTACT_CONSTRAINTS
 }
 
 template <class MotionPropertiesCallback>
@@ -1515,15 +1903,29 @@ JPH_INLINE bool ContactConstraintManager::sSolveVelocityConstraint(ContactConstr
 	Vec3 t1, t2;
 	ioConstraint.GetTangents(t1, t2);
 
+#ifdef JPH_COMPACT_CONTACT_CONSTRAINTS
+	Mat44 inv_i1 = Type1 == EMotionType::Dynamic? ioConstraint.GetInvInertia1() : Mat44::sZero();
+	Mat44 inv_i2 = Type2 == EMotionType::Dynamic? ioConstraint.GetInvInertia2() : Mat44::sZero();
+#endif // JPH_COMPACT_CONTACT_CONSTRAINTS
+
 	// First apply all friction constraints (non-penetration is more important than friction)
 	for (WorldContactPoint &wcp : ioConstraint.mContactPoints)
 	{
 		// Check if friction is enabled
 		if (wcp.mFrictionConstraint1.IsActive() || wcp.mFrictionConstraint2.IsActive())
 		{
+		#ifdef JPH_COMPACT_CONTACT_CONSTRAINTS
+			Vec3 r1 = wcp.GetR1();
+			Vec3 r2 = wcp.GetR2();
+
+			// Calculate impulse to stop motion in tangential direction
+			float lambda1 = wcp.mFrictionConstraint1.TemplatedSolveVelocityConstraintGetTotalLambda<Type1, Type2>(ioMotionProperties1, r1, ioMotionProperties2, r2, t1);
+			float lambda2 = wcp.mFrictionConstraint2.TemplatedSolveVelocityConstraintGetTotalLambda<Type1, Type2>(ioMotionProperties1, r1, ioMotionProperties2, r2, t2);
+		#else
 			// Calculate impulse to stop motion in tangential direction
 			float lambda1 = wcp.mFrictionConstraint1.TemplatedSolveVelocityConstraintGetTotalLambda<Type1, Type2>(ioMotionProperties1, ioMotionProperties2, t1);
 			float lambda2 = wcp.mFrictionConstraint2.TemplatedSolveVelocityConstraintGetTotalLambda<Type1, Type2>(ioMotionProperties1, ioMotionProperties2, t2);
+		#endif // JPH_COMPACT_CONTACT_CONSTRAINTS
 			float total_lambda_sq = Square(lambda1) + Square(lambda2);
 
 			// Calculate max impulse that can be applied. Note that we're using the non-penetration impulse from the previous iteration here.
@@ -1540,10 +1942,17 @@ JPH_INLINE bool ContactConstraintManager::sSolveVelocityConstraint(ContactConstr
 			}
 
 			// Apply the friction impulse
+		#ifdef JPH_COMPACT_CONTACT_CONSTRAINTS
+			if (wcp.mFrictionConstraint1.TemplatedSolveVelocityConstraintApplyLambda<Type1, Type2>(ioMotionProperties1, ioConstraint.mInvMass1, inv_i1, r1, ioMotionProperties2, ioConstraint.mInvMass2, inv_i2, r2, t1, lambda1))
+				any_impulse_applied = true;
+			if (wcp.mFrictionConstraint2.TemplatedSolveVelocityConstraintApplyLambda<Type1, Type2>(ioMotionProperties1, ioConstraint.mInvMass1, inv_i1, r1, ioMotionProperties2, ioConstraint.mInvMass2, inv_i2, r2, t2, lambda2))
+				any_impulse_applied = true;
+		#else
 			if (wcp.mFrictionConstraint1.TemplatedSolveVelocityConstraintApplyLambda<Type1, Type2>(ioMotionProperties1, ioConstraint.mInvMass1, ioMotionProperties2, ioConstraint.mInvMass2, t1, lambda1))
 				any_impulse_applied = true;
 			if (wcp.mFrictionConstraint2.TemplatedSolveVelocityConstraintApplyLambda<Type1, Type2>(ioMotionProperties1, ioConstraint.mInvMass1, ioMotionProperties2, ioConstraint.mInvMass2, t2, lambda2))
 				any_impulse_applied = true;
+		#endif // JPH_COMPACT_CONTACT_CONSTRAINTS
 		}
 	}
 
@@ -1553,8 +1962,13 @@ JPH_INLINE bool ContactConstraintManager::sSolveVelocityConstraint(ContactConstr
 	for (WorldContactPoint &wcp : ioConstraint.mContactPoints)
 	{
 		// Solve non penetration velocities
+	#ifdef JPH_COMPACT_CONTACT_CONSTRAINTS
+		if (wcp.mNonPenetrationConstraint.TemplatedSolveVelocityConstraint<Type1, Type2>(ioMotionProperties1, ioConstraint.mInvMass1, inv_i1, wcp.GetR1(), ioMotionProperties2, ioConstraint.mInvMass2, inv_i2, wcp.GetR2(), ws_normal, 0.0f, FLT_MAX))
+			any_impulse_applied = true;
+	#else
 		if (wcp.mNonPenetrationConstraint.TemplatedSolveVelocityConstraint<Type1, Type2>(ioMotionProperties1, ioConstraint.mInvMass1, ioMotionProperties2, ioConstraint.mInvMass2, ws_normal, 0.0f, FLT_MAX))
 			any_impulse_applied = true;
+	#endif // JPH_COMPACT_CONTACT_CONSTRAINTS
 	}
 
 	return any_impulse_applied;
@@ -1658,7 +2072,7 @@ bool ContactConstraintManager::SolvePositionConstraints(const uint32 *inConstrai
 
 		Vec3 ws_normal = constraint.GetWorldSpaceNormal();
 
-		for (WorldContactPoint &wcp : constraint.mContactPoints)
+		for (const WorldContactPoint &wcp : constraint.mContactPoints)
 		{
 			// Calculate new contact point positions in world space (the bodies may have moved)
 			RVec3 p1 = transform1 * Vec3::sLoadFloat3Unsafe(wcp.mContactPoint->mPosition1);
@@ -1673,10 +2087,11 @@ bool ContactConstraintManager::SolvePositionConstraints(const uint32 *inConstrai
 			if (separation < 0.0f)
 			{
 				// Update constraint properties (bodies may have moved)
-				wcp.CalculateNonPenetrationConstraintProperties(body1, constraint.mInvMass1, constraint.mInvInertiaScale1, body2, constraint.mInvMass2, constraint.mInvInertiaScale2, p1, p2, ws_normal);
+				AxisConstraintPart position_constraint;
+				WorldContactPoint::sCalculateNonPenetrationConstraintProperties(position_constraint, body1, constraint.mInvMass1, constraint.mInvInertiaScale1, body2, constraint.mInvMass2, constraint.mInvInertiaScale2, p1, p2, ws_normal);
 
 				// Solve position errors
-				if (wcp.mNonPenetrationConstraint.SolvePositionConstraintWithMassOverride(body1, constraint.mInvMass1, body2, constraint.mInvMass2, ws_normal, separation, mPhysicsSettings.mBaumgarte))
+				if (position_constraint.SolvePositionConstraintWithMassOverride(body1, constraint.mInvMass1, body2, constraint.mInvMass2, ws_normal, separation, mPhysicsSettings.mBaumgarte))
 					any_impulse_applied = true;
 			}
 		}
@@ -1687,14 +2102,23 @@ bool ContactConstraintManager::SolvePositionConstraints(const uint32 *inConstrai
 
 void ContactConstraintManager::RecycleConstraintBuffer()
 {
+	// Track the usage of the constraint buffer
+	mPeakNumConstraints = max<uint>(mPeakNumConstraints, mNumConstraints);
+
 	// Reset constraint array
 	mNumConstraints = 0;
+
+	// Next contact events belong to the next collision step
+	++mContactEventStep;
 }
 
 void ContactConstraintManager::FinishConstraintBuffer()
 {
+	// Track the usage of the constraint buffer
+	mPeakNumConstraints = max<uint>(mPeakNumConstraints, mNumConstraints);
+
 	// Free constraints buffer
-	mUpdateContext->mTempAllocator->Free(mConstraints, mMaxConstraints * sizeof(ContactConstraint));
+	mUpdateContext->mTempAllocator->Free(mConstraints, (mReorderConstraints? 2 : 1) * mMaxConstraints * sizeof(ContactConstraint));
 	mConstraints = nullptr;
 	mNumConstraints = 0;
 
@@ -1711,7 +2135,10 @@ bool ContactConstraintManager::RestoreState(StateRecorder &inStream)
 {
 	bool success = mCache[mCacheWriteIdx].RestoreState(mCache[mCacheWriteIdx ^ 1], inStream);
 	mCacheWriteIdx ^= 1;
-	mCache[mCacheWriteIdx].Clear();
+	ManifoldCache &write_cache = mCache[mCacheWriteIdx];
+	write_cache.Clear();
+	if (write_cache.GetMaxBodyPairs() != mMaxBodyPairs || write_cache.GetMaxManifolds() != mMaxManifolds)
+		write_cache.Init(mMaxBodyPairs, mMaxManifolds);
 	return success;
 }
 
@@ -9,8 +9,11 @@
 #include <Jolt/Physics/EPhysicsUpdateError.h>
 #include <Jolt/Physics/Body/BodyPair.h>
 #include <Jolt/Physics/Collision/Shape/SubShapeIDPair.h>
+#include <Jolt/Physics/Collision/ContactEvent.h>
+#include <Jolt/Physics/Collision/CollideShape.h>
 #include <Jolt/Physics/Collision/ManifoldBetweenTwoFaces.h>
 #include <Jolt/Physics/Constraints/ConstraintPart/AxisConstraintPart.h>
+#include <Jolt/Physics/Constraints/ConstraintPart/CompactAxisConstraintPart.h>
 #include <Jolt/Physics/Constraints/ConstraintPart/DualAxisConstraintPart.h>
 #include <Jolt/Core/HashCombine.h>
 #include <Jolt/Core/NonCopyable.h>
@@ -24,6 +27,20 @@ JPH_NAMESPACE_BEGIN
 struct PhysicsSettings;
 class PhysicsUpdateContext;
 
+/// Capacity and usage of the contact cache, see PhysicsSystem::GetContactCacheStats
+struct ContactCacheStats
+{
+	uint					mMaxBodyPairs = 0;						///< Amount of body pairs that fit in the contact cache
+	uint					mMaxManifolds = 0;						///< Amount of contact manifolds that fit in the contact cache
+	uint					mMaxContactConstraints = 0;				///< Size of the contact constraint buffer
+	uint					mPeakNumBodyPairs = 0;					///< Highest amount of body pairs in a collision step of the last update
+	uint					mPeakNumManifolds = 0;					///< Highest amount of contact manifolds in a collision step of the last update
+	uint					mPeakNumContactConstraints = 0;			///< Highest amount of contact constraints in a collision step of the last update (can be higher than mMaxContactConstraints if the buffer overflowed)
+	uint64					mCacheMemory = 0;						///< Amount of memory allocated by the contact cache (both the read and write cache) in bytes
+	uint64					mConstraintBufferMemory = 0;			///< Amount of memory allocated from the TempAllocator for the contact constraints during an update in bytes
+	uint					mNumResizes = 0;						///< How often the capacity has been changed (see PhysicsSettings::mUseAdaptiveContactCache)
+};
+
 class JPH_EXPORT ContactConstraintManager : public NonCopyable
 {
 public:
@@ -42,6 +59,23 @@ public:
 	void						SetContactListener(ContactListener *inListener)						{ mContactListener = inListener; }
 	ContactListener *			GetContactListener() const											{ return mContactListener; }
 
+	/// Set the maximum number of contact events that are recorded during a PhysicsSystem::Update, 0 disables recording contact events (default).
+	/// Events are recorded in addition to calling the contact listener.
+	void						SetMaxContactEvents(uint inMaxContactEvents);
+	uint						GetMaxContactEvents() const											{ return mMaxContactEvents; }
+
+	/// Get the contact events that were recorded during the last PhysicsSystem::Update, sorted on SubShapeIDPair and collision step
+	const ContactEvent *		GetContactEvents() const											{ return mContactEvents; }
+	uint						GetNumContactEvents() const											{ return mNumContactEvents; }
+
+	/// Discard the contact events of the previous update. Should be called before the first collision step of an update.
+	/// @param inMaxContactAllocators Upper bound on the number of ContactAllocators that record events during the update, used to size the event buffer
+	void						ResetContactEvents(uint inMaxContactAllocators);
+
+	/// Compact and sort the contact events recorded during this update. Should be called after simulation ends.
+	/// @return False if events were lost because the event buffer was full
+	bool						FinalizeContactEvents();
+
 	/// Callback function to combine the restitution or friction of two bodies
 	/// Note that when merging manifolds (when PhysicsSettings::mUseManifoldReduction is true) you will only get a callback for the merged manifold.
 	/// It is not possible in that case to get all sub shape ID pairs that were colliding, you'll get the first encountered pair.
@@ -60,6 +94,14 @@ public:
 	/// Get the max number of contact constraints that are allowed
 	uint32						GetMaxConstraints() const											{ return mMaxConstraints; }
 
+	/// When PhysicsSettings::mUseAdaptiveContactCache is true, grow or shrink the contact cache and the contact constraint buffer based on the usage of the last update.
+	/// @param inErrors Errors returned by the last update, used to detect that the capacity was exceeded
+	/// Should be called after simulation ends.
+	void						AdaptCapacity(EPhysicsUpdateError inErrors);
+
+	/// Get the capacity and usage of the contact cache
+	ContactCacheStats			GetCacheStats() const;
+
 	/// Check with the listener if inBody1 and inBody2 could collide, returns false if not
 	inline ValidateResult		ValidateContactPoint(const Body &inBody1, const Body &inBody2, RVec3Arg inBaseOffset, const CollideShapeResult &inCollisionResult) const
 	{
@@ -84,6 +126,8 @@ public:
 		uint					mNumBodyPairs = 0;													///< Total number of body pairs added using this allocator
 		uint					mNumManifolds = 0;													///< Total number of manifolds added using this allocator
 		EPhysicsUpdateError		mErrors = EPhysicsUpdateError::None;								///< Errors reported on this allocator
+		ContactEvent *			mContactEvents = nullptr;											///< Block of contact events that was reserved by this allocator
+		uint32 *				mNumContactEvents = nullptr;										///< Number of events that have been written to mContactEvents
 	};
 
 	/// Get a new allocator context for storing contacts. Note that you should call this once and then add multiple contacts using the context.
@@ -101,6 +145,10 @@ public:
 	/// Needs to be called once per body pair per frame before calling AddContactConstraint.
 	BodyPairHandle				AddBodyPair(ContactAllocator &ioContactAllocator, const Body &inBody1, const Body &inBody2);
 
+	/// Get the data that collision detection uses to speed up subsequent collision queries between a body pair (see CollideShapeSettings::mWarmStart).
+	/// The data is carried over from the previous frame when AddBodyPair is called.
+	static CollideShapeWarmStart *sGetWarmStart(BodyPairHandle inBodyPairHandle)	{ return &static_cast<CachedBodyPair *>(inBodyPairHandle)->mWarmStart; }
+
 	/// Add a contact constraint for this frame.
 	///
 	/// @param ioContactAllocator The allocator that reserves memory for the contacts
@@ -160,6 +208,14 @@ public:
 	/// Sort contact constraints deterministically
 	void						SortContacts(uint32 *inConstraintIdxBegin, uint32 *inConstraintIdxEnd) const;
 
+	/// If contact constraints need to be reordered in solve order during this update (see PhysicsSettings::mReorderContactConstraints)
+	bool						IsReorderingConstraints() const										{ return mReorderConstraints; }
+
+	/// Copy the contact constraints in [ioConstraintIdxBegin, ioConstraintIdxEnd) so that they're stored consecutively in memory in this order, the indices are replaced with the indices of the copies.
+	/// The copies are stored at [inFirstSlot, inFirstSlot + number of constraints), this range should not overlap with any other range that is reordered in this collision step
+	/// and inFirstSlot + number of constraints must be <= GetNumConstraints(). Can only be called once per constraint when IsReorderingConstraints() returns true.
+	void						ReorderConstraints(uint32 *ioConstraintIdxBegin, uint32 *ioConstraintIdxEnd, uint32 inFirstSlot);
+
 	/// Get the affected bodies for a given constraint
 	inline void					GetAffectedBodies(uint32 inConstraintIdx, const Body *&outBody1, const Body *&outBody2) const
 	{
@@ -300,7 +356,8 @@ private:
 		enum class EFlags : uint16
 		{
 			ContactPersisted	= 1,																///< If this cache entry was reused in the next simulation update
-			CCDContact			= 2																	///< This is a cached manifold reported by continuous collision detection and was only used to create a contact callback
+			CCDContact			= 2,																///< This is a cached manifold reported by continuous collision detection and was only used to create a contact callback
+			NoContactCallbacks	= 4																	///< Contact callbacks were skipped for this manifold because neither body reports contacts (see Body::SetReportContacts)
 		};
 
 		/// @see EFlags
@@ -339,9 +396,12 @@ private:
 
 		/// Handle to first manifold in ManifoldCache::mCachedManifolds
 		uint32					mFirstCachedManifold;
+
+		/// Data to speed up collision detection between the bodies in the next frame
+		CollideShapeWarmStart	mWarmStart;
 	};
 
-	static_assert(sizeof(CachedBodyPair) == 28, "Unexpected size");
+	static_assert(sizeof(CachedBodyPair) == 44, "Unexpected size");
 	static_assert(alignof(CachedBodyPair) == 4, "Assuming 4 byte aligned");
 
 	/// Define a map that maps BodyPair -> CachedBodyPair
@@ -352,8 +412,15 @@ private:
 	class ManifoldCache
 	{
 	public:
-		/// Initialize the cache
-		void					Init(uint inMaxBodyPairs, uint inMaxContactConstraints, uint inCachedManifoldsSize);
+		/// Initialize the cache, can be called again to resize an empty cache
+		void					Init(uint inMaxBodyPairs, uint inMaxManifolds);
+
+		/// Get the capacity of the cache
+		uint					GetMaxBodyPairs() const						{ return mMaxBodyPairs; }
+		uint					GetMaxManifolds() const						{ return mMaxManifolds; }
+
+		/// Get the amount of memory allocated by this cache in bytes
+		uint64					GetMemoryUsage() const;
 
 		/// Reset all entries from the cache
 		void					Clear();
@@ -379,6 +446,7 @@ private:
 		void					GetAllManifoldsSorted(const CachedBodyPair &inBodyPair, Array<const MKeyValue *> &outAll) const;
 		void					GetAllCCDManifoldsSorted(Array<const MKeyValue *> &outAll) const;
 		void					ContactPointRemovedCallbacks(ContactListener *inListener);
+		void					ContactPointRemovedEvents(ContactConstraintManager &ioManager, ContactAllocator &ioContactAllocator);
 
 #ifdef JPH_ENABLE_ASSERTS
 		/// Get the amount of manifolds in the cache
@@ -408,6 +476,11 @@ private:
 		/// Simple hash map for BodyPair -> CachedBodyPair
 		BodyPairMap				mCachedBodyPairs { mAllocator };
 
+		/// Capacity of the cache
+		uint					mMaxBodyPairs = 0;
+		uint					mMaxManifolds = 0;
+		uint					mAllocatorSize = 0;
+
 #ifdef JPH_ENABLE_ASSERTS
 		bool					mIsFinalized = false;						///< Marks if this buffer is complete
 #endif
@@ -416,20 +489,59 @@ private:
 	ManifoldCache				mCache[2];									///< We have one cache to read from and one to write to
 	int							mCacheWriteIdx = 0;							///< Which cache we're currently writing to
 
+	/// Capacity of the caches, when this changes the caches are resized as soon as they're empty
+	uint						mMaxBodyPairs = 0;
+	uint						mMaxManifolds = 0;
+
+	/// Limits for the capacity when PhysicsSettings::mUseAdaptiveContactCache is true
+	static constexpr uint		cMinAdaptiveCapacity = 256;
+	static constexpr uint		cMaxAdaptiveCapacity = 1 << 22;
+
+	/// Calculate the new capacity of a buffer when PhysicsSettings::mUseAdaptiveContactCache is true
+	static uint					sGetAdaptedCapacity(uint inCapacity, uint inPeak, uint inWindowPeak, bool inOverflowed, bool inEndOfWindow, const PhysicsSettings &inSettings);
+
+	/// Usage tracking for the adaptive contact cache
+	uint						mLastNumBodyPairs = 0;						///< Amount of body pairs in the last finalized cache
+	uint						mLastNumManifolds = 0;						///< Amount of manifolds in the last finalized cache
+	uint						mPeakNumBodyPairs = 0;						///< Peak amount of body pairs in the current update
+	uint						mPeakNumManifolds = 0;						///< Peak amount of manifolds in the current update
+	uint						mPeakNumConstraints = 0;					///< Peak amount of contact constraints in the current update
+	ContactCacheStats			mLastUpdateStats;							///< Peak usage of the last update
+	uint						mWindowPeakNumBodyPairs = 0;				///< Peak amount of body pairs since the last grow / shrink check
+	uint						mWindowPeakNumManifolds = 0;				///< Peak amount of manifolds since the last grow / shrink check
+	uint						mWindowPeakNumConstraints = 0;				///< Peak amount of contact constraints since the last grow / shrink check
+	uint						mNumUpdatesInWindow = 0;					///< Amount of updates since the last grow / shrink check
+	uint						mNumResizes = 0;							///< How often the capacity changed
+
 	/// World space contact point, used for solving penetrations
 	class WorldContactPoint
 	{
 	public:
-		/// Calculate constraint properties below
-		void					CalculateNonPenetrationConstraintProperties(const Body &inBody1, float inInvMass1, float inInvInertiaScale1, const Body &inBody2, float inInvMass2, float inInvInertiaScale2, RVec3Arg inWorldSpacePosition1, RVec3Arg inWorldSpacePosition2, Vec3Arg inWorldSpaceNormal);
+		/// Calculate the constraint properties for the position solver, these are calculated in a temporary constraint part as the constraint parts below are only used by the velocity solver
+		static void				sCalculateNonPenetrationConstraintProperties(AxisConstraintPart &outConstraintPart, const Body &inBody1, float inInvMass1, float inInvInertiaScale1, const Body &inBody2, float inInvMass2, float inInvInertiaScale2, RVec3Arg inWorldSpacePosition1, RVec3Arg inWorldSpacePosition2, Vec3Arg inWorldSpaceNormal);
 
 		template <EMotionType Type1, EMotionType Type2>
 		JPH_INLINE void			TemplatedCalculateFrictionAndNonPenetrationConstraintProperties(float inDeltaTime, const Body &inBody1, const Body &inBody2, float inInvM1, float inInvM2, Mat44Arg inInvI1, Mat44Arg inInvI2, RVec3Arg inWorldSpacePosition1, RVec3Arg inWorldSpacePosition2, Vec3Arg inWorldSpaceNormal, Vec3Arg inWorldSpaceTangent1, Vec3Arg inWorldSpaceTangent2, const ContactSettings &inSettings, float inMinVelocityForRestitution);
 
+	#ifdef JPH_COMPACT_CONTACT_CONSTRAINTS
+		/// Get the contact point relative to the center of mass of body 1 / 2
+		JPH_INLINE Vec3			GetR1() const								{ return Vec3::sLoadFloat3Unsafe(mR1); }
+		JPH_INLINE Vec3			GetR2() const								{ return Vec3::sLoadFloat3Unsafe(mR2); }
+
+		/// Contact point relative to the center of mass of body 1 / 2, used to recalculate the quantities that AxisConstraintPart stores
+		Float3					mR1;
+		Float3					mR2;
+
+		/// The constraint parts
+		CompactAxisConstraintPart mNonPenetrationConstraint;
+		CompactAxisConstraintPart mFrictionConstraint1;
+		CompactAxisConstraintPart mFrictionConstraint2;
+	#else
 		/// The constraint parts
 		AxisConstraintPart		mNonPenetrationConstraint;
 		AxisConstraintPart		mFrictionConstraint1;
 		AxisConstraintPart		mFrictionConstraint2;
+	#endif // JPH_COMPACT_CONTACT_CONSTRAINTS
 
 		/// Contact cache
 		CachedContactPoint *	mContactPoint;
@@ -460,6 +572,16 @@ private:
 			outTangent2 = ws_normal.Cross(outTangent1);
 		}
 
+	#ifdef JPH_COMPACT_CONTACT_CONSTRAINTS
+		/// Get the scaled world space inverse inertia of body 1 / 2 (only valid if the body is dynamic)
+		JPH_INLINE Mat44		GetInvInertia1() const						{ return sLoadInvInertia(mInvInertia1); }
+		JPH_INLINE Mat44		GetInvInertia2() const						{ return sLoadInvInertia(mInvInertia2); }
+
+		/// Store the scaled world space inverse inertia of body 1 / 2
+		JPH_INLINE void			SetInvInertia1(Mat44Arg inInvInertia)		{ sStoreInvInertia(inInvInertia, mInvInertia1); }
+		JPH_INLINE void			SetInvInertia2(Mat44Arg inInvInertia)		{ sStoreInvInertia(inInvInertia, mInvInertia2); }
+	#endif // JPH_COMPACT_CONTACT_CONSTRAINTS
+
 		Body *					mBody1;
 		Body *					mBody2;
 		uint64					mSortKey;
@@ -469,7 +591,26 @@ private:
 		float					mInvInertiaScale1;
 		float					mInvMass2;
 		float					mInvInertiaScale2;
+	#ifdef JPH_COMPACT_CONTACT_CONSTRAINTS
+		Float3					mInvInertia1[3];							///< Columns of the scaled world space inverse inertia of body 1, shared by all contact points
+		Float3					mInvInertia2[3];							///< Columns of the scaled world space inverse inertia of body 2, shared by all contact points
+	#endif // JPH_COMPACT_CONTACT_CONSTRAINTS
 		WorldContactPoints		mContactPoints;
+
+	#ifdef JPH_COMPACT_CONTACT_CONSTRAINTS
+	private:
+		/// Helper functions to convert between the stored columns and a matrix, note that the values are stored as floats so that the conversion is exact
+		JPH_INLINE static Mat44	sLoadInvInertia(const Float3 *inColumns)
+		{
+			return Mat44(Vec4(Vec3::sLoadFloat3Unsafe(inColumns[0]), 0), Vec4(Vec3::sLoadFloat3Unsafe(inColumns[1]), 0), Vec4(Vec3::sLoadFloat3Unsafe(inColumns[2]), 0), Vec4(0, 0, 0, 1));
+		}
+
+		JPH_INLINE static void	sStoreInvInertia(Mat44Arg inInvInertia, Float3 *outColumns)
+		{
+			for (int i = 0; i < 3; ++i)
+				inInvInertia.GetColumn3(i).StoreFloat3(&outColumns[i]);
+		}
+	#endif // JPH_COMPACT_CONTACT_CONSTRAINTS
 	};
 
 	/// Internal helper function to calculate the friction and non-penetration constraint properties. Templated to the motion type to reduce the amount of branches and calculations.
@@ -491,6 +632,15 @@ private:
 	template <EMotionType Type1, EMotionType Type2>
 	JPH_INLINE static bool		sSolveVelocityConstraint(ContactConstraint &ioConstraint, MotionProperties *ioMotionProperties1, MotionProperties *ioMotionProperties2);
 
+	/// Reserve a contact event in the block of ioContactAllocator, returns nullptr if the event buffer is full
+	inline ContactEvent *		AllocateContactEvent(ContactAllocator &ioContactAllocator);
+
+	/// (Re)allocate the contact event buffer, discards all events
+	void						AllocateContactEventBlocks(uint inNumBlocks);
+
+	/// Record an added or persisted contact event
+	void						AddContactEvent(ContactAllocator &ioContactAllocator, EContactEventType inType, const SubShapeIDPair &inKey, const ContactManifold &inManifold);
+
 	/// The main physics settings instance
 	const PhysicsSettings &		mPhysicsSettings;
 
@@ -501,13 +651,27 @@ private:
 	CombineFunction				mCombineFriction = [](const Body &inBody1, const SubShapeID &, const Body &inBody2, const SubShapeID &) { return sqrt(inBody1.GetFriction() * inBody2.GetFriction()); };
 	CombineFunction				mCombineRestitution = [](const Body &inBody1, const SubShapeID &, const Body &inBody2, const SubShapeID &) { return max(inBody1.GetRestitution(), inBody2.GetRestitution()); };
 
-	/// The constraints that were added this frame
+	/// The constraints that were added this frame.
+	/// When mReorderConstraints is true, this buffer has room for 2 * mMaxConstraints constraints, the second half is used to store the constraints in solve order.
 	ContactConstraint *			mConstraints = nullptr;
 	uint32						mMaxConstraints = 0;
 	atomic<uint32>				mNumConstraints { 0 };
+	bool						mReorderConstraints = false;
 
 	/// Context used for this physics update
 	PhysicsUpdateContext *		mUpdateContext;
+
+	/// Contact events are reserved in blocks so that every thread can write events without contention
+	static constexpr uint		cContactEventBlockSize = 64;
+
+	/// Buffer of mMaxContactEventBlocks * cContactEventBlockSize events, after FinalizeContactEvents the first mNumContactEvents are valid
+	ContactEvent *				mContactEvents = nullptr;
+	uint32 *					mContactEventBlockCounts = nullptr;									///< Number of used events per block
+	uint						mMaxContactEvents = 0;												///< Number of events that can be recorded per update as requested through SetMaxContactEvents
+	uint						mMaxContactEventBlocks = 0;											///< Number of blocks in mContactEvents, this includes a block per contact allocator to account for partially filled blocks
+	atomic<uint32>				mNumContactEventBlocks { 0 };										///< Number of blocks that have been reserved, can be higher than mMaxContactEventBlocks when the buffer overflowed
+	uint						mNumContactEvents = 0;
+	uint8						mContactEventStep = 0;												///< Collision step that is currently being simulated
 };
 
 JPH_NAMESPACE_END
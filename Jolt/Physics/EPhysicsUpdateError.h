@@ -13,6 +13,7 @@ enum class EPhysicsUpdateError : uint32
 	ManifoldCacheFull		= 1 << 0,		///< The manifold cache is full, this means that the total number of contacts between bodies is too high. Some contacts were ignored. Increase inMaxContactConstraints in PhysicsSystem::Init.
 	BodyPairCacheFull		= 1 << 1,		///< The body pair cache is full, this means that too many bodies contacted. Some contacts were ignored. Increase inMaxBodyPairs in PhysicsSystem::Init.
 	ContactConstraintsFull	= 1 << 2,		///< The contact constraints buffer is full. Some contacts were ignored. Increase inMaxContactConstraints in PhysicsSystem::Init.
+	ContactEventsFull		= 1 << 3,		///< The contact event buffer is full. Some contact events were not recorded (the simulation is not affected). Increase the amount passed to PhysicsSystem::SetMaxContactEvents.
 };
 
 /// OR operator for EPhysicsUpdateError
@@ -28,6 +29,12 @@ inline EPhysicsUpdateError operator |= (EPhysicsUpdateError &ioA, EPhysicsUpdate
 	return ioA;
 }
 
+/// NOT operator for EPhysicsUpdateError
+inline EPhysicsUpdateError operator ~ (EPhysicsUpdateError inA)
+{
+	return static_cast<EPhysicsUpdateError>(~static_cast<uint32>(inA));
+}
+
 /// AND operator for EPhysicsUpdateError
 inline EPhysicsUpdateError operator & (EPhysicsUpdateError inA, EPhysicsUpdateError inB)
 {
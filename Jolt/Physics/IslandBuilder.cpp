@@ -430,6 +430,16 @@ bool IslandBuilder::GetContactsInIsland(uint32 inIslandIndex, uint32 *&outContac
 	}
 }
 
+uint32 IslandBuilder::GetContactsOffset(uint32 inIslandIndex) const
+{
+	JPH_ASSERT(inIslandIndex < mNumIslands);
+	if (mNumContacts == 0)
+		return 0;
+
+	uint32 sorted_index = mIslandsSorted[inIslandIndex];
+	return sorted_index > 0? mContactIslandEnds[sorted_index - 1] : 0;
+}
+
 void IslandBuilder::ResetIslands(TempAllocator *inTempAllocator)
 {
 	JPH_PROFILE_FUNCTION();
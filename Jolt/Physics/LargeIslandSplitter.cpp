@@ -280,7 +280,7 @@ uint LargeIslandSplitter::AssignToNonParallelSplit(const Body *inBody)
 	return cNonParallelSplitIdx;
 }
 
-bool LargeIslandSplitter::SplitIsland(uint32 inIslandIndex, const IslandBuilder &inIslandBuilder, const BodyManager &inBodyManager, const ContactConstraintManager &inContactManager, Constraint **inActiveConstraints, CalculateSolverSteps &ioStepsCalculator)
+bool LargeIslandSplitter::SplitIsland(uint32 inIslandIndex, const IslandBuilder &inIslandBuilder, const BodyManager &inBodyManager, ContactConstraintManager &ioContactManager, Constraint **inActiveConstraints, CalculateSolverSteps &ioStepsCalculator)
 {
 	JPH_PROFILE_FUNCTION();
 
@@ -322,7 +322,7 @@ bool LargeIslandSplitter::SplitIsland(uint32 inIslandIndex, const IslandBuilder
 	for (const uint32 *c = contacts_start; c < contacts_end; ++c)
 	{
 		const Body *body1, *body2;
-		inContactManager.GetAffectedBodies(*c, body1, body2);
+		ioContactManager.GetAffectedBodies(*c, body1, body2);
 		uint split = AssignSplit(body1, body2);
 		num_contacts_in_split[split]++;
 		*cur_contact_split_idx++ = split;
@@ -459,7 +459,7 @@ bool LargeIslandSplitter::SplitIsland(uint32 inIslandIndex, const IslandBuilder
 		for (uint32 *c = mContactAndConstraintIndices + split_contacts_begin; c < mContactAndConstraintIndices + split_contacts_end; ++c)
 		{
 			const Body *body1, *body2;
-			inContactManager.GetAffectedBodies(*c, body1, body2);
+			ioContactManager.GetAffectedBodies(*c, body1, body2);
 
 			uint32 idx1 = body1->GetIndexInActiveBodiesInternal();
 			if (idx1 != Body::cInactiveIndex && body1->IsDynamic())
@@ -479,6 +479,22 @@ bool LargeIslandSplitter::SplitIsland(uint32 inIslandIndex, const IslandBuilder
 #endif // JPH_DEBUG
 #endif // JPH_ENABLE_ASSERTS
 
+	// Store the contact constraints in the order in which the splits are solved, the contacts of this island can use the same slots as the unsplit island
+	if (ioContactManager.IsReorderingConstraints())
+	{
+		uint32 slot = inIslandBuilder.GetContactsOffset(inIslandIndex);
+		for (uint s = 0; s < cNumSplits; ++s)
+		{
+			// If there are no more splits, process the non-parallel split
+			if (s >= splits.mNumSplits)
+				s = cNonParallelSplitIdx;
+
+			const Split &split = splits.mSplits[s];
+			ioContactManager.ReorderConstraints(mContactAndConstraintIndices + split.mContactBufferBegin, mContactAndConstraintIndices + split.mContactBufferEnd, slot);
+			slot += split.GetNumContacts();
+		}
+	}
+
 	// Allow other threads to pick up this split island now
 	splits.StartFirstBatch();
 	return true;
@@ -143,7 +143,8 @@ public:
 	uint					AssignToNonParallelSplit(const Body *inBody);
 
 	/// Splits up an island, the created splits will be added to the list of batches and can be fetched with FetchNextBatch. Returns false if the island did not need splitting.
-	bool					SplitIsland(uint32 inIslandIndex, const IslandBuilder &inIslandBuilder, const BodyManager &inBodyManager, const ContactConstraintManager &inContactManager, Constraint **inActiveConstraints, CalculateSolverSteps &ioStepsCalculator);
+	/// When ioContactManager is reordering contact constraints, the contact constraints of the island are stored in memory in split order.
+	bool					SplitIsland(uint32 inIslandIndex, const IslandBuilder &inIslandBuilder, const BodyManager &inBodyManager, ContactConstraintManager &ioContactManager, Constraint **inActiveConstraints, CalculateSolverSteps &ioStepsCalculator);
 
 	/// Fetch the next batch to process, returns a handle in outSplitIslandIndex that must be provided to MarkBatchProcessed when complete
 	EStatus					FetchNextBatch(uint &outSplitIslandIndex, uint32 *&outConstraintsBegin, uint32 *&outConstraintsEnd, uint32 *&outContactsBegin, uint32 *&outContactsEnd, bool &outFirstIteration);
@@ -158,6 +159,9 @@ public:
 		return mSplitIslands[inSplitIslandIndex].mIslandIndex;
 	}
 
+	/// Get the number of islands that need splitting (valid after Prepare)
+	inline uint				GetNumSplitIslands() const							{ return mNumSplitIslands; }
+
 	/// Prepare the island splitter for iterating over the split islands again for position solving. Marks all batches as startable.
 	void					PrepareForSolvePositions();
 
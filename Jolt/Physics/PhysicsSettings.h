@@ -55,6 +55,9 @@ struct PhysicsSettings
 	/// Fraction of its inner radius a body may penetrate another body for the LinearCast motion quality
 	float		mLinearCastMaxPenetration = 0.25f;
 
+	/// How far ahead the swept volume of a LinearCast body is extended when mUseCCDSweptVolumeCache is on, as a fraction of the distance the body moves in a single step
+	float		mCCDSweptVolumeLookAhead = 2.0f;
+
 	/// Max squared distance to use to determine if two points are on the same plane for determining the contact manifold between two shape faces (unit: meter^2)
 	float		mManifoldToleranceSq = 1.0e-6f;
 
@@ -92,6 +95,40 @@ struct PhysicsSettings
 	/// By default the simulation is deterministic, it is possible to turn this off by setting this setting to false. This will make the simulation run faster but it will no longer be deterministic.
 	bool		mDeterministicSimulation = true;
 
+	/// When true, bodies with motion quality LinearCast remember which non-moving bodies were not hit by a shape cast that looks ahead further than the current step (see mCCDSweptVolumeLookAhead).
+	/// As long as the body keeps moving along the same line and these bodies don't move, the narrow phase casts against them are skipped in the next steps.
+	/// This uses memory for every body in the system. The cache is not stored by PhysicsSystem::SaveState, so when replaying a simulation the result may differ from the original.
+	bool		mUseCCDSweptVolumeCache = false;
+
+	/// When true, contact constraints are copied so that they're stored in memory in the order in which the solver processes them (island by island and split by split).
+	/// Contact constraints are created in the order in which collision detection finds them, so without this the solver accesses them in random order.
+	/// This costs one copy of every contact constraint per collision step and doubles the memory that is allocated from the TempAllocator for contact constraints.
+	/// It does not change the simulation result.
+	bool		mReorderContactConstraints = false;
+
+	/// When true, the narrow phase of a body pair is split up in ranges of sub shapes when a compound shape (StaticCompoundShape or MutableCompoundShape) has many sub shapes that overlap with the other shape.
+	/// These ranges are processed by multiple FindCollisions jobs and the hits are merged afterwards, which improves load balancing when e.g. a large compound shape rests on a dense MeshShape.
+	/// The simulation is still deterministic. When a compound shape collides with a convex shape or a MeshShape the hits are found in the same order as when this setting is turned off so the result is the same,
+	/// but when two compound shapes collide the hits are found in a different order so the result is not bit-identical to the simulation with this setting turned off.
+	bool		mSplitLargeCompoundCollisions = false;
+
+	/// When true, the capacity of the contact cache and the contact constraint buffer is adapted in between updates based on the peak usage (see PhysicsSystem::GetContactCacheStats).
+	/// The values passed to PhysicsSystem::Init are used as initial capacity. Note that the contact constraints are allocated from the TempAllocator that is passed to PhysicsSystem::Update, so it must be large enough for the grown buffer.
+	/// When the capacity is exceeded, contacts are still dropped during that update but the capacity will be increased for the next update.
+	bool		mUseAdaptiveContactCache = false;
+
+	/// When mUseAdaptiveContactCache is true, the capacity is grown when the usage during an update exceeds this fraction of the capacity
+	float		mContactCacheGrowThreshold = 0.75f;
+
+	/// When mUseAdaptiveContactCache is true, the capacity is shrunk when the usage stays below this fraction of the capacity for mContactCacheShrinkDelay updates
+	float		mContactCacheShrinkThreshold = 0.25f;
+
+	/// Amount of updates that the usage needs to stay below mContactCacheShrinkThreshold before the capacity is shrunk
+	uint		mContactCacheShrinkDelay = 600;
+
+	/// When the capacity is grown or shrunk, the new capacity is the peak usage times this factor
+	float		mContactCacheHeadroom = 2.0f;
+
 	///@name These variables are mainly for debugging purposes, they allow turning on/off certain subsystems. You probably want to leave them alone.
 	///@{
 
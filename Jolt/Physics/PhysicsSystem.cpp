@@ -10,6 +10,7 @@
 #include <Jolt/Physics/PhysicsStepListener.h>
 #include <Jolt/Physics/Collision/BroadPhase/BroadPhaseBruteForce.h>
 #include <Jolt/Physics/Collision/BroadPhase/BroadPhaseQuadTree.h>
+#include <Jolt/Physics/Collision/BroadPhase/BroadPhaseSAP.h>
 #include <Jolt/Physics/Collision/CollisionDispatch.h>
 #include <Jolt/Physics/Collision/AABoxCast.h>
 #include <Jolt/Physics/Collision/ShapeCast.h>
@@ -19,6 +20,7 @@
 #include <Jolt/Physics/Collision/CollideConvexVsTriangles.h>
 #include <Jolt/Physics/Collision/ManifoldBetweenTwoFaces.h>
 #include <Jolt/Physics/Collision/Shape/ConvexShape.h>
+#include <Jolt/Physics/Collision/Shape/CompoundShape.h>
 #include <Jolt/Physics/Collision/InternalEdgeRemovingCollector.h>
 #include <Jolt/Physics/Constraints/CalculateSolverSteps.h>
 #include <Jolt/Physics/Constraints/ConstraintPart/AxisConstraintPart.h>
@@ -31,6 +33,7 @@
 #include <Jolt/Core/TempAllocator.h>
 #include <Jolt/Core/QuickSort.h>
 #include <Jolt/Core/ScopeExit.h>
+#include <Jolt/Core/HashCombine.h>
 #ifdef JPH_DEBUG_RENDERER
 	#include <Jolt/Renderer/DebugRenderer.h>
 #endif // JPH_DEBUG_RENDERER
@@ -41,9 +44,6 @@ JPH_NAMESPACE_BEGIN
 bool PhysicsSystem::sDrawMotionQualityLinearCast = false;
 #endif // JPH_DEBUG_RENDERER
 
-//#define BROAD_PHASE BroadPhaseBruteForce
-#define BROAD_PHASE BroadPhaseQuadTree
-
 static const Color cColorUpdateBroadPhaseFinalize = Color::sGetDistinctColor(1);
 static const Color cColorUpdateBroadPhasePrepare = Color::sGetDistinctColor(2);
 static const Color cColorFindCollisions = Color::sGetDistinctColor(3);
@@ -67,14 +67,18 @@ static const Color cColorSoftBodyPrepare = Color::sGetDistinctColor(20);
 static const Color cColorSoftBodyCollide = Color::sGetDistinctColor(21);
 static const Color cColorSoftBodySimulate = Color::sGetDistinctColor(22);
 static const Color cColorSoftBodyFinalize = Color::sGetDistinctColor(23);
+static const Color cColorFinalizeCCDContacts = Color::sGetDistinctColor(24);
 
 PhysicsSystem::~PhysicsSystem()
 {
 	// Remove broadphase
 	delete mBroadPhase;
+
+	// Free body pairs that can be split up
+	delete [] mSplitBodyPairs;
 }
 
-void PhysicsSystem::Init(uint inMaxBodies, uint inNumBodyMutexes, uint inMaxBodyPairs, uint inMaxContactConstraints, const BroadPhaseLayerInterface &inBroadPhaseLayerInterface, const ObjectVsBroadPhaseLayerFilter &inObjectVsBroadPhaseLayerFilter, const ObjectLayerPairFilter &inObjectLayerPairFilter)
+void PhysicsSystem::Init(uint inMaxBodies, uint inNumBodyMutexes, uint inMaxBodyPairs, uint inMaxContactConstraints, const BroadPhaseLayerInterface &inBroadPhaseLayerInterface, const ObjectVsBroadPhaseLayerFilter &inObjectVsBroadPhaseLayerFilter, const ObjectLayerPairFilter &inObjectLayerPairFilter, EBroadPhaseType inBroadPhaseType)
 {
 	mObjectVsBroadPhaseLayerFilter = &inObjectVsBroadPhaseLayerFilter;
 	mObjectLayerPairFilter = &inObjectLayerPairFilter;
@@ -83,7 +87,24 @@ void PhysicsSystem::Init(uint inMaxBodies, uint inNumBodyMutexes, uint inMaxBody
 	mBodyManager.Init(inMaxBodies, inNumBodyMutexes, inBroadPhaseLayerInterface);
 
 	// Create broadphase
-	mBroadPhase = new BROAD_PHASE();
+	switch (inBroadPhaseType)
+	{
+	case EBroadPhaseType::QuadTree:
+		mBroadPhase = new BroadPhaseQuadTree();
+		break;
+
+	case EBroadPhaseType::SweepAndPrune:
+		mBroadPhase = new BroadPhaseSAP();
+		break;
+
+	case EBroadPhaseType::BruteForce:
+		mBroadPhase = new BroadPhaseBruteForce();
+		break;
+
+	default:
+		JPH_ASSERT(false);
+		break;
+	}
 	mBroadPhase->Init(&mBodyManager, inBroadPhaseLayerInterface);
 
 	// Init contact constraint manager
@@ -106,6 +127,11 @@ void PhysicsSystem::OptimizeBroadPhase()
 	mBroadPhase->Optimize();
 }
 
+void PhysicsSystem::OptimizeBroadPhase(JobSystem *inJobSystem)
+{
+	mBroadPhase->Optimize(inJobSystem);
+}
+
 void PhysicsSystem::AddStepListener(PhysicsStepListener *inListener)
 {
 	lock_guard lock(mStepListenersMutex);
@@ -133,9 +159,18 @@ EPhysicsUpdateError PhysicsSystem::Update(float inDeltaTime, int inCollisionStep
 	JPH_ASSERT(inCollisionSteps > 0);
 	JPH_ASSERT(inDeltaTime >= 0.0f);
 
+	// Start timing the update for the update stats
+	std::chrono::high_resolution_clock::time_point update_start = std::chrono::high_resolution_clock::now();
+	mUpdateStats = PhysicsUpdateStats();
+
 	// Sync point for the broadphase. This will allow it to do clean up operations without having any mutexes locked yet.
 	mBroadPhase->FrameSync();
 
+	// Discard the contact events of the previous update.
+	// Every collision step uses a contact allocator per find collisions job, per find CCD contacts job and one for the contact removed events.
+	int max_jobs = min(int(PhysicsUpdateContext::cMaxConcurrency), inJobSystem->GetMaxConcurrency());
+	mContactManager.ResetContactEvents(uint(inCollisionSteps * (2 * max_jobs + 1)));
+
 	// If there are no active bodies or there's no time delta
 	uint32 num_active_rigid_bodies = mBodyManager.GetNumActiveBodies(EBodyType::RigidBody);
 	uint32 num_active_soft_bodies = mBodyManager.GetNumActiveBodies(EBodyType::SoftBody);
@@ -153,7 +188,13 @@ EPhysicsUpdateError PhysicsSystem::Update(float inDeltaTime, int inCollisionStep
 		mContactManager.FinalizeContactCacheAndCallContactPointRemovedCallbacks(0, 0);
 
 		mBodyManager.UnlockAllBodies();
-		return EPhysicsUpdateError::None;
+
+		// Sort the contact removed events
+		EPhysicsUpdateError errors = mContactManager.FinalizeContactEvents()? EPhysicsUpdateError::None : EPhysicsUpdateError::ContactEventsFull;
+		mUpdateStats.mUpdateTimeNs = uint64(std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::high_resolution_clock::now() - update_start).count());
+
+		// A full contact event buffer doesn't affect the simulation, so we don't assert on it
+		return errors;
 	}
 
 	// Calculate ratio between current and previous frame delta time to scale initial constraint forces
@@ -175,6 +216,28 @@ EPhysicsUpdateError PhysicsSystem::Update(float inDeltaTime, int inCollisionStep
 	JPH_ASSERT(context.mBodyPairs == nullptr);
 	context.mBodyPairs = static_cast<BodyPair *>(inTempAllocator->Allocate(sizeof(BodyPair) * mPhysicsSettings.mMaxInFlightBodyPairs));
 
+	// Make sure there is a body pair that can be split up over multiple jobs for every job, these are only reallocated when the max concurrency grows
+	if (mPhysicsSettings.mSplitLargeCompoundCollisions)
+	{
+		int max_concurrency = context.GetMaxConcurrency();
+		if (mNumSplitBodyPairs < max_concurrency)
+		{
+			delete [] mSplitBodyPairs;
+			mSplitBodyPairs = new PhysicsUpdateContext::SplitBodyPair [max_concurrency];
+			mNumSplitBodyPairs = max_concurrency;
+		}
+		context.mSplitBodyPairs = mSplitBodyPairs;
+	}
+
+	// Allocate a swept volume for every body that can do a linear cast, or free them when the cache was turned off
+	if (mPhysicsSettings.mUseCCDSweptVolumeCache)
+		mCCDSweptVolumes.resize(mBodyManager.GetMaxBodies());
+	else if (!mCCDSweptVolumes.empty())
+	{
+		mCCDSweptVolumes.clear();
+		mCCDSweptVolumes.shrink_to_fit();
+	}
+
 	// Lock all bodies for write so that we can freely touch them
 	mStepListenersMutex.lock();
 	mBodyManager.LockAllBodies();
@@ -228,7 +291,10 @@ EPhysicsUpdateError PhysicsSystem::Update(float inDeltaTime, int inCollisionStep
 					JPH_ASSERT(step.mActiveFindCollisionJobs == 0);
 
 					// Finalize the broadphase update
-					context.mPhysicsSystem->mBroadPhase->UpdateFinalize(step.mBroadPhaseUpdateState);
+					{
+						PhysicsUpdateContext::PhaseTimer timer(&context, EPhysicsUpdatePhase::BroadPhaseUpdate);
+						context.mPhysicsSystem->mBroadPhase->UpdateFinalize(step.mBroadPhaseUpdateState);
+					}
 
 					// Signal that it is done
 					step.mPreIntegrateVelocity.RemoveDependency();
@@ -242,11 +308,7 @@ EPhysicsUpdateError PhysicsSystem::Update(float inDeltaTime, int inCollisionStep
 			// If this is turned around the RemoveBody call will hang since it locks in that order
 			step.mBroadPhasePrepare = inJobSystem->CreateJob("UpdateBroadPhasePrepare", cColorUpdateBroadPhasePrepare, [&context, &step]()
 				{
-					// Prepare the broadphase update
-					step.mBroadPhaseUpdateState = context.mPhysicsSystem->mBroadPhase->UpdatePrepare();
-
-					// Now the finalize can run (if other dependencies are met too)
-					step.mUpdateBroadphaseFinalize.RemoveDependency();
+					context.mPhysicsSystem->JobUpdateBroadPhasePrepare(&context, &step);
 				}, previous_step_dependency_count);
 
 			// This job will find all collisions
@@ -354,7 +416,7 @@ EPhysicsUpdateError PhysicsSystem::Update(float inDeltaTime, int inCollisionStep
 					// Validate that all find collision jobs have stopped
 					JPH_ASSERT(step.mActiveFindCollisionJobs == 0);
 
-					context.mPhysicsSystem->JobFinalizeIslands(&context);
+					context.mPhysicsSystem->JobFinalizeIslands(&context, &step);
 
 					JobHandle::sRemoveDependencies(step.mSolveVelocityConstraints);
 					step.mBodySetIslandIndex.RemoveDependency();
@@ -377,7 +439,10 @@ EPhysicsUpdateError PhysicsSystem::Update(float inDeltaTime, int inCollisionStep
 			// It will also delete any bodies that have been destroyed in the last frame
 			step.mBodySetIslandIndex = inJobSystem->CreateJob("BodySetIslandIndex", cColorBodySetIslandIndex, [&context, &step]()
 				{
-					context.mPhysicsSystem->JobBodySetIslandIndex();
+					{
+						PhysicsUpdateContext::PhaseTimer timer(&context, EPhysicsUpdatePhase::BuildIslands);
+						context.mPhysicsSystem->JobBodySetIslandIndex();
+					}
 
 					JobHandle::sRemoveDependencies(step.mSolvePositionConstraints);
 				}, 2); // depends on: finalize islands, finish building jobs
@@ -483,12 +548,23 @@ EPhysicsUpdateError PhysicsSystem::Update(float inDeltaTime, int inCollisionStep
 				{
 					context.mPhysicsSystem->JobResolveCCDContacts(&context, &step);
 
-					JobHandle::sRemoveDependencies(step.mSolvePositionConstraints);
+					step.mFinalizeCCDContacts.RemoveDependency();
 				}, 2); // depends on: integrate velocities, detect ccd contacts (added dynamically), finish building jobs.
 
 			// Unblock previous job
 			step.mPostIntegrateVelocity.RemoveDependency();
 
+			// This job will activate the bodies that were hit by CCD bodies
+			step.mFinalizeCCDContacts = inJobSystem->CreateJob("FinalizeCCDContacts", cColorFinalizeCCDContacts, [&context, &step]()
+				{
+					context.mPhysicsSystem->JobFinalizeCCDContacts(&context, &step);
+
+					JobHandle::sRemoveDependencies(step.mSolvePositionConstraints);
+				}, 2); // depends on: resolve ccd contacts, resolve ccd contact groups (added dynamically), finish building jobs.
+
+			// Unblock previous job
+			step.mResolveCCDContacts.RemoveDependency();
+
 			// Fixes up drift in positions and updates the broadphase with new body positions
 			step.mSolvePositionConstraints.resize(max_concurrency);
 			for (int i = 0; i < max_concurrency; ++i)
@@ -499,10 +575,10 @@ EPhysicsUpdateError PhysicsSystem::Update(float inDeltaTime, int inCollisionStep
 						// Kick the next step
 						if (step.mSoftBodyPrepare.IsValid())
 							step.mSoftBodyPrepare.RemoveDependency();
-					}, 3); // depends on: resolve ccd contacts, body set island index, finish building jobs.
+					}, 3); // depends on: finalize ccd contacts, body set island index, finish building jobs.
 
 			// Unblock previous jobs.
-			step.mResolveCCDContacts.RemoveDependency();
+			step.mFinalizeCCDContacts.RemoveDependency();
 			step.mBodySetIslandIndex.RemoveDependency();
 
 			// The soft body prepare job will create other jobs if needed
@@ -548,6 +624,7 @@ EPhysicsUpdateError PhysicsSystem::Update(float inDeltaTime, int inCollisionStep
 				handles.push_back(h);
 			handles.push_back(step.mPostIntegrateVelocity);
 			handles.push_back(step.mResolveCCDContacts);
+			handles.push_back(step.mFinalizeCCDContacts);
 			for (const JobHandle &h : step.mSolvePositionConstraints)
 				handles.push_back(h);
 			handles.push_back(step.mContactRemovedCallbacks);
@@ -583,6 +660,10 @@ EPhysicsUpdateError PhysicsSystem::Update(float inDeltaTime, int inCollisionStep
 	// Clear the contact manager
 	mContactManager.FinishConstraintBuffer();
 
+	// Sort the contact events so that they can be read after the update
+	if (!mContactManager.FinalizeContactEvents())
+		context.mErrors.fetch_or((uint32)EPhysicsUpdateError::ContactEventsFull, memory_order_relaxed);
+
 	// Free active constraints
 	inTempAllocator->Free(context.mActiveConstraints, mConstraintManager.GetNumConstraints() * sizeof(Constraint *));
 	context.mActiveConstraints = nullptr;
@@ -608,14 +689,99 @@ EPhysicsUpdateError PhysicsSystem::Update(float inDeltaTime, int inCollisionStep
 	// Unlock step listeners
 	mStepListenersMutex.unlock();
 
-	// Return any errors
+	// Gather the update stats
+	for (uint p = 0; p < uint(EPhysicsUpdatePhase::Count); ++p)
+		mUpdateStats.mPhaseTimeNs[p] = context.mPhaseTimeNs[p].load(memory_order_relaxed);
+	mUpdateStats.mNumCollisionSteps = uint(inCollisionSteps);
+	for (const PhysicsUpdateContext::Step &step : context.mSteps)
+	{
+		mUpdateStats.mNumActiveBodies += step.mNumActiveBodiesAtStepStart;
+		mUpdateStats.mNumActiveConstraints += step.mNumActiveConstraints.load(memory_order_relaxed);
+		mUpdateStats.mNumBodyPairs += step.mNumBodyPairs.load(memory_order_relaxed);
+		mUpdateStats.mNumManifolds += step.mNumManifolds.load(memory_order_relaxed);
+		mUpdateStats.mNumContactConstraints += step.mNumContactConstraints;
+		mUpdateStats.mNumIslands += step.mNumIslands;
+		mUpdateStats.mNumSplitIslands += step.mNumSplitIslands;
+		mUpdateStats.mNumCCDBodies += step.mNumCCDBodies.load(memory_order_relaxed);
+	}
+	mUpdateStats.mUpdateTimeNs = uint64(std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::high_resolution_clock::now() - update_start).count());
+
+	// Resize the contact cache if needed
 	EPhysicsUpdateError errors = static_cast<EPhysicsUpdateError>(context.mErrors.load(memory_order_acquire));
-	JPH_ASSERT(errors == EPhysicsUpdateError::None, "An error occurred during the physics update, see EPhysicsUpdateError for more information");
+	mContactManager.AdaptCapacity(errors);
+
+	// Return any errors, a full contact event buffer doesn't affect the simulation so we don't assert on it.
+	// When the contact cache is adaptive, it has just been grown to absorb a full cache so we don't assert on that either.
+#ifdef JPH_ENABLE_ASSERTS
+	EPhysicsUpdateError ignored_errors = EPhysicsUpdateError::ContactEventsFull;
+	if (mPhysicsSettings.mUseAdaptiveContactCache)
+		ignored_errors = ignored_errors | EPhysicsUpdateError::ManifoldCacheFull | EPhysicsUpdateError::BodyPairCacheFull | EPhysicsUpdateError::ContactConstraintsFull;
+	JPH_ASSERT((errors & ~ignored_errors) == EPhysicsUpdateError::None, "An error occurred during the physics update, see EPhysicsUpdateError for more information");
+#endif // JPH_ENABLE_ASSERTS
 	return errors;
 }
 
+void PhysicsSystem::JobUpdateBroadPhasePrepare(PhysicsUpdateContext *ioContext, PhysicsUpdateContext::Step *ioStep)
+{
+	// Prepare the broadphase update, large trees are split up in batches that can be built in parallel
+	uint num_batches;
+	{
+		PhysicsUpdateContext::PhaseTimer timer(ioContext, EPhysicsUpdatePhase::BroadPhaseUpdate);
+		num_batches = mBroadPhase->UpdatePrepareBegin(ioStep->mBroadPhaseUpdateState);
+	}
+	if (num_batches == 0)
+	{
+		// Update was fully prepared, now the finalize can run (if other dependencies are met too)
+		ioStep->mUpdateBroadphaseFinalize.RemoveDependency();
+		return;
+	}
+	ioStep->mNumBroadPhaseBatches = num_batches;
+	ioStep->mNextBroadPhaseBatch = 0;
+	ioStep->mNumBroadPhaseBatchesLeft = num_batches;
+
+	// Spawn jobs to help building the batches
+	int num_jobs = min(int(num_batches), ioContext->GetMaxConcurrency());
+	for (int i = 1; i < num_jobs; ++i)
+	{
+		JobHandle job = ioContext->mJobSystem->CreateJob("UpdateBroadPhasePrepareBatches", cColorUpdateBroadPhasePrepare, [ioContext, ioStep]()
+		{
+			ioContext->mPhysicsSystem->JobUpdateBroadPhasePrepareBatches(ioContext, ioStep);
+		});
+		ioContext->mBarrier->AddJob(job);
+	}
+
+	// Help building the batches
+	JobUpdateBroadPhasePrepareBatches(ioContext, ioStep);
+}
+
+void PhysicsSystem::JobUpdateBroadPhasePrepareBatches(PhysicsUpdateContext *ioContext, PhysicsUpdateContext::Step *ioStep)
+{
+	PhysicsUpdateContext::PhaseTimer timer(ioContext, EPhysicsUpdatePhase::BroadPhaseUpdate);
+
+	for (;;)
+	{
+		// Fetch the next batch to build
+		uint batch = ioStep->mNextBroadPhaseBatch.fetch_add(1, memory_order_relaxed);
+		if (batch >= ioStep->mNumBroadPhaseBatches)
+			break;
+
+		mBroadPhase->UpdatePrepareBatch(ioStep->mBroadPhaseUpdateState, batch);
+
+		// The job that builds the last batch completes the update, no job needs to wait for the others
+		if (ioStep->mNumBroadPhaseBatchesLeft.fetch_sub(1, memory_order_acq_rel) == 1)
+		{
+			mBroadPhase->UpdatePrepareEnd(ioStep->mBroadPhaseUpdateState);
+
+			// Now the finalize can run (if other dependencies are met too)
+			ioStep->mUpdateBroadphaseFinalize.RemoveDependency();
+		}
+	}
+}
+
 void PhysicsSystem::JobStepListeners(PhysicsUpdateContext::Step *ioStep)
 {
+	PhysicsUpdateContext::PhaseTimer timer(ioStep->mContext, EPhysicsUpdatePhase::StepListeners);
+
 #ifdef JPH_ENABLE_ASSERTS
 	// Read positions (broadphase updates concurrently so we can't write), read/write velocities
 	BodyAccess::Grant grant(BodyAccess::EAccess::ReadWrite, BodyAccess::EAccess::Read);
@@ -641,6 +807,8 @@ void PhysicsSystem::JobStepListeners(PhysicsUpdateContext::Step *ioStep)
 
 void PhysicsSystem::JobDetermineActiveConstraints(PhysicsUpdateContext::Step *ioStep) const
 {
+	PhysicsUpdateContext::PhaseTimer timer(ioStep->mContext, EPhysicsUpdatePhase::BuildIslands);
+
 #ifdef JPH_ENABLE_ASSERTS
 	// No body access
 	BodyAccess::Grant grant(BodyAccess::EAccess::None, BodyAccess::EAccess::None);
@@ -674,6 +842,8 @@ void PhysicsSystem::JobDetermineActiveConstraints(PhysicsUpdateContext::Step *io
 
 void PhysicsSystem::JobApplyGravity(const PhysicsUpdateContext *ioContext, PhysicsUpdateContext::Step *ioStep)
 {
+	PhysicsUpdateContext::PhaseTimer timer(ioContext, EPhysicsUpdatePhase::ApplyGravity);
+
 #ifdef JPH_ENABLE_ASSERTS
 	// We update velocities and need the rotation to do so
 	BodyAccess::Grant grant(BodyAccess::EAccess::ReadWrite, BodyAccess::EAccess::Read);
@@ -721,6 +891,8 @@ void PhysicsSystem::JobApplyGravity(const PhysicsUpdateContext *ioContext, Physi
 
 void PhysicsSystem::JobSetupVelocityConstraints(float inDeltaTime, PhysicsUpdateContext::Step *ioStep) const
 {
+	PhysicsUpdateContext::PhaseTimer timer(ioStep->mContext, EPhysicsUpdatePhase::SetupVelocityConstraints);
+
 #ifdef JPH_ENABLE_ASSERTS
 	// We only read positions
 	BodyAccess::Grant grant(BodyAccess::EAccess::None, BodyAccess::EAccess::Read);
@@ -741,6 +913,8 @@ void PhysicsSystem::JobSetupVelocityConstraints(float inDeltaTime, PhysicsUpdate
 
 void PhysicsSystem::JobBuildIslandsFromConstraints(PhysicsUpdateContext *ioContext, PhysicsUpdateContext::Step *ioStep)
 {
+	PhysicsUpdateContext::PhaseTimer timer(ioContext, EPhysicsUpdatePhase::BuildIslands);
+
 #ifdef JPH_ENABLE_ASSERTS
 	// We read constraints and positions
 	BodyAccess::Grant grant(BodyAccess::EAccess::None, BodyAccess::EAccess::Read);
@@ -756,7 +930,7 @@ void PhysicsSystem::JobBuildIslandsFromConstraints(PhysicsUpdateContext *ioConte
 	ConstraintManager::sBuildIslands(ioStep->mContext->mActiveConstraints, ioStep->mNumActiveConstraints, mIslandBuilder, mBodyManager);
 }
 
-void PhysicsSystem::TrySpawnJobFindCollisions(PhysicsUpdateContext::Step *ioStep) const
+void PhysicsSystem::TrySpawnJobFindCollisions(PhysicsUpdateContext::Step *ioStep, uint inNumExtraJobs) const
 {
 	// Get how many jobs we can spawn and check if we can spawn more
 	uint max_jobs = ioStep->mBodyPairQueues.size();
@@ -772,7 +946,7 @@ void PhysicsSystem::TrySpawnJobFindCollisions(PhysicsUpdateContext::Step *ioStep
 	uint32 num_active_bodies = mBodyManager.GetNumActiveBodies(EBodyType::RigidBody) - ioStep->mActiveBodyReadIdx;
 
 	// Calculate how many jobs we would like
-	uint desired_num_jobs = min((num_body_pairs + cNarrowPhaseBatchSize - 1) / cNarrowPhaseBatchSize + (num_active_bodies + cActiveBodiesBatchSize - 1) / cActiveBodiesBatchSize, max_jobs);
+	uint desired_num_jobs = min((num_body_pairs + cNarrowPhaseBatchSize - 1) / cNarrowPhaseBatchSize + (num_active_bodies + cActiveBodiesBatchSize - 1) / cActiveBodiesBatchSize + inNumExtraJobs, max_jobs);
 
 	for (;;)
 	{
@@ -825,6 +999,8 @@ static void sFinalizeContactAllocator(PhysicsUpdateContext::Step &ioStep, const
 
 void PhysicsSystem::JobFindCollisions(PhysicsUpdateContext::Step *ioStep, int inJobIndex)
 {
+	PhysicsUpdateContext::PhaseTimer timer(ioStep->mContext, EPhysicsUpdatePhase::FindCollisions);
+
 #ifdef JPH_ENABLE_ASSERTS
 	// We read positions and read velocities (for elastic collisions)
 	BodyAccess::Grant grant(BodyAccess::EAccess::Read, BodyAccess::EAccess::Read);
@@ -872,7 +1048,7 @@ void PhysicsSystem::JobFindCollisions(PhysicsUpdateContext::Step *ioStep, int in
 						if (body_pairs_in_queue >= mStep->mMaxBodyPairsPerQueue)
 						{
 							// Buffer full, process the pair now
-							mStep->mContext->mPhysicsSystem->ProcessBodyPair(mContactAllocator, inPair);
+							mStep->mContext->mPhysicsSystem->ProcessBodyPair(mStep, mJobIndex, mContactAllocator, inPair);
 						}
 						else
 						{
@@ -925,6 +1101,16 @@ void PhysicsSystem::JobFindCollisions(PhysicsUpdateContext::Step *ioStep, int in
 					// If we're back at the first queue, we've looked at all of them and found nothing
 					if (read_queue_idx == first_read_queue_idx)
 					{
+						// Help other jobs with the body pairs that they have split up
+						if (context->mSplitBodyPairs != nullptr)
+						{
+							bool processed_range = false;
+							for (uint i = 0; i < ioStep->mBodyPairQueues.size() && !processed_range; ++i)
+								processed_range = ProcessSplitBodyPairRange(ioStep, inJobIndex, contact_allocator, context->mSplitBodyPairs[i]);
+							if (processed_range)
+								break;
+						}
+
 						// Collect information from the contact allocator and accumulate it in the step.
 						sFinalizeContactAllocator(*ioStep, contact_allocator);
 
@@ -948,7 +1134,7 @@ void PhysicsSystem::JobFindCollisions(PhysicsUpdateContext::Step *ioStep, int in
 				if (queue.mReadIdx.compare_exchange_strong(pair_idx, pair_idx + 1))
 				{
 					// Process the actual body pair
-					ProcessBodyPair(contact_allocator, bp);
+					ProcessBodyPair(ioStep, inJobIndex, contact_allocator, bp);
 					break;
 				}
 			}
@@ -956,7 +1142,7 @@ void PhysicsSystem::JobFindCollisions(PhysicsUpdateContext::Step *ioStep, int in
 	}
 }
 
-void PhysicsSystem::ProcessBodyPair(ContactAllocator &ioContactAllocator, const BodyPair &inBodyPair)
+void PhysicsSystem::ProcessBodyPair(PhysicsUpdateContext::Step *ioStep, int inJobIndex, ContactAllocator &ioContactAllocator, const BodyPair &inBodyPair, const PhysicsUpdateContext::SplitBodyPair *inSplitPair)
 {
 	JPH_PROFILE_FUNCTION();
 
@@ -987,15 +1173,15 @@ void PhysicsSystem::ProcessBodyPair(ContactAllocator &ioContactAllocator, const
 
 	// Check if the contact points from the previous frame are reusable and if so copy them
 	bool pair_handled = false, constraint_created = false;
-	if (mPhysicsSettings.mUseBodyPairContactCache && !(body1->IsCollisionCacheInvalid() || body2->IsCollisionCacheInvalid()))
+	if (inSplitPair == nullptr && mPhysicsSettings.mUseBodyPairContactCache && !(body1->IsCollisionCacheInvalid() || body2->IsCollisionCacheInvalid()))
 		mContactManager.GetContactsFromCache(ioContactAllocator, *body1, *body2, pair_handled, constraint_created);
 
 	// If the cache hasn't handled this body pair do actual collision detection
 	if (!pair_handled)
 	{
-		// Create entry in the cache for this body pair
+		// Create entry in the cache for this body pair, a body pair that was split up already has one
 		// Needs to happen irrespective if we found a collision or not (we want to remember that no collision was found too)
-		ContactConstraintManager::BodyPairHandle body_pair_handle = mContactManager.AddBodyPair(ioContactAllocator, *body1, *body2);
+		ContactConstraintManager::BodyPairHandle body_pair_handle = inSplitPair != nullptr? inSplitPair->mBodyPairHandle : mContactManager.AddBodyPair(ioContactAllocator, *body1, *body2);
 		if (body_pair_handle == nullptr)
 			return; // Out of cache space
 
@@ -1006,11 +1192,19 @@ void PhysicsSystem::ProcessBodyPair(ContactAllocator &ioContactAllocator, const
 		settings.mMaxSeparationDistance = body1->IsSensor() || body2->IsSensor()? 0.0f : mPhysicsSettings.mSpeculativeContactDistance;
 		settings.mActiveEdgeMovementDirection = body1->GetLinearVelocity() - body2->GetLinearVelocity();
 
+		// The warm start data is stored per body pair, for a compound shape it would be shared by all sub shapes so we don't use it
+		if (body1->GetShape()->GetType() != EShapeType::Compound && body2->GetShape()->GetType() != EShapeType::Compound)
+			settings.mWarmStart = ContactConstraintManager::sGetWarmStart(body_pair_handle);
+
 		// Get transforms relative to body1
 		RVec3 offset = body1->GetCenterOfMassPosition();
 		Mat44 transform1 = Mat44::sRotation(body1->GetRotation());
 		Mat44 transform2 = body2->GetCenterOfMassTransform().PostTranslated(-offset).ToMat44();
 
+		// Check if the work needs to be split up over multiple jobs, in that case the job that finishes last will call this function again to add the contacts
+		if (inSplitPair == nullptr && TrySplitBodyPair(ioStep, inJobIndex, ioContactAllocator, inBodyPair, *body1, *body2, body_pair_handle, settings, transform1, transform2))
+			return;
+
 		if (mPhysicsSettings.mUseManifoldReduction				// Check global flag
 			&& body1->GetUseManifoldReductionWithBody(*body2))	// Check body flag
 		{
@@ -1125,9 +1319,7 @@ void PhysicsSystem::ProcessBodyPair(ContactAllocator &ioContactAllocator, const
 			ReductionCollideShapeCollector collector(this, body1, body2);
 
 			// Perform collision detection between the two shapes
-			SubShapeIDCreator part1, part2;
-			auto f = body1->GetEnhancedInternalEdgeRemovalWithBody(*body2)? InternalEdgeRemovingCollector::sCollideShapeVsShape : CollisionDispatch::sCollideShapeVsShape;
-			f(body1->GetShape(), body2->GetShape(), Vec3::sReplicate(1.0f), Vec3::sReplicate(1.0f), transform1, transform2, part1, part2, settings, collector, { });
+			sCollideBodyPairShapes(*body1, *body2, settings, transform1, transform2, inSplitPair, collector);
 
 			// Add the contacts
 			for (ContactManifold &manifold : collector.mManifolds)
@@ -1226,9 +1418,7 @@ void PhysicsSystem::ProcessBodyPair(ContactAllocator &ioContactAllocator, const
 			NonReductionCollideShapeCollector collector(this, ioContactAllocator, body1, body2, body_pair_handle);
 
 			// Perform collision detection between the two shapes
-			SubShapeIDCreator part1, part2;
-			auto f = body1->GetEnhancedInternalEdgeRemovalWithBody(*body2)? InternalEdgeRemovingCollector::sCollideShapeVsShape : CollisionDispatch::sCollideShapeVsShape;
-			f(body1->GetShape(), body2->GetShape(), Vec3::sReplicate(1.0f), Vec3::sReplicate(1.0f), transform1, transform2, part1, part2, settings, collector, { });
+			sCollideBodyPairShapes(*body1, *body2, settings, transform1, transform2, inSplitPair, collector);
 
 			constraint_created = collector.mConstraintCreated;
 		}
@@ -1252,8 +1442,180 @@ void PhysicsSystem::ProcessBodyPair(ContactAllocator &ioContactAllocator, const
 	}
 }
 
-void PhysicsSystem::JobFinalizeIslands(PhysicsUpdateContext *ioContext)
+void PhysicsSystem::sCollideBodyPairShapes(const Body &inBody1, const Body &inBody2, const CollideShapeSettings &inSettings, Mat44Arg inTransform1, Mat44Arg inTransform2, const PhysicsUpdateContext::SplitBodyPair *inSplitPair, CollideShapeCollector &ioCollector)
+{
+	// If the body pair was split up, pass on the hits in range order so that the result doesn't depend on which job processed which range
+	if (inSplitPair != nullptr)
+	{
+		uint num_ranges = uint((inSplitPair->mState.load(memory_order_relaxed) >> 16) & 0xffff);
+		for (uint r = 0; r < num_ranges; ++r)
+			for (const CollideShapeResult &hit : inSplitPair->mHits[r].mHits)
+			{
+				if (ioCollector.ShouldEarlyOut())
+					return;
+				ioCollector.AddHit(hit);
+			}
+		return;
+	}
+
+	const Shape *shape1 = inBody1.GetShape();
+	const Shape *shape2 = inBody2.GetShape();
+	SubShapeIDCreator part1, part2;
+	if (inBody1.GetEnhancedInternalEdgeRemovalWithBody(inBody2))
+		InternalEdgeRemovingCollector::sCollideShapeVsShape(shape1, shape2, Vec3::sReplicate(1.0f), Vec3::sReplicate(1.0f), inTransform1, inTransform2, part1, part2, inSettings, ioCollector, { });
+	else
+		CollisionDispatch::sCollideShapeVsShape(shape1, shape2, Vec3::sReplicate(1.0f), Vec3::sReplicate(1.0f), inTransform1, inTransform2, part1, part2, inSettings, ioCollector, { });
+}
+
+bool PhysicsSystem::TrySplitBodyPair(PhysicsUpdateContext::Step *ioStep, int inJobIndex, ContactAllocator &ioContactAllocator, const BodyPair &inBodyPair, const Body &inBody1, const Body &inBody2, ContactConstraintManager::BodyPairHandle inBodyPairHandle, const CollideShapeSettings &inSettings, Mat44Arg inTransform1, Mat44Arg inTransform2)
+{
+	// Check if splitting is enabled
+	if (ioStep->mContext->mSplitBodyPairs == nullptr)
+		return false;
+
+	// Enhanced internal edge removal needs to see all hits, so we can't split the work
+	if (inBody1.GetEnhancedInternalEdgeRemovalWithBody(inBody2))
+		return false;
+
+	// Check if one of the shapes is a compound shape with enough sub shapes
+	const Shape *shape1 = inBody1.GetShape();
+	const Shape *shape2 = inBody2.GetShape();
+	if (!sIsLargeCompound(shape1) && !sIsLargeCompound(shape2))
+		return false;
+
+	// Claim a body pair that is not in use by making the generation odd.
+	// There is one for every job and a body pair is only in use while a job is working on it, so this job will always find one.
+	PhysicsUpdateContext::SplitBodyPair *split_pairs = ioStep->mContext->mSplitBodyPairs;
+	uint num_split_pairs = uint(ioStep->mBodyPairQueues.size());
+	PhysicsUpdateContext::SplitBodyPair *split_pair = nullptr;
+	uint64 generation = 0;
+	for (uint i = uint(inJobIndex); split_pair == nullptr; i = (i + 1) % num_split_pairs)
+	{
+		uint64 state = split_pairs[i].mState.load(memory_order_relaxed);
+		generation = state >> 32;
+		if ((generation & 1) == 0 && split_pairs[i].mState.compare_exchange_strong(state, (generation + 1) << 32, memory_order_acquire))
+			split_pair = &split_pairs[i];
+	}
+	++generation;
+
+	// Check if we should split up the work, first try the sub shapes of shape 1, then of shape 2
+	Mat44 transform2_to_1 = inTransform1.InversedRotationTranslation() * inTransform2;
+	if (sFindSubShapesToSplit(shape1, shape2, transform2_to_1, inSettings.mMaxSeparationDistance, split_pair->mSubShapeIndices))
+		split_pair->mSplitShape1 = true;
+	else if (sFindSubShapesToSplit(shape2, shape1, transform2_to_1.InversedRotationTranslation(), inSettings.mMaxSeparationDistance, split_pair->mSubShapeIndices))
+		split_pair->mSplitShape1 = false;
+	else
+	{
+		// Release the body pair again
+		split_pair->mState.store((generation + 1) << 32, memory_order_release);
+		return false;
+	}
+
+	JPH_PROFILE("SplitBodyPair");
+
+	// Fill in the body pair
+	split_pair->mBodyPair = inBodyPair;
+	split_pair->mBodyPairHandle = inBodyPairHandle;
+	split_pair->mShape1 = shape1;
+	split_pair->mShape2 = shape2;
+	split_pair->mTransform1 = inTransform1;
+	split_pair->mTransform2 = inTransform2;
+	split_pair->mSettings = inSettings;
+	JPH_ASSERT(inSettings.mWarmStart == nullptr); // The warm start data is not thread safe, but it is not used for compound shapes
+	uint num_ranges = min(PhysicsUpdateContext::SplitBodyPair::cMaxRanges, (uint(split_pair->mSubShapeIndices.size()) + cSplitBodyPairSubShapesPerRange - 1) / cSplitBodyPairSubShapesPerRange);
+	for (uint r = 0; r < num_ranges; ++r)
+		split_pair->mHits[r].Reset();
+	split_pair->mNumRangesDone.store(0, memory_order_relaxed);
+
+	// Make the ranges available to other jobs
+	split_pair->mState.store((generation << 32) | (uint64(num_ranges) << 16), memory_order_release);
+
+	// Start jobs to help, each call spawns at most 1 job
+	for (uint r = 1; r < num_ranges; ++r)
+		TrySpawnJobFindCollisions(ioStep, num_ranges - 1);
+
+	// Process ranges ourselves until there are none left.
+	// We don't wait for the ranges that other jobs claimed, the job that finishes the last range adds the contacts.
+	while (ProcessSplitBodyPairRange(ioStep, inJobIndex, ioContactAllocator, *split_pair))
+		continue;
+	return true;
+}
+
+bool PhysicsSystem::sIsLargeCompound(const Shape *inShape)
+{
+	return inShape->GetType() == EShapeType::Compound && static_cast<const CompoundShape *>(inShape)->GetNumSubShapes() >= cSplitBodyPairMinSubShapes;
+}
+
+bool PhysicsSystem::sFindSubShapesToSplit(const Shape *inCompound, const Shape *inOther, Mat44Arg inOtherToCompound, float inMaxSeparationDistance, Array<uint> &outSubShapeIndices)
 {
+	if (!sIsLargeCompound(inCompound))
+		return false;
+	const CompoundShape *compound = static_cast<const CompoundShape *>(inCompound);
+	uint num_sub_shapes = compound->GetNumSubShapes();
+
+	// Get the bounding box of the other shape in the space of the compound shape
+	AABox bounds = inOther->GetLocalBounds().Transformed(inOtherToCompound);
+	bounds.ExpandBy(Vec3::sReplicate(inMaxSeparationDistance));
+
+	// Find the sub shapes that overlap with it
+	outSubShapeIndices.resize(num_sub_shapes);
+	outSubShapeIndices.resize(compound->GetIntersectingSubShapes(bounds, outSubShapeIndices.data(), (int)num_sub_shapes));
+	return outSubShapeIndices.size() >= cSplitBodyPairMinSubShapes;
+}
+
+bool PhysicsSystem::ProcessSplitBodyPairRange(PhysicsUpdateContext::Step *ioStep, int inJobIndex, ContactAllocator &ioContactAllocator, PhysicsUpdateContext::SplitBodyPair &ioPair)
+{
+	// Claim the next range
+	uint64 state = ioPair.mState.load(memory_order_acquire);
+	uint range, num_ranges;
+	do
+	{
+		range = uint(state & 0xffff);
+		num_ranges = uint((state >> 16) & 0xffff);
+		if ((state & (uint64(1) << 32)) == 0 || range >= num_ranges)
+			return false; // Not active or no ranges left
+	}
+	while (!ioPair.mState.compare_exchange_weak(state, state + 1, memory_order_acquire));
+
+	JPH_PROFILE_FUNCTION();
+
+	// Collide the sub shapes in the range
+	const CompoundShape *compound = static_cast<const CompoundShape *>(ioPair.mSplitShape1? ioPair.mShape1 : ioPair.mShape2);
+	uint num_sub_shapes = ioPair.mSubShapeIndices.size();
+	AllHitCollisionCollector<CollideShapeCollector> &collector = ioPair.mHits[range];
+	SubShapeIDCreator part1, part2;
+	for (uint i = range * num_sub_shapes / num_ranges, end = (range + 1) * num_sub_shapes / num_ranges; i < end; ++i)
+	{
+		uint index = ioPair.mSubShapeIndices[i];
+		const CompoundShape::SubShape &sub_shape = compound->GetSubShape(index);
+		if (ioPair.mSplitShape1)
+		{
+			Mat44 transform1 = ioPair.mTransform1 * sub_shape.GetLocalTransformNoScale(Vec3::sReplicate(1.0f));
+			CollisionDispatch::sCollideShapeVsShape(sub_shape.mShape, ioPair.mShape2, sub_shape.TransformScale(Vec3::sReplicate(1.0f)), Vec3::sReplicate(1.0f), transform1, ioPair.mTransform2, compound->GetSubShapeIDFromIndex(index, part1), part2, ioPair.mSettings, collector, { });
+		}
+		else
+		{
+			Mat44 transform2 = ioPair.mTransform2 * sub_shape.GetLocalTransformNoScale(Vec3::sReplicate(1.0f));
+			CollisionDispatch::sCollideShapeVsShape(ioPair.mShape1, sub_shape.mShape, Vec3::sReplicate(1.0f), sub_shape.TransformScale(Vec3::sReplicate(1.0f)), ioPair.mTransform1, transform2, part1, compound->GetSubShapeIDFromIndex(index, part2), ioPair.mSettings, collector, { });
+		}
+	}
+
+	// Signal that the range is done, the job that finishes the last range sees the hits of all other ranges and adds the contacts
+	if (ioPair.mNumRangesDone.fetch_add(1, memory_order_acq_rel) + 1 == num_ranges)
+	{
+		ProcessBodyPair(ioStep, inJobIndex, ioContactAllocator, ioPair.mBodyPair, &ioPair);
+
+		// Make the body pair available again by making the generation even
+		ioPair.mState.store(((state >> 32) + 1) << 32, memory_order_release);
+	}
+
+	return true;
+}
+
+void PhysicsSystem::JobFinalizeIslands(PhysicsUpdateContext *ioContext, PhysicsUpdateContext::Step *ioStep)
+{
+	PhysicsUpdateContext::PhaseTimer timer(ioContext, EPhysicsUpdatePhase::BuildIslands);
+
 #ifdef JPH_ENABLE_ASSERTS
 	// We only touch island data
 	BodyAccess::Grant grant(BodyAccess::EAccess::None, BodyAccess::EAccess::None);
@@ -1265,6 +1627,11 @@ void PhysicsSystem::JobFinalizeIslands(PhysicsUpdateContext *ioContext)
 	// Prepare the large island splitter
 	if (mPhysicsSettings.mUseLargeIslandSplitter)
 		mLargeIslandSplitter.Prepare(mIslandBuilder, mBodyManager.GetNumActiveBodies(EBodyType::RigidBody), ioContext->mTempAllocator);
+
+	// Store the counts for the update stats, the island builder and splitter are reset before the next step
+	ioStep->mNumIslands = mIslandBuilder.GetNumIslands();
+	ioStep->mNumSplitIslands = mLargeIslandSplitter.GetNumSplitIslands();
+	ioStep->mNumContactConstraints = mContactManager.GetNumConstraints();
 }
 
 void PhysicsSystem::JobBodySetIslandIndex()
@@ -1289,6 +1656,8 @@ JPH_CLANG_SUPPRESS_WARNING("-Wundefined-func-template") // ConstraintManager::sW
 
 void PhysicsSystem::JobSolveVelocityConstraints(PhysicsUpdateContext *ioContext, PhysicsUpdateContext::Step *ioStep)
 {
+	PhysicsUpdateContext::PhaseTimer timer(ioContext, EPhysicsUpdatePhase::SolveVelocityConstraints);
+
 #ifdef JPH_ENABLE_ASSERTS
 	// We update velocities and need to read positions to do so
 	BodyAccess::Grant grant(BodyAccess::EAccess::ReadWrite, BodyAccess::EAccess::Read);
@@ -1398,6 +1767,10 @@ void PhysicsSystem::JobSolveVelocityConstraints(PhysicsUpdateContext *ioContext,
 				&& mLargeIslandSplitter.SplitIsland(island_idx, mIslandBuilder, mBodyManager, mContactManager, active_constraints, steps_calculator))
 				continue; // Loop again to try to fetch the newly split island
 
+			// Store the contact constraints in the order in which they will be solved
+			if (mContactManager.IsReorderingConstraints())
+				mContactManager.ReorderConstraints(contacts_begin, contacts_end, mIslandBuilder.GetContactsOffset(island_idx));
+
 			// We didn't create a split, just run the solver now for this entire island. Begin by warm starting.
 			ConstraintManager::sWarmStartVelocityConstraints(active_constraints, constraints_begin, constraints_end, warm_start_impulse_ratio, steps_calculator);
 			mContactManager.WarmStartVelocityConstraints(contacts_begin, contacts_end, warm_start_impulse_ratio, steps_calculator);
@@ -1432,6 +1805,8 @@ JPH_SUPPRESS_WARNING_POP
 
 void PhysicsSystem::JobPreIntegrateVelocity(PhysicsUpdateContext *ioContext, PhysicsUpdateContext::Step *ioStep)
 {
+	PhysicsUpdateContext::PhaseTimer timer(ioContext, EPhysicsUpdatePhase::IntegrateVelocity);
+
 	// Reserve enough space for all bodies that may need a cast
 	TempAllocator *temp_allocator = ioContext->mTempAllocator;
 	JPH_ASSERT(ioStep->mCCDBodies == nullptr);
@@ -1443,12 +1818,18 @@ void PhysicsSystem::JobPreIntegrateVelocity(PhysicsUpdateContext *ioContext, Phy
 	ioStep->mNumActiveBodyToCCDBody = mBodyManager.GetNumActiveBodies(EBodyType::RigidBody);
 	ioStep->mActiveBodyToCCDBody = (int *)temp_allocator->Allocate(ioStep->mNumActiveBodyToCCDBody * sizeof(int));
 
+	// Advance the swept volume cache, the swept volumes are only valid if they were used in the previous step
+	if (mPhysicsSettings.mUseCCDSweptVolumeCache)
+		++mCCDSweptVolumeStep;
+
 	// Prepare the split island builder for solving the position constraints
 	mLargeIslandSplitter.PrepareForSolvePositions();
 }
 
 void PhysicsSystem::JobIntegrateVelocity(const PhysicsUpdateContext *ioContext, PhysicsUpdateContext::Step *ioStep)
 {
+	PhysicsUpdateContext::PhaseTimer timer(ioContext, EPhysicsUpdatePhase::IntegrateVelocity);
+
 #ifdef JPH_ENABLE_ASSERTS
 	// We update positions and need velocity to do so, we also clamp velocities so need to write to them
 	BodyAccess::Grant grant(BodyAccess::EAccess::ReadWrite, BodyAccess::EAccess::ReadWrite);
@@ -1579,6 +1960,8 @@ void PhysicsSystem::JobIntegrateVelocity(const PhysicsUpdateContext *ioContext,
 
 void PhysicsSystem::JobPostIntegrateVelocity(PhysicsUpdateContext *ioContext, PhysicsUpdateContext::Step *ioStep) const
 {
+	PhysicsUpdateContext::PhaseTimer timer(ioContext, EPhysicsUpdatePhase::IntegrateVelocity);
+
 	// Validate that our reservations were correct
 	JPH_ASSERT(ioStep->mNumCCDBodies <= mBodyManager.GetNumActiveCCDBodies());
 
@@ -1648,6 +2031,8 @@ inline static PhysicsUpdateContext::Step::CCDBody *sGetCCDBody(const Body &inBod
 
 void PhysicsSystem::JobFindCCDContacts(const PhysicsUpdateContext *ioContext, PhysicsUpdateContext::Step *ioStep)
 {
+	PhysicsUpdateContext::PhaseTimer timer(ioContext, EPhysicsUpdatePhase::CCD);
+
 #ifdef JPH_ENABLE_ASSERTS
 	// We only read positions, but the validate callback may read body positions and velocities
 	BodyAccess::Grant grant(BodyAccess::EAccess::Read, BodyAccess::EAccess::Read);
@@ -1689,6 +2074,46 @@ void PhysicsSystem::JobFindCCDContacts(const PhysicsUpdateContext *ioContext, Ph
 		}
 	#endif // JPH_DEBUG_RENDERER
 
+		// Get the swept volume of this body and check if the sweep of this step is still inside it
+		CCDSweptVolume *swept_volume = nullptr;
+		Vec3 swept_volume_direction = Vec3::sZero();
+		if (mPhysicsSettings.mUseCCDSweptVolumeCache)
+		{
+			swept_volume = &mCCDSweptVolumes[body.GetID().GetIndex()];
+			RVec3 start = body.GetCenterOfMassPosition();
+			Quat rotation = body.GetRotation();
+
+			// Test if a point lies on the sweep, we're allowed to penetrate by mMaxPenetration so we allow a deviation of half of that
+			float tolerance_sq = Square(0.5f * ccd_body.mMaxPenetration);
+			auto is_on_sweep = [swept_volume, tolerance_sq](Vec3Arg inPoint) {
+				float fraction = Clamp(inPoint.Dot(swept_volume->mDirection) / swept_volume->mDirection.LengthSq(), 0.0f, 1.0f);
+				return (inPoint - fraction * swept_volume->mDirection).LengthSq() <= tolerance_sq;
+			};
+
+			Vec3 relative_start = Vec3(start - swept_volume->mStart);
+			if (swept_volume->mBodyID != body.GetID()
+				|| swept_volume->mStep + 1 != mCCDSweptVolumeStep
+				|| swept_volume->mRotation != rotation
+				|| body.IsCollisionCacheInvalid()
+				|| !is_on_sweep(relative_start)
+				|| !is_on_sweep(relative_start + ccd_body.mDeltaPosition))
+			{
+				// Start a new swept volume that looks ahead along the current movement
+				swept_volume->mBodyID = body.GetID();
+				swept_volume->mStart = start;
+				swept_volume->mDirection = (1.0f + mPhysicsSettings.mCCDSweptVolumeLookAhead) * ccd_body.mDeltaPosition;
+				swept_volume->mRotation = rotation;
+				for (CCDSweptVolume::ClearBody *b = swept_volume->mClearBodies, *b_end = b + swept_volume->mNumClearBodies; b < b_end; ++b)
+					b->mShape = nullptr;
+				swept_volume->mNumClearBodies = 0;
+				relative_start = Vec3::sZero();
+			}
+			swept_volume->mStep = mCCDSweptVolumeStep;
+
+			// Direction of a cast from the current position to the end of the swept volume
+			swept_volume_direction = swept_volume->mDirection - relative_start;
+		}
+
 		// Create a collector that will find the maximum distance allowed to travel while not penetrating more than 'max penetration'
 		class CCDNarrowPhaseCollector : public CastShapeCollector
 		{
@@ -1801,7 +2226,7 @@ void PhysicsSystem::JobFindCCDContacts(const PhysicsUpdateContext *ioContext, Ph
 		class CCDBroadPhaseCollector : public CastShapeBodyCollector
 		{
 		public:
-										CCDBroadPhaseCollector(const CCDBody &inCCDBody, const Body &inBody1, const RShapeCast &inShapeCast, ShapeCastSettings &inShapeCastSettings, CCDNarrowPhaseCollector &ioCollector, const BodyManager &inBodyManager, PhysicsUpdateContext::Step *inStep, float inDeltaTime) :
+										CCDBroadPhaseCollector(const CCDBody &inCCDBody, const Body &inBody1, const RShapeCast &inShapeCast, ShapeCastSettings &inShapeCastSettings, CCDNarrowPhaseCollector &ioCollector, const BodyManager &inBodyManager, PhysicsUpdateContext::Step *inStep, float inDeltaTime, CCDSweptVolume *ioSweptVolume, Vec3Arg inSweptVolumeDirection) :
 				mCCDBody(inCCDBody),
 				mBody1(inBody1),
 				mBody1Extent(inShapeCast.mShapeWorldBounds.GetExtent()),
@@ -1810,10 +2235,61 @@ void PhysicsSystem::JobFindCCDContacts(const PhysicsUpdateContext *ioContext, Ph
 				mCollector(ioCollector),
 				mBodyManager(inBodyManager),
 				mStep(inStep),
-				mDeltaTime(inDeltaTime)
+				mDeltaTime(inDeltaTime),
+				mSweptVolume(ioSweptVolume),
+				mSweptVolumeDirection(inSweptVolumeDirection)
 			{
 			}
 
+			/// Check if body 2 was found to be outside of the swept volume before, if not test it against the swept volume.
+			/// Returns true if body 2 doesn't intersect with the swept volume and the narrow phase can be skipped.
+			bool						IsClearOfSweptVolume(const Body &inBody2)
+			{
+				// Calculate a hash that changes when body 2 is moved
+				RVec3 position = inBody2.GetCenterOfMassPosition();
+				Real position_data[] = { position.GetX(), position.GetY(), position.GetZ() };
+				Quat rotation = inBody2.GetRotation();
+				uint64 state_hash = HashBytes(position_data, sizeof(position_data));
+				state_hash = HashBytes(&rotation, sizeof(rotation), state_hash);
+
+				// Check if we already know that body 2 is clear
+				CCDSweptVolume::ClearBody *clear_body = nullptr;
+				for (CCDSweptVolume::ClearBody *b = mSweptVolume->mClearBodies, *b_end = b + mSweptVolume->mNumClearBodies; b < b_end; ++b)
+					if (b->mBodyID == inBody2.GetID())
+					{
+						if (b->mStateHash == state_hash && b->mShape == inBody2.GetShape())
+						{
+							JPH_IF_TRACK_NARROWPHASE_STATS(++CCDSweptVolumeStat::sNumCacheHits;)
+							return true;
+						}
+						clear_body = b;
+						break;
+					}
+
+				// Cast against the remainder of the swept volume
+				JPH_IF_TRACK_NARROWPHASE_STATS(++CCDSweptVolumeStat::sNumProbes;)
+				AnyHitCollisionCollector<CastShapeCollector> collector;
+				mShapeCastSettings.mActiveEdgeMovementDirection = mSweptVolumeDirection;
+				RShapeCast swept_volume_cast(mShapeCast.mShape, mShapeCast.mScale, mShapeCast.mCenterOfMassStart, mSweptVolumeDirection);
+				inBody2.GetTransformedShape().CastShape(swept_volume_cast, mShapeCastSettings, mShapeCast.mCenterOfMassStart.GetTranslation(), collector);
+				if (collector.HadHit())
+					return false;
+				JPH_IF_TRACK_NARROWPHASE_STATS(++CCDSweptVolumeStat::sNumProbeMisses;)
+
+				// Remember that body 2 is clear so that we can skip it in the next steps
+				if (clear_body == nullptr && mSweptVolume->mNumClearBodies < CCDSweptVolume::cMaxClearBodies)
+				{
+					clear_body = &mSweptVolume->mClearBodies[mSweptVolume->mNumClearBodies++];
+					clear_body->mBodyID = inBody2.GetID();
+				}
+				if (clear_body != nullptr)
+				{
+					clear_body->mShape = inBody2.GetShape();
+					clear_body->mStateHash = state_hash;
+				}
+				return true;
+			}
+
 			virtual void				AddHit(const BroadPhaseCastResult &inResult) override
 			{
 				JPH_PROFILE_FUNCTION();
@@ -1853,6 +2329,14 @@ void PhysicsSystem::JobFindCCDContacts(const PhysicsUpdateContext *ioContext, Ph
 				if (hit_fraction > GetPositiveEarlyOutFraction()) // If early out fraction <= 0, we have the possibility of finding a deeper hit so we need to clamp the early out fraction
 					return;
 
+				// If body 2 is not moving, check if it is outside of the swept volume
+				if (mSweptVolume != nullptr
+					&& !body2.IsActive()
+					&& !body2.IsCollisionCacheInvalid()
+					&& direction == mShapeCast.mDirection
+					&& IsClearOfSweptVolume(body2))
+					return;
+
 				// Reset collector (this is a new body pair)
 				mCollector.ResetEarlyOutFraction(GetEarlyOutFraction());
 				mCollector.mValidateBodyPair = true;
@@ -1879,11 +2363,13 @@ void PhysicsSystem::JobFindCCDContacts(const PhysicsUpdateContext *ioContext, Ph
 			const BodyManager &			mBodyManager;
 			PhysicsUpdateContext::Step *mStep;
 			float						mDeltaTime;
+			CCDSweptVolume *			mSweptVolume;
+			Vec3						mSweptVolumeDirection;
 		};
 
 		// Check if we collide with any other body. Note that we use the non-locking interface as we know the broadphase cannot be modified at this point.
 		RShapeCast shape_cast(body.GetShape(), Vec3::sReplicate(1.0f), body.GetCenterOfMassTransform(), ccd_body.mDeltaPosition);
-		CCDBroadPhaseCollector bp_collector(ccd_body, body, shape_cast, settings, np_collector, mBodyManager, ioStep, ioContext->mStepDeltaTime);
+		CCDBroadPhaseCollector bp_collector(ccd_body, body, shape_cast, settings, np_collector, mBodyManager, ioStep, ioContext->mStepDeltaTime, swept_volume, swept_volume_direction);
 		mBroadPhase->CastAABoxNoLock({ shape_cast.mShapeWorldBounds, shape_cast.mDirection }, bp_collector, broadphase_layer_filter, object_layer_filter);
 
 		// Check if there was a hit
@@ -1932,21 +2418,26 @@ void PhysicsSystem::JobFindCCDContacts(const PhysicsUpdateContext *ioContext, Ph
 
 void PhysicsSystem::JobResolveCCDContacts(PhysicsUpdateContext *ioContext, PhysicsUpdateContext::Step *ioStep)
 {
-#ifdef JPH_ENABLE_ASSERTS
-	// Read/write body access
-	BodyAccess::Grant grant(BodyAccess::EAccess::ReadWrite, BodyAccess::EAccess::ReadWrite);
+	PhysicsUpdateContext::PhaseTimer timer(ioContext, EPhysicsUpdatePhase::CCD);
 
-	// We activate bodies that we collide with
-	BodyManager::GrantActiveBodiesAccess grant_active(true, false);
-#endif
+	// Check if there's anything to do
+	uint num_ccd_bodies = ioStep->mNumCCDBodies;
+	if (num_ccd_bodies == 0)
+		return;
 
-	uint32 num_active_bodies_after_find_collisions = ioStep->mActiveBodyReadIdx;
+	// Allocate the arrays that need to stay alive until JobFinalizeCCDContacts
 	TempAllocator *temp_allocator = ioContext->mTempAllocator;
+	JPH_ASSERT(ioStep->mSortedCCDBodies == nullptr);
+	ioStep->mSortedCCDBodies = (CCDBody **)temp_allocator->Allocate(num_ccd_bodies * sizeof(CCDBody *));
+	ioStep->mCCDGroupEnds = (uint32 *)temp_allocator->Allocate(num_ccd_bodies * sizeof(uint32));
+	ioStep->mCCDBodiesToActivate = (BodyID *)temp_allocator->Allocate(num_ccd_bodies * sizeof(BodyID));
 
-	// Check if there's anything to do
-	uint num_ccd_bodies = ioStep->mNumCCDBodies;
-	if (num_ccd_bodies > 0)
 	{
+	#ifdef JPH_ENABLE_ASSERTS
+		// We only read the bodies to determine which CCD bodies can interact
+		BodyAccess::Grant grant(BodyAccess::EAccess::Read, BodyAccess::EAccess::Read);
+	#endif
+
 		// Sort on fraction so that we process earliest collisions first
 		// This is needed to make the simulation deterministic and also to be able to stop contact processing
 		// between body pairs if an earlier hit was found involving the body by another CCD body
@@ -1973,19 +2464,159 @@ void PhysicsSystem::JobResolveCCDContacts(PhysicsUpdateContext *ioContext, Physi
 				});
 		}
 
-		// We can collide with bodies that are not active, we track them here so we can activate them in one go at the end.
-		// This is also needed because we can't modify the active body array while we iterate it.
-		static constexpr int cBodiesBatch = 64;
-		BodyID *bodies_to_activate = (BodyID *)JPH_STACK_ALLOC(cBodiesBatch * sizeof(BodyID));
-		int num_bodies_to_activate = 0;
+		JPH_PROFILE("Group");
+
+		// Resolving a contact modifies the velocity of the body that was hit (if it is dynamic) and the CCD body of that body (if it has one).
+		// We partition the CCD bodies in groups that don't share any dynamic bodies using a union find structure over the sorted CCD bodies.
+		// The root of a group is always the lowest sorted index, so that the groups don't depend on the order in which we merge them.
+		uint32 *parent = (uint32 *)temp_allocator->Allocate(num_ccd_bodies * sizeof(uint32));
+		JPH_SCOPE_EXIT([temp_allocator, parent, num_ccd_bodies]{ temp_allocator->Free(parent, num_ccd_bodies * sizeof(uint32)); });
+		uint32 *sorted_index = (uint32 *)temp_allocator->Allocate(num_ccd_bodies * sizeof(uint32));
+		JPH_SCOPE_EXIT([temp_allocator, sorted_index, num_ccd_bodies]{ temp_allocator->Free(sorted_index, num_ccd_bodies * sizeof(uint32)); });
+		for (uint i = 0; i < num_ccd_bodies; ++i)
+		{
+			parent[i] = i;
+			sorted_index[sorted_ccd_bodies[i] - ioStep->mCCDBodies] = i;
+		}
+
+		auto find_root = [parent](uint32 inIndex)
+		{
+			while (parent[inIndex] != inIndex)
+			{
+				parent[inIndex] = parent[parent[inIndex]]; // Path halving
+				inIndex = parent[inIndex];
+			}
+			return inIndex;
+		};
+
+		auto merge = [parent, &find_root](uint32 inIndex1, uint32 inIndex2)
+		{
+			uint32 root1 = find_root(inIndex1);
+			uint32 root2 = find_root(inIndex2);
+			if (root1 < root2)
+				parent[root2] = root1;
+			else if (root2 < root1)
+				parent[root1] = root2;
+		};
 
-		// We can move bodies that are not part of an island. In this case we need to notify the broadphase of the movement.
-		BodyID *bodies_to_update_bounds = (BodyID *)JPH_STACK_ALLOC(cBodiesBatch * sizeof(BodyID));
-		int num_bodies_to_update_bounds = 0;
+		// Dynamic bodies without a CCD body that were hit, we sort these on body ID to find CCD bodies that hit the same body
+		struct HitBody
+		{
+			BodyID				mBodyID;
+			uint32				mSortedIndex;
+		};
+		HitBody *hit_bodies = (HitBody *)temp_allocator->Allocate(num_ccd_bodies * sizeof(HitBody));
+		JPH_SCOPE_EXIT([temp_allocator, hit_bodies, num_ccd_bodies]{ temp_allocator->Free(hit_bodies, num_ccd_bodies * sizeof(HitBody)); });
+		uint num_hit_bodies = 0;
 
 		for (uint i = 0; i < num_ccd_bodies; ++i)
 		{
 			const CCDBody *ccd_body = sorted_ccd_bodies[i];
+			if (ccd_body->mBodyID2.IsInvalid())
+				continue;
+
+			// Static and kinematic bodies are not modified, so they don't connect CCD bodies
+			const Body &body2 = mBodyManager.GetBody(ccd_body->mBodyID2);
+			if (!body2.IsDynamic())
+				continue;
+
+			const CCDBody *ccd_body2 = sGetCCDBody(body2, ioStep);
+			if (ccd_body2 != nullptr)
+				merge(i, sorted_index[ccd_body2 - ioStep->mCCDBodies]);
+			else
+				hit_bodies[num_hit_bodies++] = { ccd_body->mBodyID2, i };
+		}
+
+		QuickSort(hit_bodies, hit_bodies + num_hit_bodies, [](const HitBody &inLHS, const HitBody &inRHS) { return inLHS.mBodyID < inRHS.mBodyID; });
+		for (uint i = 1; i < num_hit_bodies; ++i)
+			if (hit_bodies[i].mBodyID == hit_bodies[i - 1].mBodyID)
+				merge(hit_bodies[i].mSortedIndex, hit_bodies[i - 1].mSortedIndex);
+
+		// Number the groups in order of their first CCD body and count the number of CCD bodies in each group
+		uint32 *group_of = sorted_index; // No longer needed, reuse the memory
+		uint32 *group_ends = ioStep->mCCDGroupEnds;
+		uint32 num_groups = 0;
+		for (uint i = 0; i < num_ccd_bodies; ++i)
+		{
+			uint32 root = find_root(i);
+			uint32 group;
+			if (root == i)
+			{
+				group = num_groups++;
+				group_ends[group] = 0;
+			}
+			else
+				group = group_of[root]; // Root is always lower than i so has already been assigned
+			group_of[i] = group;
+			group_ends[group]++;
+		}
+
+		// Convert the counts into start indices
+		uint32 group_start = 0;
+		for (uint32 g = 0; g < num_groups; ++g)
+		{
+			uint32 count = group_ends[g];
+			group_ends[g] = group_start;
+			group_start += count;
+		}
+
+		// Distribute the CCD bodies over the groups, this keeps the bodies within a group sorted on fraction and turns the start indices into end indices
+		for (uint i = 0; i < num_ccd_bodies; ++i)
+			ioStep->mSortedCCDBodies[group_ends[group_of[i]]++] = sorted_ccd_bodies[i];
+		ioStep->mNumCCDGroups = num_groups;
+	}
+
+	// Spawn additional jobs if there are enough independent groups
+	int num_resolve_jobs = min(int(ioStep->mNumCCDGroups + cNumCCDGroupsPerJob - 1) / cNumCCDGroupsPerJob, ioContext->GetMaxConcurrency());
+	if (num_resolve_jobs > 1)
+	{
+		ioStep->mFinalizeCCDContacts.AddDependency(num_resolve_jobs - 1);
+		for (int i = 1; i < num_resolve_jobs; ++i)
+		{
+			JobHandle job = ioContext->mJobSystem->CreateJob("ResolveCCDContactGroups", cColorResolveCCDContacts, [ioContext, ioStep]()
+			{
+				{
+					PhysicsUpdateContext::PhaseTimer timer(ioContext, EPhysicsUpdatePhase::CCD);
+					ioContext->mPhysicsSystem->JobResolveCCDContactGroups(ioStep);
+				}
+
+				ioStep->mFinalizeCCDContacts.RemoveDependency();
+			});
+			ioContext->mBarrier->AddJob(job);
+		}
+	}
+
+	// Help resolving the groups
+	JobResolveCCDContactGroups(ioStep);
+}
+
+void PhysicsSystem::JobResolveCCDContactGroups(PhysicsUpdateContext::Step *ioStep)
+{
+#ifdef JPH_ENABLE_ASSERTS
+	// Read/write body access
+	BodyAccess::Grant grant(BodyAccess::EAccess::ReadWrite, BodyAccess::EAccess::ReadWrite);
+#endif
+
+	uint32 num_active_bodies_after_find_collisions = ioStep->mActiveBodyReadIdx;
+
+	// We can move bodies that are not part of an island. In this case we need to notify the broadphase of the movement.
+	static constexpr int cBodiesBatch = 64;
+	BodyID *bodies_to_update_bounds = (BodyID *)JPH_STACK_ALLOC(cBodiesBatch * sizeof(BodyID));
+	int num_bodies_to_update_bounds = 0;
+
+	for (;;)
+	{
+		// Fetch the next group to resolve
+		uint32 group = ioStep->mNextCCDGroup++;
+		if (group >= ioStep->mNumCCDGroups)
+			break;
+
+		// Groups don't share any dynamic bodies, so within a group we resolve in order of hit fraction which gives the same result as resolving all CCD bodies sequentially
+		for (uint32 i = group > 0? ioStep->mCCDGroupEnds[group - 1] : 0, i_end = ioStep->mCCDGroupEnds[group]; i < i_end; ++i)
+		{
+			ioStep->mCCDBodiesToActivate[i] = BodyID();
+
+			const CCDBody *ccd_body = ioStep->mSortedCCDBodies[i];
 			Body &body1 = mBodyManager.GetBody(ccd_body->mBodyID1);
 			MotionProperties *body_mp = body1.GetMotionProperties();
 
@@ -2132,17 +2763,9 @@ void PhysicsSystem::JobResolveCCDContacts(PhysicsUpdateContext *ioContext, Physi
 					body_mp->ClampLinearVelocity();
 					body_mp->ClampAngularVelocity();
 
-					// Activate the 2nd body if it is not already active
+					// Activate the 2nd body if it is not already active (this is deferred to JobFinalizeCCDContacts as we cannot modify the active bodies list from multiple threads deterministically)
 					if (body2.IsDynamic() && !body2.IsActive())
-					{
-						bodies_to_activate[num_bodies_to_activate++] = ccd_body->mBodyID2;
-						if (num_bodies_to_activate == cBodiesBatch)
-						{
-							// Batch is full, activate now
-							mBodyManager.ActivateBodies(bodies_to_activate, num_bodies_to_activate);
-							num_bodies_to_activate = 0;
-						}
-					}
+						ioStep->mCCDBodiesToActivate[i] = ccd_body->mBodyID2;
 
 				#ifdef JPH_DEBUG_RENDERER
 					if (sDrawMotionQualityLinearCast)
@@ -2185,14 +2808,41 @@ void PhysicsSystem::JobResolveCCDContacts(PhysicsUpdateContext *ioContext, Physi
 				}
 			}
 		}
+	}
 
-		// Activate the requested bodies
-		if (num_bodies_to_activate > 0)
-			mBodyManager.ActivateBodies(bodies_to_activate, num_bodies_to_activate);
+	// Notify change bounds on requested bodies
+	if (num_bodies_to_update_bounds > 0)
+		mBroadPhase->NotifyBodiesAABBChanged(bodies_to_update_bounds, num_bodies_to_update_bounds, false);
+}
 
-		// Notify change bounds on requested bodies
-		if (num_bodies_to_update_bounds > 0)
-			mBroadPhase->NotifyBodiesAABBChanged(bodies_to_update_bounds, num_bodies_to_update_bounds, false);
+void PhysicsSystem::JobFinalizeCCDContacts(PhysicsUpdateContext *ioContext, PhysicsUpdateContext::Step *ioStep)
+{
+	PhysicsUpdateContext::PhaseTimer timer(ioContext, EPhysicsUpdatePhase::CCD);
+
+#ifdef JPH_ENABLE_ASSERTS
+	// Read/write body access
+	BodyAccess::Grant grant(BodyAccess::EAccess::ReadWrite, BodyAccess::EAccess::ReadWrite);
+
+	// We activate bodies that we collide with
+	BodyManager::GrantActiveBodiesAccess grant_active(true, false);
+#endif
+
+	TempAllocator *temp_allocator = ioContext->mTempAllocator;
+
+	uint num_ccd_bodies = ioStep->mNumCCDBodies;
+	if (num_ccd_bodies > 0)
+	{
+		// We can collide with bodies that are not active, activate them in one go in the order of mSortedCCDBodies to keep the simulation deterministic (invalid body IDs are skipped)
+		mBodyManager.ActivateBodies(ioStep->mCCDBodiesToActivate, (int)num_ccd_bodies);
+
+		// Free the arrays allocated by JobResolveCCDContacts in reverse order
+		temp_allocator->Free(ioStep->mCCDBodiesToActivate, num_ccd_bodies * sizeof(BodyID));
+		ioStep->mCCDBodiesToActivate = nullptr;
+		temp_allocator->Free(ioStep->mCCDGroupEnds, num_ccd_bodies * sizeof(uint32));
+		ioStep->mCCDGroupEnds = nullptr;
+		ioStep->mNumCCDGroups = 0;
+		temp_allocator->Free(ioStep->mSortedCCDBodies, num_ccd_bodies * sizeof(CCDBody *));
+		ioStep->mSortedCCDBodies = nullptr;
 	}
 
 	// Ensure we free the CCD bodies array now, will not call the destructor!
@@ -2206,6 +2856,8 @@ void PhysicsSystem::JobResolveCCDContacts(PhysicsUpdateContext *ioContext, Physi
 
 void PhysicsSystem::JobContactRemovedCallbacks(const PhysicsUpdateContext::Step *ioStep)
 {
+	PhysicsUpdateContext::PhaseTimer timer(ioStep->mContext, EPhysicsUpdatePhase::ContactRemovedCallbacks);
+
 #ifdef JPH_ENABLE_ASSERTS
 	// We don't touch any bodies
 	BodyAccess::Grant grant(BodyAccess::EAccess::None, BodyAccess::EAccess::None);
@@ -2323,6 +2975,8 @@ void PhysicsSystem::CheckSleepAndUpdateBounds(uint32 inIslandIndex, const Physic
 
 void PhysicsSystem::JobSolvePositionConstraints(PhysicsUpdateContext *ioContext, PhysicsUpdateContext::Step *ioStep)
 {
+	PhysicsUpdateContext::PhaseTimer timer(ioContext, EPhysicsUpdatePhase::SolvePositionConstraints);
+
 #ifdef JPH_ENABLE_ASSERTS
 	// We fix up position errors
 	BodyAccess::Grant grant(BodyAccess::EAccess::None, BodyAccess::EAccess::ReadWrite);
@@ -2426,6 +3080,8 @@ void PhysicsSystem::JobSolvePositionConstraints(PhysicsUpdateContext *ioContext,
 
 void PhysicsSystem::JobSoftBodyPrepare(PhysicsUpdateContext *ioContext, PhysicsUpdateContext::Step *ioStep)
 {
+	PhysicsUpdateContext::PhaseTimer timer(ioContext, EPhysicsUpdatePhase::SoftBodies);
+
 	JPH_PROFILE_FUNCTION();
 
 	{
@@ -2507,6 +3163,8 @@ void PhysicsSystem::JobSoftBodyPrepare(PhysicsUpdateContext *ioContext, PhysicsU
 
 void PhysicsSystem::JobSoftBodyCollide(PhysicsUpdateContext *ioContext) const
 {
+	PhysicsUpdateContext::PhaseTimer timer(ioContext, EPhysicsUpdatePhase::SoftBodies);
+
 #ifdef JPH_ENABLE_ASSERTS
 	// Reading rigid body positions and velocities
 	BodyAccess::Grant grant(BodyAccess::EAccess::Read, BodyAccess::EAccess::Read);
@@ -2527,6 +3185,8 @@ void PhysicsSystem::JobSoftBodyCollide(PhysicsUpdateContext *ioContext) const
 
 void PhysicsSystem::JobSoftBodySimulate(PhysicsUpdateContext *ioContext, uint inThreadIndex) const
 {
+	PhysicsUpdateContext::PhaseTimer timer(ioContext, EPhysicsUpdatePhase::SoftBodies);
+
 #ifdef JPH_ENABLE_ASSERTS
 	// Updating velocities of soft bodies, allow the contact listener to read the soft body state
 	BodyAccess::Grant grant(BodyAccess::EAccess::ReadWrite, BodyAccess::EAccess::Read);
@@ -2567,6 +3227,8 @@ void PhysicsSystem::JobSoftBodySimulate(PhysicsUpdateContext *ioContext, uint in
 
 void PhysicsSystem::JobSoftBodyFinalize(PhysicsUpdateContext *ioContext)
 {
+	PhysicsUpdateContext::PhaseTimer timer(ioContext, EPhysicsUpdatePhase::SoftBodies);
+
 #ifdef JPH_ENABLE_ASSERTS
 	// Updating rigid body velocities and soft body positions / velocities
 	BodyAccess::Grant grant(BodyAccess::EAccess::ReadWrite, BodyAccess::EAccess::ReadWrite);
@@ -5,6 +5,7 @@
 #pragma once
 
 #include <Jolt/Physics/Body/BodyInterface.h>
+#include <Jolt/Physics/Collision/BroadPhase/BroadPhase.h>
 #include <Jolt/Physics/Collision/NarrowPhaseQuery.h>
 #include <Jolt/Physics/Collision/ContactListener.h>
 #include <Jolt/Physics/Constraints/ContactConstraintManager.h>
@@ -21,6 +22,7 @@ class StateRecorder;
 class TempAllocator;
 class PhysicsStepListener;
 class SoftBodyContactListener;
+class CollideShapeSettings;
 
 /// The main class for the physics system. It contains all rigid bodies and simulates them.
 ///
@@ -42,7 +44,8 @@ public:
 	/// @param inBroadPhaseLayerInterface Information on the mapping of object layers to broad phase layers. Since this is a virtual interface, the instance needs to stay alive during the lifetime of the PhysicsSystem.
 	/// @param inObjectVsBroadPhaseLayerFilter Filter callback function that is used to determine if an object layer collides with a broad phase layer. Since this is a virtual interface, the instance needs to stay alive during the lifetime of the PhysicsSystem.
 	/// @param inObjectLayerPairFilter Filter callback function that is used to determine if two object layers collide. Since this is a virtual interface, the instance needs to stay alive during the lifetime of the PhysicsSystem.
-	void						Init(uint inMaxBodies, uint inNumBodyMutexes, uint inMaxBodyPairs, uint inMaxContactConstraints, const BroadPhaseLayerInterface &inBroadPhaseLayerInterface, const ObjectVsBroadPhaseLayerFilter &inObjectVsBroadPhaseLayerFilter, const ObjectLayerPairFilter &inObjectLayerPairFilter);
+	/// @param inBroadPhaseType Which broadphase implementation to use.
+	void						Init(uint inMaxBodies, uint inNumBodyMutexes, uint inMaxBodyPairs, uint inMaxContactConstraints, const BroadPhaseLayerInterface &inBroadPhaseLayerInterface, const ObjectVsBroadPhaseLayerFilter &inObjectVsBroadPhaseLayerFilter, const ObjectLayerPairFilter &inObjectLayerPairFilter, EBroadPhaseType inBroadPhaseType = EBroadPhaseType::QuadTree);
 
 	/// Listener that is notified whenever a body is activated/deactivated
 	void						SetBodyActivationListener(BodyActivationListener *inListener) { mBodyManager.SetBodyActivationListener(inListener); }
@@ -52,6 +55,22 @@ public:
 	void						SetContactListener(ContactListener *inListener)				{ mContactManager.SetContactListener(inListener); }
 	ContactListener *			GetContactListener() const									{ return mContactManager.GetContactListener(); }
 
+	/// Record contact added / persisted / removed events in a buffer instead of (or in addition to) using a ContactListener.
+	/// Events are written to per thread blocks without taking locks and are sorted at the end of Update, so reading them afterwards is deterministic.
+	/// inMaxContactEvents is the maximum amount of events that can be recorded per Update, 0 disables recording (default).
+	/// Every job reserves events in blocks of 64, so the buffer holds an extra block per job and collision step on top of inMaxContactEvents to account for partially filled blocks.
+	void						SetMaxContactEvents(uint inMaxContactEvents)				{ mContactManager.SetMaxContactEvents(inMaxContactEvents); }
+	uint						GetMaxContactEvents() const									{ return mContactManager.GetMaxContactEvents(); }
+
+	/// Get the contact events that were recorded during the last call to Update, sorted on ContactEvent::mSubShapePair and collision step.
+	/// The events stay valid until the next call to Update.
+	const ContactEvent *		GetContactEvents() const									{ return mContactManager.GetContactEvents(); }
+	uint						GetNumContactEvents() const									{ return mContactManager.GetNumContactEvents(); }
+
+	/// Get the capacity, peak usage during the last update and memory usage of the contact cache and contact constraint buffer.
+	/// Can be used to tune the inMaxBodyPairs / inMaxContactConstraints parameters of Init or to monitor PhysicsSettings::mUseAdaptiveContactCache.
+	ContactCacheStats			GetContactCacheStats() const								{ return mContactManager.GetCacheStats(); }
+
 	/// Listener that is notified whenever a contact point between a soft body and another body
 	void						SetSoftBodyContactListener(SoftBodyContactListener *inListener) { mSoftBodyContactListener = inListener; }
 	SoftBodyContactListener *	GetSoftBodyContactListener() const							{ return mSoftBodyContactListener; }
@@ -101,6 +120,9 @@ public:
 	/// Optimize the broadphase, needed only if you've added many bodies prior to calling Update() for the first time.
 	void						OptimizeBroadPhase();
 
+	/// Same as OptimizeBroadPhase but rebuilds the broadphase using multiple jobs of inJobSystem. This function waits until the jobs have completed.
+	void						OptimizeBroadPhase(JobSystem *inJobSystem);
+
 	/// Adds a new step listener
 	void						AddStepListener(PhysicsStepListener *inListener);
 
@@ -173,6 +195,10 @@ public:
 	/// Get stats about the bodies in the body manager (slow, iterates through all bodies)
 	BodyStats					GetBodyStats() const										{ return mBodyManager.GetBodyStats(); }
 
+	/// Get lightweight statistics about the last Update call, like the time spent in each phase and the number of contacts and islands.
+	/// Should not be called while Update is running.
+	const PhysicsUpdateStats &	GetUpdateStats() const										{ return mUpdateStats; }
+
 	/// Get copy of the list of all bodies under protection of a lock.
 	/// @param outBodyIDs On return, this will contain the list of BodyIDs
 	void						GetBodies(BodyIDVector &outBodyIDs) const					{ return mBodyManager.GetBodyIDs(outBodyIDs); }
@@ -205,13 +231,15 @@ private:
 	using CCDBody = PhysicsUpdateContext::Step::CCDBody;
 
 	// Various job entry points
+	void						JobUpdateBroadPhasePrepare(PhysicsUpdateContext *ioContext, PhysicsUpdateContext::Step *ioStep);
+	void						JobUpdateBroadPhasePrepareBatches(PhysicsUpdateContext *ioContext, PhysicsUpdateContext::Step *ioStep);
 	void						JobStepListeners(PhysicsUpdateContext::Step *ioStep);
 	void						JobDetermineActiveConstraints(PhysicsUpdateContext::Step *ioStep) const;
 	void						JobApplyGravity(const PhysicsUpdateContext *ioContext, PhysicsUpdateContext::Step *ioStep);
 	void						JobSetupVelocityConstraints(float inDeltaTime, PhysicsUpdateContext::Step *ioStep) const;
 	void						JobBuildIslandsFromConstraints(PhysicsUpdateContext *ioContext, PhysicsUpdateContext::Step *ioStep);
 	void						JobFindCollisions(PhysicsUpdateContext::Step *ioStep, int inJobIndex);
-	void						JobFinalizeIslands(PhysicsUpdateContext *ioContext);
+	void						JobFinalizeIslands(PhysicsUpdateContext *ioContext, PhysicsUpdateContext::Step *ioStep);
 	void						JobBodySetIslandIndex();
 	void						JobSolveVelocityConstraints(PhysicsUpdateContext *ioContext, PhysicsUpdateContext::Step *ioStep);
 	void						JobPreIntegrateVelocity(PhysicsUpdateContext *ioContext, PhysicsUpdateContext::Step *ioStep);
@@ -219,6 +247,8 @@ private:
 	void						JobPostIntegrateVelocity(PhysicsUpdateContext *ioContext, PhysicsUpdateContext::Step *ioStep) const;
 	void						JobFindCCDContacts(const PhysicsUpdateContext *ioContext, PhysicsUpdateContext::Step *ioStep);
 	void						JobResolveCCDContacts(PhysicsUpdateContext *ioContext, PhysicsUpdateContext::Step *ioStep);
+	void						JobResolveCCDContactGroups(PhysicsUpdateContext::Step *ioStep);
+	void						JobFinalizeCCDContacts(PhysicsUpdateContext *ioContext, PhysicsUpdateContext::Step *ioStep);
 	void						JobContactRemovedCallbacks(const PhysicsUpdateContext::Step *ioStep);
 	void						JobSolvePositionConstraints(PhysicsUpdateContext *ioContext, PhysicsUpdateContext::Step *ioStep);
 	void						JobSoftBodyPrepare(PhysicsUpdateContext *ioContext, PhysicsUpdateContext::Step *ioStep);
@@ -226,13 +256,27 @@ private:
 	void						JobSoftBodySimulate(PhysicsUpdateContext *ioContext, uint inThreadIndex) const;
 	void						JobSoftBodyFinalize(PhysicsUpdateContext *ioContext);
 
-	/// Tries to spawn a new FindCollisions job if max concurrency hasn't been reached yet
-	void						TrySpawnJobFindCollisions(PhysicsUpdateContext::Step *ioStep) const;
+	/// Tries to spawn a new FindCollisions job if max concurrency hasn't been reached yet, inNumExtraJobs is the amount of jobs that are needed on top of the ones needed for the queued body pairs and active bodies
+	void						TrySpawnJobFindCollisions(PhysicsUpdateContext::Step *ioStep, uint inNumExtraJobs = 0) const;
 
 	using ContactAllocator = ContactConstraintManager::ContactAllocator;
 
-	/// Process narrow phase for a single body pair
-	void						ProcessBodyPair(ContactAllocator &ioContactAllocator, const BodyPair &inBodyPair);
+	/// Process narrow phase for a single body pair.
+	/// When inSplitPair is not null, the body pair has been split up and all ranges have been processed. In this case the hits of the ranges are used instead of colliding the shapes.
+	void						ProcessBodyPair(PhysicsUpdateContext::Step *ioStep, int inJobIndex, ContactAllocator &ioContactAllocator, const BodyPair &inBodyPair, const PhysicsUpdateContext::SplitBodyPair *inSplitPair = nullptr);
+
+	/// Helper functions for ProcessBodyPair
+	/// Collide the shapes of a body pair or pass on the hits of a body pair that was split up
+	static void					sCollideBodyPairShapes(const Body &inBody1, const Body &inBody2, const CollideShapeSettings &inSettings, Mat44Arg inTransform1, Mat44Arg inTransform2, const PhysicsUpdateContext::SplitBodyPair *inSplitPair, CollideShapeCollector &ioCollector);
+	/// Split up the narrow phase of a body pair that contains a large compound shape (see PhysicsSettings::mSplitLargeCompoundCollisions).
+	/// Returns false if the body pair was not split up, otherwise the job that processes the last range will call ProcessBodyPair again to add the contacts.
+	bool						TrySplitBodyPair(PhysicsUpdateContext::Step *ioStep, int inJobIndex, ContactAllocator &ioContactAllocator, const BodyPair &inBodyPair, const Body &inBody1, const Body &inBody2, ContactConstraintManager::BodyPairHandle inBodyPairHandle, const CollideShapeSettings &inSettings, Mat44Arg inTransform1, Mat44Arg inTransform2);
+	/// Check if inShape is a compound shape with enough sub shapes to split up the work
+	static bool					sIsLargeCompound(const Shape *inShape);
+	/// Find the sub shapes of inCompound that need to be tested against inOther, returns false if inCompound is not a compound shape or if there are not enough sub shapes to split up the work
+	static bool					sFindSubShapesToSplit(const Shape *inCompound, const Shape *inOther, Mat44Arg inOtherToCompound, float inMaxSeparationDistance, Array<uint> &outSubShapeIndices);
+	/// Claim the next range of a split body pair and collide its sub shapes, returns false if there were no ranges left. When the last range is done the contacts of the body pair are added.
+	bool						ProcessSplitBodyPairRange(PhysicsUpdateContext::Step *ioStep, int inJobIndex, ContactAllocator &ioContactAllocator, PhysicsUpdateContext::SplitBodyPair &ioPair);
 
 	/// This helper batches up bodies that need to put to sleep to avoid contention on the activation mutex
 	class BodiesToSleep;
@@ -258,9 +302,18 @@ private:
 	/// Number of contacts that need to be queued before another narrow phase job is started
 	static constexpr int		cNarrowPhaseBatchSize = 16;
 
+	/// Minimum number of sub shapes of a compound shape that need to overlap with the other shape before the narrow phase of a body pair is split up over multiple jobs
+	static constexpr uint		cSplitBodyPairMinSubShapes = 16;
+
+	/// Number of sub shapes to collide per range when the narrow phase of a body pair is split up over multiple jobs
+	static constexpr uint		cSplitBodyPairSubShapesPerRange = 4;
+
 	/// Number of continuous collision shape casts that need to be queued before another job is started
 	static constexpr int		cNumCCDBodiesPerJob = 4;
 
+	/// Number of independent groups of CCD bodies that need to be available before another resolve job is started
+	static constexpr int		cNumCCDGroupsPerJob = 16;
+
 	/// Broadphase layer filter that decides if two objects can collide
 	const ObjectVsBroadPhaseLayerFilter *mObjectVsBroadPhaseLayerFilter = nullptr;
 
@@ -303,6 +356,11 @@ private:
 	/// Will split large islands into smaller groups of bodies that can be processed in parallel
 	LargeIslandSplitter			mLargeIslandSplitter;
 
+	/// Body pairs that are split up over multiple jobs, there is one for every FindCollisions job (see PhysicsSettings::mSplitLargeCompoundCollisions).
+	/// These are kept in between updates so that the arrays they contain don't need to be reallocated every step.
+	PhysicsUpdateContext::SplitBodyPair *mSplitBodyPairs = nullptr;
+	int							mNumSplitBodyPairs = 0;
+
 	/// Mutex protecting mStepListeners
 	Mutex						mStepListenersMutex;
 
@@ -315,6 +373,37 @@ private:
 
 	/// Previous frame's delta time of one sub step to allow scaling previous frame's constraint impulses
 	float						mPreviousStepDeltaTime = 0.0f;
+
+	/// Statistics of the last update
+	PhysicsUpdateStats			mUpdateStats;
+
+	/// Expanded swept volume of a LinearCast body and the non-moving bodies that it doesn't hit (see PhysicsSettings::mUseCCDSweptVolumeCache)
+	struct CCDSweptVolume
+	{
+		static constexpr uint	cMaxClearBodies = 4;
+
+		/// A body that did not intersect with the swept volume
+		struct ClearBody
+		{
+			BodyID				mBodyID;												///< ID of the body
+			RefConst<Shape>		mShape;													///< Shape of the body when it was tested, we keep a reference so that a new shape can't get the same address
+			uint64				mStateHash;												///< Hash of the position and rotation of the body when it was tested
+		};
+
+		BodyID					mBodyID;												///< Body that owns this swept volume, invalid if this volume is not in use
+		uint32					mStep = 0;												///< Value of mCCDSweptVolumeStep when this volume was last used
+		RVec3					mStart;													///< Center of mass position at the start of the sweep
+		Vec3					mDirection;												///< Direction and length of the sweep
+		Quat					mRotation;												///< Rotation of the body during the sweep
+		uint					mNumClearBodies = 0;									///< Number of bodies in mClearBodies
+		ClearBody				mClearBodies[cMaxClearBodies];							///< Bodies that did not intersect with the swept volume
+	};
+
+	/// Swept volumes indexed by body index, only allocated when PhysicsSettings::mUseCCDSweptVolumeCache is on
+	Array<CCDSweptVolume>		mCCDSweptVolumes;
+
+	/// Incremented every simulation step, used to detect if a swept volume was used in the previous step
+	uint32						mCCDSweptVolumeStep = 0;
 };
 
 JPH_NAMESPACE_END
@@ -7,10 +7,18 @@
 #include <Jolt/Physics/Body/BodyPair.h>
 #include <Jolt/Physics/Collision/ContactListener.h>
 #include <Jolt/Physics/Collision/BroadPhase/BroadPhase.h>
+#include <Jolt/Physics/Collision/Shape/Shape.h>
+#include <Jolt/Physics/Collision/CollideShape.h>
+#include <Jolt/Physics/Collision/CollisionCollectorImpl.h>
+#include <Jolt/Physics/PhysicsUpdateStats.h>
 #include <Jolt/Core/StaticArray.h>
 #include <Jolt/Core/JobSystem.h>
 #include <Jolt/Core/STLTempAllocator.h>
 
+JPH_SUPPRESS_WARNINGS_STD_BEGIN
+#include <chrono>
+JPH_SUPPRESS_WARNINGS_STD_END
+
 JPH_NAMESPACE_BEGIN
 
 class PhysicsSystem;
@@ -44,6 +52,40 @@ public:
 
 	using BodyPairQueues = StaticArray<BodyPairQueue, cMaxConcurrency>;
 
+	/// A body pair of which the narrow phase has been split up in ranges of sub shapes so that multiple FindCollisions jobs can work on it (see PhysicsSettings::mSplitLargeCompoundCollisions).
+	/// The job that processes the last range adds the contacts of the body pair.
+	struct SplitBodyPair
+	{
+		JPH_OVERRIDE_NEW_DELETE
+
+		static constexpr uint cMaxRanges = 16;										///< Maximum amount of ranges a body pair is split into
+
+		atomic<uint64>		mState { 0 };											///< Bits 0-15: next range to process, bits 16-31: number of ranges, bits 32-63: generation. The body pair is in use while the generation is odd, ranges can be claimed once the number of ranges is set.
+		atomic<uint32>		mNumRangesDone { 0 };									///< Number of ranges that have been processed
+		BodyPair			mBodyPair;												///< The body pair that is being processed
+		void *				mBodyPairHandle = nullptr;								///< Handle of the body pair in the contact cache (ContactConstraintManager::BodyPairHandle)
+		const Shape *		mShape1 = nullptr;										///< Shape of body 1
+		const Shape *		mShape2 = nullptr;										///< Shape of body 2
+		Mat44				mTransform1;											///< Transform of shape 1 (relative to body 1)
+		Mat44				mTransform2;											///< Transform of shape 2 (relative to body 1)
+		CollideShapeSettings mSettings;												///< Settings used to collide the sub shapes
+		bool				mSplitShape1 = true;									///< If the sub shapes of shape 1 (true) or shape 2 (false) are divided over the ranges
+		Array<uint>			mSubShapeIndices;										///< Indices of the sub shapes of the compound shape that need to be tested
+		AllHitCollisionCollector<CollideShapeCollector> mHits[cMaxRanges];			///< Hits found for each range
+	};
+
+	/// Adds the time spent in its scope to a phase of the update stats
+	class PhaseTimer : public NonCopyable
+	{
+	public:
+		inline				PhaseTimer(const PhysicsUpdateContext *inContext, EPhysicsUpdatePhase inPhase) : mPhaseTime(inContext->mPhaseTimeNs[uint(inPhase)]), mStart(std::chrono::high_resolution_clock::now()) { }
+		inline				~PhaseTimer()											{ mPhaseTime.fetch_add(uint64(std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::high_resolution_clock::now() - mStart).count()), memory_order_relaxed); }
+
+	private:
+		atomic<uint64> &	mPhaseTime;
+		std::chrono::high_resolution_clock::time_point mStart;
+	};
+
 	using JobMask = uint32;															///< A mask that has as many bits as we can have concurrent jobs
 	static_assert(sizeof(JobMask) * 8 >= cMaxConcurrency);
 
@@ -58,7 +100,10 @@ public:
 		bool				mIsFirst;												///< If this is the first step
 		bool				mIsLast;												///< If this is the last step
 
-		BroadPhase::UpdateState	mBroadPhaseUpdateState;								///< Handle returned by Broadphase::UpdatePrepare
+		BroadPhase::UpdateState	mBroadPhaseUpdateState;								///< Handle returned by Broadphase::UpdatePrepareBegin
+		uint				mNumBroadPhaseBatches = 0;								///< Number of batches that the broadphase update was split into by Broadphase::UpdatePrepareBegin
+		atomic<uint>		mNextBroadPhaseBatch { 0 };								///< Next broadphase batch that needs to be built
+		atomic<uint>		mNumBroadPhaseBatchesLeft { 0 };						///< Number of broadphase batches that have not been built yet, the job that builds the last batch calls Broadphase::UpdatePrepareEnd
 
 		uint32				mNumActiveBodiesAtStepStart;							///< Number of bodies that were active at the start of the physics update step. Only these bodies will receive gravity (they are the first N in the active body list).
 
@@ -89,6 +134,10 @@ public:
 		atomic<uint>		mNumBodyPairs { 0 };									///< The number of body pairs found in this step (used to size the contact cache in the next step)
 		atomic<uint>		mNumManifolds { 0 };									///< The number of manifolds found in this step (used to size the contact cache in the next step)
 
+		uint32				mNumIslands = 0;										///< Number of islands in this step (for PhysicsUpdateStats)
+		uint32				mNumSplitIslands = 0;									///< Number of islands that were split in this step (for PhysicsUpdateStats)
+		uint32				mNumContactConstraints = 0;								///< Number of contact constraints in this step (for PhysicsUpdateStats)
+
 		atomic<uint32>		mSolveVelocityConstraintsNextIsland { 0 };				///< Next island that needs to be processed for the solve velocity constraints step (doesn't need own cache line since position jobs don't run at same time)
 		atomic<uint32>		mSolvePositionConstraintsNextIsland { 0 };				///< Next island that needs to be processed for the solve position constraints step (doesn't need own cache line since velocity jobs don't run at same time)
 
@@ -116,6 +165,11 @@ public:
 		atomic<uint32>		mNextCCDBody { 0 };										///< Next unprocessed body index in mCCDBodies
 		int *				mActiveBodyToCCDBody = nullptr;							///< A mapping between an index in BodyManager::mActiveBodies and the index in mCCDBodies
 		uint32				mNumActiveBodyToCCDBody = 0;							///< Number of indices in mActiveBodyToCCDBody
+		CCDBody **			mSortedCCDBodies = nullptr;								///< CCD bodies sorted by group and then by hit fraction, CCD bodies in the same group can touch the same dynamic body and need to be resolved sequentially
+		uint32 *			mCCDGroupEnds = nullptr;								///< For each group, the end index of the group in mSortedCCDBodies
+		uint32				mNumCCDGroups = 0;										///< Number of groups in mCCDGroupEnds
+		atomic<uint32>		mNextCCDGroup { 0 };									///< Next unprocessed group index in mCCDGroupEnds
+		BodyID *			mCCDBodiesToActivate = nullptr;							///< For each entry in mSortedCCDBodies the body that was hit and needs to be activated (or an invalid body ID)
 
 		// Jobs in order of execution (some run in parallel)
 		JobHandle			mBroadPhasePrepare;										///< Prepares the new tree in the background
@@ -133,6 +187,7 @@ public:
 		JobHandleArray		mIntegrateVelocity;										///< Integrate all body positions
 		JobHandle			mPostIntegrateVelocity;									///< Finalize integration of all body positions
 		JobHandle			mResolveCCDContacts;									///< Updates the positions and velocities for all bodies that need continuous collision detection
+		JobHandle			mFinalizeCCDContacts;									///< Activates the bodies that were hit by CCD bodies and releases the CCD data
 		JobHandleArray		mSolvePositionConstraints;								///< Solve all constraints in the position domain
 		JobHandle			mContactRemovedCallbacks;								///< Calls the contact removed callbacks
 		JobHandle			mSoftBodyPrepare;										///< Prepares updating the soft bodies
@@ -155,11 +210,14 @@ public:
 	float					mStepDeltaTime;											///< Delta time for a simulation step (collision step)
 	float					mWarmStartImpulseRatio;									///< Ratio of this step delta time vs last step
 	atomic<uint32>			mErrors { 0 };											///< Errors that occurred during the update, actual type is EPhysicsUpdateError
+	mutable atomic<uint64>	mPhaseTimeNs[uint(EPhysicsUpdatePhase::Count)] = { };	///< Time spent in each phase in nanoseconds, see PhaseTimer
 
 	Constraint **			mActiveConstraints = nullptr;							///< Constraints that were active at the start of the physics update step (activating bodies can activate constraints and we need a consistent snapshot). Only these constraints will be resolved.
 
 	BodyPair *				mBodyPairs = nullptr;									///< A list of body pairs found by the broadphase
 
+	SplitBodyPair *			mSplitBodyPairs = nullptr;								///< Body pairs that are being split up, one for every FindCollisions job, only set when PhysicsSettings::mSplitLargeCompoundCollisions is true (owned by PhysicsSystem)
+
 	IslandBuilder *			mIslandBuilder;											///< Keeps track of connected bodies and builds islands for multithreaded velocity/position update
 
 	Steps					mSteps;
@@ -0,0 +1,62 @@
+// Jolt Physics Library (https://github.com/jrouwe/JoltPhysics)
+// SPDX-FileCopyrightText: 2024 Jorrit Rouwe
+// SPDX-License-Identifier: MIT
+
+#pragma once
+
+JPH_NAMESPACE_BEGIN
+
+/// The phases of PhysicsSystem::Update that are timed in PhysicsUpdateStats
+enum class EPhysicsUpdatePhase : uint
+{
+	BroadPhaseUpdate,				///< Preparing and finalizing the broadphase update
+	StepListeners,					///< Calling the PhysicsStepListeners
+	ApplyGravity,					///< Applying gravity to all active bodies
+	FindCollisions,					///< Finding colliding body pairs through the broadphase and the narrow phase
+	BuildIslands,					///< Determining active constraints, building islands and preparing the large island splitter
+	SetupVelocityConstraints,		///< Setting up the velocity constraint properties of all active constraints
+	SolveVelocityConstraints,		///< Warm starting and solving the velocity constraints
+	IntegrateVelocity,				///< Updating body positions from their velocities
+	CCD,							///< Finding, resolving and finalizing continuous collision detection contacts
+	SolvePositionConstraints,		///< Solving the position constraints and updating sleep state
+	ContactRemovedCallbacks,		///< Finalizing the contact cache and calling the contact removed callbacks
+	SoftBodies,						///< Updating soft bodies
+	Count							///< Number of phases
+};
+
+/// Lightweight statistics about the last PhysicsSystem::Update call, see PhysicsSystem::GetUpdateStats.
+/// These are always gathered, gathering costs a couple of clock reads per job.
+struct PhysicsUpdateStats
+{
+	/// Get the name of a phase
+	static const char *				sGetPhaseName(EPhysicsUpdatePhase inPhase)
+	{
+		static const char *names[] = { "BroadPhaseUpdate", "StepListeners", "ApplyGravity", "FindCollisions", "BuildIslands", "SetupVelocityConstraints", "SolveVelocityConstraints", "IntegrateVelocity", "CCD", "SolvePositionConstraints", "ContactRemovedCallbacks", "SoftBodies" };
+		static_assert(sizeof(names) / sizeof(names[0]) == size_t(EPhysicsUpdatePhase::Count));
+		return names[uint(inPhase)];
+	}
+
+	/// Get the time spent in a phase in seconds.
+	/// This is the sum of the time spent in all jobs of the phase over all threads and collision steps (including time that jobs spend waiting for other jobs of the same phase),
+	/// so when multiple threads are used the phases can add up to more than GetUpdateTime().
+	float							GetPhaseTime(EPhysicsUpdatePhase inPhase) const	{ return 1.0e-9f * float(mPhaseTimeNs[uint(inPhase)]); }
+
+	/// Get the wall clock time of the update in seconds
+	float							GetUpdateTime() const						{ return 1.0e-9f * float(mUpdateTimeNs); }
+
+	uint64							mPhaseTimeNs[uint(EPhysicsUpdatePhase::Count)] = { };	///< Time spent in each phase in nanoseconds, see GetPhaseTime
+	uint64							mUpdateTimeNs				= 0;			///< Wall clock time of the entire update in nanoseconds
+
+	// The counts below are summed over all collision steps
+	uint							mNumCollisionSteps			= 0;			///< Number of collision steps that were simulated (0 if there was nothing to simulate)
+	uint							mNumActiveBodies			= 0;			///< Number of active rigid bodies at the start of each step
+	uint							mNumActiveConstraints		= 0;			///< Number of constraints that were active
+	uint							mNumBodyPairs				= 0;			///< Number of body pairs that were found to be in contact by the narrow phase
+	uint							mNumManifolds				= 0;			///< Number of contact manifolds that were found by the narrow phase
+	uint							mNumContactConstraints		= 0;			///< Number of contact constraints that were solved
+	uint							mNumIslands					= 0;			///< Number of simulation islands
+	uint							mNumSplitIslands			= 0;			///< Number of islands that were split up by the large island splitter
+	uint							mNumCCDBodies				= 0;			///< Number of bodies that needed continuous collision detection
+};
+
+JPH_NAMESPACE_END
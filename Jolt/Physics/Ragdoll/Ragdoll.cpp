@@ -12,6 +12,8 @@
 #include <Jolt/Physics/Collision/CollisionCollectorImpl.h>
 #include <Jolt/Physics/Collision/CollideShape.h>
 #include <Jolt/Physics/Collision/CollisionDispatch.h>
+#include <Jolt/Physics/Collision/Shape/StaticCompoundShape.h>
+#include <Jolt/Physics/Collision/Shape/OffsetCenterOfMassShape.h>
 #include <Jolt/ObjectStream/TypeDeclarations.h>
 #include <Jolt/Core/StreamIn.h>
 #include <Jolt/Core/StreamOut.h>
@@ -487,6 +489,9 @@ void Ragdoll::AddToPhysicsSystem(EActivation inActivationMode, bool inLockBodies
 
 void Ragdoll::RemoveFromPhysicsSystem(bool inLockBodies)
 {
+	// Put frozen bodies back so that all bodies are in the simulation
+	UnfreezeBodies(inLockBodies);
+
 	// Remove all constraints before removing the bodies
 	mSystem->RemoveConstraints((Constraint **)mConstraints.data(), (int)mConstraints.size());
 
@@ -504,7 +509,21 @@ void Ragdoll::RemoveFromPhysicsSystem(bool inLockBodies)
 
 void Ragdoll::Activate(bool inLockBodies)
 {
-	sGetBodyInterface(mSystem, inLockBodies).ActivateBodies(mBodyIDs.data(), (int)mBodyIDs.size());
+	BodyInterface &bi = sGetBodyInterface(mSystem, inLockBodies);
+	if (mMergedInto.empty())
+	{
+		bi.ActivateBodies(mBodyIDs.data(), (int)mBodyIDs.size());
+	}
+	else
+	{
+		// Frozen bodies are not in the simulation, skip them
+		Array<BodyID> bodies;
+		bodies.reserve(mBodyIDs.size());
+		for (int i = 0; i < (int)mBodyIDs.size(); ++i)
+			if (!IsBodyFrozen(i))
+				bodies.push_back(mBodyIDs[i]);
+		bi.ActivateBodies(bodies.data(), (int)bodies.size());
+	}
 }
 
 bool Ragdoll::IsActive(bool inLockBodies) const
@@ -548,12 +567,14 @@ void Ragdoll::SetPose(const SkeletonPose &inPose, bool inLockBodies)
 void Ragdoll::SetPose(RVec3Arg inRootOffset, const Mat44 *inJointMatrices, bool inLockBodies)
 {
 	// Move bodies instantly into the correct position
+	// Frozen bodies follow the body that they're merged into
 	BodyInterface &bi = sGetBodyInterface(mSystem, inLockBodies);
 	for (int i = 0; i < (int)mBodyIDs.size(); ++i)
-	{
-		const Mat44 &joint = inJointMatrices[i];
-		bi.SetPositionAndRotation(mBodyIDs[i], inRootOffset + joint.GetTranslation(), joint.GetQuaternion(), EActivation::DontActivate);
-	}
+		if (!IsBodyFrozen(i))
+		{
+			const Mat44 &joint = inJointMatrices[i];
+			bi.SetPositionAndRotation(mBodyIDs[i], inRootOffset + joint.GetTranslation(), joint.GetQuaternion(), EActivation::DontActivate);
+		}
 }
 
 void Ragdoll::GetPose(SkeletonPose &outPose, bool inLockBodies)
@@ -582,8 +603,8 @@ void Ragdoll::GetPose(RVec3 &outRootOffset, Mat44 *outJointMatrices, bool inLock
 	// Get other matrices
 	for (int b = 1; b < body_count; ++b)
 	{
-		const Body *body = lock.GetBody(b);
-		RMat44 transform = body->GetWorldTransform();
+		// Frozen bodies are no longer simulated, derive their transform from the body that they're merged into
+		RMat44 transform = IsBodyFrozen(b)? lock.GetBody(mMergedInto[b])->GetWorldTransform() * mMergedTransforms[b] : lock.GetBody(b)->GetWorldTransform();
 		outJointMatrices[b] = Mat44(transform.GetColumn4(0), transform.GetColumn4(1), transform.GetColumn4(2), Vec4(Vec3(transform.GetTranslation() - outRootOffset), 1));
 	}
 }
@@ -603,13 +624,78 @@ void Ragdoll::DriveToPoseUsingKinematics(const SkeletonPose &inPose, float inDel
 
 void Ragdoll::DriveToPoseUsingKinematics(RVec3Arg inRootOffset, const Mat44 *inJointMatrices, float inDeltaTime, bool inLockBodies)
 {
-	// Move bodies into the correct position using kinematics
-	BodyInterface &bi = sGetBodyInterface(mSystem, inLockBodies);
-	for (int i = 0; i < (int)mBodyIDs.size(); ++i)
+	Ragdoll *ragdoll = this;
+	RVec3 root_offset(inRootOffset);
+	sDriveToPoseUsingKinematics(&ragdoll, &root_offset, &inJointMatrices, 1, inDeltaTime, inLockBodies);
+}
+
+void Ragdoll::sDriveToPoseUsingKinematics(Ragdoll *const *inRagdolls, const SkeletonPose *const *inPoses, uint inNumRagdolls, float inDeltaTime, bool inLockBodies)
+{
+	Array<RVec3> root_offsets;
+	Array<const Mat44 *> joint_matrices;
+	root_offsets.reserve(inNumRagdolls);
+	joint_matrices.reserve(inNumRagdolls);
+	for (uint r = 0; r < inNumRagdolls; ++r)
 	{
-		const Mat44 &joint = inJointMatrices[i];
-		bi.MoveKinematic(mBodyIDs[i], inRootOffset + joint.GetTranslation(), joint.GetQuaternion(), inDeltaTime);
+		const SkeletonPose *pose = inPoses[r];
+		JPH_ASSERT(pose->GetSkeleton() == inRagdolls[r]->mRagdollSettings->mSkeleton);
+		root_offsets.push_back(pose->GetRootOffset());
+		joint_matrices.push_back(pose->GetJointMatrices().data());
 	}
+
+	sDriveToPoseUsingKinematics(inRagdolls, root_offsets.data(), joint_matrices.data(), inNumRagdolls, inDeltaTime, inLockBodies);
+}
+
+void Ragdoll::sDriveToPoseUsingKinematics(Ragdoll *const *inRagdolls, const RVec3 *inRootOffsets, const Mat44 *const *inJointMatrices, uint inNumRagdolls, float inDeltaTime, bool inLockBodies)
+{
+	if (inNumRagdolls == 0)
+		return;
+	PhysicsSystem *system = inRagdolls[0]->mSystem;
+
+	// Collect the bodies of all ragdolls, frozen bodies follow the body that they're merged into
+	Array<BodyID> bodies;
+	for (uint r = 0; r < inNumRagdolls; ++r)
+	{
+		const Ragdoll *ragdoll = inRagdolls[r];
+		JPH_ASSERT(ragdoll->mSystem == system, "All ragdolls must belong to the same physics system");
+		for (int i = 0; i < (int)ragdoll->mBodyIDs.size(); ++i)
+			if (!ragdoll->IsBodyFrozen(i))
+				bodies.push_back(ragdoll->mBodyIDs[i]);
+	}
+
+	// Scope for the lock
+	Array<BodyID> bodies_to_activate;
+	{
+		// Lock all bodies at once
+		BodyLockMultiWrite lock(sGetBodyLockInterface(system, inLockBodies), bodies.data(), (int)bodies.size());
+
+		// Move bodies into the correct position using kinematics
+		int body_idx = 0;
+		for (uint r = 0; r < inNumRagdolls; ++r)
+		{
+			const Ragdoll *ragdoll = inRagdolls[r];
+			RVec3 root_offset = inRootOffsets[r];
+			const Mat44 *joint_matrices = inJointMatrices[r];
+			for (int i = 0; i < (int)ragdoll->mBodyIDs.size(); ++i)
+				if (!ragdoll->IsBodyFrozen(i))
+				{
+					Body *body = lock.GetBody(body_idx++);
+					if (body != nullptr)
+					{
+						const Mat44 &joint = joint_matrices[i];
+						body->MoveKinematic(root_offset + joint.GetTranslation(), joint.GetQuaternion(), inDeltaTime);
+
+						// Wake up the body when it starts moving
+						if (!body->IsActive() && (!body->GetLinearVelocity().IsNearZero() || !body->GetAngularVelocity().IsNearZero()))
+							bodies_to_activate.push_back(body->GetID());
+					}
+				}
+		}
+	}
+
+	// Activate all bodies that started moving as a single batch
+	if (!bodies_to_activate.empty())
+		sGetBodyInterface(system, inLockBodies).ActivateBodies(bodies_to_activate.data(), (int)bodies_to_activate.size());
 }
 
 void Ragdoll::DriveToPoseUsingMotors(const SkeletonPose &inPose)
@@ -644,29 +730,270 @@ void Ragdoll::DriveToPoseUsingMotors(const SkeletonPose &inPose)
 void Ragdoll::SetLinearAndAngularVelocity(Vec3Arg inLinearVelocity, Vec3Arg inAngularVelocity, bool inLockBodies)
 {
 	BodyInterface &bi = sGetBodyInterface(mSystem, inLockBodies);
-	for (BodyID body_id : mBodyIDs)
-		bi.SetLinearAndAngularVelocity(body_id, inLinearVelocity, inAngularVelocity);
+	for (int i = 0; i < (int)mBodyIDs.size(); ++i)
+		if (!IsBodyFrozen(i))
+			bi.SetLinearAndAngularVelocity(mBodyIDs[i], inLinearVelocity, inAngularVelocity);
 }
 
 void Ragdoll::SetLinearVelocity(Vec3Arg inLinearVelocity, bool inLockBodies)
 {
 	BodyInterface &bi = sGetBodyInterface(mSystem, inLockBodies);
-	for (BodyID body_id : mBodyIDs)
-		bi.SetLinearVelocity(body_id, inLinearVelocity);
+	for (int i = 0; i < (int)mBodyIDs.size(); ++i)
+		if (!IsBodyFrozen(i))
+			bi.SetLinearVelocity(mBodyIDs[i], inLinearVelocity);
 }
 
 void Ragdoll::AddLinearVelocity(Vec3Arg inLinearVelocity, bool inLockBodies)
 {
 	BodyInterface &bi = sGetBodyInterface(mSystem, inLockBodies);
-	for (BodyID body_id : mBodyIDs)
-		bi.AddLinearVelocity(body_id, inLinearVelocity);
+	for (int i = 0; i < (int)mBodyIDs.size(); ++i)
+		if (!IsBodyFrozen(i))
+			bi.AddLinearVelocity(mBodyIDs[i], inLinearVelocity);
 }
 
 void Ragdoll::AddImpulse(Vec3Arg inImpulse, bool inLockBodies)
 {
 	BodyInterface &bi = sGetBodyInterface(mSystem, inLockBodies);
-	for (BodyID body_id : mBodyIDs)
-		bi.AddImpulse(body_id, inImpulse);
+	for (int i = 0; i < (int)mBodyIDs.size(); ++i)
+		if (!IsBodyFrozen(i))
+			bi.AddImpulse(mBodyIDs[i], inImpulse);
+}
+
+// Replace the shape and mass properties of a body, the body does not move but its center of mass may
+static void sSetShapeAndMassProperties(BodyInterface &inBodyInterface, const BodyLockInterface &inLockInterface, const BodyID &inBodyID, const Shape *inShape, const MassProperties &inMassProperties)
+{
+	RVec3 old_com = inBodyInterface.GetCenterOfMassPosition(inBodyID);
+	inBodyInterface.SetShape(inBodyID, inShape, false, EActivation::DontActivate);
+
+	BodyLockWrite lock(inLockInterface, inBodyID);
+	if (lock.Succeeded())
+	{
+		Body &body = lock.GetBody();
+		MotionProperties *mp = body.GetMotionProperties();
+		mp->SetMassProperties(mp->GetAllowedDOFs(), inMassProperties);
+
+		// Keep the velocity of the body the same at its new center of mass
+		body.SetLinearVelocityClamped(body.GetPointVelocityCOM(Vec3(body.GetCenterOfMassPosition() - old_com)));
+	}
+}
+
+void Ragdoll::SetFrozenBodies(const Array<int> &inBodyIndices, bool inLockBodies)
+{
+	const Skeleton *skeleton = mRagdollSettings->GetSkeleton();
+	JPH_ASSERT(skeleton->AreJointsCorrectlyOrdered());
+	JPH_ASSERT(mRagdollSettings->GetConstraintIndexToBodyIdxPair().size() == mConstraints.size(), "Call RagdollSettings::CalculateConstraintIndexToBodyIdxPair first");
+
+	// Mark the bodies that need to be frozen
+	int body_count = (int)mBodyIDs.size();
+	Array<int> merged_into;
+	merged_into.resize(body_count, -1);
+	bool any_frozen = false;
+	for (int body_idx : inBodyIndices)
+		if (skeleton->GetJoint(body_idx).mParentJointIndex >= 0)
+		{
+			merged_into[body_idx] = 0;
+			any_frozen = true;
+		}
+		else
+			JPH_ASSERT(false, "The root body cannot be frozen");
+	if (!any_frozen)
+		merged_into.clear();
+
+	// Determine for each frozen body the closest ancestor that is not frozen, children of frozen bodies are frozen too
+	// Note that the parent of a joint always comes before the joint itself so the parent has already been resolved
+	for (int i = 0; i < (int)merged_into.size(); ++i)
+	{
+		int parent_idx = skeleton->GetJoint(i).mParentJointIndex;
+		if (parent_idx >= 0 && (merged_into[i] >= 0 || merged_into[parent_idx] >= 0))
+			merged_into[i] = merged_into[parent_idx] >= 0? merged_into[parent_idx] : parent_idx;
+	}
+
+	// Check if anything changed
+	if (merged_into == mMergedInto)
+		return;
+
+	// Restore the bodies and freeze the new set
+	UnfreezeBodies(inLockBodies);
+	if (any_frozen)
+		FreezeBodies(merged_into, inLockBodies);
+}
+
+void Ragdoll::FreezeBodies(const Array<int> &inMergedInto, bool inLockBodies)
+{
+	JPH_ASSERT(mMergedInto.empty());
+
+	int body_count = (int)mBodyIDs.size();
+	mMergedInto = inMergedInto;
+	mMergedTransforms.resize(body_count, Mat44::sIdentity());
+
+	// Shapes and mass properties for the bodies that have frozen bodies merged into them
+	struct NewState
+	{
+		RefConst<Shape>					mShape;
+		MassProperties					mMassProperties;
+	};
+	Array<NewState> new_states;
+
+	const BodyLockInterface &lock_interface = sGetBodyLockInterface(mSystem, inLockBodies);
+
+	// Scope for the lock
+	{
+		BodyLockMultiRead lock(lock_interface, mBodyIDs.data(), body_count);
+
+		for (int target_idx = 0; target_idx < body_count; ++target_idx)
+		{
+			// Find the bodies that are merged into this body
+			Array<int> parts;
+			for (int i = 0; i < body_count; ++i)
+				if (mMergedInto[i] == target_idx)
+					parts.push_back(i);
+			if (parts.empty())
+				continue;
+
+			const Body *target = lock.GetBody(target_idx);
+			JPH_ASSERT(target->IsInBroadPhase(), "Ragdoll must be added to the physics system");
+			Quat inv_target_rotation = target->GetRotation().Conjugated();
+			RVec3 target_position = target->GetPosition();
+
+			// Get the mass properties of a body in the space of its center of mass.
+			// We can't invert the inverse mass / inertia of the body as they can be zero when the degrees of freedom are restricted,
+			// so we calculate them from the current shape and the mass override of the part that the body was created from.
+			auto get_mass_properties = [this](int inBodyIdx, const Body *inBody) {
+				BodyCreationSettings part = mRagdollSettings->mParts[inBodyIdx];
+				part.SetShape(inBody->GetShape());
+				return part.GetMassProperties();
+			};
+
+			// Start with the target body itself
+			MergedBody &merged_body = mMergedBodies.emplace_back();
+			merged_body.mBodyIndex = target_idx;
+			merged_body.mShape = target->GetShape();
+			merged_body.mMassProperties = get_mass_properties(target_idx, target);
+			StaticCompoundShapeSettings compound;
+			compound.AddShape(Vec3::sZero(), Quat::sIdentity(), target->GetShape());
+			Array<MassProperties> part_mass_properties { merged_body.mMassProperties };
+			Array<Vec3> part_com { target->GetShape()->GetCenterOfMass() };
+
+			// Add the frozen bodies in the space of the target body
+			for (int part_idx : parts)
+			{
+				const Body *part = lock.GetBody(part_idx);
+				Quat rotation = inv_target_rotation * part->GetRotation();
+				Vec3 position = inv_target_rotation * Vec3(part->GetPosition() - target_position);
+				mMergedTransforms[part_idx] = Mat44::sRotationTranslation(rotation, position);
+				compound.AddShape(position, rotation, part->GetShape());
+
+				MassProperties mass_properties = get_mass_properties(part_idx, part);
+				mass_properties.Rotate(Mat44::sRotation(rotation));
+				part_mass_properties.push_back(mass_properties);
+				part_com.push_back(position + rotation * part->GetShape()->GetCenterOfMass());
+			}
+
+			// Combine the mass properties around the combined center of mass
+			MassProperties combined;
+			Vec3 combined_com = Vec3::sZero();
+			for (size_t i = 0; i < part_mass_properties.size(); ++i)
+			{
+				combined.mMass += part_mass_properties[i].mMass;
+				combined_com += part_mass_properties[i].mMass * part_com[i];
+			}
+			combined_com /= combined.mMass;
+			combined.mInertia = Mat44::sZero();
+			for (size_t i = 0; i < part_mass_properties.size(); ++i)
+			{
+				MassProperties &mass_properties = part_mass_properties[i];
+				mass_properties.Translate(part_com[i] - combined_com);
+				combined.mInertia += mass_properties.mInertia;
+			}
+			combined.mInertia.SetColumn4(3, Vec4(0, 0, 0, 1));
+
+			// Create the merged shape, move its center of mass to the combined center of mass since the shape does not know the masses of the bodies
+			ShapeSettings::ShapeResult compound_result = compound.Create();
+			JPH_ASSERT(compound_result.IsValid());
+			const Shape *compound_shape = compound_result.Get();
+			ShapeSettings::ShapeResult shape_result = OffsetCenterOfMassShapeSettings(combined_com - compound_shape->GetCenterOfMass(), compound_shape).Create();
+			JPH_ASSERT(shape_result.IsValid());
+			new_states.push_back({ shape_result.Get(), combined });
+		}
+	}
+
+	// Replace the shapes and mass properties
+	BodyInterface &bi = sGetBodyInterface(mSystem, inLockBodies);
+	for (size_t i = 0; i < mMergedBodies.size(); ++i)
+	{
+		BodyID body_id = mBodyIDs[mMergedBodies[i].mBodyIndex];
+		sSetShapeAndMassProperties(bi, lock_interface, body_id, new_states[i].mShape, new_states[i].mMassProperties);
+	}
+
+	// Disable all constraints that connect to a frozen body
+	const Array<RagdollSettings::BodyIdxPair> &body_idx_pairs = mRagdollSettings->GetConstraintIndexToBodyIdxPair();
+	for (size_t c = 0; c < mConstraints.size(); ++c)
+		if (IsBodyFrozen(body_idx_pairs[c].first) || IsBodyFrozen(body_idx_pairs[c].second))
+			mConstraints[c]->SetEnabled(false);
+
+	// Remove the frozen bodies from the simulation
+	Array<BodyID> frozen_bodies;
+	for (int i = 0; i < body_count; ++i)
+		if (IsBodyFrozen(i))
+			frozen_bodies.push_back(mBodyIDs[i]);
+	bi.RemoveBodies(frozen_bodies.data(), (int)frozen_bodies.size());
+}
+
+void Ragdoll::UnfreezeBodies(bool inLockBodies)
+{
+	if (mMergedInto.empty())
+		return;
+
+	BodyInterface &bi = sGetBodyInterface(mSystem, inLockBodies);
+	const BodyLockInterface &lock_interface = sGetBodyLockInterface(mSystem, inLockBodies);
+
+	// Restore the original shapes and mass properties
+	for (const MergedBody &merged_body : mMergedBodies)
+	{
+		sSetShapeAndMassProperties(bi, lock_interface, mBodyIDs[merged_body.mBodyIndex], merged_body.mShape, merged_body.mMassProperties);
+	}
+
+	// Move the frozen bodies to their current pose and give them the velocity of the body that they were merged into
+	int body_count = (int)mBodyIDs.size();
+	Array<BodyID> frozen_bodies, bodies_to_activate;
+	{
+		BodyLockMultiWrite lock(lock_interface, mBodyIDs.data(), body_count);
+
+		for (int i = 0; i < body_count; ++i)
+			if (IsBodyFrozen(i))
+			{
+				const Body *target = lock.GetBody(mMergedInto[i]);
+				RMat44 transform = target->GetWorldTransform() * mMergedTransforms[i];
+
+				Body *body = lock.GetBody(i);
+				body->SetPositionAndRotationInternal(transform.GetTranslation(), transform.GetQuaternion());
+				Vec3 angular_velocity = target->GetAngularVelocity();
+				body->SetLinearVelocityClamped(target->GetPointVelocity(body->GetCenterOfMassPosition()));
+				body->SetAngularVelocityClamped(angular_velocity);
+
+				frozen_bodies.push_back(body->GetID());
+				if (target->IsActive())
+					bodies_to_activate.push_back(body->GetID());
+			}
+	}
+
+	// Add the bodies back to the simulation
+	BodyInterface::AddState add_state = bi.AddBodiesPrepare(frozen_bodies.data(), (int)frozen_bodies.size());
+	bi.AddBodiesFinalize(frozen_bodies.data(), (int)frozen_bodies.size(), add_state, EActivation::DontActivate);
+	bi.ActivateBodies(bodies_to_activate.data(), (int)bodies_to_activate.size());
+
+	// Enable the constraints again
+	const Array<RagdollSettings::BodyIdxPair> &body_idx_pairs = mRagdollSettings->GetConstraintIndexToBodyIdxPair();
+	for (size_t c = 0; c < mConstraints.size(); ++c)
+		if (IsBodyFrozen(body_idx_pairs[c].first) || IsBodyFrozen(body_idx_pairs[c].second))
+		{
+			mConstraints[c]->SetEnabled(true);
+			mConstraints[c]->ResetWarmStart();
+		}
+
+	mMergedInto.clear();
+	mMergedTransforms.clear();
+	mMergedBodies.clear();
 }
 
 void Ragdoll::GetRootTransform(RVec3 &outPosition, Quat &outRotation, bool inLockBodies) const
@@ -695,8 +1022,9 @@ AABox Ragdoll::GetWorldSpaceBounds(bool inLockBodies) const
 	AABox bounds;
 	for (int b = 0; b < body_count; ++b)
 	{
+		// Frozen bodies are part of the shape of the body they're merged into
 		const Body *body = lock.GetBody(b);
-		if (body != nullptr)
+		if (body != nullptr && !IsBodyFrozen(b))
 			bounds.Encapsulate(body->GetWorldSpaceBounds());
 	}
 	return bounds;
@@ -7,6 +7,7 @@
 #include <Jolt/Core/Reference.h>
 #include <Jolt/Core/Result.h>
 #include <Jolt/Physics/Body/BodyCreationSettings.h>
+#include <Jolt/Physics/Body/MassProperties.h>
 #include <Jolt/Physics/Constraints/TwoBodyConstraint.h>
 #include <Jolt/Skeleton/Skeleton.h>
 #include <Jolt/Skeleton/SkeletonPose.h>
@@ -178,6 +179,14 @@ public:
 	/// Lower level version of DriveToPoseUsingKinematics that directly takes the world space joint matrices
 	void								DriveToPoseUsingKinematics(RVec3Arg inRootOffset, const Mat44 *inJointMatrices, float inDeltaTime, bool inLockBodies = true);
 
+	/// Drive multiple ragdolls to a pose using kinematics. This has the same effect as calling DriveToPoseUsingKinematics on each of the ragdolls,
+	/// but the bodies of all ragdolls are locked only once and the bodies that need to wake up are activated as a single batch.
+	/// All ragdolls must belong to the same PhysicsSystem.
+	static void							sDriveToPoseUsingKinematics(Ragdoll *const *inRagdolls, const SkeletonPose *const *inPoses, uint inNumRagdolls, float inDeltaTime, bool inLockBodies = true);
+
+	/// Lower level version of sDriveToPoseUsingKinematics that directly takes the root offset and the world space joint matrices of each ragdoll
+	static void							sDriveToPoseUsingKinematics(Ragdoll *const *inRagdolls, const RVec3 *inRootOffsets, const Mat44 *const *inJointMatrices, uint inNumRagdolls, float inDeltaTime, bool inLockBodies = true);
+
 	/// Drive the ragdoll to a specific pose by activating the motors on each constraint
 	void								DriveToPoseUsingMotors(const SkeletonPose &inPose);
 
@@ -193,6 +202,19 @@ public:
 	/// Add impulse to all bodies of the ragdoll (center of mass of each of them)
 	void								AddImpulse(Vec3Arg inImpulse, bool inLockBodies = true);
 
+	/// Freeze bodies of the ragdoll to make it cheaper to simulate, e.g. to lower the level of detail of a ragdoll that is far away.
+	/// A frozen body is removed from the simulation, the constraints that connect to it are disabled and its shape is merged into
+	/// the shape of its closest ancestor that is not frozen. The mass properties of the merged bodies are combined so that the frozen
+	/// sub chain moves as a single rigid body in the pose that it had at the moment it was frozen. The mass properties of a body are
+	/// calculated from its current shape and the mass override of its part in RagdollSettings::mParts.
+	/// Freezing a body also freezes all of its children and the root body cannot be frozen. Bodies that were frozen by a previous call
+	/// and that are not in inBodyIndices are put back into the simulation, pass an empty array to unfreeze all bodies.
+	/// The ragdoll must have been added to the PhysicsSystem and RagdollSettings::CalculateConstraintIndexToBodyIdxPair must have been called.
+	void								SetFrozenBodies(const Array<int> &inBodyIndices, bool inLockBodies = true);
+
+	/// Check if a body has been frozen through SetFrozenBodies
+	bool								IsBodyFrozen(int inBodyIndex) const						{ return !mMergedInto.empty() && mMergedInto[inBodyIndex] >= 0; }
+
 	/// Get the position and orientation of the root of the ragdoll
 	void								GetRootTransform(RVec3 &outPosition, Quat &outRotation, bool inLockBodies = true) const;
 
@@ -224,6 +246,10 @@ private:
 	/// For RagdollSettings::CreateRagdoll function
 	friend class RagdollSettings;
 
+	/// Helper functions for SetFrozenBodies
+	void								FreezeBodies(const Array<int> &inMergedInto, bool inLockBodies);
+	void								UnfreezeBodies(bool inLockBodies);
+
 	/// The settings that created this ragdoll
 	RefConst<RagdollSettings>			mRagdollSettings;
 
@@ -233,6 +259,23 @@ private:
 	/// Array of constraints that connect the bodies together
 	Array<Ref<TwoBodyConstraint>>		mConstraints;
 
+	/// A body that has frozen bodies merged into it, stores the state of the body before the merge
+	struct MergedBody
+	{
+		int								mBodyIndex;												///< Index of the body in mBodyIDs
+		RefConst<Shape>					mShape;													///< Original shape of the body
+		MassProperties					mMassProperties;										///< Original mass properties of the body
+	};
+
+	/// For each body the index of the body that it has been merged into or -1 if the body is not frozen (empty when no bodies are frozen)
+	Array<int>							mMergedInto;
+
+	/// For each frozen body its transform relative to the body that it has been merged into
+	Array<Mat44>						mMergedTransforms;
+
+	/// The bodies that have frozen bodies merged into them
+	Array<MergedBody>					mMergedBodies;
+
 	/// Cached physics system
 	PhysicsSystem *						mSystem;
 };
@@ -13,11 +13,113 @@
 #include <Jolt/Physics/Collision/Shape/CylinderShape.h>
 #include <Jolt/Physics/Collision/CollisionCollectorImpl.h>
 #include <Jolt/Physics/PhysicsSystem.h>
+#include <Jolt/Geometry/RayAABox.h>
+#include <Jolt/Core/StaticArray.h>
+#include <Jolt/Core/QuickSort.h>
 
 JPH_NAMESPACE_BEGIN
 
-bool VehicleCollisionTesterRay::Collide(PhysicsSystem &inPhysicsSystem, const VehicleConstraint &inVehicleConstraint, uint inWheelIndex, RVec3Arg inOrigin, Vec3Arg inDirection, const BodyID &inVehicleBodyID, Body *&outBody, SubShapeID &outSubShapeID, RVec3 &outContactPosition, Vec3 &outContactNormal, float &outSuspensionLength) const
+/// Calls inVisitor for the shapes that were collected for all wheels in the order in which their bounds are hit by a swept box, closest first like the broad phase does, so that the collector can early out
+template <class Collector, class Visitor>
+static void sVisitShapesClosestFirst(const Array<TransformedShape> &inShapes, Vec3Arg inOrigin, Vec3Arg inDirection, Vec3Arg inExtent, Collector &ioCollector, const Visitor &inVisitor)
+{
+	struct ShapeAndFraction
+	{
+		float					mFraction;
+		uint					mIndex;
+	};
+
+	// Determine which shapes can be hit
+	StaticArray<ShapeAndFraction, 64> order;
+	RayInvDirection inv_direction(inDirection);
+	for (uint i = 0; i < inShapes.size(); ++i)
+	{
+		AABox bounds = inShapes[i].GetWorldSpaceBounds();
+		float fraction = RayAABox(inOrigin, inv_direction, bounds.mMin - inExtent, bounds.mMax + inExtent);
+		if (fraction < FLT_MAX)
+		{
+			if (order.size() < order.capacity())
+				order.push_back({ fraction, i });
+			else if (!ioCollector.ShouldEarlyOut())
+				inVisitor(inShapes[i]); // Too many shapes to sort, test this one immediately
+		}
+	}
+
+	// Test the shapes closest first
+	QuickSort(order.begin(), order.end(), [](const ShapeAndFraction &inLHS, const ShapeAndFraction &inRHS) { return inLHS.mFraction < inRHS.mFraction; });
+	for (const ShapeAndFraction &s : order)
+	{
+		if (ioCollector.ShouldEarlyOut() || s.mFraction > max(0.0f, ioCollector.GetEarlyOutFraction()))
+			break;
+		inVisitor(inShapes[s.mIndex]);
+	}
+}
+
+void VehicleCollisionTester::CollectShapes(PhysicsSystem &inPhysicsSystem, const AABox &inBounds, const BodyID &inVehicleBodyID, Array<TransformedShape> &outShapes) const
+{
+	JPH_PROFILE_FUNCTION();
+
+	const DefaultBroadPhaseLayerFilter default_broadphase_layer_filter = inPhysicsSystem.GetDefaultBroadPhaseLayerFilter(mObjectLayer);
+	const BroadPhaseLayerFilter &broadphase_layer_filter = mBroadPhaseLayerFilter != nullptr? *mBroadPhaseLayerFilter : default_broadphase_layer_filter;
+
+	const DefaultObjectLayerFilter default_object_layer_filter = inPhysicsSystem.GetDefaultLayerFilter(mObjectLayer);
+	const ObjectLayerFilter &object_layer_filter = mObjectLayerFilter != nullptr? *mObjectLayerFilter : default_object_layer_filter;
+
+	const IgnoreSingleBodyFilter default_body_filter(inVehicleBodyID);
+	const BodyFilter &body_filter = mBodyFilter != nullptr? *mBodyFilter : default_body_filter;
+
+	// Collect the bodies in the bounds
+	AllHitCollisionCollector<CollideShapeBodyCollector> collector;
+	inPhysicsSystem.GetBroadPhaseQuery().CollideAABox(inBounds, collector, broadphase_layer_filter, object_layer_filter);
+
+	// Store the transformed shape of each body, we don't break up the shape into its leaf shapes so that we get exactly the same results as when casting against the body through NarrowPhaseQuery
+	outShapes.reserve(collector.mHits.size());
+	const BodyLockInterface &lock_interface = inPhysicsSystem.GetBodyLockInterfaceNoLock();
+	for (const BodyID &body_id : collector.mHits)
+		if (body_filter.ShouldCollide(body_id))
+		{
+			BodyLockRead lock(lock_interface, body_id);
+			if (lock.SucceededAndIsInBroadPhase() && body_filter.ShouldCollideLocked(lock.GetBody()))
+				outShapes.push_back(lock.GetBody().GetTransformedShape());
+		}
+}
+
+void VehicleCollisionTester::CastRay(PhysicsSystem &inPhysicsSystem, const VehicleConstraint &inVehicleConstraint, const RRayCast &inRay, const RayCastSettings &inRayCastSettings, const BodyID &inVehicleBodyID, CastRayCollector &ioCollector) const
+{
+	// Test against the shapes that were collected for all wheels
+	const Array<TransformedShape> *shapes = inVehicleConstraint.GetWheelCollisionShapes();
+	if (shapes != nullptr)
+	{
+		sVisitShapesClosestFirst(*shapes, Vec3(inRay.mOrigin), inRay.mDirection, Vec3::sZero(), ioCollector, [&inRay, &inRayCastSettings, &ioCollector](const TransformedShape &inShape) {
+			inShape.CastRay(inRay, inRayCastSettings, ioCollector);
+		});
+		return;
+	}
+
+	const DefaultBroadPhaseLayerFilter default_broadphase_layer_filter = inPhysicsSystem.GetDefaultBroadPhaseLayerFilter(mObjectLayer);
+	const BroadPhaseLayerFilter &broadphase_layer_filter = mBroadPhaseLayerFilter != nullptr? *mBroadPhaseLayerFilter : default_broadphase_layer_filter;
+
+	const DefaultObjectLayerFilter default_object_layer_filter = inPhysicsSystem.GetDefaultLayerFilter(mObjectLayer);
+	const ObjectLayerFilter &object_layer_filter = mObjectLayerFilter != nullptr? *mObjectLayerFilter : default_object_layer_filter;
+
+	const IgnoreSingleBodyFilter default_body_filter(inVehicleBodyID);
+	const BodyFilter &body_filter = mBodyFilter != nullptr? *mBodyFilter : default_body_filter;
+
+	inPhysicsSystem.GetNarrowPhaseQueryNoLock().CastRay(inRay, inRayCastSettings, ioCollector, broadphase_layer_filter, object_layer_filter, body_filter);
+}
+
+void VehicleCollisionTester::CastShape(PhysicsSystem &inPhysicsSystem, const VehicleConstraint &inVehicleConstraint, const RShapeCast &inShapeCast, const ShapeCastSettings &inShapeCastSettings, RVec3Arg inBaseOffset, const BodyID &inVehicleBodyID, CastShapeCollector &ioCollector) const
 {
+	// Test against the shapes that were collected for all wheels
+	const Array<TransformedShape> *shapes = inVehicleConstraint.GetWheelCollisionShapes();
+	if (shapes != nullptr)
+	{
+		sVisitShapesClosestFirst(*shapes, inShapeCast.mShapeWorldBounds.GetCenter(), inShapeCast.mDirection, inShapeCast.mShapeWorldBounds.GetExtent(), ioCollector, [&inShapeCast, &inShapeCastSettings, inBaseOffset, &ioCollector](const TransformedShape &inShape) {
+			inShape.CastShape(inShapeCast, inShapeCastSettings, inBaseOffset, ioCollector);
+		});
+		return;
+	}
+
 	const DefaultBroadPhaseLayerFilter default_broadphase_layer_filter = inPhysicsSystem.GetDefaultBroadPhaseLayerFilter(mObjectLayer);
 	const BroadPhaseLayerFilter &broadphase_layer_filter = mBroadPhaseLayerFilter != nullptr? *mBroadPhaseLayerFilter : default_broadphase_layer_filter;
 
@@ -27,6 +129,11 @@ bool VehicleCollisionTesterRay::Collide(PhysicsSystem &inPhysicsSystem, const Ve
 	const IgnoreSingleBodyFilter default_body_filter(inVehicleBodyID);
 	const BodyFilter &body_filter = mBodyFilter != nullptr? *mBodyFilter : default_body_filter;
 
+	inPhysicsSystem.GetNarrowPhaseQueryNoLock().CastShape(inShapeCast, inShapeCastSettings, inBaseOffset, ioCollector, broadphase_layer_filter, object_layer_filter, body_filter);
+}
+
+bool VehicleCollisionTesterRay::Collide(PhysicsSystem &inPhysicsSystem, const VehicleConstraint &inVehicleConstraint, uint inWheelIndex, RVec3Arg inOrigin, Vec3Arg inDirection, const BodyID &inVehicleBodyID, Body *&outBody, SubShapeID &outSubShapeID, RVec3 &outContactPosition, Vec3 &outContactNormal, float &outSuspensionLength) const
+{
 	const WheelSettings *wheel_settings = inVehicleConstraint.GetWheel(inWheelIndex)->GetSettings();
 	float wheel_radius = wheel_settings->mRadius;
 	float ray_length = wheel_settings->mSuspensionMaxLength + wheel_radius;
@@ -89,7 +196,7 @@ bool VehicleCollisionTesterRay::Collide(PhysicsSystem &inPhysicsSystem, const Ve
 	RayCastSettings settings;
 
 	MyCollector collector(inPhysicsSystem, ray, mUp, mCosMaxSlopeAngle);
-	inPhysicsSystem.GetNarrowPhaseQueryNoLock().CastRay(ray, settings, collector, broadphase_layer_filter, object_layer_filter, body_filter);
+	CastRay(inPhysicsSystem, inVehicleConstraint, ray, settings, inVehicleBodyID, collector);
 	if (collector.mBody == nullptr)
 		return false;
 
@@ -102,6 +209,16 @@ bool VehicleCollisionTesterRay::Collide(PhysicsSystem &inPhysicsSystem, const Ve
 	return true;
 }
 
+AABox VehicleCollisionTesterRay::GetCollisionTestBounds(const VehicleConstraint &inVehicleConstraint, uint inWheelIndex, RVec3Arg inOrigin, Vec3Arg inDirection) const
+{
+	// Same ray as in Collide
+	const WheelSettings *wheel_settings = inVehicleConstraint.GetWheel(inWheelIndex)->GetSettings();
+	Vec3 origin(inOrigin);
+	AABox bounds(origin, origin);
+	bounds.Encapsulate(origin + (wheel_settings->mSuspensionMaxLength + wheel_settings->mRadius) * inDirection);
+	return bounds;
+}
+
 void VehicleCollisionTesterRay::PredictContactProperties(PhysicsSystem &inPhysicsSystem, const VehicleConstraint &inVehicleConstraint, uint inWheelIndex, RVec3Arg inOrigin, Vec3Arg inDirection, const BodyID &inVehicleBodyID, Body *&ioBody, SubShapeID &ioSubShapeID, RVec3 &ioContactPosition, Vec3 &ioContactNormal, float &ioSuspensionLength) const
 {
 	// Recalculate the contact points assuming the contact point is on an infinite plane
@@ -124,15 +241,6 @@ void VehicleCollisionTesterRay::PredictContactProperties(PhysicsSystem &inPhysic
 
 bool VehicleCollisionTesterCastSphere::Collide(PhysicsSystem &inPhysicsSystem, const VehicleConstraint &inVehicleConstraint, uint inWheelIndex, RVec3Arg inOrigin, Vec3Arg inDirection, const BodyID &inVehicleBodyID, Body *&outBody, SubShapeID &outSubShapeID, RVec3 &outContactPosition, Vec3 &outContactNormal, float &outSuspensionLength) const
 {
-	const DefaultBroadPhaseLayerFilter default_broadphase_layer_filter = inPhysicsSystem.GetDefaultBroadPhaseLayerFilter(mObjectLayer);
-	const BroadPhaseLayerFilter &broadphase_layer_filter = mBroadPhaseLayerFilter != nullptr? *mBroadPhaseLayerFilter : default_broadphase_layer_filter;
-
-	const DefaultObjectLayerFilter default_object_layer_filter = inPhysicsSystem.GetDefaultLayerFilter(mObjectLayer);
-	const ObjectLayerFilter &object_layer_filter = mObjectLayerFilter != nullptr? *mObjectLayerFilter : default_object_layer_filter;
-
-	const IgnoreSingleBodyFilter default_body_filter(inVehicleBodyID);
-	const BodyFilter &body_filter = mBodyFilter != nullptr? *mBodyFilter : default_body_filter;
-
 	SphereShape sphere(mRadius);
 	sphere.SetEmbedded();
 
@@ -202,7 +310,7 @@ bool VehicleCollisionTesterCastSphere::Collide(PhysicsSystem &inPhysicsSystem, c
 	};
 
 	MyCollector collector(inPhysicsSystem, shape_cast, mUp, mCosMaxSlopeAngle);
-	inPhysicsSystem.GetNarrowPhaseQueryNoLock().CastShape(shape_cast, settings, shape_cast.mCenterOfMassStart.GetTranslation(), collector, broadphase_layer_filter, object_layer_filter, body_filter);
+	CastShape(inPhysicsSystem, inVehicleConstraint, shape_cast, settings, shape_cast.mCenterOfMassStart.GetTranslation(), inVehicleBodyID, collector);
 	if (collector.mBody == nullptr)
 		return false;
 
@@ -215,6 +323,17 @@ bool VehicleCollisionTesterCastSphere::Collide(PhysicsSystem &inPhysicsSystem, c
 	return true;
 }
 
+AABox VehicleCollisionTesterCastSphere::GetCollisionTestBounds(const VehicleConstraint &inVehicleConstraint, uint inWheelIndex, RVec3Arg inOrigin, Vec3Arg inDirection) const
+{
+	// Same sphere cast as in Collide
+	const WheelSettings *wheel_settings = inVehicleConstraint.GetWheel(inWheelIndex)->GetSettings();
+	Vec3 origin(inOrigin);
+	AABox bounds(origin, origin);
+	bounds.Encapsulate(origin + (wheel_settings->mSuspensionMaxLength + wheel_settings->mRadius - mRadius) * inDirection);
+	bounds.ExpandBy(Vec3::sReplicate(mRadius));
+	return bounds;
+}
+
 void VehicleCollisionTesterCastSphere::PredictContactProperties(PhysicsSystem &inPhysicsSystem, const VehicleConstraint &inVehicleConstraint, uint inWheelIndex, RVec3Arg inOrigin, Vec3Arg inDirection, const BodyID &inVehicleBodyID, Body *&ioBody, SubShapeID &ioSubShapeID, RVec3 &ioContactPosition, Vec3 &ioContactNormal, float &ioSuspensionLength) const
 {
 	// Recalculate the contact points assuming the contact point is on an infinite plane
@@ -240,15 +359,6 @@ void VehicleCollisionTesterCastSphere::PredictContactProperties(PhysicsSystem &i
 
 bool VehicleCollisionTesterCastCylinder::Collide(PhysicsSystem &inPhysicsSystem, const VehicleConstraint &inVehicleConstraint, uint inWheelIndex, RVec3Arg inOrigin, Vec3Arg inDirection, const BodyID &inVehicleBodyID, Body *&outBody, SubShapeID &outSubShapeID, RVec3 &outContactPosition, Vec3 &outContactNormal, float &outSuspensionLength) const
 {
-	const DefaultBroadPhaseLayerFilter default_broadphase_layer_filter = inPhysicsSystem.GetDefaultBroadPhaseLayerFilter(mObjectLayer);
-	const BroadPhaseLayerFilter &broadphase_layer_filter = mBroadPhaseLayerFilter != nullptr? *mBroadPhaseLayerFilter : default_broadphase_layer_filter;
-
-	const DefaultObjectLayerFilter default_object_layer_filter = inPhysicsSystem.GetDefaultLayerFilter(mObjectLayer);
-	const ObjectLayerFilter &object_layer_filter = mObjectLayerFilter != nullptr? *mObjectLayerFilter : default_object_layer_filter;
-
-	const IgnoreSingleBodyFilter default_body_filter(inVehicleBodyID);
-	const BodyFilter &body_filter = mBodyFilter != nullptr? *mBodyFilter : default_body_filter;
-
 	const WheelSettings *wheel_settings = inVehicleConstraint.GetWheel(inWheelIndex)->GetSettings();
 	float max_suspension_length = wheel_settings->mSuspensionMaxLength;
 
@@ -315,7 +425,7 @@ bool VehicleCollisionTesterCastCylinder::Collide(PhysicsSystem &inPhysicsSystem,
 	};
 
 	MyCollector collector(inPhysicsSystem, shape_cast);
-	inPhysicsSystem.GetNarrowPhaseQueryNoLock().CastShape(shape_cast, settings, shape_cast.mCenterOfMassStart.GetTranslation(), collector, broadphase_layer_filter, object_layer_filter, body_filter);
+	CastShape(inPhysicsSystem, inVehicleConstraint, shape_cast, settings, shape_cast.mCenterOfMassStart.GetTranslation(), inVehicleBodyID, collector);
 	if (collector.mBody == nullptr)
 		return false;
 
@@ -328,6 +438,17 @@ bool VehicleCollisionTesterCastCylinder::Collide(PhysicsSystem &inPhysicsSystem,
 	return true;
 }
 
+AABox VehicleCollisionTesterCastCylinder::GetCollisionTestBounds(const VehicleConstraint &inVehicleConstraint, uint inWheelIndex, RVec3Arg inOrigin, Vec3Arg inDirection) const
+{
+	// Same cylinder cast as in Collide, use a sphere that encloses the cylinder
+	const WheelSettings *wheel_settings = inVehicleConstraint.GetWheel(inWheelIndex)->GetSettings();
+	Vec3 origin(inOrigin);
+	AABox bounds(origin, origin);
+	bounds.Encapsulate(origin + wheel_settings->mSuspensionMaxLength * inDirection);
+	bounds.ExpandBy(Vec3::sReplicate(sqrt(Square(wheel_settings->mRadius) + Square(0.5f * wheel_settings->mWidth))));
+	return bounds;
+}
+
 void VehicleCollisionTesterCastCylinder::PredictContactProperties(PhysicsSystem &inPhysicsSystem, const VehicleConstraint &inVehicleConstraint, uint inWheelIndex, RVec3Arg inOrigin, Vec3Arg inDirection, const BodyID &inVehicleBodyID, Body *&ioBody, SubShapeID &ioSubShapeID, RVec3 &ioContactPosition, Vec3 &ioContactNormal, float &ioSuspensionLength) const
 {
 	// Recalculate the contact points assuming the contact point is on an infinite plane
@@ -5,6 +5,7 @@
 #pragma once
 
 #include <Jolt/Physics/Body/Body.h>
+#include <Jolt/Physics/Collision/TransformedShape.h>
 #include <Jolt/Core/NonCopyable.h>
 
 JPH_NAMESPACE_BEGIN
@@ -73,7 +74,29 @@ public:
 	/// @param ioSuspensionLength New length of the suspension [0, inSuspensionMaxLength]
 	virtual void					PredictContactProperties(PhysicsSystem &inPhysicsSystem, const VehicleConstraint &inVehicleConstraint, uint inWheelIndex, RVec3Arg inOrigin, Vec3Arg inDirection, const BodyID &inVehicleBodyID, Body *&ioBody, SubShapeID &ioSubShapeID, RVec3 &ioContactPosition, Vec3 &ioContactNormal, float &ioSuspensionLength) const = 0;
 
+	/// Get the world space bounding box of the collision test that Collide does for a wheel.
+	/// This is used to find the shapes that the wheels of a vehicle can collide with using a single broad phase query (see VehicleConstraint::SetBatchWheelCollisionTests).
+	/// @param inVehicleConstraint The vehicle constraint
+	/// @param inWheelIndex Index of the wheel that we're testing collision for
+	/// @param inOrigin Origin for the test, corresponds to the world space position for the suspension attachment point
+	/// @param inDirection Direction for the test (unit vector, world space)
+	/// @return The bounding box or an invalid box if the collision tester doesn't support batching the wheel collision tests
+	virtual AABox					GetCollisionTestBounds(const VehicleConstraint &inVehicleConstraint, uint inWheelIndex, RVec3Arg inOrigin, Vec3Arg inDirection) const { return AABox(); }
+
+	/// Collect the shapes of the bodies that overlap with inBounds, using the filters of this collision tester
+	/// @param inPhysicsSystem The physics system that should be tested against
+	/// @param inBounds World space bounding box of the collision tests of all wheels
+	/// @param inVehicleBodyID This body should be filtered out during collision detection to avoid self collisions
+	/// @param outShapes The shapes that were found
+	void							CollectShapes(PhysicsSystem &inPhysicsSystem, const AABox &inBounds, const BodyID &inVehicleBodyID, Array<TransformedShape> &outShapes) const;
+
 protected:
+	/// Cast a ray against the world. When the vehicle has collected the shapes for all wheels (see VehicleConstraint::GetWheelCollisionShapes) only these shapes are tested, otherwise the broad phase is queried.
+	void							CastRay(PhysicsSystem &inPhysicsSystem, const VehicleConstraint &inVehicleConstraint, const RRayCast &inRay, const RayCastSettings &inRayCastSettings, const BodyID &inVehicleBodyID, CastRayCollector &ioCollector) const;
+
+	/// Cast a shape against the world. When the vehicle has collected the shapes for all wheels (see VehicleConstraint::GetWheelCollisionShapes) only these shapes are tested, otherwise the broad phase is queried.
+	void							CastShape(PhysicsSystem &inPhysicsSystem, const VehicleConstraint &inVehicleConstraint, const RShapeCast &inShapeCast, const ShapeCastSettings &inShapeCastSettings, RVec3Arg inBaseOffset, const BodyID &inVehicleBodyID, CastShapeCollector &ioCollector) const;
+
 	const BroadPhaseLayerFilter	*	mBroadPhaseLayerFilter = nullptr;
 	const ObjectLayerFilter *		mObjectLayerFilter = nullptr;
 	const BodyFilter *				mBodyFilter = nullptr;
@@ -95,6 +118,7 @@ public:
 	// See: VehicleCollisionTester
 	virtual bool					Collide(PhysicsSystem &inPhysicsSystem, const VehicleConstraint &inVehicleConstraint, uint inWheelIndex, RVec3Arg inOrigin, Vec3Arg inDirection, const BodyID &inVehicleBodyID, Body *&outBody, SubShapeID &outSubShapeID, RVec3 &outContactPosition, Vec3 &outContactNormal, float &outSuspensionLength) const override;
 	virtual void					PredictContactProperties(PhysicsSystem &inPhysicsSystem, const VehicleConstraint &inVehicleConstraint, uint inWheelIndex, RVec3Arg inOrigin, Vec3Arg inDirection, const BodyID &inVehicleBodyID, Body *&ioBody, SubShapeID &ioSubShapeID, RVec3 &ioContactPosition, Vec3 &ioContactNormal, float &ioSuspensionLength) const override;
+	virtual AABox					GetCollisionTestBounds(const VehicleConstraint &inVehicleConstraint, uint inWheelIndex, RVec3Arg inOrigin, Vec3Arg inDirection) const override;
 
 private:
 	Vec3							mUp;
@@ -117,6 +141,7 @@ public:
 	// See: VehicleCollisionTester
 	virtual bool					Collide(PhysicsSystem &inPhysicsSystem, const VehicleConstraint &inVehicleConstraint, uint inWheelIndex, RVec3Arg inOrigin, Vec3Arg inDirection, const BodyID &inVehicleBodyID, Body *&outBody, SubShapeID &outSubShapeID, RVec3 &outContactPosition, Vec3 &outContactNormal, float &outSuspensionLength) const override;
 	virtual void					PredictContactProperties(PhysicsSystem &inPhysicsSystem, const VehicleConstraint &inVehicleConstraint, uint inWheelIndex, RVec3Arg inOrigin, Vec3Arg inDirection, const BodyID &inVehicleBodyID, Body *&ioBody, SubShapeID &ioSubShapeID, RVec3 &ioContactPosition, Vec3 &ioContactNormal, float &ioSuspensionLength) const override;
+	virtual AABox					GetCollisionTestBounds(const VehicleConstraint &inVehicleConstraint, uint inWheelIndex, RVec3Arg inOrigin, Vec3Arg inDirection) const override;
 
 private:
 	float							mRadius;
@@ -138,6 +163,7 @@ public:
 	// See: VehicleCollisionTester
 	virtual bool					Collide(PhysicsSystem &inPhysicsSystem, const VehicleConstraint &inVehicleConstraint, uint inWheelIndex, RVec3Arg inOrigin, Vec3Arg inDirection, const BodyID &inVehicleBodyID, Body *&outBody, SubShapeID &outSubShapeID, RVec3 &outContactPosition, Vec3 &outContactNormal, float &outSuspensionLength) const override;
 	virtual void					PredictContactProperties(PhysicsSystem &inPhysicsSystem, const VehicleConstraint &inVehicleConstraint, uint inWheelIndex, RVec3Arg inOrigin, Vec3Arg inDirection, const BodyID &inVehicleBodyID, Body *&ioBody, SubShapeID &ioSubShapeID, RVec3 &ioContactPosition, Vec3 &ioContactNormal, float &ioSuspensionLength) const override;
+	virtual AABox					GetCollisionTestBounds(const VehicleConstraint &inVehicleConstraint, uint inWheelIndex, RVec3Arg inOrigin, Vec3Arg inDirection) const override;
 
 private:
 	float							mConvexRadiusFraction;
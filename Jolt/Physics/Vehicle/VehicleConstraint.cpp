@@ -157,6 +157,59 @@ RMat44 VehicleConstraint::GetWheelWorldTransform(uint inWheelIndex, Vec3Arg inWh
 	return mBody->GetWorldTransform() * GetWheelLocalTransform(inWheelIndex, inWheelRight, inWheelUp);
 }
 
+void VehicleConstraint::SetLOD(EVehicleLOD inLOD)
+{
+	if (mLOD == inLOD)
+		return;
+
+	MotionProperties *mp = mBody->GetMotionProperties();
+	if (inLOD == EVehicleLOD::Low)
+	{
+		// Remember the solver steps of the full LOD so we can restore them
+		mFullLODNumVelocityStepsOverride = uint8(GetNumVelocityStepsOverride());
+		mFullLODNumPositionStepsOverride = uint8(GetNumPositionStepsOverride());
+		mFullLODBodyNumVelocityStepsOverride = uint8(mp->GetNumVelocityStepsOverride());
+		mFullLODBodyNumPositionStepsOverride = uint8(mp->GetNumPositionStepsOverride());
+
+		mLOD = inLOD;
+		ApplyLODSolverSteps();
+	}
+	else
+	{
+		// Restore the solver steps of the full LOD
+		SetNumVelocityStepsOverride(mFullLODNumVelocityStepsOverride);
+		SetNumPositionStepsOverride(mFullLODNumPositionStepsOverride);
+		mp->SetNumVelocityStepsOverride(mFullLODBodyNumVelocityStepsOverride);
+		mp->SetNumPositionStepsOverride(mFullLODBodyNumPositionStepsOverride);
+
+		mLOD = inLOD;
+	}
+}
+
+void VehicleConstraint::SetLowLODNumSolverSteps(uint inNumVelocitySteps, uint inNumPositionSteps)
+{
+	JPH_ASSERT(inNumVelocitySteps > 0 && inNumVelocitySteps < 256);
+	JPH_ASSERT(inNumPositionSteps < 256);
+
+	mLowLODNumVelocitySteps = uint8(inNumVelocitySteps);
+	mLowLODNumPositionSteps = uint8(inNumPositionSteps);
+
+	if (mLOD == EVehicleLOD::Low)
+		ApplyLODSolverSteps();
+}
+
+void VehicleConstraint::ApplyLODSolverSteps()
+{
+	JPH_ASSERT(mLOD == EVehicleLOD::Low);
+
+	SetNumVelocityStepsOverride(mLowLODNumVelocitySteps);
+	SetNumPositionStepsOverride(mLowLODNumPositionSteps);
+
+	MotionProperties *mp = mBody->GetMotionProperties();
+	mp->SetNumVelocityStepsOverride(mLowLODNumVelocitySteps);
+	mp->SetNumPositionStepsOverride(mLowLODNumPositionSteps);
+}
+
 void VehicleConstraint::OnStep(float inDeltaTime, PhysicsSystem &inPhysicsSystem)
 {
 	JPH_PROFILE_FUNCTION();
@@ -195,6 +248,29 @@ void VehicleConstraint::OnStep(float inDeltaTime, PhysicsSystem &inPhysicsSystem
 
 	RMat44 body_transform = mBody->GetWorldTransform();
 
+	// Select the collision tester for the current LOD
+	const VehicleCollisionTester *collision_tester = mLOD == EVehicleLOD::Low && mLowLODVehicleCollisionTester != nullptr? mLowLODVehicleCollisionTester.GetPtr() : mVehicleCollisionTester.GetPtr();
+
+	// Find the shapes that the wheels can collide with using a single broad phase query
+	if (mBatchWheelCollisionTests && num_steps_between_collisions != 0)
+	{
+		AABox bounds;
+		bool supported = true;
+		for (uint wheel_index = 0; wheel_index < mWheels.size() && supported; ++wheel_index)
+			if ((mCurrentStep + wheel_index) % num_steps_between_collisions == 0)
+			{
+				const WheelSettings *settings = mWheels[wheel_index]->mSettings;
+				AABox wheel_bounds = collision_tester->GetCollisionTestBounds(*this, wheel_index, body_transform * settings->mPosition, body_transform.Multiply3x3(settings->mSuspensionDirection));
+				supported = wheel_bounds.IsValid();
+				bounds.Encapsulate(wheel_bounds);
+			}
+		if (supported && bounds.IsValid())
+		{
+			collision_tester->CollectShapes(inPhysicsSystem, bounds, mBody->GetID(), mWheelCollisionShapes);
+			mUseWheelCollisionShapes = true;
+		}
+	}
+
 	// Test collision for wheels
 	for (uint wheel_index = 0; wheel_index < mWheels.size(); ++wheel_index)
 	{
@@ -224,7 +300,7 @@ void VehicleConstraint::OnStep(float inDeltaTime, PhysicsSystem &inPhysicsSystem
 				else
 				{
 					// Extrapolate the wheel contact properties
-					mVehicleCollisionTester->PredictContactProperties(inPhysicsSystem, *this, wheel_index, ws_origin, ws_direction, mBody->GetID(), w->mContactBody, w->mContactSubShapeID, w->mContactPosition, w->mContactNormal, w->mSuspensionLength);
+					collision_tester->PredictContactProperties(inPhysicsSystem, *this, wheel_index, ws_origin, ws_direction, mBody->GetID(), w->mContactBody, w->mContactSubShapeID, w->mContactPosition, w->mContactNormal, w->mSuspensionLength);
 				}
 			}
 		}
@@ -237,7 +313,7 @@ void VehicleConstraint::OnStep(float inDeltaTime, PhysicsSystem &inPhysicsSystem
 			w->mSuspensionLength = settings->mSuspensionMaxLength;
 
 			// Test collision to find the floor
-			if (mVehicleCollisionTester->Collide(inPhysicsSystem, *this, wheel_index, ws_origin, ws_direction, mBody->GetID(), w->mContactBody, w->mContactSubShapeID, w->mContactPosition, w->mContactNormal, w->mSuspensionLength))
+			if (collision_tester->Collide(inPhysicsSystem, *this, wheel_index, ws_origin, ws_direction, mBody->GetID(), w->mContactBody, w->mContactSubShapeID, w->mContactPosition, w->mContactNormal, w->mSuspensionLength))
 			{
 				// Store ID (pointer is not valid outside of the simulation step)
 				w->mContactBodyID = w->mContactBody->GetID();
@@ -276,6 +352,13 @@ void VehicleConstraint::OnStep(float inDeltaTime, PhysicsSystem &inPhysicsSystem
 		}
 	}
 
+	// Release the shapes that were collected for the wheels
+	if (mUseWheelCollisionShapes)
+	{
+		mWheelCollisionShapes.clear();
+		mUseWheelCollisionShapes = false;
+	}
+
 	// Callback to higher-level systems. We do it immediately after wheel collision.
 	if (mPostCollideCallback != nullptr)
 		mPostCollideCallback(*this, inDeltaTime, inPhysicsSystem);
@@ -40,6 +40,13 @@ protected:
 	virtual void				RestoreBinaryState(StreamIn &inStream) override;
 };
 
+/// Level of detail of the simulation of a vehicle, see VehicleConstraint::SetLOD
+enum class EVehicleLOD : uint8
+{
+	Full,				///< Full simulation of the vehicle
+	Low,				///< Reduced simulation for vehicles that are far away from the camera: uses the low LOD collision tester, simplified drivetrain and fewer solver steps
+};
+
 /// Constraint that simulates a vehicle
 /// Note: Don't forget to register the constraint as a StepListener with the PhysicsSystem!
 ///
@@ -176,6 +183,34 @@ public:
 	void						SetNumStepsBetweenCollisionTestInactive(uint inSteps) { mNumStepsBetweenCollisionTestInactive = inSteps; }
 	uint						GetNumStepsBetweenCollisionTestInactive() const { return mNumStepsBetweenCollisionTestInactive; }
 
+	/// When true, the shapes that the wheels can collide with are collected using a single broad phase query for all wheels that need a collision test this step.
+	/// The collision tests of the individual wheels then only need to do narrow phase tests against these shapes, which reduces the cost of the broad phase when simulating many vehicles.
+	/// This is only done when the VehicleCollisionTester supports it (see VehicleCollisionTester::GetCollisionTestBounds). Default is false.
+	void						SetBatchWheelCollisionTests(bool inBatch)	{ mBatchWheelCollisionTests = inBatch; }
+	bool						GetBatchWheelCollisionTests() const			{ return mBatchWheelCollisionTests; }
+
+	/// Set the level of detail of the simulation, can be used to reduce the cost of vehicles that are far away from the camera. Default is EVehicleLOD::Full.
+	/// In EVehicleLOD::Low:
+	/// - The collision tester set with SetLowLODVehicleCollisionTester is used (e.g. a VehicleCollisionTesterRay), if none is set the normal collision tester is used.
+	/// - The vehicle controller may use a simplified model (e.g. the WheeledVehicleController rigidly couples the engine to the wheels instead of simulating the clutch).
+	/// - The number of solver steps for the vehicle constraint and body are overridden by the values set with SetLowLODNumSolverSteps.
+	/// The state of the vehicle (wheel speeds, engine RPM, gear) is kept in both modes so that the vehicle can switch without discontinuities.
+	/// Note that this changes the number of solver steps of the vehicle body, so this should not be called while the physics system is updating.
+	void						SetLOD(EVehicleLOD inLOD);
+	EVehicleLOD					GetLOD() const								{ return mLOD; }
+
+	/// Set the interface that tests collision between wheel and ground when the LOD is EVehicleLOD::Low, nullptr to use the normal collision tester
+	void						SetLowLODVehicleCollisionTester(const VehicleCollisionTester *inTester) { mLowLODVehicleCollisionTester = inTester; }
+
+	/// Number of solver velocity / position steps for the vehicle constraint and body when the LOD is EVehicleLOD::Low. Default is 2 velocity and 1 position step.
+	/// Note that the number of steps used is the max of all bodies and constraints in the island, so if the vehicle touches other bodies it can still use more steps.
+	void						SetLowLODNumSolverSteps(uint inNumVelocitySteps, uint inNumPositionSteps);
+	uint						GetLowLODNumVelocitySteps() const			{ return mLowLODNumVelocitySteps; }
+	uint						GetLowLODNumPositionSteps() const			{ return mLowLODNumPositionSteps; }
+
+	/// Get the shapes that the wheels can collide with, only valid during the wheel collision tests when they're batched (see SetBatchWheelCollisionTests), returns nullptr otherwise
+	const Array<TransformedShape> *GetWheelCollisionShapes() const			{ return mUseWheelCollisionShapes? &mWheelCollisionShapes : nullptr; }
+
 	// Generic interface of a constraint
 	virtual bool				IsActive() const override					{ return mIsActive && Constraint::IsActive(); }
 	virtual void				NotifyShapeChanged(const BodyID &inBodyID, Vec3Arg inDeltaCOM) override { /* Do nothing */ }
@@ -201,6 +236,9 @@ private:
 	// Calculate the position where the suspension and traction forces should be applied in world space, relative to the center of mass of both bodies
 	void						CalculateSuspensionForcePoint(const Wheel &inWheel, Vec3 &outR1PlusU, Vec3 &outR2) const;
 
+	// Override the number of solver steps of the constraint and body with the values for the current LOD
+	void						ApplyLODSolverSteps();
+
 	// Calculate the constraint properties for mPitchRollPart
 	void						CalculatePitchRollConstraintProperties(RMat44Arg inBodyTransform);
 
@@ -220,6 +258,18 @@ private:
 	uint						mNumStepsBetweenCollisionTestActive = 1;	///< Number of simulation steps between wheel collision tests when the vehicle is active
 	uint						mNumStepsBetweenCollisionTestInactive = 1;	///< Number of simulation steps between wheel collision tests when the vehicle is inactive
 	uint						mCurrentStep = 0;							///< Current step number, used to determine when to test a wheel
+	bool						mBatchWheelCollisionTests = false;			///< If the wheel collision tests use a single broad phase query for all wheels
+	bool						mUseWheelCollisionShapes = false;			///< If mWheelCollisionShapes is valid
+	Array<TransformedShape>		mWheelCollisionShapes;						///< Shapes that the wheels can collide with when the wheel collision tests are batched
+
+	// Level of detail
+	EVehicleLOD					mLOD = EVehicleLOD::Full;					///< Current level of detail of the simulation
+	uint8						mLowLODNumVelocitySteps = 2;				///< Number of solver velocity steps when the LOD is EVehicleLOD::Low
+	uint8						mLowLODNumPositionSteps = 1;				///< Number of solver position steps when the LOD is EVehicleLOD::Low
+	uint8						mFullLODNumVelocityStepsOverride = 0;		///< Velocity steps override of the constraint when switching to EVehicleLOD::Low, restored when switching back
+	uint8						mFullLODNumPositionStepsOverride = 0;		///< Position steps override of the constraint when switching to EVehicleLOD::Low, restored when switching back
+	uint8						mFullLODBodyNumVelocityStepsOverride = 0;	///< Velocity steps override of the body when switching to EVehicleLOD::Low, restored when switching back
+	uint8						mFullLODBodyNumPositionStepsOverride = 0;	///< Position steps override of the body when switching to EVehicleLOD::Low, restored when switching back
 
 	// Prevent vehicle from toppling over
 	float						mCosMaxPitchRollAngle;						///< Cos of the max pitch/roll angle
@@ -229,6 +279,7 @@ private:
 
 	// Interfaces
 	RefConst<VehicleCollisionTester> mVehicleCollisionTester;				///< Class that performs testing of collision for the wheels
+	RefConst<VehicleCollisionTester> mLowLODVehicleCollisionTester;			///< Class that performs testing of collision for the wheels when the LOD is EVehicleLOD::Low
 	CombineFunction				mCombineFriction = [](uint, float &ioLongitudinalFriction, float &ioLateralFriction, const Body &inBody2, const SubShapeID &)
 	{
 		float body_friction = inBody2.GetFriction();
@@ -257,33 +257,13 @@ void WheeledVehicleController::PreCollide(float inDeltaTime, PhysicsSystem &inPh
 	}
 }
 
-void WheeledVehicleController::PostCollide(float inDeltaTime, PhysicsSystem &inPhysicsSystem)
+bool WheeledVehicleController::UpdateDrivetrain(float inForwardInput, float inDeltaTime)
 {
-	JPH_PROFILE_FUNCTION();
-
-	// Remember old RPM so we can detect if we're increasing or decreasing
-	float old_engine_rpm = mEngine.GetCurrentRPM();
+	// Calculate engine torque
+	float engine_torque = mEngine.GetTorque(inForwardInput);
 
 	Wheels &wheels = mConstraint.GetWheels();
 
-	// Update wheel angle, do this before applying torque to the wheels (as friction will slow them down again)
-	for (uint wheel_index = 0, num_wheels = (uint)wheels.size(); wheel_index < num_wheels; ++wheel_index)
-	{
-		WheelWV *w = static_cast<WheelWV *>(wheels[wheel_index]);
-		w->Update(wheel_index, inDeltaTime, mConstraint);
-	}
-
-	// In auto transmission mode, don't accelerate the engine when switching gears
-	float forward_input = abs(mForwardInput);
-	if (mTransmission.mMode == ETransmissionMode::Auto)
-		forward_input *= mTransmission.GetClutchFriction();
-
-	// Apply engine damping
-	mEngine.ApplyDamping(inDeltaTime);
-
-	// Calculate engine torque
-	float engine_torque = mEngine.GetTorque(forward_input);
-
 	// Define a struct that contains information about driven differentials (i.e. that have wheels connected)
 	struct DrivenDifferential
 	{
@@ -605,6 +585,85 @@ void WheeledVehicleController::PostCollide(float inDeltaTime, PhysicsSystem &inP
 	for (const DrivenWheel &w : driven_wheels)
 		wheels_slipping |= w.mClutchToWheelTorqueRatio > 0.0f && (!w.mWheel->HasContact() || w.mWheel->mLongitudinalSlip > 0.1f);
 
+	return wheels_slipping;
+}
+
+bool WheeledVehicleController::UpdateDrivetrainLowLOD(float inForwardInput, float inDeltaTime)
+{
+	// Instead of solving the coupled engine / clutch / wheel speeds, we assume the engine is rigidly connected to the driven wheels.
+	// The engine RPM follows the wheels so that we can switch back to the full model without a jump in RPM.
+	float transmission_ratio = mTransmission.GetCurrentRatio();
+	float clutch_friction = mTransmission.GetClutchFriction();
+	bool engine_connected = transmission_ratio != 0.0f && clutch_friction > 0.0f;
+	float wheel_rpm_at_clutch = 0.0f;
+	if (engine_connected)
+	{
+		wheel_rpm_at_clutch = abs(GetWheelSpeedAtClutch());
+		mEngine.SetCurrentRPM(wheel_rpm_at_clutch);
+	}
+
+	// Calculate engine torque, cut it when the wheels turn faster than the engine can (rev limiter)
+	float engine_torque = mEngine.GetTorque(inForwardInput);
+	if (!engine_connected)
+	{
+		// Engine not connected to wheels, apply all torque to engine rotation
+		mEngine.ApplyTorque(engine_torque, inDeltaTime);
+		engine_torque = 0.0f;
+	}
+	else if (wheel_rpm_at_clutch >= mEngine.mMaxRPM)
+		engine_torque = 0.0f;
+
+	// Apply the torque to the driven wheels
+	Wheels &wheels = mConstraint.GetWheels();
+	bool wheels_slipping = false;
+	for (const VehicleDifferentialSettings &d : mDifferentials)
+	{
+		int indices[] = { d.mLeftWheel, d.mRightWheel };
+		int num_wheels = (d.mLeftWheel != -1? 1 : 0) + (d.mRightWheel != -1? 1 : 0);
+		if (num_wheels == 0)
+			continue;
+
+		// Split the torque evenly between the left and right wheel
+		float wheel_torque = engine_torque * clutch_friction * transmission_ratio * d.mDifferentialRatio * d.mEngineTorqueRatio / float(num_wheels);
+		for (int idx : indices)
+			if (idx != -1)
+			{
+				WheelWV *w = static_cast<WheelWV *>(wheels[idx]);
+				w->ApplyTorque(wheel_torque, inDeltaTime);
+				wheels_slipping |= d.mEngineTorqueRatio > 0.0f && (!w->HasContact() || w->mLongitudinalSlip > 0.1f);
+			}
+	}
+
+	return wheels_slipping;
+}
+
+void WheeledVehicleController::PostCollide(float inDeltaTime, PhysicsSystem &inPhysicsSystem)
+{
+	JPH_PROFILE_FUNCTION();
+
+	// Remember old RPM so we can detect if we're increasing or decreasing
+	float old_engine_rpm = mEngine.GetCurrentRPM();
+
+	Wheels &wheels = mConstraint.GetWheels();
+
+	// Update wheel angle, do this before applying torque to the wheels (as friction will slow them down again)
+	for (uint wheel_index = 0, num_wheels = (uint)wheels.size(); wheel_index < num_wheels; ++wheel_index)
+	{
+		WheelWV *w = static_cast<WheelWV *>(wheels[wheel_index]);
+		w->Update(wheel_index, inDeltaTime, mConstraint);
+	}
+
+	// In auto transmission mode, don't accelerate the engine when switching gears
+	float forward_input = abs(mForwardInput);
+	if (mTransmission.mMode == ETransmissionMode::Auto)
+		forward_input *= mTransmission.GetClutchFriction();
+
+	// Apply engine damping
+	mEngine.ApplyDamping(inDeltaTime);
+
+	// Transfer the engine torque to the wheels
+	bool wheels_slipping = mConstraint.GetLOD() == EVehicleLOD::Low? UpdateDrivetrainLowLOD(forward_input, inDeltaTime) : UpdateDrivetrain(forward_input, inDeltaTime);
+
 	// Only allow shifting up when we're not slipping and we're increasing our RPM.
 	// After a jump, we have a very high engine RPM but once we hit the ground the RPM should be decreasing and we don't want to shift up
 	// during that time.
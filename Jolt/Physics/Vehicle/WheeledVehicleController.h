@@ -168,6 +168,12 @@ protected:
 	virtual void				Draw(DebugRenderer *inRenderer) const override;
 #endif // JPH_DEBUG_RENDERER
 
+	// Update the engine and apply its torque to the driven wheels, returns true when any of the driven wheels are slipping
+	bool						UpdateDrivetrain(float inForwardInput, float inDeltaTime);
+
+	// Simplified version of UpdateDrivetrain used when the vehicle LOD is EVehicleLOD::Low
+	bool						UpdateDrivetrainLowLOD(float inForwardInput, float inDeltaTime);
+
 	// Control information
 	float						mForwardInput = 0.0f;						///< Value between -1 and 1 for auto transmission and value between 0 and 1 indicating desired driving direction and amount the gas pedal is pressed
 	float						mRightInput = 0.0f;							///< Value between -1 and 1 indicating desired steering angle
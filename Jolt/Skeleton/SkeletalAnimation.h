@@ -59,6 +59,9 @@ public:
 	/// Get the length (in seconds) of this animation
 	float								GetDuration() const;
 
+	/// If this animation loops back to start
+	bool								IsLooping() const									{ return mIsLooping; }
+
 	/// Scale the size of all joints by inScale
 	void								ScaleJoints(float inScale);
 
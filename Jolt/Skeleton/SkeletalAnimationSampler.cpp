@@ -0,0 +1,195 @@
+// Jolt Physics Library (https://github.com/jrouwe/JoltPhysics)
+// SPDX-FileCopyrightText: 2024 Jorrit Rouwe
+// SPDX-License-Identifier: MIT
+
+#include <Jolt/Jolt.h>
+
+#include <Jolt/Skeleton/SkeletalAnimationSampler.h>
+#include <Jolt/Skeleton/SkeletonPose.h>
+
+JPH_NAMESPACE_BEGIN
+
+/// Collects rotations that need to be interpolated and interpolates them 4 at a time
+class SkeletalAnimationSampler::InterpolationBatch
+{
+public:
+	/// Add a rotation to interpolate, the result is written to outRotation when the batch is flushed
+	inline void					Add(QuatArg inFrom, QuatArg inTo, float inFraction, Quat *outRotation)
+	{
+		mFrom[mCount] = inFrom.GetXYZW();
+		mTo[mCount] = inTo.GetXYZW();
+		mFraction[mCount] = inFraction;
+		mOutput[mCount] = outRotation;
+		if (++mCount == 4)
+			Flush();
+	}
+
+	/// Interpolate all rotations that have been added, this does the same as Quat::SLERP
+	void						Flush()
+	{
+		if (mCount == 0)
+			return;
+
+		// Fill unused lanes with identity rotations
+		for (uint i = mCount; i < 4; ++i)
+		{
+			mFrom[i] = mTo[i] = Quat::sIdentity().GetXYZW();
+			mFraction[i] = 0.0f;
+		}
+
+		// Transpose so that each column contains one component of 4 quaternions
+		Mat44 from = Mat44(mFrom[0], mFrom[1], mFrom[2], mFrom[3]).Transposed();
+		Mat44 to = Mat44(mTo[0], mTo[1], mTo[2], mTo[3]).Transposed();
+		Vec4 fraction(mFraction[0], mFraction[1], mFraction[2], mFraction[3]);
+		Vec4 one = Vec4::sReplicate(1.0f);
+		Vec4 one_minus_fraction = one - fraction;
+
+		// Calculate cosine
+		Vec4 cos_omega = from.GetColumn4(0) * to.GetColumn4(0) + from.GetColumn4(1) * to.GetColumn4(1) + from.GetColumn4(2) * to.GetColumn4(2) + from.GetColumn4(3) * to.GetColumn4(3);
+
+		// Adjust signs so that we take the shortest path
+		Vec4 sign_scale1 = cos_omega.GetSign();
+		cos_omega = Vec4::sMin(cos_omega.Abs(), one);
+
+		// Quaternions that are very close are interpolated linearly
+		UVec4 use_lerp = Vec4::sLessOrEqual(one - cos_omega, Vec4::sReplicate(0.0001f));
+
+		// Calculate coefficients
+		Vec4 omega = cos_omega.ACos();
+		Vec4 sin_omega, sin_scale0, sin_scale1, cos_unused;
+		omega.SinCos(sin_omega, cos_unused);
+		(one_minus_fraction * omega).SinCos(sin_scale0, cos_unused);
+		(fraction * omega).SinCos(sin_scale1, cos_unused);
+		sin_omega = Vec4::sSelect(sin_omega, one, use_lerp); // Avoid division by zero for the lanes that lerp
+		Vec4 scale0 = Vec4::sSelect(sin_scale0 / sin_omega, one_minus_fraction, use_lerp);
+		Vec4 scale1 = sign_scale1 * Vec4::sSelect(sin_scale1 / sin_omega, fraction, use_lerp);
+
+		// Interpolate and normalize
+		Mat44 result;
+		for (int c = 0; c < 4; ++c)
+			result.SetColumn4(c, scale0 * from.GetColumn4(c) + scale1 * to.GetColumn4(c));
+		Vec4 length_sq = result.GetColumn4(0) * result.GetColumn4(0) + result.GetColumn4(1) * result.GetColumn4(1) + result.GetColumn4(2) * result.GetColumn4(2) + result.GetColumn4(3) * result.GetColumn4(3);
+		Vec4 length = length_sq.Sqrt();
+		for (int c = 0; c < 4; ++c)
+			result.SetColumn4(c, result.GetColumn4(c) / length);
+
+		// Transpose back and store the results
+		result = result.Transposed();
+		for (uint i = 0; i < mCount; ++i)
+		{
+			*mOutput[i] = Quat(result.GetColumn4(i));
+			JPH_ASSERT(mOutput[i]->IsNormalized());
+		}
+
+		mCount = 0;
+	}
+
+private:
+	Vec4						mFrom[4];
+	Vec4						mTo[4];
+	float						mFraction[4];
+	Quat *						mOutput[4];
+	uint						mCount = 0;
+};
+
+SkeletalAnimationSampler::SkeletalAnimationSampler(const SkeletalAnimation *inAnimation, const Skeleton *inSkeleton) :
+	mAnimation(inAnimation),
+	mSkeleton(inSkeleton)
+{
+	const SkeletalAnimation::AnimatedJointVector &animated_joints = inAnimation->GetAnimatedJoints();
+	mJointIndices.reserve(animated_joints.size());
+	for (const SkeletalAnimation::AnimatedJoint &aj : animated_joints)
+		mJointIndices.push_back(inSkeleton->GetJointIndex(aj.mJointName));
+	mKeyframeCursors.resize(animated_joints.size(), -1);
+}
+
+void SkeletalAnimationSampler::Sample(float inTime, SkeletonPose &ioPose, InterpolationBatch &ioBatch)
+{
+	JPH_ASSERT(ioPose.GetSkeleton() == mSkeleton);
+
+	// Max number of keyframes to step forward before switching to a binary search
+	constexpr int cMaxLinearSteps = 4;
+
+	// Correct time when animation is looping
+	JPH_ASSERT(inTime >= 0.0f);
+	float duration = mAnimation->GetDuration();
+	float time = duration > 0.0f && mAnimation->IsLooping()? fmod(inTime, duration) : inTime;
+
+	const SkeletalAnimation::AnimatedJointVector &animated_joints = mAnimation->GetAnimatedJoints();
+	for (size_t j = 0; j < animated_joints.size(); ++j)
+	{
+		int joint_idx = mJointIndices[j];
+		const SkeletalAnimation::KeyframeVector &keyframes = animated_joints[j].mKeyframes;
+		if (joint_idx < 0 || keyframes.empty())
+			continue;
+		int num_keyframes = (int)keyframes.size();
+
+		// Find the last keyframe before time, start at the keyframe of the previous sample
+		int low = mKeyframeCursors[j];
+		if (low >= 0 && !(keyframes[low].mTime < time))
+			low = -1; // Time went backwards, e.g. because the animation looped
+		for (int step = 0; low + 1 < num_keyframes && keyframes[low + 1].mTime < time; ++step)
+		{
+			if (step == cMaxLinearSteps)
+			{
+				// Too far away, do a binary search in the remaining keyframes
+				int high = num_keyframes;
+				while (high - low > 1)
+				{
+					int probe = (high + low) / 2;
+					if (keyframes[probe].mTime < time)
+						low = probe;
+					else
+						high = probe;
+				}
+				break;
+			}
+			++low;
+		}
+		mKeyframeCursors[j] = low;
+
+		SkeletalAnimation::JointState &state = ioPose.GetJoint(joint_idx);
+
+		if (low == -1)
+		{
+			// Before first key, return first key
+			state = static_cast<const SkeletalAnimation::JointState &>(keyframes.front());
+		}
+		else if (low == num_keyframes - 1)
+		{
+			// Beyond last key, return last key
+			state = static_cast<const SkeletalAnimation::JointState &>(keyframes.back());
+		}
+		else
+		{
+			// Interpolate
+			const SkeletalAnimation::Keyframe &s1 = keyframes[low];
+			const SkeletalAnimation::Keyframe &s2 = keyframes[low + 1];
+
+			float fraction = (time - s1.mTime) / (s2.mTime - s1.mTime);
+			JPH_ASSERT(fraction >= 0.0f && fraction <= 1.0f);
+
+			state.mTranslation = (1.0f - fraction) * s1.mTranslation + fraction * s2.mTranslation;
+			JPH_ASSERT(s1.mRotation.IsNormalized());
+			JPH_ASSERT(s2.mRotation.IsNormalized());
+			ioBatch.Add(s1.mRotation, s2.mRotation, fraction, &state.mRotation);
+		}
+	}
+}
+
+void SkeletalAnimationSampler::Sample(float inTime, SkeletonPose &ioPose)
+{
+	InterpolationBatch batch;
+	Sample(inTime, ioPose, batch);
+	batch.Flush();
+}
+
+void SkeletalAnimationSampler::sSample(SkeletalAnimationSampler *const *inSamplers, const float *inTimes, SkeletonPose *const *ioPoses, uint inNumPoses)
+{
+	InterpolationBatch batch;
+	for (uint i = 0; i < inNumPoses; ++i)
+		inSamplers[i]->Sample(inTimes[i], *ioPoses[i], batch);
+	batch.Flush();
+}
+
+JPH_NAMESPACE_END
@@ -0,0 +1,53 @@
+// Jolt Physics Library (https://github.com/jrouwe/JoltPhysics)
+// SPDX-FileCopyrightText: 2024 Jorrit Rouwe
+// SPDX-License-Identifier: MIT
+
+#pragma once
+
+#include <Jolt/Core/NonCopyable.h>
+#include <Jolt/Skeleton/SkeletalAnimation.h>
+#include <Jolt/Skeleton/Skeleton.h>
+
+JPH_NAMESPACE_BEGIN
+
+class SkeletonPose;
+
+/// Samples a SkeletalAnimation into a SkeletonPose. Gives the same result as SkeletalAnimation::Sample but is cheaper when the animation is played back over time:
+/// - The animated joints are mapped to the joints of the skeleton once instead of on every sample.
+/// - The keyframe that was used for each joint is remembered so that sampling at a slightly later time only needs to step forward instead of doing a binary search.
+/// - The rotations of 4 joints are interpolated at the same time using SIMD instructions.
+///
+/// A sampler keeps track of the playback position of a single animation instance, so create one for every pose that the animation is played on.
+class JPH_EXPORT SkeletalAnimationSampler : public NonCopyable
+{
+public:
+	JPH_OVERRIDE_NEW_DELETE
+
+	/// Constructor
+	/// @param inAnimation The animation to sample
+	/// @param inSkeleton The skeleton of the poses that will be sampled into, joints of the animation that are not in the skeleton are ignored
+								SkeletalAnimationSampler(const SkeletalAnimation *inAnimation, const Skeleton *inSkeleton);
+
+	/// Get the (interpolated) joint transforms at time inTime
+	void						Sample(float inTime, SkeletonPose &ioPose);
+
+	/// Sample multiple poses at once, this fills up the 4-wide interpolation batches across poses.
+	/// Equivalent to calling inSamplers[i]->Sample(inTimes[i], *ioPoses[i]) for all i.
+	static void					sSample(SkeletalAnimationSampler *const *inSamplers, const float *inTimes, SkeletonPose *const *ioPoses, uint inNumPoses);
+
+	/// Get the animation that is being sampled
+	const SkeletalAnimation *	GetAnimation() const										{ return mAnimation; }
+
+private:
+	class InterpolationBatch;
+
+	/// Sample all joints and add the rotations that need interpolating to ioBatch
+	void						Sample(float inTime, SkeletonPose &ioPose, InterpolationBatch &ioBatch);
+
+	RefConst<SkeletalAnimation>	mAnimation;													///< Animation that is being sampled
+	RefConst<Skeleton>			mSkeleton;													///< Skeleton that the animation is sampled for
+	Array<int>					mJointIndices;												///< For each animated joint the index of the joint in mSkeleton or -1 if it doesn't exist
+	Array<int>					mKeyframeCursors;											///< For each animated joint the index of the last keyframe before the previous sample time (or -1)
+};
+
+JPH_NAMESPACE_END
@@ -0,0 +1,153 @@
+// Jolt Physics Library (https://github.com/jrouwe/JoltPhysics)
+// SPDX-FileCopyrightText: 2024 Jorrit Rouwe
+// SPDX-License-Identifier: MIT
+
+#pragma once
+
+// Jolt includes
+#include <Jolt/Physics/Ragdoll/Ragdoll.h>
+#include <Jolt/Skeleton/SkeletalAnimationSampler.h>
+#include <Jolt/ObjectStream/ObjectStreamIn.h>
+
+// Local includes
+#include "PerformanceTestScene.h"
+#include "Layers.h"
+
+#ifdef JPH_OBJECT_STREAM
+
+// A grid of kinematic ragdolls that are driven by a walk animation, to measure the cost of sampling animations and driving ragdolls to a pose
+class AnimatedRagdollsScene : public PerformanceTestScene
+{
+public:
+							AnimatedRagdollsScene(bool inBatched) : mBatched(inBatched) { }
+
+	virtual const char *	GetName() const override
+	{
+		return mBatched? "AnimatedRagdollsBatched" : "AnimatedRagdolls";
+	}
+
+	virtual bool			Load() override
+	{
+		// Load ragdoll
+		if (!ObjectStreamIn::sReadObject("Assets/Human.tof", mRagdollSettings))
+		{
+			cerr << "Unable to load ragdoll" << endl;
+			return false;
+		}
+		for (BodyCreationSettings &body : mRagdollSettings->mParts)
+		{
+			body.mObjectLayer = Layers::MOVING;
+			body.mMotionType = EMotionType::Kinematic;
+		}
+
+		// Init ragdoll
+		mRagdollSettings->GetSkeleton()->CalculateParentJointIndices();
+		mRagdollSettings->CalculateBodyIndexToConstraintIndex();
+		mRagdollSettings->CalculateConstraintIndexToBodyIdxPair();
+
+		// Load animation
+		if (!ObjectStreamIn::sReadObject("Assets/Human/walk.tof", mAnimation))
+		{
+			cerr << "Unable to load animation" << endl;
+			return false;
+		}
+
+		return true;
+	}
+
+	virtual void			StartTest(PhysicsSystem &inPhysicsSystem, EMotionQuality inMotionQuality) override
+	{
+		// Test configuration
+		const int cNumPerAxis = 20;
+		const float cSeparation = 2.0f;
+
+		// Set motion quality on ragdoll
+		for (BodyCreationSettings &body : mRagdollSettings->mParts)
+			body.mMotionQuality = inMotionQuality;
+
+		const Skeleton *skeleton = mRagdollSettings->GetSkeleton();
+		mInstances.resize(cNumPerAxis * cNumPerAxis);
+		for (int i = 0; i < (int)mInstances.size(); ++i)
+		{
+			Instance &instance = mInstances[i];
+
+			// Start every ragdoll at a different point in the animation
+			instance.mTime = mAnimation->GetDuration() * i / mInstances.size();
+			instance.mSampler = new SkeletalAnimationSampler(mAnimation, skeleton);
+
+			// Create ragdoll in its initial pose
+			instance.mPose.SetSkeleton(skeleton);
+			instance.mPose.SetRootOffset(RVec3(cSeparation * (i % cNumPerAxis - cNumPerAxis / 2), 0, cSeparation * (i / cNumPerAxis - cNumPerAxis / 2)));
+			mAnimation->Sample(instance.mTime, instance.mPose);
+			instance.mPose.CalculateJointMatrices();
+			instance.mRagdoll = mRagdollSettings->CreateRagdoll(CollisionGroup::GroupID(i), 0, &inPhysicsSystem);
+			instance.mRagdoll->SetPose(instance.mPose);
+			instance.mRagdoll->AddToPhysicsSystem(EActivation::Activate);
+		}
+	}
+
+	virtual void			UpdateTest([[maybe_unused]] PhysicsSystem &inPhysicsSystem, [[maybe_unused]] JobSystem &inJobSystem) override
+	{
+		const float cDeltaTime = 1.0f / 60.0f;
+
+		for (Instance &instance : mInstances)
+			instance.mTime += cDeltaTime;
+
+		if (mBatched)
+		{
+			// Sample all animations at once and drive all ragdolls with a single lock
+			Array<SkeletalAnimationSampler *> samplers;
+			Array<float> times;
+			Array<SkeletonPose *> poses;
+			Array<Ragdoll *> ragdolls;
+			for (Instance &instance : mInstances)
+			{
+				samplers.push_back(instance.mSampler);
+				times.push_back(instance.mTime);
+				poses.push_back(&instance.mPose);
+				ragdolls.push_back(instance.mRagdoll);
+			}
+			SkeletalAnimationSampler::sSample(samplers.data(), times.data(), poses.data(), (uint)mInstances.size());
+			for (SkeletonPose *pose : poses)
+				pose->CalculateJointMatrices();
+			Ragdoll::sDriveToPoseUsingKinematics(ragdolls.data(), poses.data(), (uint)mInstances.size(), cDeltaTime);
+		}
+		else
+		{
+			// Sample and drive the ragdolls one by one
+			for (Instance &instance : mInstances)
+			{
+				mAnimation->Sample(instance.mTime, instance.mPose);
+				instance.mPose.CalculateJointMatrices();
+				instance.mRagdoll->DriveToPoseUsingKinematics(instance.mPose, cDeltaTime);
+			}
+		}
+	}
+
+	virtual void			StopTest(PhysicsSystem &inPhysicsSystem) override
+	{
+		for (Instance &instance : mInstances)
+		{
+			instance.mRagdoll->RemoveFromPhysicsSystem();
+			delete instance.mSampler;
+		}
+		mInstances.clear();
+	}
+
+private:
+	// A single animated ragdoll
+	struct Instance
+	{
+		Ref<Ragdoll>				mRagdoll;
+		SkeletalAnimationSampler *	mSampler = nullptr;
+		SkeletonPose				mPose;
+		float						mTime = 0.0f;
+	};
+
+	bool					mBatched;
+	Ref<RagdollSettings>	mRagdollSettings;
+	Ref<SkeletalAnimation>	mAnimation;
+	Array<Instance>			mInstances;
+};
+
+#endif // JPH_OBJECT_STREAM
@@ -0,0 +1,186 @@
+// Jolt Physics Library (https://github.com/jrouwe/JoltPhysics)
+// SPDX-FileCopyrightText: 2024 Jorrit Rouwe
+// SPDX-License-Identifier: MIT
+
+#pragma once
+
+// Jolt includes
+#include <Jolt/Physics/Collision/Shape/BoxShape.h>
+#include <Jolt/Physics/Collision/Shape/CapsuleShape.h>
+#include <Jolt/Physics/Collision/Shape/MeshShape.h>
+#include <Jolt/Physics/Collision/Shape/RotatedTranslatedShape.h>
+#include <Jolt/Physics/Character/CharacterVirtualBatchUpdater.h>
+#include <Jolt/Physics/Character/CharacterVsCharacterGrid.h>
+#include <Jolt/Physics/Body/BodyCreationSettings.h>
+#include <Jolt/Core/TempAllocator.h>
+
+// Local includes
+#include "PerformanceTestScene.h"
+#include "Layers.h"
+
+// A large number of virtual characters walking in circles (or standing still) over a terrain with static rubble and dynamic boxes, to measure the cost of updating characters
+class CharactersScene : public PerformanceTestScene
+{
+public:
+	// Variants of the scene
+	enum class EMode
+	{
+		Serial,						// Walking characters, updated one after the other
+		Batched,					// Walking characters, updated in parallel
+		Idle,						// Characters that stand still
+		IdleReuseContacts,			// Characters that stand still and reuse their contacts
+		VsCharacters,				// Walking characters that collide with each other, updated in parallel
+	};
+
+							CharactersScene(EMode inMode) : mMode(inMode) { }
+
+	virtual const char *	GetName() const override
+	{
+		switch (mMode)
+		{
+		case EMode::Serial:				return "Characters";
+		case EMode::Batched:			return "CharactersBatched";
+		case EMode::Idle:				return "CharactersIdle";
+		case EMode::IdleReuseContacts:	return "CharactersIdleReuseContacts";
+		case EMode::VsCharacters:		return "CharactersVsCharacters";
+		}
+
+		JPH_ASSERT(false);
+		return "";
+	}
+
+	virtual bool			Load() override
+	{
+		const int n = 100;
+		const float cell_size = 2.0f;
+		const float max_height = 1.0f;
+		float center = n * cell_size / 2;
+
+		// Create a gently sloping terrain
+		VertexList vertices;
+		vertices.resize((n + 1) * (n + 1));
+		for (int x = 0; x <= n; ++x)
+			for (int z = 0; z <= n; ++z)
+			{
+				float height = Sin(float(x) * 20.0f / n) * Cos(float(z) * 20.0f / n);
+				vertices[z * (n + 1) + x] = Float3(cell_size * x - center, max_height * height, cell_size * z - center);
+			}
+		IndexedTriangleList indices;
+		for (int x = 0; x < n; ++x)
+			for (int z = 0; z < n; ++z)
+			{
+				uint32 start = (n + 1) * z + x;
+				indices.push_back(IndexedTriangle(start, start + n + 1, start + 1));
+				indices.push_back(IndexedTriangle(start + 1, start + n + 1, start + n + 2));
+			}
+		mTerrain = MeshShapeSettings(vertices, indices).Create().Get();
+
+		// Shapes for the rubble, the boxes and the characters
+		mRubble = new BoxShape(Vec3(0.5f, 0.2f, 0.5f));
+		mBox = new BoxShape(Vec3::sReplicate(0.25f));
+		mCharacterShape = RotatedTranslatedShapeSettings(Vec3(0, 0.9f, 0), Quat::sIdentity(), new CapsuleShape(0.6f, 0.3f)).Create().Get();
+
+		return true;
+	}
+
+	virtual void			StartTest(PhysicsSystem &inPhysicsSystem, EMotionQuality inMotionQuality) override
+	{
+		BodyInterface &bi = inPhysicsSystem.GetBodyInterface();
+
+		// Create the terrain
+		bi.CreateAndAddBody(BodyCreationSettings(mTerrain, RVec3::sZero(), Quat::sIdentity(), EMotionType::Static, Layers::NON_MOVING), EActivation::DontActivate);
+
+		// Scatter static rubble and dynamic boxes over the terrain
+		for (int x = 0; x < 40; ++x)
+			for (int z = 0; z < 40; ++z)
+			{
+				bi.CreateAndAddBody(BodyCreationSettings(mRubble, RVec3(Real(5.0f * x - 97.5f), Real(0.5f), Real(5.0f * z - 97.5f)), Quat::sRotation(Vec3::sAxisY(), 0.7f * (x + 40 * z)), EMotionType::Static, Layers::NON_MOVING), EActivation::DontActivate);
+
+				if ((x + z) % 4 == 0)
+				{
+					BodyCreationSettings box_settings(mBox, RVec3(Real(5.0f * x - 95.0f), Real(1.5f), Real(5.0f * z - 95.0f)), Quat::sIdentity(), EMotionType::Dynamic, Layers::MOVING);
+					box_settings.mMotionQuality = inMotionQuality;
+					bi.CreateAndAddBody(box_settings, EActivation::Activate);
+				}
+			}
+
+		// Create the characters
+		CharacterVirtualSettings settings;
+		settings.mShape = mCharacterShape;
+		settings.mSupportingVolume = Plane(Vec3::sAxisY(), -0.6f); // Accept contacts that touch the lower sphere of the capsule
+		settings.mRestingTolerance = mMode == EMode::IdleReuseContacts? 1.0e-3f : 0.0f;
+		for (int x = 0; x < cNumCharactersX; ++x)
+			for (int z = 0; z < cNumCharactersZ; ++z)
+			{
+				Ref<CharacterVirtual> character = new CharacterVirtual(&settings, RVec3(Real(2.0f * x - 99.0f), Real(1.5f), Real(4.0f * z - 98.0f)), Quat::sIdentity(), 0, &inPhysicsSystem);
+				mCharacters.push_back(character);
+				mCharacterPtrs.push_back(character);
+
+				if (mMode == EMode::VsCharacters)
+				{
+					character->SetCharacterVsCharacterGrid(&mGrid);
+					mGrid.Add(character);
+				}
+			}
+
+		mFrame = 0;
+	}
+
+	virtual void			UpdateTest(PhysicsSystem &inPhysicsSystem, JobSystem &inJobSystem) override
+	{
+		const float cDeltaTime = 1.0f / 60.0f;
+		Vec3 gravity = inPhysicsSystem.GetGravity();
+
+		// Walk in circles, each character with a different phase
+		float time = cDeltaTime * mFrame++;
+		for (uint i = 0; i < mCharacters.size(); ++i)
+		{
+			CharacterVirtual *character = mCharacters[i];
+			float angle = 0.5f * time + 0.1f * i;
+			bool idle = mMode == EMode::Idle || mMode == EMode::IdleReuseContacts;
+			Vec3 velocity = idle? Vec3::sZero() : 2.0f * Vec3(Sin(angle), 0, Cos(angle));
+			if (character->GetGroundState() != CharacterBase::EGroundState::OnGround)
+				velocity += Vec3(0, character->GetLinearVelocity().GetY(), 0);
+			character->SetLinearVelocity(velocity + cDeltaTime * gravity);
+		}
+
+		// Take a snapshot of the characters so they can collide with each other
+		if (mMode == EMode::VsCharacters)
+			mGrid.Update();
+
+		// Update the characters
+		DefaultBroadPhaseLayerFilter broad_phase_layer_filter = inPhysicsSystem.GetDefaultBroadPhaseLayerFilter(Layers::MOVING);
+		DefaultObjectLayerFilter object_layer_filter = inPhysicsSystem.GetDefaultLayerFilter(Layers::MOVING);
+		CharacterVirtual::ExtendedUpdateSettings update_settings;
+		if (mMode == EMode::Batched || mMode == EMode::VsCharacters)
+			mBatchUpdater.ExtendedUpdate(mCharacterPtrs.data(), (uint)mCharacterPtrs.size(), cDeltaTime, gravity, update_settings, broad_phase_layer_filter, object_layer_filter, { }, { }, inJobSystem);
+		else
+			for (CharacterVirtual *character : mCharacters)
+				character->ExtendedUpdate(cDeltaTime, gravity, update_settings, broad_phase_layer_filter, object_layer_filter, { }, { }, mTempAllocator);
+	}
+
+	virtual void			StopTest([[maybe_unused]] PhysicsSystem &inPhysicsSystem) override
+	{
+		for (CharacterVirtual *character : mCharacterPtrs)
+			if (character->GetCharacterVsCharacterGrid() != nullptr)
+				mGrid.Remove(character);
+		mCharacters.clear();
+		mCharacterPtrs.clear();
+	}
+
+private:
+	static constexpr int	cNumCharactersX = 100;
+	static constexpr int	cNumCharactersZ = 50;
+
+	EMode					mMode;
+	RefConst<Shape>			mTerrain;
+	RefConst<Shape>			mRubble;
+	RefConst<Shape>			mBox;
+	RefConst<Shape>			mCharacterShape;
+	Array<Ref<CharacterVirtual>> mCharacters;
+	Array<CharacterVirtual *> mCharacterPtrs;
+	uint					mFrame = 0;
+	TempAllocatorImpl		mTempAllocator { 1024 * 1024 };
+	CharacterVirtualBatchUpdater mBatchUpdater { 16, 1024 * 1024 };
+	CharacterVsCharacterGrid mGrid;
+};
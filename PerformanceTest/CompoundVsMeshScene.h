@@ -0,0 +1,85 @@
+// Jolt Physics Library (https://github.com/jrouwe/JoltPhysics)
+// SPDX-FileCopyrightText: 2024 Jorrit Rouwe
+// SPDX-License-Identifier: MIT
+
+#pragma once
+
+// Jolt includes
+#include <Jolt/Physics/Collision/Shape/BoxShape.h>
+#include <Jolt/Physics/Collision/Shape/MeshShape.h>
+#include <Jolt/Physics/Collision/Shape/StaticCompoundShape.h>
+#include <Jolt/Physics/Body/BodyCreationSettings.h>
+
+// Local includes
+#include "PerformanceTestScene.h"
+#include "Layers.h"
+
+// A small number of large compound shapes on a dense mesh, to measure how well the narrow phase of a few expensive body pairs is spread over multiple threads
+class CompoundVsMeshScene : public PerformanceTestScene
+{
+public:
+	virtual const char *	GetName() const override
+	{
+		return "CompoundVsMesh";
+	}
+
+	virtual bool			Load() override
+	{
+		const int n = 80;
+		const float cell_size = 0.5f;
+		const float max_height = 0.5f;
+		float center = n * cell_size / 2;
+
+		// Create vertices
+		VertexList vertices;
+		vertices.resize((n + 1) * (n + 1));
+		for (int x = 0; x <= n; ++x)
+			for (int z = 0; z <= n; ++z)
+			{
+				float height = Sin(float(x) * 10.0f / n) * Cos(float(z) * 10.0f / n);
+				vertices[z * (n + 1) + x] = Float3(cell_size * x - center, max_height * height, cell_size * z - center);
+			}
+
+		// Create regular grid of triangles
+		IndexedTriangleList indices;
+		for (int x = 0; x < n; ++x)
+			for (int z = 0; z < n; ++z)
+			{
+				uint32 start = (n + 1) * z + x;
+				indices.push_back(IndexedTriangle(start, start + n + 1, start + 1));
+				indices.push_back(IndexedTriangle(start + 1, start + n + 1, start + n + 2));
+			}
+		mMesh = MeshShapeSettings(vertices, indices).Create().Get();
+
+		// Create a plate made out of 8x8 boxes
+		StaticCompoundShapeSettings plate;
+		for (int x = 0; x < 8; ++x)
+			for (int z = 0; z < 8; ++z)
+				plate.AddShape(Vec3(0.5f * x - 1.75f, 0, 0.5f * z - 1.75f), Quat::sIdentity(), new BoxShapeSettings(Vec3(0.25f, 0.1f, 0.25f)));
+		mCompound = plate.Create().Get();
+
+		return true;
+	}
+
+	virtual void			StartTest(PhysicsSystem &inPhysicsSystem, EMotionQuality inMotionQuality) override
+	{
+		BodyInterface &bi = inPhysicsSystem.GetBodyInterface();
+
+		// Create the terrain
+		bi.CreateAndAddBody(BodyCreationSettings(mMesh, RVec3::sZero(), Quat::sIdentity(), EMotionType::Static, Layers::NON_MOVING), EActivation::DontActivate);
+
+		// Drop the compound shapes
+		for (int x = 0; x < 4; ++x)
+			for (int z = 0; z < 4; ++z)
+			{
+				BodyCreationSettings settings(mCompound, RVec3(Real(8.0f * x - 12.0f), Real(2.0f), Real(8.0f * z - 12.0f)), Quat::sRotation(Vec3::sAxisY(), 0.3f * (x + 4 * z)), EMotionType::Dynamic, Layers::MOVING);
+				settings.mMotionQuality = inMotionQuality;
+				settings.mFriction = 0.5f;
+				bi.CreateAndAddBody(settings, EActivation::Activate);
+			}
+	}
+
+private:
+	RefConst<Shape>			mMesh;
+	RefConst<Shape>			mCompound;
+};
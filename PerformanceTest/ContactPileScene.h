@@ -0,0 +1,116 @@
+// Jolt Physics Library (https://github.com/jrouwe/JoltPhysics)
+// SPDX-FileCopyrightText: 2024 Jorrit Rouwe
+// SPDX-License-Identifier: MIT
+
+#pragma once
+
+// Jolt includes
+#include <Jolt/Physics/Collision/Shape/BoxShape.h>
+#include <Jolt/Physics/Collision/ContactListener.h>
+#include <Jolt/Physics/Body/BodyCreationSettings.h>
+
+// Local includes
+#include "PerformanceTestScene.h"
+#include "Layers.h"
+
+// A grid of 110 x 110 boxes resting on the floor (around 48K contact points) with a contact listener installed, to measure the cost of contact callbacks.
+// The boxes don't touch each other and never fall asleep, so every step the contacts are reused from the contact cache and reporting them is a large part of the step.
+// When inReportContacts is false, the bodies are created with BodyCreationSettings::mReportContacts = false so that the callbacks are skipped.
+class ContactPileScene : public PerformanceTestScene
+{
+public:
+							ContactPileScene(bool inReportContacts) : mReportContacts(inReportContacts) { }
+
+	virtual const char *	GetName() const override
+	{
+		return mReportContacts? "ContactPile" : "ContactPileNoReport";
+	}
+
+	virtual uint			GetMaxBodies() const override
+	{
+		return 16384;
+	}
+
+	virtual uint			GetMaxContactConstraints() const override
+	{
+		return 16384;
+	}
+
+	virtual void			StartTest(PhysicsSystem &inPhysicsSystem, EMotionQuality inMotionQuality) override
+	{
+		BodyInterface &bi = inPhysicsSystem.GetBodyInterface();
+
+		// Install the contact listener
+		mListener.mNumContactPoints = 0;
+		mListener.mNumImpacts = 0;
+		inPhysicsSystem.SetContactListener(&mListener);
+
+		const int cGridSize = 110;
+		const float cHalfBoxSize = 0.5f;
+		const float cSpacing = 1.5f;
+		const float cHalfGridExtent = 0.5f * cSpacing * cGridSize;
+
+		// Floor
+		BodyCreationSettings floor_settings(new BoxShape(Vec3(cHalfGridExtent + 1.0f, 1.0f, cHalfGridExtent + 1.0f), 0.0f), RVec3(Vec3(0.0f, -1.0f, 0.0f)), Quat::sIdentity(), EMotionType::Static, Layers::NON_MOVING);
+		floor_settings.mReportContacts = mReportContacts;
+		bi.CreateAndAddBody(floor_settings, EActivation::DontActivate);
+
+		RefConst<Shape> box_shape = new BoxShape(Vec3::sReplicate(cHalfBoxSize), 0.0f); // No convex radius so that every box has 4 contact points with the floor
+
+		// Boxes that are spaced apart so that every box only touches the floor
+		for (int x = 0; x < cGridSize; ++x)
+			for (int z = 0; z < cGridSize; ++z)
+			{
+				RVec3 position(Real(-cHalfGridExtent + cSpacing * (x + 0.5f)), Real(cHalfBoxSize), Real(-cHalfGridExtent + cSpacing * (z + 0.5f)));
+				BodyCreationSettings settings(box_shape, position, Quat::sIdentity(), EMotionType::Dynamic, Layers::MOVING);
+				settings.mMotionQuality = inMotionQuality;
+				settings.mAllowSleeping = false; // No sleeping to keep generating contacts
+				settings.mReportContacts = mReportContacts;
+				bi.CreateAndAddBody(settings, EActivation::Activate);
+			}
+	}
+
+	virtual void			StopTest(PhysicsSystem &inPhysicsSystem) override
+	{
+		inPhysicsSystem.SetContactListener(nullptr);
+	}
+
+private:
+	// Listener that does the kind of work a game would do per contact point, e.g. to trigger impact sounds
+	class Listener : public ContactListener
+	{
+	public:
+		virtual void		OnContactAdded(const Body &inBody1, const Body &inBody2, const ContactManifold &inManifold, ContactSettings &ioSettings) override
+		{
+			ProcessContact(inBody1, inBody2, inManifold);
+		}
+
+		virtual void		OnContactPersisted(const Body &inBody1, const Body &inBody2, const ContactManifold &inManifold, ContactSettings &ioSettings) override
+		{
+			ProcessContact(inBody1, inBody2, inManifold);
+		}
+
+		atomic<uint64>		mNumContactPoints { 0 };
+		atomic<uint64>		mNumImpacts { 0 };
+
+	private:
+		void				ProcessContact(const Body &inBody1, const Body &inBody2, const ContactManifold &inManifold)
+		{
+			// Determine the highest approach speed over all contact points
+			float max_impact_speed = 0.0f;
+			for (uint i = 0; i < inManifold.mRelativeContactPointsOn1.size(); ++i)
+			{
+				RVec3 point = inManifold.GetWorldSpaceContactPointOn1(i);
+				Vec3 relative_velocity = inBody1.GetPointVelocity(point) - inBody2.GetPointVelocity(point);
+				max_impact_speed = max(max_impact_speed, relative_velocity.Dot(inManifold.mWorldSpaceNormal));
+			}
+
+			mNumContactPoints.fetch_add(inManifold.mRelativeContactPointsOn1.size(), memory_order_relaxed);
+			if (max_impact_speed > 1.0f)
+				mNumImpacts.fetch_add(1, memory_order_relaxed);
+		}
+	};
+
+	bool					mReportContacts;
+	Listener				mListener;
+};
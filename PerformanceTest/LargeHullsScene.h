@@ -0,0 +1,81 @@
+// Jolt Physics Library (https://github.com/jrouwe/JoltPhysics)
+// SPDX-FileCopyrightText: 2024 Jorrit Rouwe
+// SPDX-License-Identifier: MIT
+
+#pragma once
+
+// Jolt includes
+#include <Jolt/Physics/Collision/Shape/BoxShape.h>
+#include <Jolt/Physics/Collision/Shape/ConvexHullShape.h>
+#include <Jolt/Physics/Body/BodyCreationSettings.h>
+
+// Local includes
+#include "PerformanceTestScene.h"
+#include "Layers.h"
+
+// A pile of convex hulls with a high number of vertices (64 - 256) in a pit, to measure the cost of the support function of large hulls
+class LargeHullsScene : public PerformanceTestScene
+{
+public:
+	virtual const char *	GetName() const override
+	{
+		return "LargeHulls";
+	}
+
+	virtual bool			Load() override
+	{
+		// Create ellipsoids with points distributed evenly over the surface (Fibonacci sphere), this doesn't use a random generator so the shapes are the same on all platforms
+		const int cNumPoints[] = { 64, 128, 200, 256 };
+		const Vec3 cRadius[] = { Vec3(1.0f, 1.0f, 1.0f), Vec3(1.2f, 0.8f, 1.0f), Vec3(1.4f, 0.7f, 0.9f), Vec3(1.0f, 0.6f, 1.3f) };
+		const float cGoldenAngle = JPH_PI * (3.0f - sqrt(5.0f));
+		for (int s = 0; s < (int)std::size(cNumPoints); ++s)
+		{
+			Array<Vec3> points;
+			int num_points = cNumPoints[s];
+			for (int i = 0; i < num_points; ++i)
+			{
+				float y = 1.0f - 2.0f * (i + 0.5f) / num_points;
+				float r = sqrt(1.0f - y * y);
+				float angle = cGoldenAngle * i;
+				points.push_back(cRadius[s] * Vec3(r * Cos(angle), y, r * Sin(angle)));
+			}
+			mShapes.push_back(ConvexHullShapeSettings(points).Create().Get());
+		}
+
+		return true;
+	}
+
+	virtual void			StartTest(PhysicsSystem &inPhysicsSystem, EMotionQuality inMotionQuality) override
+	{
+		BodyInterface &bi = inPhysicsSystem.GetBodyInterface();
+
+		// Floor and walls of the pit
+		const float cPitSize = 12.0f;
+		const float cWallHeight = 10.0f;
+		bi.CreateAndAddBody(BodyCreationSettings(new BoxShape(Vec3(cPitSize + 1.0f, 1.0f, cPitSize + 1.0f), 0.0f), RVec3(0, -1, 0), Quat::sIdentity(), EMotionType::Static, Layers::NON_MOVING), EActivation::DontActivate);
+		RefConst<Shape> wall_shape = new BoxShape(Vec3(cPitSize + 1.0f, cWallHeight, 1.0f), 0.0f);
+		for (int i = 0; i < 4; ++i)
+		{
+			Quat rotation = Quat::sRotation(Vec3::sAxisY(), 0.5f * JPH_PI * i);
+			bi.CreateAndAddBody(BodyCreationSettings(wall_shape, RVec3(rotation * Vec3(0, cWallHeight, cPitSize)), rotation, EMotionType::Static, Layers::NON_MOVING), EActivation::DontActivate);
+		}
+
+		// Drop the hulls in the pit
+		const int cNumPerAxis = 10;
+		const int cNumLayers = 4;
+		for (int y = 0; y < cNumLayers; ++y)
+			for (int x = 0; x < cNumPerAxis; ++x)
+				for (int z = 0; z < cNumPerAxis; ++z)
+				{
+					RVec3 position(Real(-cPitSize + 2.4f * (x + 0.5f) + (y & 1) * 0.3f), Real(2.0f + 3.0f * y), Real(-cPitSize + 2.4f * (z + 0.5f)));
+					Quat rotation = Quat::sRotation(Vec3(1, 2, 3).Normalized(), 0.37f * (x + cNumPerAxis * (z + cNumPerAxis * y)));
+					BodyCreationSettings settings(mShapes[(x + y + z) % mShapes.size()], position, rotation, EMotionType::Dynamic, Layers::MOVING);
+					settings.mMotionQuality = inMotionQuality;
+					settings.mFriction = 0.5f;
+					bi.CreateAndAddBody(settings, EActivation::Activate);
+				}
+	}
+
+private:
+	Array<Ref<Shape>>		mShapes;
+};
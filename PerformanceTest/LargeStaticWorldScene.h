@@ -0,0 +1,83 @@
+// Jolt Physics Library (https://github.com/jrouwe/JoltPhysics)
+// SPDX-FileCopyrightText: 2024 Jorrit Rouwe
+// SPDX-License-Identifier: MIT
+
+#pragma once
+
+// Jolt includes
+#include <Jolt/Physics/Collision/Shape/BoxShape.h>
+#include <Jolt/Physics/Collision/Shape/SphereShape.h>
+#include <Jolt/Physics/Body/BodyCreationSettings.h>
+
+// Local includes
+#include "PerformanceTestScene.h"
+#include "Layers.h"
+
+// A city of static buildings with balls bouncing through the streets, to measure the cost of a large broadphase that mostly contains static bodies
+class LargeStaticWorldScene : public PerformanceTestScene
+{
+public:
+	virtual const char *	GetName() const override
+	{
+		return "LargeStaticWorld";
+	}
+
+	virtual uint			GetMaxBodies() const override
+	{
+		return cNumBuildingsPerAxis * cNumBuildingsPerAxis + cNumBalls + 1;
+	}
+
+	virtual void			StartTest(PhysicsSystem &inPhysicsSystem, EMotionQuality inMotionQuality) override
+	{
+		BodyInterface &bi = inPhysicsSystem.GetBodyInterface();
+
+		// Floor
+		const float cHalfWorldSize = 0.5f * cNumBuildingsPerAxis * cBlockSize;
+		BodyCreationSettings floor(new BoxShape(Vec3(cHalfWorldSize, 1.0f, cHalfWorldSize)), RVec3(0, -1, 0), Quat::sIdentity(), EMotionType::Static, Layers::NON_MOVING);
+		floor.mFriction = 0.0f;
+		bi.CreateAndAddBody(floor, EActivation::DontActivate);
+
+		// Buildings of random sizes, leaving streets in between, added in one batch
+		default_random_engine random;
+		uniform_real_distribution<float> width_range(2.0f, 0.5f * (cBlockSize - cStreetWidth));
+		uniform_real_distribution<float> height_range(5.0f, 50.0f);
+		BodyIDVector buildings;
+		buildings.reserve(cNumBuildingsPerAxis * cNumBuildingsPerAxis);
+		for (int x = 0; x < cNumBuildingsPerAxis; ++x)
+			for (int z = 0; z < cNumBuildingsPerAxis; ++z)
+			{
+				Vec3 half_extent(width_range(random), height_range(random), width_range(random));
+				RVec3 position(cBlockSize * (x + 0.5f) - cHalfWorldSize, half_extent.GetY(), cBlockSize * (z + 0.5f) - cHalfWorldSize);
+				BodyCreationSettings settings(new BoxShape(half_extent), position, Quat::sIdentity(), EMotionType::Static, Layers::NON_MOVING);
+				settings.mRestitution = 0.8f;
+				buildings.push_back(bi.CreateBody(settings)->GetID());
+			}
+		BodyInterface::AddState add_state = bi.AddBodiesPrepare(buildings.data(), (int)buildings.size());
+		bi.AddBodiesFinalize(buildings.data(), (int)buildings.size(), add_state, EActivation::DontActivate);
+
+		// Balls that keep bouncing through the streets
+		RefConst<Shape> ball_shape = new SphereShape(0.5f);
+		uniform_int_distribution<int> street_range(0, cNumBuildingsPerAxis - 1);
+		uniform_real_distribution<float> offset_range(-0.5f * cStreetWidth + 1.0f, 0.5f * cStreetWidth - 1.0f);
+		uniform_real_distribution<float> speed_range(-cMaxBallSpeed, cMaxBallSpeed);
+		for (int i = 0; i < cNumBalls; ++i)
+		{
+			// Place the ball on a street crossing
+			RVec3 position(cBlockSize * street_range(random) - cHalfWorldSize + offset_range(random), 0.5f, cBlockSize * street_range(random) - cHalfWorldSize + offset_range(random));
+			BodyCreationSettings settings(ball_shape, position, Quat::sIdentity(), EMotionType::Dynamic, Layers::MOVING);
+			settings.mMotionQuality = inMotionQuality;
+			settings.mRestitution = 0.8f;
+			settings.mFriction = 0.0f;
+			settings.mAllowSleeping = false;
+			settings.mLinearVelocity = Vec3(speed_range(random), 0, speed_range(random));
+			bi.CreateAndAddBody(settings, EActivation::Activate);
+		}
+	}
+
+private:
+	static constexpr int	cNumBuildingsPerAxis = 100;
+	static constexpr float	cBlockSize = 20.0f;
+	static constexpr float	cStreetWidth = 8.0f;
+	static constexpr int	cNumBalls = 2000;
+	static constexpr float	cMaxBallSpeed = 10.0f;
+};
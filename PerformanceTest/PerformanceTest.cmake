@@ -7,8 +7,20 @@ set(PERFORMANCE_TEST_SRC_FILES
 	${PERFORMANCE_TEST_ROOT}/PerformanceTest.cpp
 	${PERFORMANCE_TEST_ROOT}/PerformanceTest.cmake
 	${PERFORMANCE_TEST_ROOT}/PerformanceTestScene.h
+	${PERFORMANCE_TEST_ROOT}/PlanarMoversScene.h
+	${PERFORMANCE_TEST_ROOT}/ProjectileSwarmScene.h
 	${PERFORMANCE_TEST_ROOT}/RagdollScene.h
+	${PERFORMANCE_TEST_ROOT}/AnimatedRagdollsScene.h
+	${PERFORMANCE_TEST_ROOT}/StreamingScene.h
+	${PERFORMANCE_TEST_ROOT}/ContactPileScene.h
 	${PERFORMANCE_TEST_ROOT}/ConvexVsMeshScene.h
+	${PERFORMANCE_TEST_ROOT}/LargeHullsScene.h
+	${PERFORMANCE_TEST_ROOT}/CompoundVsMeshScene.h
+	${PERFORMANCE_TEST_ROOT}/VehiclesScene.h
+	${PERFORMANCE_TEST_ROOT}/CharactersScene.h
+	${PERFORMANCE_TEST_ROOT}/LargeStaticWorldScene.h
+	${PERFORMANCE_TEST_ROOT}/RaycastStormScene.h
+	${PERFORMANCE_TEST_ROOT}/SoftBodiesScene.h
 	${PERFORMANCE_TEST_ROOT}/Layers.h
 )
 
@@ -9,6 +9,8 @@
 #include <Jolt/Core/Factory.h>
 #include <Jolt/Core/TempAllocator.h>
 #include <Jolt/Core/JobSystemThreadPool.h>
+#include <Jolt/Core/QuickSort.h>
+#include <Jolt/Core/StringTools.h>
 #include <Jolt/Physics/PhysicsSettings.h>
 #include <Jolt/Physics/PhysicsSystem.h>
 #include <Jolt/Physics/Collision/NarrowPhaseStats.h>
@@ -30,6 +32,9 @@ JPH_SUPPRESS_WARNINGS_STD_BEGIN
 #include <chrono>
 #include <memory>
 #include <cstdarg>
+#include <random>
+#include <fstream>
+#include <algorithm>
 JPH_SUPPRESS_WARNINGS_STD_END
 
 using namespace JPH;
@@ -41,18 +46,239 @@ JPH_SUPPRESS_WARNINGS
 
 // Local includes
 #include "RagdollScene.h"
+#include "AnimatedRagdollsScene.h"
 #include "ConvexVsMeshScene.h"
 #include "PyramidScene.h"
+#include "ProjectileSwarmScene.h"
+#include "StreamingScene.h"
+#include "PlanarMoversScene.h"
+#include "ContactPileScene.h"
+#include "LargeHullsScene.h"
+#include "CompoundVsMeshScene.h"
+#include "VehiclesScene.h"
+#include "CharactersScene.h"
+#include "LargeStaticWorldScene.h"
+#include "RaycastStormScene.h"
+#include "SoftBodiesScene.h"
 
 // Time step for physics
 constexpr float cDeltaTime = 1.0f / 60.0f;
 
+// Number of frames to keep in the profiler frame history when writing traces
+constexpr uint cTraceFrameHistory = 10;
+
+// A scene that can be selected on the command line
+struct SceneEntry
+{
+	const char *			mName;
+	PerformanceTestScene *	(*mCreate)();
+};
+
+// All scenes that can be selected with -s=<scene>, the first one is the default scene
+static const SceneEntry sScenes[] =
+{
+#ifdef JPH_OBJECT_STREAM
+	{ "Ragdoll",						[]() -> PerformanceTestScene * { return new RagdollScene(4, 10, 0.6f); } },
+	{ "RagdollSinglePile",				[]() -> PerformanceTestScene * { return new RagdollScene(1, 160, 0.4f); } },
+	{ "RagdollLowLOD",					[]() -> PerformanceTestScene * { return new RagdollScene(4, 10, 0.6f, true); } },
+	{ "AnimatedRagdolls",				[]() -> PerformanceTestScene * { return new AnimatedRagdollsScene(false); } },
+	{ "AnimatedRagdollsBatched",		[]() -> PerformanceTestScene * { return new AnimatedRagdollsScene(true); } },
+#else
+	{ "Ragdoll",						[]() -> PerformanceTestScene * { return new ConvexVsMeshScene; } }, // Ragdoll needs the object stream to load, fall back to another scene
+#endif // JPH_OBJECT_STREAM
+	{ "ConvexVsMesh",					[]() -> PerformanceTestScene * { return new ConvexVsMeshScene; } },
+	{ "Pyramid",						[]() -> PerformanceTestScene * { return new PyramidScene; } },
+	{ "ProjectileSwarm",				[]() -> PerformanceTestScene * { return new ProjectileSwarmScene; } },
+	{ "Streaming",						[]() -> PerformanceTestScene * { return new StreamingScene; } },
+	{ "PlanarMovers",					[]() -> PerformanceTestScene * { return new PlanarMoversScene; } },
+	{ "ContactPile",					[]() -> PerformanceTestScene * { return new ContactPileScene(true); } },
+	{ "ContactPileNoReport",			[]() -> PerformanceTestScene * { return new ContactPileScene(false); } },
+	{ "LargeHulls",						[]() -> PerformanceTestScene * { return new LargeHullsScene; } },
+	{ "CompoundVsMesh",					[]() -> PerformanceTestScene * { return new CompoundVsMeshScene; } },
+	{ "Vehicles",						[]() -> PerformanceTestScene * { return new VehiclesScene(false, false); } },
+	{ "VehiclesBatchedWheels",			[]() -> PerformanceTestScene * { return new VehiclesScene(true, false); } },
+	{ "VehiclesLowLOD",					[]() -> PerformanceTestScene * { return new VehiclesScene(false, true); } },
+	{ "Characters",						[]() -> PerformanceTestScene * { return new CharactersScene(CharactersScene::EMode::Serial); } },
+	{ "CharactersBatched",				[]() -> PerformanceTestScene * { return new CharactersScene(CharactersScene::EMode::Batched); } },
+	{ "CharactersIdle",					[]() -> PerformanceTestScene * { return new CharactersScene(CharactersScene::EMode::Idle); } },
+	{ "CharactersIdleReuseContacts",	[]() -> PerformanceTestScene * { return new CharactersScene(CharactersScene::EMode::IdleReuseContacts); } },
+	{ "CharactersVsCharacters",			[]() -> PerformanceTestScene * { return new CharactersScene(CharactersScene::EMode::VsCharacters); } },
+	{ "LargeStaticWorld",				[]() -> PerformanceTestScene * { return new LargeStaticWorldScene; } },
+	{ "RaycastStorm",					[]() -> PerformanceTestScene * { return new RaycastStormScene; } },
+	{ "SoftBodies",						[]() -> PerformanceTestScene * { return new SoftBodiesScene; } },
+};
+
+// Parse 'all' or a comma separated list of scene names
+static bool sParseScenes(const char *inNames, Array<const SceneEntry *> &outScenes)
+{
+	outScenes.clear();
+
+	if (strcmp(inNames, "all") == 0)
+	{
+		for (const SceneEntry &entry : sScenes)
+			outScenes.push_back(&entry);
+		return true;
+	}
+
+	Array<String> names;
+	StringToVector(inNames, names);
+	for (const String &name : names)
+	{
+		const SceneEntry *entry = find_if(begin(sScenes), end(sScenes), [&name](const SceneEntry &inEntry) { return name == inEntry.mName; });
+		if (entry == end(sScenes))
+			return false;
+		outScenes.push_back(entry);
+	}
+	return !outScenes.empty();
+}
+
+// Result of running a scene with a particular motion quality and thread count
+struct TestResult
+{
+	String					mScene;
+	String					mMotionQuality;
+	uint					mNumThreads = 0;
+	uint					mNumSteps = 0;
+	double					mStepsPerSecond = 0.0;
+	double					mMeanStepTimeMs = 0.0;
+	double					mMedianStepTimeMs = 0.0;
+	double					mP90StepTimeMs = 0.0;
+	double					mP99StepTimeMs = 0.0;
+	double					mMaxStepTimeMs = 0.0;
+	String					mHash;
+	double					mPhaseTimeMs[uint(EPhysicsUpdatePhase::Count)] = { }; // Mean CPU time per step spent in each phase of PhysicsSystem::Update (see PhysicsUpdateStats)
+
+	// Check if this result is for the same test as inRHS
+	bool					IsSameTest(const TestResult &inRHS) const		{ return mScene == inRHS.mScene && mMotionQuality == inRHS.mMotionQuality && mNumThreads == inRHS.mNumThreads; }
+};
+
+// Get a percentile from a sorted list of values using the nearest rank method
+static double sPercentile(const Array<double> &inSortedValues, double inFraction)
+{
+	size_t rank = clamp(size_t(ceil(inFraction * inSortedValues.size())), size_t(1), inSortedValues.size());
+	return inSortedValues[rank - 1];
+}
+
+// Write the results as JSON, each result is written on a single line so that sReadJSONResults can read it back without needing a JSON parser
+static bool sWriteJSONResults(const char *inFileName, const Array<TestResult> &inResults)
+{
+	ofstream f(inFileName, ofstream::out | ofstream::trunc);
+	if (!f.is_open())
+		return false;
+
+	f << "{\n\"configuration\": \"" << GetConfigurationString() << "\",\n\"results\": [\n";
+	for (const TestResult &r : inResults)
+	{
+		f << StringFormat(R"({"scene": "%s", "quality": "%s", "threads": %u, "steps": %u, "steps_per_second": %.3f, "mean_ms": %.4f, "p50_ms": %.4f, "p90_ms": %.4f, "p99_ms": %.4f, "max_ms": %.4f, "hash": "%s", "phases_ms": {)",
+			r.mScene.c_str(), r.mMotionQuality.c_str(), r.mNumThreads, r.mNumSteps, r.mStepsPerSecond, r.mMeanStepTimeMs, r.mMedianStepTimeMs, r.mP90StepTimeMs, r.mP99StepTimeMs, r.mMaxStepTimeMs, r.mHash.c_str());
+		for (uint p = 0; p < uint(EPhysicsUpdatePhase::Count); ++p)
+			f << StringFormat(R"(%s"%s": %.4f)", p > 0? ", " : "", PhysicsUpdateStats::sGetPhaseName(EPhysicsUpdatePhase(p)), r.mPhaseTimeMs[p]);
+		f << "}}" << (&r != &inResults.back()? "," : "") << "\n";
+	}
+	f << "]\n}\n";
+
+	return true;
+}
+
+// Get the value of a key from a line written by sWriteJSONResults, returns an empty string if the key was not found
+static String sGetJSONValue(const String &inLine, const char *inKey)
+{
+	String key = String("\"") + inKey + "\": ";
+	size_t start = inLine.find(key);
+	if (start == String::npos)
+		return String();
+	start += key.size();
+
+	// String value
+	if (inLine[start] == '"')
+		return inLine.substr(start + 1, inLine.find('"', start + 1) - start - 1);
+
+	// Number value
+	return inLine.substr(start, inLine.find_first_of(",}", start) - start);
+}
+
+// Read the results from a file written by sWriteJSONResults
+static bool sReadJSONResults(const char *inFileName, Array<TestResult> &outResults)
+{
+	ifstream f(inFileName);
+	if (!f.is_open())
+		return false;
+
+	String line;
+	while (getline(f, line))
+		if (line.find("\"scene\": ") != String::npos)
+		{
+			TestResult r;
+			r.mScene = sGetJSONValue(line, "scene");
+			r.mMotionQuality = sGetJSONValue(line, "quality");
+			r.mNumThreads = uint(atoi(sGetJSONValue(line, "threads").c_str()));
+			r.mNumSteps = uint(atoi(sGetJSONValue(line, "steps").c_str()));
+			r.mStepsPerSecond = atof(sGetJSONValue(line, "steps_per_second").c_str());
+			r.mMeanStepTimeMs = atof(sGetJSONValue(line, "mean_ms").c_str());
+			r.mMedianStepTimeMs = atof(sGetJSONValue(line, "p50_ms").c_str());
+			r.mP90StepTimeMs = atof(sGetJSONValue(line, "p90_ms").c_str());
+			r.mP99StepTimeMs = atof(sGetJSONValue(line, "p99_ms").c_str());
+			r.mMaxStepTimeMs = atof(sGetJSONValue(line, "max_ms").c_str());
+			r.mHash = sGetJSONValue(line, "hash");
+			for (uint p = 0; p < uint(EPhysicsUpdatePhase::Count); ++p)
+				r.mPhaseTimeMs[p] = atof(sGetJSONValue(line, PhysicsUpdateStats::sGetPhaseName(EPhysicsUpdatePhase(p))).c_str());
+			outResults.push_back(r);
+		}
+
+	return true;
+}
+
+// Find the result with the lowest median step time for the same test as inTest (a test can be in the results multiple times when using -repeat)
+static const TestResult *sFindBestResult(const Array<TestResult> &inResults, const TestResult &inTest)
+{
+	const TestResult *best = nullptr;
+	for (const TestResult &r : inResults)
+		if (r.IsSameTest(inTest) && (best == nullptr || r.mMedianStepTimeMs < best->mMedianStepTimeMs))
+			best = &r;
+	return best;
+}
+
+// Compare the median step time of the results against a baseline, returns false if a test got slower by more than inTolerance (a fraction)
+static bool sCompareResults(const Array<TestResult> &inBaseline, const Array<TestResult> &inResults, double inTolerance)
+{
+	bool success = true;
+
+	Trace("Scene, Motion Quality, Thread Count, Baseline Median (ms), Median (ms), Change, Status");
+	for (const TestResult &r : inResults)
+	{
+		// Only report the best result of repeated tests
+		const TestResult *current = sFindBestResult(inResults, r);
+		if (current != &r)
+			continue;
+
+		const TestResult *baseline = sFindBestResult(inBaseline, r);
+		if (baseline == nullptr)
+		{
+			Trace("%s, %s, %u, -, %.4f, -, New", r.mScene.c_str(), r.mMotionQuality.c_str(), r.mNumThreads, r.mMedianStepTimeMs);
+			continue;
+		}
+
+		double change = r.mMedianStepTimeMs / baseline->mMedianStepTimeMs - 1.0;
+		const char *status = "OK";
+		if (change > inTolerance)
+		{
+			status = "Regression";
+			success = false;
+		}
+		else if (change < -inTolerance)
+			status = "Improvement";
+		Trace("%s, %s, %u, %.4f, %.4f, %+.1f%%, %s%s", r.mScene.c_str(), r.mMotionQuality.c_str(), r.mNumThreads, baseline->mMedianStepTimeMs, r.mMedianStepTimeMs, 100.0 * change, status, r.mHash != baseline->mHash? " (hash changed)" : "");
+	}
+
+	return success;
+}
+
 static void TraceImpl(const char *inFMT, ...)
 {
 	// Format the message
 	va_list list;
 	va_start(list, inFMT);
-	char buffer[1024];
+	char buffer[4096];
 	vsnprintf(buffer, sizeof(buffer), inFMT, list);
 	va_end(list);
 
@@ -73,46 +299,36 @@ int main(int argc, char** argv)
 	// Register allocation hook
 	RegisterDefaultAllocator();
 
-	// Helper function that creates the default scene
-#ifdef JPH_OBJECT_STREAM
-	auto create_ragdoll_scene = []{ return unique_ptr<PerformanceTestScene>(new RagdollScene(4, 10, 0.6f)); };
-#else
-	auto create_ragdoll_scene = []{ return unique_ptr<PerformanceTestScene>(new ConvexVsMeshScene); };
-#endif // JPH_OBJECT_STREAM
-
 	// Parse command line parameters
 	int specified_quality = -1;
 	int specified_threads = -1;
 	uint max_iterations = 500;
 	bool disable_sleep = false;
+	bool reorder_contacts = false;
+	bool split_compound = false;
 	bool enable_profiler = false;
+	bool enable_trace = false;
 #ifdef JPH_DEBUG_RENDERER
 	bool enable_debug_renderer = false;
 #endif // JPH_DEBUG_RENDERER
 	bool enable_per_frame_recording = false;
 	bool record_state = false;
 	bool validate_state = false;
-	unique_ptr<PerformanceTestScene> scene;
+	Array<const SceneEntry *> scenes;
 	const char *validate_hash = nullptr;
+	const char *json_file = nullptr;
+	const char *compare_file = nullptr;
+	double tolerance = 0.05;
 	int repeat = 1;
+	EBroadPhaseType broad_phase_type = EBroadPhaseType::QuadTree;
 	for (int argidx = 1; argidx < argc; ++argidx)
 	{
 		const char *arg = argv[argidx];
 
 		if (strncmp(arg, "-s=", 3) == 0)
 		{
-			// Parse scene
-			if (strcmp(arg + 3, "Ragdoll") == 0)
-				scene = create_ragdoll_scene();
-#ifdef JPH_OBJECT_STREAM
-			else if (strcmp(arg + 3, "RagdollSinglePile") == 0)
-				scene = unique_ptr<PerformanceTestScene>(new RagdollScene(1, 160, 0.4f));
-#endif // JPH_OBJECT_STREAM
-			else if (strcmp(arg + 3, "ConvexVsMesh") == 0)
-				scene = unique_ptr<PerformanceTestScene>(new ConvexVsMeshScene);
-			else if (strcmp(arg + 3, "Pyramid") == 0)
-				scene = unique_ptr<PerformanceTestScene>(new PyramidScene);
-			else
+			// Parse scenes
+			if (!sParseScenes(arg + 3, scenes))
 			{
 				Trace("Invalid scene");
 				return 1;
@@ -136,6 +352,21 @@ int main(int argc, char** argv)
 				return 1;
 			}
 		}
+		else if (strncmp(arg, "-bp=", 4) == 0)
+		{
+			// Parse broadphase type
+			if (strcmp(arg + 4, "QuadTree") == 0)
+				broad_phase_type = EBroadPhaseType::QuadTree;
+			else if (strcmp(arg + 4, "SAP") == 0)
+				broad_phase_type = EBroadPhaseType::SweepAndPrune;
+			else if (strcmp(arg + 4, "BruteForce") == 0)
+				broad_phase_type = EBroadPhaseType::BruteForce;
+			else
+			{
+				Trace("Invalid broadphase");
+				return 1;
+			}
+		}
 		else if (strncmp(arg, "-t=max", 6) == 0)
 		{
 			// Default to number of threads on the system
@@ -150,10 +381,22 @@ int main(int argc, char** argv)
 		{
 			disable_sleep = true;
 		}
+		else if (strcmp(arg, "-reorder_contacts") == 0)
+		{
+			reorder_contacts = true;
+		}
+		else if (strcmp(arg, "-split_compound") == 0)
+		{
+			split_compound = true;
+		}
 		else if (strcmp(arg, "-p") == 0)
 		{
 			enable_profiler = true;
 		}
+		else if (strcmp(arg, "-trace") == 0)
+		{
+			enable_trace = true;
+		}
 	#ifdef JPH_DEBUG_RENDERER
 		else if (strcmp(arg, "-r") == 0)
 		{
@@ -181,23 +424,49 @@ int main(int argc, char** argv)
 			// Parse repeat count
 			repeat = atoi(arg + 8);
 		}
+		else if (strncmp(arg, "-json=", 6) == 0)
+		{
+			json_file = arg + 6;
+		}
+		else if (strncmp(arg, "-compare=", 9) == 0)
+		{
+			compare_file = arg + 9;
+		}
+		else if (strncmp(arg, "-tolerance=", 11) == 0)
+		{
+			// Parse tolerance in percent
+			tolerance = 0.01 * atof(arg + 11);
+		}
 		else if (strcmp(arg, "-h") == 0)
 		{
+			// List the scenes
+			String scene_names;
+			for (const SceneEntry &entry : sScenes)
+				scene_names += String(scene_names.empty()? "" : ", ") + entry.mName;
+
 			// Print usage
 			Trace("Usage:\n"
-				  "-s=<scene>: Select scene (Ragdoll, RagdollSinglePile, ConvexVsMesh, Pyramid)\n"
+				  "-s=<scene>: Select scene (%s). Can be a comma separated list or 'all' to run multiple scenes\n"
 				  "-i=<num physics steps>: Number of physics steps to simulate (default 500)\n"
 				  "-q=<quality>: Test only with specified quality (Discrete, LinearCast)\n"
+				  "-bp=<broadphase>: Select broadphase (QuadTree, SAP, BruteForce), default is QuadTree\n"
 				  "-t=<num threads>: Test only with N threads (default is to iterate over 1 .. num hardware threads)\n"
 				  "-t=max: Test with the number of threads available on the system\n"
 				  "-p: Write out profiles\n"
+				  "-trace: Write out a Chrome trace of the frames leading up to the slowest frame\n"
 				  "-r: Record debug renderer output for JoltViewer\n"
 				  "-f: Record per frame timings\n"
 				  "-no_sleep: Disable sleeping\n"
+				  "-reorder_contacts: Store contact constraints in solve order (see PhysicsSettings::mReorderContactConstraints)\n"
+				  "-split_compound: Split the narrow phase of large compound shapes over multiple jobs (see PhysicsSettings::mSplitLargeCompoundCollisions)\n"
 				  "-rs: Record state\n"
 				  "-vs: Validate state\n"
 				  "-validate_hash=<hash>: Validate hash (return 0 if successful, 1 if failed)\n"
-				  "-repeat=<num>: Repeat all tests <num> times");
+				  "-repeat=<num>: Repeat all tests <num> times\n"
+				  "-json=<file>: Write the results including per step time percentiles to a JSON file\n"
+				  "-compare=<file>: Compare the median step times against a JSON file written by -json (return 1 if there are regressions)\n"
+				  "-tolerance=<percent>: Allowed slowdown before -compare reports a regression (default 5). Median step times are noisy for small\n"
+				  "  iteration counts or few threads (e.g. -i=50 -t=2 can show +18%% on an unchanged build), use more iterations, -repeat or a larger tolerance", scene_names.c_str());
 			return 0;
 		}
 	}
@@ -208,21 +477,16 @@ int main(int argc, char** argv)
 	// Register all Jolt physics types
 	RegisterTypes();
 
-	// Create temp allocator
-	TempAllocatorImpl temp_allocator(32 * 1024 * 1024);
+	// Create temp allocator (reordering contacts needs space for a second copy of the contact constraints)
+	TempAllocatorImpl temp_allocator((reorder_contacts? 64 : 32) * 1024 * 1024);
 
-	// Load the scene
-	if (scene == nullptr)
-		scene = create_ragdoll_scene();
-	if (!scene->Load())
-		return 1;
+	// Default to the first scene
+	if (scenes.empty())
+		scenes.push_back(&sScenes[0]);
 
 	// Show used instruction sets
 	Trace(GetConfigurationString());
 
-	// Output scene we're running
-	Trace("Running scene: %s", scene->GetName());
-
 	// Create mapping table from object layer to broadphase layer
 	BPLayerInterfaceImpl broad_phase_layer_interface;
 
@@ -234,207 +498,280 @@ int main(int argc, char** argv)
 
 	// Start profiling this program
 	JPH_PROFILE_START("Main");
+#ifdef JPH_PROFILE_ENABLED
+	if (enable_trace)
+		Profiler::sInstance->SetFrameHistory(cTraceFrameHistory);
+#endif // JPH_PROFILE_ENABLED
 
-	// Trace header
-	Trace("Motion Quality, Thread Count, Steps / Second, Hash");
+	// Collected results of all tests
+	Array<TestResult> results;
 
-	// Repeat test
-	for (int r = 0; r < repeat; ++r)
+	// Iterate scenes
+	for (const SceneEntry *scene_entry : scenes)
 	{
-		// Iterate motion qualities
-		for (uint mq = 0; mq < 2; ++mq)
-		{
-			// Skip quality if another was specified
-			if (specified_quality != -1 && mq != (uint)specified_quality)
-				continue;
-
-			// Determine motion quality
-			EMotionQuality motion_quality = mq == 0? EMotionQuality::Discrete : EMotionQuality::LinearCast;
-			String motion_quality_str = mq == 0? "Discrete" : "LinearCast";
-
-			// Determine which thread counts to test
-			Array<uint> thread_permutations;
-			if (specified_threads > 0)
-				thread_permutations.push_back((uint)specified_threads - 1);
-			else
-				for (uint num_threads = 0; num_threads < thread::hardware_concurrency(); ++num_threads)
-					thread_permutations.push_back(num_threads);
+		// Load the scene
+		unique_ptr<PerformanceTestScene> scene(scene_entry->mCreate());
+		if (!scene->Load())
+			return 1;
+
+		// Output scene we're running
+		Trace("Running scene: %s", scene->GetName());
 
-			// Test thread permutations
-			for (uint num_threads : thread_permutations)
+		// Trace header
+		Trace("Motion Quality, Thread Count, Steps / Second, Hash");
+
+		// Repeat test
+		for (int r = 0; r < repeat; ++r)
+		{
+			// Iterate motion qualities
+			for (uint mq = 0; mq < 2; ++mq)
 			{
-				// Create job system with desired number of threads
-				JobSystemThreadPool job_system(cMaxPhysicsJobs, cMaxPhysicsBarriers, num_threads);
+				// Skip quality if another was specified
+				if (specified_quality != -1 && mq != (uint)specified_quality)
+					continue;
+
+				// Determine motion quality
+				EMotionQuality motion_quality = mq == 0? EMotionQuality::Discrete : EMotionQuality::LinearCast;
+				String motion_quality_str = mq == 0? "Discrete" : "LinearCast";
+
+				// Determine which thread counts to test
+				Array<uint> thread_permutations;
+				if (specified_threads > 0)
+					thread_permutations.push_back((uint)specified_threads - 1);
+				else
+					for (uint num_threads = 0; num_threads < thread::hardware_concurrency(); ++num_threads)
+						thread_permutations.push_back(num_threads);
+
+				// Test thread permutations
+				for (uint num_threads : thread_permutations)
+				{
+					// Create job system with desired number of threads
+					JobSystemThreadPool job_system(cMaxPhysicsJobs, cMaxPhysicsBarriers, num_threads);
 
-				// Create physics system
-				PhysicsSystem physics_system;
-				physics_system.Init(10240, 0, 65536, 20480, broad_phase_layer_interface, object_vs_broadphase_layer_filter, object_vs_object_layer_filter);
+					// Create physics system
+					PhysicsSystem physics_system;
+					physics_system.Init(scene->GetMaxBodies(), 0, 65536, scene->GetMaxContactConstraints(), broad_phase_layer_interface, object_vs_broadphase_layer_filter, object_vs_object_layer_filter, broad_phase_type);
+
+					// Apply physics settings
+					if (reorder_contacts || split_compound)
+					{
+						PhysicsSettings settings = physics_system.GetPhysicsSettings();
+						settings.mReorderContactConstraints = reorder_contacts;
+						settings.mSplitLargeCompoundCollisions = split_compound;
+						physics_system.SetPhysicsSettings(settings);
+					}
 
-				// Start test scene
-				scene->StartTest(physics_system, motion_quality);
+					// Start test scene
+					scene->StartTest(physics_system, motion_quality);
 
-				// Disable sleeping if requested
-				if (disable_sleep)
-				{
-					const BodyLockInterface &bli = physics_system.GetBodyLockInterfaceNoLock();
-					BodyIDVector body_ids;
-					physics_system.GetBodies(body_ids);
-					for (BodyID id : body_ids)
+					// Disable sleeping if requested
+					if (disable_sleep)
 					{
-						BodyLockWrite lock(bli, id);
-						if (lock.Succeeded())
+						const BodyLockInterface &bli = physics_system.GetBodyLockInterfaceNoLock();
+						BodyIDVector body_ids;
+						physics_system.GetBodies(body_ids);
+						for (BodyID id : body_ids)
 						{
-							Body &body = lock.GetBody();
-							if (!body.IsStatic())
-								body.SetAllowSleeping(false);
+							BodyLockWrite lock(bli, id);
+							if (lock.Succeeded())
+							{
+								Body &body = lock.GetBody();
+								if (!body.IsStatic())
+									body.SetAllowSleeping(false);
+							}
 						}
 					}
-				}
 
-				// Optimize the broadphase to prevent an expensive first frame
-				physics_system.OptimizeBroadPhase();
+					// Optimize the broadphase to prevent an expensive first frame
+					physics_system.OptimizeBroadPhase(&job_system);
 
-				// A tag used to identify the test
-				String tag = ToLower(motion_quality_str) + "_th" + ConvertToString(num_threads + 1);
+					// A tag used to identify the test
+					String tag = ToLower(motion_quality_str) + "_th" + ConvertToString(num_threads + 1);
+					if (scenes.size() > 1)
+						tag = ToLower(scene->GetName()) + "_" + tag;
 
-			#ifdef JPH_DEBUG_RENDERER
-				// Open renderer output
-				ofstream renderer_file;
-				if (enable_debug_renderer)
-					renderer_file.open(("performance_test_" + tag + ".jor").c_str(), ofstream::out | ofstream::binary | ofstream::trunc);
-				StreamOutWrapper renderer_stream(renderer_file);
-				DebugRendererRecorder renderer(renderer_stream);
-			#endif // JPH_DEBUG_RENDERER
+				#ifdef JPH_DEBUG_RENDERER
+					// Open renderer output
+					ofstream renderer_file;
+					if (enable_debug_renderer)
+						renderer_file.open(("performance_test_" + tag + ".jor").c_str(), ofstream::out | ofstream::binary | ofstream::trunc);
+					StreamOutWrapper renderer_stream(renderer_file);
+					DebugRendererRecorder renderer(renderer_stream);
+				#endif // JPH_DEBUG_RENDERER
 
-				// Open per frame timing output
-				ofstream per_frame_file;
-				if (enable_per_frame_recording)
-				{
-					per_frame_file.open(("per_frame_" + tag + ".csv").c_str(), ofstream::out | ofstream::trunc);
-					per_frame_file << "Frame, Time (ms)" << endl;
-				}
+					// Open per frame timing output
+					ofstream per_frame_file;
+					if (enable_per_frame_recording)
+					{
+						per_frame_file.open(("per_frame_" + tag + ".csv").c_str(), ofstream::out | ofstream::trunc);
+						per_frame_file << "Frame, Time (ms)" << endl;
+					}
 
-				ofstream record_state_file;
-				ifstream validate_state_file;
-				if (record_state)
-					record_state_file.open(("state_" + ToLower(motion_quality_str) + ".bin").c_str(), ofstream::out | ofstream::binary | ofstream::trunc);
-				else if (validate_state)
-					validate_state_file.open(("state_" + ToLower(motion_quality_str) + ".bin").c_str(), ifstream::in | ifstream::binary);
+					ofstream record_state_file;
+					ifstream validate_state_file;
+					if (record_state)
+						record_state_file.open(("state_" + ToLower(motion_quality_str) + ".bin").c_str(), ofstream::out | ofstream::binary | ofstream::trunc);
+					else if (validate_state)
+						validate_state_file.open(("state_" + ToLower(motion_quality_str) + ".bin").c_str(), ifstream::in | ifstream::binary);
 
-				chrono::nanoseconds total_duration(0);
+					chrono::nanoseconds total_duration(0);
+					Array<double> step_times_ms;
+					step_times_ms.reserve(max_iterations);
+					uint64 phase_time_ns[uint(EPhysicsUpdatePhase::Count)] = { };
+					chrono::nanoseconds slowest_duration(0);
 
-				// Step the world for a fixed amount of iterations
-				for (uint iterations = 0; iterations < max_iterations; ++iterations)
-				{
-					JPH_PROFILE_NEXTFRAME();
-					JPH_DET_LOG("Iteration: " << iterations);
+					// Step the world for a fixed amount of iterations
+					for (uint iterations = 0; iterations < max_iterations; ++iterations)
+					{
+						JPH_PROFILE_NEXTFRAME();
+						JPH_DET_LOG("Iteration: " << iterations);
 
-					// Start measuring
-					chrono::high_resolution_clock::time_point clock_start = chrono::high_resolution_clock::now();
+						// Start measuring
+						chrono::high_resolution_clock::time_point clock_start = chrono::high_resolution_clock::now();
 
-					// Do a physics step
-					physics_system.Update(cDeltaTime, 1, &temp_allocator, &job_system);
+						// Update the scene
+						scene->UpdateTest(physics_system, job_system);
 
-					// Stop measuring
-					chrono::high_resolution_clock::time_point clock_end = chrono::high_resolution_clock::now();
-					chrono::nanoseconds duration = chrono::duration_cast<chrono::nanoseconds>(clock_end - clock_start);
-					total_duration += duration;
+						// Do a physics step
+						physics_system.Update(cDeltaTime, 1, &temp_allocator, &job_system);
 
-				#ifdef JPH_DEBUG_RENDERER
-					if (enable_debug_renderer)
-					{
-						// Draw the state of the world
-						BodyManager::DrawSettings settings;
-						physics_system.DrawBodies(settings, &renderer);
+						// Stop measuring
+						chrono::high_resolution_clock::time_point clock_end = chrono::high_resolution_clock::now();
+						chrono::nanoseconds duration = chrono::duration_cast<chrono::nanoseconds>(clock_end - clock_start);
+						total_duration += duration;
+						step_times_ms.push_back(1.0e-6 * duration.count());
 
-						// Mark end of frame
-						renderer.EndFrame();
-					}
-				#endif // JPH_DEBUG_RENDERER
+						// Accumulate the time spent in the phases of the update
+						const PhysicsUpdateStats &update_stats = physics_system.GetUpdateStats();
+						for (uint p = 0; p < uint(EPhysicsUpdatePhase::Count); ++p)
+							phase_time_ns[p] += update_stats.mPhaseTimeNs[p];
 
-					// Record time taken this iteration
-					if (enable_per_frame_recording)
-						per_frame_file << iterations << ", " << (1.0e-6 * duration.count()) << endl;
+					#ifdef JPH_DEBUG_RENDERER
+						if (enable_debug_renderer)
+						{
+							// Draw the state of the world
+							BodyManager::DrawSettings settings;
+							physics_system.DrawBodies(settings, &renderer);
 
-					// Dump profile information every 100 iterations
-					if (enable_profiler && iterations % 100 == 0)
-					{
-						JPH_PROFILE_DUMP(tag + "_it" + ConvertToString(iterations));
-					}
+							// Mark end of frame
+							renderer.EndFrame();
+						}
+					#endif // JPH_DEBUG_RENDERER
 
-					if (record_state)
-					{
-						// Record state
-						StateRecorderImpl recorder;
-						physics_system.SaveState(recorder);
-
-						// Write to file
-						string data = recorder.GetData();
-						size_t size = data.size();
-						record_state_file.write((char *)&size, sizeof(size));
-						record_state_file.write(data.data(), size);
-					}
-					else if (validate_state)
-					{
-						// Read state
-						size_t size = 0;
-						validate_state_file.read((char *)&size, sizeof(size));
-						string data;
-						data.resize(size);
-						validate_state_file.read(data.data(), size);
-
-						// Copy to validator
-						StateRecorderImpl validator;
-						validator.WriteBytes(data.data(), size);
-
-						// Validate state
-						validator.SetValidating(true);
-						physics_system.RestoreState(validator);
+						// Record time taken this iteration
+						if (enable_per_frame_recording)
+							per_frame_file << iterations << ", " << (1.0e-6 * duration.count()) << endl;
+
+						// Dump profile information every 100 iterations
+						if (enable_profiler && iterations % 100 == 0)
+						{
+							JPH_PROFILE_DUMP(tag + "_it" + ConvertToString(iterations));
+						}
+
+						// Write a trace when we find a new slowest frame, skip the first frames as they're usually slow because the caches are cold
+						if (enable_trace && iterations >= cTraceFrameHistory && duration > slowest_duration)
+						{
+							slowest_duration = duration;
+							JPH_PROFILE_DUMP_CHROME_TRACE(tag + "_slowest");
+						}
+
+						if (record_state)
+						{
+							// Record state
+							StateRecorderImpl recorder;
+							physics_system.SaveState(recorder);
+
+							// Write to file
+							string data = recorder.GetData();
+							size_t size = data.size();
+							record_state_file.write((char *)&size, sizeof(size));
+							record_state_file.write(data.data(), size);
+						}
+						else if (validate_state)
+						{
+							// Read state
+							size_t size = 0;
+							validate_state_file.read((char *)&size, sizeof(size));
+							string data;
+							data.resize(size);
+							validate_state_file.read(data.data(), size);
+
+							// Copy to validator
+							StateRecorderImpl validator;
+							validator.WriteBytes(data.data(), size);
+
+							// Validate state
+							validator.SetValidating(true);
+							physics_system.RestoreState(validator);
+						}
+
+					#ifdef JPH_ENABLE_DETERMINISM_LOG
+						const BodyLockInterface &bli = physics_system.GetBodyLockInterfaceNoLock();
+						BodyIDVector body_ids;
+						physics_system.GetBodies(body_ids);
+						for (BodyID id : body_ids)
+						{
+							BodyLockRead lock(bli, id);
+							const Body &body = lock.GetBody();
+							if (!body.IsStatic())
+								JPH_DET_LOG(id << ": p: " << body.GetPosition() << " r: " << body.GetRotation() << " v: " << body.GetLinearVelocity() << " w: " << body.GetAngularVelocity());
+						}
+					#endif // JPH_ENABLE_DETERMINISM_LOG
 					}
 
-				#ifdef JPH_ENABLE_DETERMINISM_LOG
-					const BodyLockInterface &bli = physics_system.GetBodyLockInterfaceNoLock();
+					// Flush pending profile dumps
+					JPH_PROFILE_NEXTFRAME();
+
+					// Calculate hash of all positions and rotations of the bodies
+					uint64 hash = HashBytes(nullptr, 0); // Ensure we start with the proper seed
+					BodyInterface &bi = physics_system.GetBodyInterfaceNoLock();
 					BodyIDVector body_ids;
 					physics_system.GetBodies(body_ids);
 					for (BodyID id : body_ids)
 					{
-						BodyLockRead lock(bli, id);
-						const Body &body = lock.GetBody();
-						if (!body.IsStatic())
-							JPH_DET_LOG(id << ": p: " << body.GetPosition() << " r: " << body.GetRotation() << " v: " << body.GetLinearVelocity() << " w: " << body.GetAngularVelocity());
+						RVec3 pos = bi.GetPosition(id);
+						hash = HashBytes(&pos, 3 * sizeof(Real), hash);
+						Quat rot = bi.GetRotation(id);
+						hash = HashBytes(&rot, sizeof(Quat), hash);
 					}
-				#endif // JPH_ENABLE_DETERMINISM_LOG
-				}
 
-				// Calculate hash of all positions and rotations of the bodies
-				uint64 hash = HashBytes(nullptr, 0); // Ensure we start with the proper seed
-				BodyInterface &bi = physics_system.GetBodyInterfaceNoLock();
-				BodyIDVector body_ids;
-				physics_system.GetBodies(body_ids);
-				for (BodyID id : body_ids)
-				{
-					RVec3 pos = bi.GetPosition(id);
-					hash = HashBytes(&pos, 3 * sizeof(Real), hash);
-					Quat rot = bi.GetRotation(id);
-					hash = HashBytes(&rot, sizeof(Quat), hash);
-				}
+					// Convert hash to string
+					stringstream hash_stream;
+					hash_stream << "0x" << hex << hash << dec;
+					string hash_str = hash_stream.str();
 
-				// Convert hash to string
-				stringstream hash_stream;
-				hash_stream << "0x" << hex << hash << dec;
-				string hash_str = hash_stream.str();
+					// Stop test scene
+					scene->StopTest(physics_system);
 
-				// Stop test scene
-				scene->StopTest(physics_system);
+					// Trace stat line
+					Trace("%s, %d, %f, %s", motion_quality_str.c_str(), num_threads + 1, double(max_iterations) / (1.0e-9 * total_duration.count()), hash_str.c_str());
 
-				// Trace stat line
-				Trace("%s, %d, %f, %s", motion_quality_str.c_str(), num_threads + 1, double(max_iterations) / (1.0e-9 * total_duration.count()), hash_str.c_str());
+					// Store the result
+					if (max_iterations > 0)
+					{
+						TestResult &result = results.emplace_back();
+						result.mScene = scene->GetName();
+						result.mMotionQuality = motion_quality_str;
+						result.mNumThreads = num_threads + 1;
+						result.mNumSteps = max_iterations;
+						result.mStepsPerSecond = double(max_iterations) / (1.0e-9 * total_duration.count());
+						result.mMeanStepTimeMs = 1.0e-6 * total_duration.count() / max_iterations;
+						QuickSort(step_times_ms.begin(), step_times_ms.end());
+						result.mMedianStepTimeMs = sPercentile(step_times_ms, 0.5);
+						result.mP90StepTimeMs = sPercentile(step_times_ms, 0.9);
+						result.mP99StepTimeMs = sPercentile(step_times_ms, 0.99);
+						result.mMaxStepTimeMs = step_times_ms.back();
+						result.mHash = hash_str;
+						for (uint p = 0; p < uint(EPhysicsUpdatePhase::Count); ++p)
+							result.mPhaseTimeMs[p] = 1.0e-6 * phase_time_ns[p] / max_iterations;
+					}
 
-				// Check hash code
-				if (validate_hash != nullptr && hash_str != validate_hash)
-				{
-					Trace("Fail hash validation. Was: %s, expected: %s", hash_str.c_str(), validate_hash);
-					return 1;
+					// Check hash code
+					if (validate_hash != nullptr && hash_str != validate_hash)
+					{
+						Trace("Fail hash validation. Was: %s, expected: %s", hash_str.c_str(), validate_hash);
+						return 1;
+					}
 				}
 			}
 		}
@@ -444,6 +781,27 @@ int main(int argc, char** argv)
 	NarrowPhaseStat::sReportStats();
 #endif // JPH_TRACK_NARROWPHASE_STATS
 
+	// Write the results
+	if (json_file != nullptr && !sWriteJSONResults(json_file, results))
+	{
+		Trace("Unable to write results to %s", json_file);
+		return 1;
+	}
+
+	// Compare against the baseline
+	int exit_code = 0;
+	if (compare_file != nullptr)
+	{
+		Array<TestResult> baseline;
+		if (!sReadJSONResults(compare_file, baseline))
+		{
+			Trace("Unable to read baseline from %s", compare_file);
+			return 1;
+		}
+		if (!sCompareResults(baseline, results, tolerance))
+			exit_code = 1;
+	}
+
 	// Unregisters all types with the factory and cleans up the default material
 	UnregisterTypes();
 
@@ -454,7 +812,7 @@ int main(int argc, char** argv)
 	// End profiling this program
 	JPH_PROFILE_END();
 
-	return 0;
+	return exit_code;
 }
 
 #ifdef JPH_PLATFORM_ANDROID
@@ -17,9 +17,18 @@ public:
 	// Load assets for the scene
 	virtual bool			Load()											{ return true; }
 
+	// Maximum number of bodies that this scene needs
+	virtual uint			GetMaxBodies() const							{ return 10240; }
+
+	// Maximum number of contact constraints that this scene needs
+	virtual uint			GetMaxContactConstraints() const				{ return 20480; }
+
 	// Start a new test by adding objects to inPhysicsSystem
 	virtual void			StartTest(PhysicsSystem &inPhysicsSystem, EMotionQuality inMotionQuality) = 0;
 
+	// Called before every physics step, time spent in this function is included in the measurements
+	virtual void			UpdateTest([[maybe_unused]] PhysicsSystem &inPhysicsSystem, [[maybe_unused]] JobSystem &inJobSystem) { }
+
 	// Stop a test and remove objects from inPhysicsSystem
 	virtual void			StopTest(PhysicsSystem &inPhysicsSystem)		{ }
 };
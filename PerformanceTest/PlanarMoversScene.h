@@ -0,0 +1,75 @@
+// Jolt Physics Library (https://github.com/jrouwe/JoltPhysics)
+// SPDX-FileCopyrightText: 2024 Jorrit Rouwe
+// SPDX-License-Identifier: MIT
+
+#pragma once
+
+// Jolt includes
+#include <Jolt/Physics/Collision/Shape/BoxShape.h>
+#include <Jolt/Physics/Collision/Shape/SphereShape.h>
+#include <Jolt/Physics/Body/BodyCreationSettings.h>
+
+// Local includes
+#include "PerformanceTestScene.h"
+#include "Layers.h"
+
+// A scene with a large amount of bodies that keep sliding around over a big plane, to compare the broadphases for mostly planar worlds with many moving bodies
+class PlanarMoversScene : public PerformanceTestScene
+{
+public:
+	virtual const char *	GetName() const override
+	{
+		return "PlanarMovers";
+	}
+
+	virtual uint			GetMaxBodies() const override
+	{
+		return cNumMovers + 5;
+	}
+
+	virtual void			StartTest(PhysicsSystem &inPhysicsSystem, EMotionQuality inMotionQuality) override
+	{
+		BodyInterface &bi = inPhysicsSystem.GetBodyInterface();
+
+		// Frictionless floor with bouncy walls so that the bodies keep moving
+		const float cWallHalfThickness = 1.0f;
+		const float cWallHalfHeight = 2.0f;
+		RefConst<Shape> floor_shape = new BoxShape(Vec3(cArenaHalfSize, cWallHalfThickness, cArenaHalfSize));
+		RefConst<Shape> wall_x_shape = new BoxShape(Vec3(cWallHalfThickness, cWallHalfHeight, cArenaHalfSize));
+		RefConst<Shape> wall_z_shape = new BoxShape(Vec3(cArenaHalfSize, cWallHalfHeight, cWallHalfThickness));
+		const RVec3 wall_positions[] = { RVec3(0, -cWallHalfThickness, 0), RVec3(-cArenaHalfSize - cWallHalfThickness, cWallHalfHeight, 0), RVec3(cArenaHalfSize + cWallHalfThickness, cWallHalfHeight, 0), RVec3(0, cWallHalfHeight, -cArenaHalfSize - cWallHalfThickness), RVec3(0, cWallHalfHeight, cArenaHalfSize + cWallHalfThickness) };
+		const Shape *wall_shapes[] = { floor_shape, wall_x_shape, wall_x_shape, wall_z_shape, wall_z_shape };
+		for (int i = 0; i < 5; ++i)
+		{
+			BodyCreationSettings settings(wall_shapes[i], wall_positions[i], Quat::sIdentity(), EMotionType::Static, Layers::NON_MOVING);
+			settings.mRestitution = 1.0f;
+			settings.mFriction = 0.0f;
+			bi.CreateAndAddBody(settings, EActivation::DontActivate);
+		}
+
+		// Movers alternate between boxes and spheres and are spread out over the floor with a random horizontal velocity
+		RefConst<Shape> shapes[] = { new BoxShape(Vec3::sReplicate(0.5f)), new SphereShape(0.5f) };
+		default_random_engine random;
+		uniform_real_distribution<float> position_range(-0.95f * cArenaHalfSize, 0.95f * cArenaHalfSize);
+		uniform_real_distribution<float> velocity_range(-cMaxSpeed, cMaxSpeed);
+		BodyIDVector ids;
+		ids.reserve(cNumMovers);
+		for (int i = 0; i < cNumMovers; ++i)
+		{
+			BodyCreationSettings settings(shapes[i & 1], RVec3(position_range(random), 0.5f, position_range(random)), Quat::sIdentity(), EMotionType::Dynamic, Layers::MOVING);
+			settings.mMotionQuality = inMotionQuality;
+			settings.mRestitution = 1.0f;
+			settings.mFriction = 0.0f;
+			settings.mAllowSleeping = false;
+			settings.mLinearVelocity = Vec3(velocity_range(random), 0, velocity_range(random));
+			ids.push_back(bi.CreateBody(settings)->GetID());
+		}
+		BodyInterface::AddState add_state = bi.AddBodiesPrepare(ids.data(), (int)ids.size());
+		bi.AddBodiesFinalize(ids.data(), (int)ids.size(), add_state, EActivation::Activate);
+	}
+
+private:
+	static constexpr int	cNumMovers = 10000;
+	static constexpr float	cArenaHalfSize = 250.0f;
+	static constexpr float	cMaxSpeed = 10.0f;
+};
@@ -0,0 +1,78 @@
+// Jolt Physics Library (https://github.com/jrouwe/JoltPhysics)
+// SPDX-FileCopyrightText: 2024 Jorrit Rouwe
+// SPDX-License-Identifier: MIT
+
+#pragma once
+
+// Jolt includes
+#include <Jolt/Physics/Collision/Shape/BoxShape.h>
+#include <Jolt/Physics/Collision/Shape/SphereShape.h>
+#include <Jolt/Physics/Body/BodyCreationSettings.h>
+
+// Local includes
+#include "PerformanceTestScene.h"
+#include "Layers.h"
+
+// A scene that fires a large number of fast moving projectiles around in a closed arena filled with boxes to stress continuous collision detection
+class ProjectileSwarmScene : public PerformanceTestScene
+{
+public:
+	virtual const char *	GetName() const override
+	{
+		return "ProjectileSwarm";
+	}
+
+	virtual void			StartTest(PhysicsSystem &inPhysicsSystem, EMotionQuality inMotionQuality) override
+	{
+		BodyInterface &bi = inPhysicsSystem.GetBodyInterface();
+
+		// Closed arena so that the projectiles keep bouncing around
+		const float cArenaHalfSize = 50.0f;
+		const float cWallHalfThickness = 1.0f;
+		RefConst<Shape> floor_shape = new BoxShape(Vec3(cArenaHalfSize, cWallHalfThickness, cArenaHalfSize));
+		RefConst<Shape> wall_x_shape = new BoxShape(Vec3(cWallHalfThickness, cArenaHalfSize, cArenaHalfSize));
+		RefConst<Shape> wall_z_shape = new BoxShape(Vec3(cArenaHalfSize, cArenaHalfSize, cWallHalfThickness));
+		const RVec3 wall_positions[] = { RVec3(0, -cWallHalfThickness, 0), RVec3(0, 2.0f * cArenaHalfSize + cWallHalfThickness, 0), RVec3(-cArenaHalfSize - cWallHalfThickness, cArenaHalfSize, 0), RVec3(cArenaHalfSize + cWallHalfThickness, cArenaHalfSize, 0), RVec3(0, cArenaHalfSize, -cArenaHalfSize - cWallHalfThickness), RVec3(0, cArenaHalfSize, cArenaHalfSize + cWallHalfThickness) };
+		const Shape *wall_shapes[] = { floor_shape, floor_shape, wall_x_shape, wall_x_shape, wall_z_shape, wall_z_shape };
+		for (int i = 0; i < 6; ++i)
+		{
+			BodyCreationSettings settings(wall_shapes[i], wall_positions[i], Quat::sIdentity(), EMotionType::Static, Layers::NON_MOVING);
+			settings.mRestitution = 0.9f;
+			settings.mFriction = 0.0f;
+			bi.CreateAndAddBody(settings, EActivation::DontActivate);
+		}
+
+		// Stacks of boxes that the projectiles can hit
+		RefConst<Shape> box_shape = new BoxShape(Vec3::sReplicate(1.0f));
+		for (int x = -4; x <= 4; ++x)
+			for (int z = -4; z <= 4; ++z)
+				for (int y = 0; y < 5; ++y)
+				{
+					BodyCreationSettings settings(box_shape, RVec3(10.0_r * x, 1.0_r + 2.0_r * y, 10.0_r * z), Quat::sIdentity(), EMotionType::Dynamic, Layers::MOVING);
+					settings.mMotionQuality = inMotionQuality;
+					bi.CreateAndAddBody(settings, EActivation::Activate);
+				}
+
+		// Projectiles are always linear cast as they would otherwise tunnel out of the arena
+		RefConst<Shape> projectile_shape = new SphereShape(0.1f);
+		default_random_engine random;
+		uniform_real_distribution<float> position_range(-0.8f * cArenaHalfSize, 0.8f * cArenaHalfSize);
+		uniform_real_distribution<float> height_range(15.0f, 1.8f * cArenaHalfSize);
+		uniform_real_distribution<float> direction_range(-1.0f, 1.0f);
+		for (int i = 0; i < cNumProjectiles; ++i)
+		{
+			BodyCreationSettings settings(projectile_shape, RVec3(position_range(random), height_range(random), position_range(random)), Quat::sIdentity(), EMotionType::Dynamic, Layers::MOVING);
+			settings.mMotionQuality = EMotionQuality::LinearCast;
+			settings.mRestitution = 0.9f;
+			settings.mFriction = 0.0f;
+			settings.mAllowSleeping = false;
+			settings.mGravityFactor = 0.0f;
+			settings.mLinearVelocity = cProjectileSpeed * Vec3(direction_range(random), direction_range(random), direction_range(random)).NormalizedOr(Vec3::sAxisX());
+			bi.CreateAndAddBody(settings, EActivation::Activate);
+		}
+	}
+
+private:
+	static constexpr int	cNumProjectiles = 1000;
+	static constexpr float	cProjectileSpeed = 250.0f;
+};
@@ -21,10 +21,12 @@
 class RagdollScene : public PerformanceTestScene
 {
 public:
-							RagdollScene(int inNumPilesPerAxis, int inPileSize, float inVerticalSeparation) : mNumPilesPerAxis(inNumPilesPerAxis), mPileSize(inPileSize), mVerticalSeparation(inVerticalSeparation) { }
+							RagdollScene(int inNumPilesPerAxis, int inPileSize, float inVerticalSeparation, bool inLowLOD = false) : mNumPilesPerAxis(inNumPilesPerAxis), mPileSize(inPileSize), mVerticalSeparation(inVerticalSeparation), mLowLOD(inLowLOD) { }
 
 	virtual const char *	GetName() const override
 	{
+		if (mLowLOD)
+			return "RagdollLowLOD";
 		return mNumPilesPerAxis == 1? "RagdollSinglePile" : "Ragdoll";
 	}
 
@@ -45,6 +47,19 @@ public:
 		mRagdollSettings->CalculateBodyIndexToConstraintIndex();
 		mRagdollSettings->CalculateConstraintIndexToBodyIdxPair();
 
+		// Determine which bodies to freeze for the low level of detail version: the lower arms, lower legs and the head
+		if (mLowLOD)
+			for (const char *name : { "L_Arm_sjnt_1", "R_Arm_sjnt_1", "L_Leg_sjnt_1", "R_Leg_sjnt_1", "C_Neck_sjnt_0" })
+			{
+				int joint_idx = mRagdollSettings->GetSkeleton()->GetJointIndex(name);
+				if (joint_idx < 0)
+				{
+					cerr << "Unable to find joint " << name << endl;
+					return false;
+				}
+				mFrozenBodies.push_back(joint_idx);
+			}
+
 		// Load animation
 		if (!ObjectStreamIn::sReadObject("Assets/Human/dead_pose1.tof", mAnimation))
 		{
@@ -116,6 +131,10 @@ public:
 					ragdoll->DriveToPoseUsingMotors(pose_copy);
 					ragdoll->AddToPhysicsSystem(EActivation::Activate);
 
+					// Merge the frozen bodies into their parents
+					if (mLowLOD)
+						ragdoll->SetFrozenBodies(mFrozenBodies);
+
 					// Keep reference
 					mRagdolls.push_back(ragdoll);
 				}
@@ -134,6 +153,8 @@ private:
 	int 					mNumPilesPerAxis;
 	int 					mPileSize;
 	float 					mVerticalSeparation;
+	bool					mLowLOD;
+	Array<int>				mFrozenBodies;
 	Ref<RagdollSettings>	mRagdollSettings;
 	Ref<SkeletalAnimation>	mAnimation;
 	SkeletonPose			mPose;
@@ -0,0 +1,113 @@
+// Jolt Physics Library (https://github.com/jrouwe/JoltPhysics)
+// SPDX-FileCopyrightText: 2024 Jorrit Rouwe
+// SPDX-License-Identifier: MIT
+
+#pragma once
+
+// Jolt includes
+#include <Jolt/Physics/Collision/Shape/BoxShape.h>
+#include <Jolt/Physics/Collision/Shape/SphereShape.h>
+#include <Jolt/Physics/Collision/Shape/HeightFieldShape.h>
+#include <Jolt/Physics/Collision/RayCast.h>
+#include <Jolt/Physics/Collision/CastResult.h>
+#include <Jolt/Physics/Body/BodyCreationSettings.h>
+
+// Local includes
+#include "PerformanceTestScene.h"
+#include "Layers.h"
+
+// A pile of bodies on a height field terrain that is hit by a storm of ray casts every step.
+// The rays are cast from multiple jobs while the simulation is not running, like a game would do for e.g. bullets and line of sight checks.
+class RaycastStormScene : public PerformanceTestScene
+{
+public:
+	virtual const char *	GetName() const override
+	{
+		return "RaycastStorm";
+	}
+
+	virtual bool			Load() override
+	{
+		// Create a rolling terrain
+		Array<float> samples;
+		samples.resize(cTerrainSampleCount * cTerrainSampleCount);
+		for (uint z = 0; z < cTerrainSampleCount; ++z)
+			for (uint x = 0; x < cTerrainSampleCount; ++x)
+				samples[z * cTerrainSampleCount + x] = 5.0f * Sin(0.1f * x) * Cos(0.1f * z);
+		HeightFieldShapeSettings settings(samples.data(), Vec3(-0.5f * cTerrainSize, 0, -0.5f * cTerrainSize), Vec3(cTerrainSize / (cTerrainSampleCount - 1), 1.0f, cTerrainSize / (cTerrainSampleCount - 1)), cTerrainSampleCount);
+		mTerrain = settings.Create().Get();
+		return mTerrain != nullptr;
+	}
+
+	virtual void			StartTest(PhysicsSystem &inPhysicsSystem, EMotionQuality inMotionQuality) override
+	{
+		BodyInterface &bi = inPhysicsSystem.GetBodyInterface();
+
+		// Terrain
+		bi.CreateAndAddBody(BodyCreationSettings(mTerrain, RVec3::sZero(), Quat::sIdentity(), EMotionType::Static, Layers::NON_MOVING), EActivation::DontActivate);
+
+		// Piles of boxes and spheres
+		RefConst<Shape> shapes[] = { new BoxShape(Vec3::sReplicate(0.5f)), new SphereShape(0.5f) };
+		for (int x = -10; x < 10; ++x)
+			for (int z = -10; z < 10; ++z)
+				for (int y = 0; y < 5; ++y)
+				{
+					BodyCreationSettings settings(shapes[(x + y + z) & 1], RVec3(4.0_r * x, 10.0_r + 2.0_r * y, 4.0_r * z), Quat::sIdentity(), EMotionType::Dynamic, Layers::MOVING);
+					settings.mMotionQuality = inMotionQuality;
+					bi.CreateAndAddBody(settings, EActivation::Activate);
+				}
+
+		mStep = 0;
+		mNumHits = 0;
+	}
+
+	virtual void			UpdateTest(PhysicsSystem &inPhysicsSystem, JobSystem &inJobSystem) override
+	{
+		// Cast the rays in batches spread out over the job system
+		JobSystem::Barrier *barrier = inJobSystem.CreateBarrier();
+		for (int batch = 0; batch < cNumRays / cRaysPerJob; ++batch)
+		{
+			JobHandle job = inJobSystem.CreateJob("RaycastStorm", Color::sGreen, [this, &inPhysicsSystem, batch]()
+				{
+					// Use a deterministic set of rays that is different every step
+					default_random_engine random(uint(mStep * cNumRays + batch));
+					uniform_real_distribution<float> position_range(-0.5f * cTerrainSize, 0.5f * cTerrainSize);
+					uniform_real_distribution<float> direction_range(-1.0f, 1.0f);
+
+					const NarrowPhaseQuery &query = inPhysicsSystem.GetNarrowPhaseQuery();
+					uint num_hits = 0;
+					for (int i = 0; i < cRaysPerJob; ++i)
+					{
+						// Cast downwards from high above the terrain in a random direction
+						RVec3 origin(position_range(random), 50.0f, position_range(random));
+						Vec3 direction = 100.0f * Vec3(direction_range(random), -1.0f, direction_range(random)).Normalized();
+						RayCastResult hit;
+						if (query.CastRay(RRayCast(origin, direction), hit))
+							++num_hits;
+					}
+					mNumHits.fetch_add(num_hits, memory_order_relaxed);
+				});
+			barrier->AddJob(job);
+		}
+		inJobSystem.WaitForJobs(barrier);
+		inJobSystem.DestroyBarrier(barrier);
+
+		++mStep;
+	}
+
+	virtual void			StopTest([[maybe_unused]] PhysicsSystem &inPhysicsSystem) override
+	{
+		// Report the number of hits so that it is clear that the rays actually hit something
+		Trace("RaycastStorm: %.1f of %d rays hit per step", mStep > 0? double(mNumHits) / mStep : 0.0, cNumRays);
+	}
+
+private:
+	static constexpr uint	cTerrainSampleCount = 128;
+	static constexpr float	cTerrainSize = 200.0f;
+	static constexpr int	cNumRays = 20000;
+	static constexpr int	cRaysPerJob = 500;
+
+	RefConst<Shape>			mTerrain;
+	int						mStep = 0;
+	atomic<uint>			mNumHits { 0 };
+};
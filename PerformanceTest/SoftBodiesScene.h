@@ -0,0 +1,84 @@
+// Jolt Physics Library (https://github.com/jrouwe/JoltPhysics)
+// SPDX-FileCopyrightText: 2024 Jorrit Rouwe
+// SPDX-License-Identifier: MIT
+
+#pragma once
+
+// Jolt includes
+#include <Jolt/Physics/Collision/Shape/BoxShape.h>
+#include <Jolt/Physics/Collision/Shape/SphereShape.h>
+#include <Jolt/Physics/Body/BodyCreationSettings.h>
+#include <Jolt/Physics/SoftBody/SoftBodyCreationSettings.h>
+
+// Local includes
+#include "PerformanceTestScene.h"
+#include "Layers.h"
+
+// A grid of cloths that fall on spheres and boxes, to measure the cost of simulating soft bodies
+class SoftBodiesScene : public PerformanceTestScene
+{
+public:
+	virtual const char *	GetName() const override
+	{
+		return "SoftBodies";
+	}
+
+	virtual bool			Load() override
+	{
+		const float cOffset = -0.5f * cClothSpacing * (cClothGridSize - 1);
+
+		// Create a square cloth
+		mClothSettings = new SoftBodySharedSettings;
+		for (uint z = 0; z < cClothGridSize; ++z)
+			for (uint x = 0; x < cClothGridSize; ++x)
+			{
+				SoftBodySharedSettings::Vertex v;
+				v.mPosition = Float3(cOffset + x * cClothSpacing, 0.0f, cOffset + z * cClothSpacing);
+				mClothSettings->mVertices.push_back(v);
+			}
+		for (uint z = 0; z < cClothGridSize - 1; ++z)
+			for (uint x = 0; x < cClothGridSize - 1; ++x)
+			{
+				uint v0 = x + z * cClothGridSize;
+				uint v1 = v0 + cClothGridSize;
+				mClothSettings->AddFace(SoftBodySharedSettings::Face(v0, v1, v1 + 1));
+				mClothSettings->AddFace(SoftBodySharedSettings::Face(v0, v1 + 1, v0 + 1));
+			}
+		SoftBodySharedSettings::VertexAttributes attributes(1.0e-5f, 1.0e-5f, 1.0e-3f);
+		mClothSettings->CreateConstraints(&attributes, 1, SoftBodySharedSettings::EBendType::Distance);
+		mClothSettings->Optimize();
+
+		return true;
+	}
+
+	virtual void			StartTest(PhysicsSystem &inPhysicsSystem, EMotionQuality inMotionQuality) override
+	{
+		BodyInterface &bi = inPhysicsSystem.GetBodyInterface();
+
+		// Floor
+		bi.CreateAndAddBody(BodyCreationSettings(new BoxShape(Vec3(100.0f, 1.0f, 100.0f)), RVec3(0, -1, 0), Quat::sIdentity(), EMotionType::Static, Layers::NON_MOVING), EActivation::DontActivate);
+
+		// A grid of alternating spheres and boxes with a cloth above each of them
+		RefConst<Shape> shapes[] = { new SphereShape(2.0f), new BoxShape(Vec3::sReplicate(1.5f)) };
+		const float cSpacing = 10.0f;
+		for (int x = 0; x < cNumPerAxis; ++x)
+			for (int z = 0; z < cNumPerAxis; ++z)
+			{
+				RVec3 position(cSpacing * (x - 0.5f * (cNumPerAxis - 1)), 2.0f, cSpacing * (z - 0.5f * (cNumPerAxis - 1)));
+
+				BodyCreationSettings obstacle(shapes[(x + z) & 1], position, Quat::sRotation(Vec3::sAxisY(), 0.3f * x), EMotionType::Dynamic, Layers::MOVING);
+				obstacle.mMotionQuality = inMotionQuality;
+				bi.CreateAndAddBody(obstacle, EActivation::Activate);
+
+				SoftBodyCreationSettings cloth(mClothSettings, position + RVec3(0, 5.0f, 0), Quat::sIdentity(), Layers::MOVING);
+				bi.CreateAndAddSoftBody(cloth, EActivation::Activate);
+			}
+	}
+
+private:
+	static constexpr uint	cClothGridSize = 25;
+	static constexpr float	cClothSpacing = 0.3f;
+	static constexpr int	cNumPerAxis = 6;
+
+	Ref<SoftBodySharedSettings> mClothSettings;
+};
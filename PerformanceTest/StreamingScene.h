@@ -0,0 +1,98 @@
+// Jolt Physics Library (https://github.com/jrouwe/JoltPhysics)
+// SPDX-FileCopyrightText: 2024 Jorrit Rouwe
+// SPDX-License-Identifier: MIT
+
+#pragma once
+
+// Jolt includes
+#include <Jolt/Physics/Collision/Shape/BoxShape.h>
+#include <Jolt/Physics/Body/BodyCreationSettings.h>
+
+// Local includes
+#include "PerformanceTestScene.h"
+#include "Layers.h"
+
+// A scene that continuously streams in and out large chunks of static bodies while a pile of boxes is being simulated, to measure the cost of adding bodies in batches
+class StreamingScene : public PerformanceTestScene
+{
+public:
+	virtual const char *	GetName() const override
+	{
+		return "Streaming";
+	}
+
+	virtual uint			GetMaxBodies() const override
+	{
+		return 65536;
+	}
+
+	virtual void			StartTest(PhysicsSystem &inPhysicsSystem, EMotionQuality inMotionQuality) override
+	{
+		BodyInterface &bi = inPhysicsSystem.GetBodyInterface();
+
+		// Reset streaming state
+		mFrame = 0;
+		mNextChunk = 0;
+		mChunks.clear();
+
+		// Floor
+		bi.CreateAndAddBody(BodyCreationSettings(new BoxShape(Vec3(50.0f, 1.0f, 50.0f), 0.0f), RVec3(0, -1, 0), Quat::sIdentity(), EMotionType::Static, Layers::NON_MOVING), EActivation::DontActivate);
+
+		// Pile of boxes to keep the simulation busy
+		RefConst<Shape> box_shape = new BoxShape(Vec3::sReplicate(0.5f));
+		for (int x = -5; x < 5; ++x)
+			for (int z = -5; z < 5; ++z)
+				for (int y = 0; y < 4; ++y)
+				{
+					BodyCreationSettings settings(box_shape, RVec3(2.0_r * x, 1.0_r + 2.0_r * y, 2.0_r * z), Quat::sIdentity(), EMotionType::Dynamic, Layers::MOVING);
+					settings.mMotionQuality = inMotionQuality;
+					bi.CreateAndAddBody(settings, EActivation::Activate);
+				}
+
+		mChunkShape = new BoxShape(Vec3::sReplicate(0.4f));
+	}
+
+	virtual void			UpdateTest(PhysicsSystem &inPhysicsSystem, JobSystem &inJobSystem) override
+	{
+		if (mFrame++ % cFramesPerChunk != 0)
+			return;
+
+		BodyInterface &bi = inPhysicsSystem.GetBodyInterface();
+
+		// Unload the oldest chunk
+		if (mChunks.size() >= cMaxLoadedChunks)
+		{
+			BodyIDVector &chunk = mChunks.front();
+			bi.RemoveBodies(chunk.data(), int(chunk.size()));
+			bi.DestroyBodies(chunk.data(), int(chunk.size()));
+			mChunks.erase(mChunks.begin());
+		}
+
+		// Create the bodies of a new chunk, chunks are placed on a ring around the pile of boxes
+		BodyIDVector chunk;
+		chunk.reserve(cBodiesPerChunk);
+		int chunk_index = mNextChunk++;
+		RVec3 chunk_origin = RVec3(Vec3(Cos(0.5f * JPH_PI * chunk_index), 0, Sin(0.5f * JPH_PI * chunk_index)) * 200.0f);
+		for (int i = 0; i < cBodiesPerChunk; ++i)
+		{
+			RVec3 position = chunk_origin + Vec3(float(i % cChunkSize), float(i / (cChunkSize * cChunkSize)), float((i / cChunkSize) % cChunkSize));
+			chunk.push_back(bi.CreateBody(BodyCreationSettings(mChunkShape, position, Quat::sIdentity(), EMotionType::Static, Layers::NON_MOVING))->GetID());
+		}
+
+		// Add them to the broadphase as a single batch
+		BodyInterface::AddState add_state = bi.AddBodiesPrepare(chunk.data(), cBodiesPerChunk, &inJobSystem);
+		bi.AddBodiesFinalize(chunk.data(), cBodiesPerChunk, add_state, EActivation::DontActivate);
+		mChunks.push_back(std::move(chunk));
+	}
+
+private:
+	static constexpr int	cChunkSize = 64;
+	static constexpr int	cBodiesPerChunk = cChunkSize * cChunkSize * 4;
+	static constexpr int	cFramesPerChunk = 10;
+	static constexpr size_t	cMaxLoadedChunks = 2;
+
+	RefConst<Shape>			mChunkShape;
+	uint					mFrame = 0;
+	int						mNextChunk = 0;
+	Array<BodyIDVector>		mChunks;
+};
@@ -0,0 +1,139 @@
+// Jolt Physics Library (https://github.com/jrouwe/JoltPhysics)
+// SPDX-FileCopyrightText: 2024 Jorrit Rouwe
+// SPDX-License-Identifier: MIT
+
+#pragma once
+
+// Jolt includes
+#include <Jolt/Physics/Collision/Shape/BoxShape.h>
+#include <Jolt/Physics/Collision/Shape/MeshShape.h>
+#include <Jolt/Physics/Collision/Shape/OffsetCenterOfMassShape.h>
+#include <Jolt/Physics/Vehicle/VehicleConstraint.h>
+#include <Jolt/Physics/Vehicle/WheeledVehicleController.h>
+#include <Jolt/Physics/Body/BodyCreationSettings.h>
+
+// Local includes
+#include "PerformanceTestScene.h"
+#include "Layers.h"
+
+// A large number of vehicles driving in circles over a terrain with rubble, to measure the cost of the wheel collision tests
+class VehiclesScene : public PerformanceTestScene
+{
+public:
+							VehiclesScene(bool inBatchWheelCollisionTests, bool inLowLOD) : mBatchWheelCollisionTests(inBatchWheelCollisionTests), mLowLOD(inLowLOD) { }
+
+	virtual const char *	GetName() const override
+	{
+		return mLowLOD? "VehiclesLowLOD" : (mBatchWheelCollisionTests? "VehiclesBatchedWheels" : "Vehicles");
+	}
+
+	virtual bool			Load() override
+	{
+		const int n = 100;
+		const float cell_size = 2.0f;
+		const float max_height = 1.0f;
+		float center = n * cell_size / 2;
+
+		// Create a gently sloping terrain
+		VertexList vertices;
+		vertices.resize((n + 1) * (n + 1));
+		for (int x = 0; x <= n; ++x)
+			for (int z = 0; z <= n; ++z)
+			{
+				float height = Sin(float(x) * 20.0f / n) * Cos(float(z) * 20.0f / n);
+				vertices[z * (n + 1) + x] = Float3(cell_size * x - center, max_height * height, cell_size * z - center);
+			}
+		IndexedTriangleList indices;
+		for (int x = 0; x < n; ++x)
+			for (int z = 0; z < n; ++z)
+			{
+				uint32 start = (n + 1) * z + x;
+				indices.push_back(IndexedTriangle(start, start + n + 1, start + 1));
+				indices.push_back(IndexedTriangle(start + 1, start + n + 1, start + n + 2));
+			}
+		mTerrain = MeshShapeSettings(vertices, indices).Create().Get();
+
+		// Shapes for the rubble and the vehicle body
+		mRubble = new BoxShape(Vec3(0.5f, 0.2f, 0.5f));
+		mCarBody = OffsetCenterOfMassShapeSettings(Vec3(0, -0.2f, 0), new BoxShape(Vec3(0.9f, 0.2f, 2.0f))).Create().Get();
+
+		return true;
+	}
+
+	virtual void			StartTest(PhysicsSystem &inPhysicsSystem, EMotionQuality inMotionQuality) override
+	{
+		BodyInterface &bi = inPhysicsSystem.GetBodyInterface();
+
+		// Create the terrain
+		bi.CreateAndAddBody(BodyCreationSettings(mTerrain, RVec3::sZero(), Quat::sIdentity(), EMotionType::Static, Layers::NON_MOVING), EActivation::DontActivate);
+
+		// Scatter static rubble over the terrain
+		for (int x = 0; x < 40; ++x)
+			for (int z = 0; z < 40; ++z)
+				bi.CreateAndAddBody(BodyCreationSettings(mRubble, RVec3(Real(5.0f * x - 97.5f), Real(0.5f), Real(5.0f * z - 97.5f)), Quat::sRotation(Vec3::sAxisY(), 0.7f * (x + 40 * z)), EMotionType::Static, Layers::NON_MOVING), EActivation::DontActivate);
+
+		// Collision tester that is shared by all vehicles
+		Ref<VehicleCollisionTester> tester = new VehicleCollisionTesterCastCylinder(Layers::MOVING);
+		Ref<VehicleCollisionTester> low_lod_tester = new VehicleCollisionTesterRay(Layers::MOVING);
+
+		// Create the vehicles
+		const int cNumPerAxis = 20;
+		for (int x = 0; x < cNumPerAxis; ++x)
+			for (int z = 0; z < cNumPerAxis; ++z)
+			{
+				BodyCreationSettings car_body_settings(mCarBody, RVec3(Real(9.0f * x - 85.5f), Real(3.0f), Real(9.0f * z - 85.5f)), Quat::sIdentity(), EMotionType::Dynamic, Layers::MOVING);
+				car_body_settings.mMotionQuality = inMotionQuality;
+				car_body_settings.mOverrideMassProperties = EOverrideMassProperties::CalculateInertia;
+				car_body_settings.mMassPropertiesOverride.mMass = 1500.0f;
+				Body *car_body = bi.CreateBody(car_body_settings);
+				bi.AddBody(car_body->GetID(), EActivation::Activate);
+
+				VehicleConstraintSettings vehicle;
+				const Vec3 cWheelPositions[] = { Vec3(0.9f, -0.18f, 1.4f), Vec3(-0.9f, -0.18f, 1.4f), Vec3(0.9f, -0.18f, -1.4f), Vec3(-0.9f, -0.18f, -1.4f) };
+				for (int w = 0; w < 4; ++w)
+				{
+					WheelSettingsWV *wheel = new WheelSettingsWV;
+					wheel->mPosition = cWheelPositions[w];
+					wheel->mMaxSteerAngle = w < 2? DegreesToRadians(30.0f) : 0.0f;
+					wheel->mRadius = 0.3f;
+					wheel->mWidth = 0.1f;
+					wheel->mSuspensionMinLength = 0.3f;
+					wheel->mSuspensionMaxLength = 0.5f;
+					vehicle.mWheels.push_back(wheel);
+				}
+				WheeledVehicleControllerSettings *controller = new WheeledVehicleControllerSettings;
+				controller->mDifferentials.resize(1);
+				controller->mDifferentials[0].mLeftWheel = 0;
+				controller->mDifferentials[0].mRightWheel = 1;
+				vehicle.mController = controller;
+
+				Ref<VehicleConstraint> constraint = new VehicleConstraint(*car_body, vehicle);
+				constraint->SetVehicleCollisionTester(tester);
+				constraint->SetBatchWheelCollisionTests(mBatchWheelCollisionTests);
+				constraint->SetLowLODVehicleCollisionTester(low_lod_tester);
+				constraint->SetLOD(mLowLOD? EVehicleLOD::Low : EVehicleLOD::Full);
+				static_cast<WheeledVehicleController *>(constraint->GetController())->SetDriverInput(0.5f, (x + z) % 2 == 0? 0.5f : -0.5f, 0.0f, 0.0f);
+				inPhysicsSystem.AddConstraint(constraint);
+				inPhysicsSystem.AddStepListener(constraint);
+				mVehicles.push_back(constraint);
+			}
+	}
+
+	virtual void			StopTest(PhysicsSystem &inPhysicsSystem) override
+	{
+		for (VehicleConstraint *v : mVehicles)
+		{
+			inPhysicsSystem.RemoveStepListener(v);
+			inPhysicsSystem.RemoveConstraint(v);
+		}
+		mVehicles.clear();
+	}
+
+private:
+	bool					mBatchWheelCollisionTests;
+	bool					mLowLOD;
+	RefConst<Shape>			mTerrain;
+	RefConst<Shape>			mRubble;
+	RefConst<Shape>			mCarBody;
+	Array<Ref<VehicleConstraint>> mVehicles;
+};
@@ -9,6 +9,8 @@
 #include <Jolt/Physics/Body/BodyCreationSettings.h>
 #include <Jolt/Physics/Collision/BroadPhase/BroadPhaseBruteForce.h>
 #include <Jolt/Physics/Collision/BroadPhase/BroadPhaseQuadTree.h>
+#include <Jolt/Physics/Collision/BroadPhase/BroadPhaseSAP.h>
+#include <Application/DebugUI.h>
 #include <random>
 
 JPH_IMPLEMENT_RTTI_ABSTRACT(BroadPhaseTest)
@@ -18,9 +20,6 @@ JPH_IMPLEMENT_RTTI_ABSTRACT(BroadPhaseTest)
 
 #define NUM_BODIES		10000
 
-//#define BROAD_PHASE		BroadPhaseBruteForce()
-#define BROAD_PHASE		BroadPhaseQuadTree()
-
 BroadPhaseTest::~BroadPhaseTest()
 {
 	delete mBroadPhase;
@@ -58,7 +57,20 @@ void BroadPhaseTest::Initialize()
 	mBodyManager->Init(NUM_BODIES, 0, mBroadPhaseLayerInterface);
 
 	// Crate broadphase
-	mBroadPhase = new BROAD_PHASE;
+	switch (sBroadPhaseType)
+	{
+	case EBroadPhaseType::QuadTree:
+		mBroadPhase = new BroadPhaseQuadTree;
+		break;
+
+	case EBroadPhaseType::SweepAndPrune:
+		mBroadPhase = new BroadPhaseSAP;
+		break;
+
+	case EBroadPhaseType::BruteForce:
+		mBroadPhase = new BroadPhaseBruteForce;
+		break;
+	}
 	mBroadPhase->Init(mBodyManager, mBroadPhaseLayerInterface);
 }
 
@@ -68,3 +80,8 @@ void BroadPhaseTest::PostPhysicsUpdate(float inDeltaTime)
 	mBodyManager->Draw(BodyManager::DrawSettings(), PhysicsSettings(), mDebugRenderer);
 #endif // JPH_DEBUG_RENDERER
 }
+
+void BroadPhaseTest::CreateSettingsMenu(DebugUI *inUI, UIElement *inSubMenu)
+{
+	inUI->CreateComboBox(inSubMenu, "Broad Phase", { "Quad Tree", "Sweep And Prune", "Brute Force" }, (int)sBroadPhaseType, [this](int inItem) { sBroadPhaseType = (EBroadPhaseType)inItem; RestartTest(); });
+}
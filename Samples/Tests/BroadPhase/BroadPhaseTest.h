@@ -24,11 +24,18 @@ public:
 	// Update the test, called after the physics update
 	virtual void			PostPhysicsUpdate(float inDeltaTime) override;
 
+	// Optional settings menu
+	virtual bool			HasSettingsMenu() const override							{ return true; }
+	virtual void			CreateSettingsMenu(DebugUI *inUI, UIElement *inSubMenu) override;
+
 protected:
 	// Create bodies according to method outlined in "FAST SOFTWARE FOR BOX INTERSECTIONS by AFRA ZOMORODIAN" section "The balanced distribution"
 	// http://pub.ist.ac.at/~edels/Papers/2002-J-01-FastBoxIntersection.pdf
 	void					CreateBalancedDistribution(BodyManager *inBodyManager, int inNumBodies, float inEnvironmentSize = 512.0f);
 
+	// Broadphase implementation that is tested
+	static inline EBroadPhaseType sBroadPhaseType = EBroadPhaseType::QuadTree;
+
 	BPLayerInterfaceImpl	mBroadPhaseLayerInterface;
 	BroadPhase *			mBroadPhase = nullptr;
 	BodyManager *			mBodyManager = nullptr;
@@ -0,0 +1,61 @@
+// Jolt Physics Library (https://github.com/jrouwe/JoltPhysics)
+// SPDX-FileCopyrightText: 2024 Jorrit Rouwe
+// SPDX-License-Identifier: MIT
+
+#include "UnitTestFramework.h"
+#include <Jolt/Core/Profiler.h>
+#include <Jolt/Core/Color.h>
+
+JPH_SUPPRESS_WARNINGS_STD_BEGIN
+#include <sstream>
+JPH_SUPPRESS_WARNINGS_STD_END
+
+#ifdef JPH_PROFILE_ENABLED
+
+TEST_SUITE("ProfilerTest")
+{
+	static int sCountOccurrences(const std::string &inString, const char *inSubString)
+	{
+		int count = 0;
+		for (size_t pos = inString.find(inSubString); pos != std::string::npos; pos = inString.find(inSubString, pos + 1))
+			++count;
+		return count;
+	}
+
+	TEST_CASE("TestChromeTraceFrameHistory")
+	{
+		JPH_PROFILE_START("Main \"Thread\"");
+		Profiler::sInstance->SetFrameHistory(3);
+
+		// Record more frames than fit in the history
+		for (int frame = 0; frame < 5; ++frame)
+		{
+			{
+				JPH_PROFILE(frame < 2? "OldFrame" : "Outer", Color::sRed.GetUInt32());
+				JPH_PROFILE("Inner");
+			}
+			JPH_PROFILE_NEXTFRAME();
+		}
+
+		std::stringstream stream;
+		Profiler::sInstance->WriteChromeTrace(stream);
+		std::string trace = stream.str();
+
+		JPH_PROFILE_END();
+
+		// Only the last 3 frames should be in the trace
+		CHECK(trace.rfind(R"({"displayTimeUnit":"ms","traceEvents":[)", 0) == 0);
+		CHECK(sCountOccurrences(trace, R"("name":"OldFrame")") == 0);
+		CHECK(sCountOccurrences(trace, R"("name":"Outer")") == 3);
+		CHECK(sCountOccurrences(trace, R"("name":"Inner")") == 3);
+		CHECK(sCountOccurrences(trace, R"("ph":"i")") == 3);
+
+		// Inner inherits the color of Outer
+		CHECK(sCountOccurrences(trace, R"("color":"#ff0000")") == 6);
+
+		// Thread name is escaped
+		CHECK(sCountOccurrences(trace, R"({"name":"thread_name","ph":"M","pid":0,"tid":0,"args":{"name":"Main \"Thread\""}})") == 1);
+	}
+}
+
+#endif // JPH_PROFILE_ENABLED
@@ -4,12 +4,18 @@
 
 #include "UnitTestFramework.h"
 #include <Jolt/Physics/Collision/BroadPhase/BroadPhaseQuadTree.h>
+#include <Jolt/Physics/Collision/BroadPhase/BroadPhaseSAP.h>
 #include <Jolt/Physics/Collision/Shape/BoxShape.h>
 #include <Jolt/Physics/Collision/CollisionCollectorImpl.h>
 #include <Jolt/Physics/Collision/RayCast.h>
 #include <Jolt/Physics/Collision/CastResult.h>
+#include <Jolt/Physics/Collision/AABoxCast.h>
+#include <Jolt/Geometry/RayAABox.h>
 #include <Jolt/Physics/Body/BodyManager.h>
 #include <Jolt/Physics/Body/BodyCreationSettings.h>
+#include <Jolt/Physics/PhysicsSettings.h>
+#include <Jolt/Core/JobSystemThreadPool.h>
+#include "PhysicsTestContext.h"
 #include "Layers.h"
 
 TEST_SUITE("BroadPhaseTests")
@@ -112,4 +118,466 @@ TEST_SUITE("BroadPhaseTests")
 		CHECK_APPROX_EQUAL(collector.mHits[0].mFraction, 0.5f);
 		collector.Reset();
 	}
+
+	// Create a grid of static boxes, the first row is put in a different layer so that both a large layer and a small layer are created
+	static void sCreateBoxGrid(BodyManager &ioBodyManager, int inGridSize, Array<BodyID> &outBodyIDs)
+	{
+		RefConst<Shape> box_shape = new BoxShape(Vec3::sReplicate(0.25f));
+		for (int x = 0; x < inGridSize; ++x)
+			for (int z = 0; z < inGridSize; ++z)
+			{
+				BodyCreationSettings settings(box_shape, RVec3(Real(x), 0, Real(z)), Quat::sIdentity(), EMotionType::Static, x == 0? Layers::MOVING : Layers::NON_MOVING);
+				Body &body = *ioBodyManager.AllocateBody(settings);
+				ioBodyManager.AddBody(&body);
+				outBodyIDs.push_back(body.GetID());
+			}
+	}
+
+	// Check that all boxes created by sCreateBoxGrid can be found in the broadphase
+	static void sCheckBoxGrid(const BroadPhase &inBroadPhase, const BodyManager &inBodyManager, int inGridSize)
+	{
+		// Test that all bodies can be found
+		AllHitCollisionCollector<CollideShapeBodyCollector> collector;
+		inBroadPhase.CollideAABox(AABox(Vec3(-1, -1, -1), Vec3(float(inGridSize), 1, float(inGridSize))), collector, BroadPhaseLayerFilter(), ObjectLayerFilter());
+		CHECK(collector.mHits.size() == size_t(inGridSize * inGridSize));
+
+		// Test that every body can be found at its own location
+		for (int x = 0; x < inGridSize; ++x)
+			for (int z = 0; z < inGridSize; ++z)
+			{
+				collector.Reset();
+				inBroadPhase.CollidePoint(Vec3(float(x), 0, float(z)), collector, BroadPhaseLayerFilter(), ObjectLayerFilter());
+				CHECK(collector.mHits.size() == 1);
+				CHECK(inBodyManager.GetBodies()[collector.mHits[0].GetIndex()]->GetPosition() == RVec3(Real(x), 0, Real(z)));
+			}
+	}
+
+	TEST_CASE("TestBroadPhaseAddBodiesParallel")
+	{
+		BPLayerInterfaceImpl broad_phase_layer_interface;
+
+		// Create body manager
+		const int cGridSize = 50;
+		const int cNumBodies = cGridSize * cGridSize;
+		BodyManager body_manager;
+		body_manager.Init(cNumBodies, 0, broad_phase_layer_interface);
+
+		// Create quad tree
+		BroadPhaseQuadTree broadphase;
+		broadphase.Init(&body_manager, broad_phase_layer_interface);
+
+		// Add a grid of boxes to the broadphase using a job system
+		Array<BodyID> ids;
+		sCreateBoxGrid(body_manager, cGridSize, ids);
+		JobSystemThreadPool job_system(cMaxPhysicsJobs, cMaxPhysicsBarriers, 2);
+		BroadPhase::AddState add_state = broadphase.AddBodiesPrepare(ids.data(), cNumBodies, &job_system);
+		broadphase.AddBodiesFinalize(ids.data(), cNumBodies, add_state);
+		sCheckBoxGrid(broadphase, body_manager, cGridSize);
+
+		// Remove all bodies again
+		broadphase.RemoveBodies(ids.data(), cNumBodies);
+		AllHitCollisionCollector<CollideShapeBodyCollector> collector;
+		broadphase.CollideAABox(AABox(Vec3(-1, -1, -1), Vec3(cGridSize, 1, cGridSize)), collector, BroadPhaseLayerFilter(), ObjectLayerFilter());
+		CHECK(collector.mHits.empty());
+	}
+
+	TEST_CASE("TestBroadPhaseOptimizeParallel")
+	{
+		BPLayerInterfaceImpl broad_phase_layer_interface;
+
+		// Create body manager
+		const int cGridSize = 50;
+		const int cNumBodies = cGridSize * cGridSize;
+		BodyManager body_manager;
+		body_manager.Init(cNumBodies, 0, broad_phase_layer_interface);
+
+		// Create quad tree
+		BroadPhaseQuadTree broadphase;
+		broadphase.Init(&body_manager, broad_phase_layer_interface);
+
+		// Create a grid of boxes and add them one by one so that the tree is badly balanced
+		Array<BodyID> ids;
+		sCreateBoxGrid(body_manager, cGridSize, ids);
+		for (BodyID &id : ids)
+		{
+			BroadPhase::AddState add_state = broadphase.AddBodiesPrepare(&id, 1);
+			broadphase.AddBodiesFinalize(&id, 1, add_state);
+		}
+
+		// Rebuild the trees using a job system
+		JobSystemThreadPool job_system(cMaxPhysicsJobs, cMaxPhysicsBarriers, 2);
+		broadphase.Optimize(&job_system);
+		sCheckBoxGrid(broadphase, body_manager, cGridSize);
+
+		// Optimize again, this time the old tree needs to be discarded first
+		broadphase.Optimize(&job_system);
+		sCheckBoxGrid(broadphase, body_manager, cGridSize);
+	}
+
+	TEST_CASE("TestBroadPhaseUpdateBatched")
+	{
+		BPLayerInterfaceImpl broad_phase_layer_interface;
+
+		// Create body manager
+		const int cGridSize = 50;
+		const int cNumBodies = cGridSize * cGridSize;
+		BodyManager body_manager;
+		body_manager.Init(cNumBodies, 0, broad_phase_layer_interface);
+
+		// Create quad tree
+		BroadPhaseQuadTree broadphase;
+		broadphase.Init(&body_manager, broad_phase_layer_interface);
+
+		// Create a grid of boxes and add them one by one so that both trees need an update
+		Array<BodyID> ids;
+		sCreateBoxGrid(body_manager, cGridSize, ids);
+		for (BodyID &id : ids)
+		{
+			BroadPhase::AddState add_state = broadphase.AddBodiesPrepare(&id, 1);
+			broadphase.AddBodiesFinalize(&id, 1, add_state);
+		}
+
+		// Every update rebuilds one layer, build the batches in reverse order to check that they don't depend on each other
+		uint total_batches = 0;
+		for (int layer = 0; layer < 2; ++layer)
+		{
+			broadphase.FrameSync();
+			broadphase.LockModifications();
+			BroadPhase::UpdateState update_state;
+			uint num_batches = broadphase.UpdatePrepareBegin(update_state);
+			if (num_batches > 0)
+			{
+				for (uint batch = num_batches; batch > 0; --batch)
+					broadphase.UpdatePrepareBatch(update_state, batch - 1);
+				broadphase.UpdatePrepareEnd(update_state);
+			}
+			broadphase.UpdateFinalize(update_state);
+			broadphase.UnlockModifications();
+			total_batches += num_batches;
+		}
+
+		// Only the large layer should have been split up
+		CHECK(total_batches == QuadTree::cNumAddBatches);
+		sCheckBoxGrid(broadphase, body_manager, cGridSize);
+	}
+
+	TEST_CASE("TestBroadPhaseSAP")
+	{
+		BPLayerInterfaceImpl broad_phase_layer_interface;
+
+		// Create body manager
+		const int cNumBodies = 1000;
+		BodyManager body_manager;
+		body_manager.Init(cNumBodies + 1, 0, broad_phase_layer_interface);
+
+		// Create sweep and prune broadphase
+		BroadPhaseSAP broadphase;
+		broadphase.Init(&body_manager, broad_phase_layer_interface);
+
+		// Create a floor, this is a lot bigger than the other bodies
+		BodyCreationSettings floor_settings(new BoxShape(Vec3(200, 1, 200)), RVec3(0, -1, 0), Quat::sIdentity(), EMotionType::Static, Layers::NON_MOVING);
+		Body &floor = *body_manager.AllocateBody(floor_settings);
+		body_manager.AddBody(&floor);
+		Array<BodyID> ids;
+		ids.push_back(floor.GetID());
+
+		// Create bodies spread out over a plane
+		UnitTestRandom random;
+		uniform_real_distribution<float> position(-100.0f, 100.0f);
+		uniform_real_distribution<float> height(0.0f, 4.0f);
+		uniform_real_distribution<float> size(0.1f, 2.0f);
+		for (int i = 0; i < cNumBodies; ++i)
+		{
+			BodyCreationSettings settings(new BoxShape(Vec3(size(random), size(random), size(random))), RVec3(position(random), height(random), position(random)), Quat::sIdentity(), EMotionType::Dynamic, (i & 1)? Layers::MOVING : Layers::NON_MOVING);
+			Body &body = *body_manager.AllocateBody(settings);
+			body_manager.AddBody(&body);
+			ids.push_back(body.GetID());
+		}
+
+		// Add half of the bodies in one batch and the other half one by one so that both the sorted and unsorted lists are used
+		int num_in_batch = (int)ids.size() / 2;
+		BroadPhase::AddState add_state = broadphase.AddBodiesPrepare(ids.data(), num_in_batch);
+		broadphase.AddBodiesFinalize(ids.data(), num_in_batch, add_state);
+		for (int i = num_in_batch; i < (int)ids.size(); ++i)
+		{
+			BodyID id = ids[i];
+			add_state = broadphase.AddBodiesPrepare(&id, 1);
+			broadphase.AddBodiesFinalize(&id, 1, add_state);
+		}
+
+		// Function that compares the results of queries with a brute force approach
+		auto check_queries = [&broadphase, &body_manager, &random, &height]()
+		{
+			uniform_real_distribution<float> query_position(-110.0f, 110.0f);
+			uniform_real_distribution<float> query_size(0.1f, 20.0f);
+
+			// Get the expected hits
+			auto get_expected = [&body_manager](const function<bool(const AABox &)> &inFilter)
+			{
+				Array<BodyID> expected;
+				for (const Body *b : body_manager.GetBodies())
+					if (b->IsInBroadPhase() && inFilter(b->GetWorldSpaceBounds()))
+						expected.push_back(b->GetID());
+				sort(expected.begin(), expected.end());
+				return expected;
+			};
+
+			// Get the actual hits
+			auto get_actual = [](const auto &inHits)
+			{
+				Array<BodyID> actual;
+				for (const auto &h : inHits)
+				{
+					if constexpr (std::is_same_v<std::decay_t<decltype(h)>, BodyID>)
+						actual.push_back(h);
+					else
+						actual.push_back(h.mBodyID);
+				}
+				sort(actual.begin(), actual.end());
+				return actual;
+			};
+
+			for (int i = 0; i < 20; ++i)
+			{
+				Vec3 center(query_position(random), height(random), query_position(random));
+				Vec3 extent(query_size(random), query_size(random), query_size(random));
+				AABox box(center - extent, center + extent);
+
+				// Test collide box
+				AllHitCollisionCollector<CollideShapeBodyCollector> collide_collector;
+				broadphase.CollideAABox(box, collide_collector, BroadPhaseLayerFilter(), ObjectLayerFilter());
+				CHECK(get_actual(collide_collector.mHits) == get_expected([&box](const AABox &inBounds) { return inBounds.Overlaps(box); }));
+
+				// Test collide sphere
+				float radius = extent.GetX();
+				collide_collector.Reset();
+				broadphase.CollideSphere(center, radius, collide_collector, BroadPhaseLayerFilter(), ObjectLayerFilter());
+				CHECK(get_actual(collide_collector.mHits) == get_expected([center, radius](const AABox &inBounds) { return inBounds.GetSqDistanceTo(center) <= Square(radius); }));
+
+				// Test collide point
+				collide_collector.Reset();
+				broadphase.CollidePoint(center, collide_collector, BroadPhaseLayerFilter(), ObjectLayerFilter());
+				CHECK(get_actual(collide_collector.mHits) == get_expected([center](const AABox &inBounds) { return inBounds.Contains(center); }));
+
+				// Test cast ray
+				Vec3 direction = 10.0f * extent;
+				AllHitCollisionCollector<RayCastBodyCollector> ray_collector;
+				broadphase.CastRay({ center, direction }, ray_collector, BroadPhaseLayerFilter(), ObjectLayerFilter());
+				CHECK(get_actual(ray_collector.mHits) == get_expected([center, direction](const AABox &inBounds) { return RayAABoxHits(center, direction, inBounds.mMin, inBounds.mMax); }));
+
+				// Test cast box
+				AABox small_box(center - 0.1f * extent, center + 0.1f * extent);
+				AllHitCollisionCollector<CastShapeBodyCollector> cast_collector;
+				broadphase.CastAABox({ small_box, direction }, cast_collector, BroadPhaseLayerFilter(), ObjectLayerFilter());
+				Vec3 small_extent = small_box.GetExtent();
+				CHECK(get_actual(cast_collector.mHits) == get_expected([center, direction, small_extent](const AABox &inBounds) { return RayAABoxHits(center, direction, inBounds.mMin - small_extent, inBounds.mMax + small_extent); }));
+			}
+		};
+		check_queries();
+
+		// Check that the unsorted list was used and that the floor is found
+		AllHitCollisionCollector<CollideShapeBodyCollector> collector;
+		broadphase.CollidePoint(Vec3(150, -1, 150), collector, BroadPhaseLayerFilter(), ObjectLayerFilter());
+		CHECK(collector.mHits.size() == 1);
+		CHECK(collector.mHits[0] == floor.GetID());
+
+		// Move bodies around outside of the physics update
+		uniform_int_distribution<uint> body_index(1, cNumBodies);
+		for (int i = 0; i < 100; ++i)
+		{
+			Body &body = *body_manager.GetBodies()[ids[body_index(random)].GetIndex()];
+			body.SetPositionAndRotationInternal(RVec3(position(random), height(random), position(random)), Quat::sIdentity());
+			BodyID id = body.GetID();
+			broadphase.NotifyBodiesAABBChanged(&id, 1, true);
+		}
+		check_queries();
+
+		// Move bodies around as if we're inside the physics update
+		broadphase.LockModifications();
+		Array<BodyID> moved_ids;
+		for (int i = 0; i < 500; ++i)
+		{
+			Body &body = *body_manager.GetBodies()[ids[body_index(random)].GetIndex()];
+			body.SetPositionAndRotationInternal(body.GetPosition() + RVec3(position(random), 0, position(random)) / 50, Quat::sIdentity());
+			moved_ids.push_back(body.GetID());
+		}
+		broadphase.NotifyBodiesAABBChanged(moved_ids.data(), (int)moved_ids.size(), false);
+		broadphase.UnlockModifications();
+		check_queries();
+
+		// Update the broadphase, this re-sorts the layers
+		broadphase.LockModifications();
+		BroadPhase::UpdateState update_state = broadphase.UpdatePrepare();
+		broadphase.UpdateFinalize(update_state);
+		broadphase.UnlockModifications();
+		broadphase.FrameSync();
+		check_queries();
+
+		// Change the layer of some bodies
+		for (int i = 0; i < 50; ++i)
+		{
+			Body &body = *body_manager.GetBodies()[ids[body_index(random)].GetIndex()];
+			body_manager.SetBodyObjectLayerInternal(body, body.GetObjectLayer() == Layers::MOVING? Layers::NON_MOVING : Layers::MOVING);
+			BodyID id = body.GetID();
+			broadphase.NotifyBodiesLayerChanged(&id, 1);
+		}
+		check_queries();
+
+		// Remove some bodies
+		Array<BodyID> removed_ids;
+		for (int i = 0; i < 100; ++i)
+		{
+			BodyID id = ids[body_index(random)];
+			if (body_manager.GetBodies()[id.GetIndex()]->IsInBroadPhase()
+				&& std::find(removed_ids.begin(), removed_ids.end(), id) == removed_ids.end())
+				removed_ids.push_back(id);
+		}
+		broadphase.RemoveBodies(removed_ids.data(), (int)removed_ids.size());
+		check_queries();
+
+		// Optimize the broadphase
+		broadphase.Optimize();
+		broadphase.FrameSync();
+		check_queries();
+
+		// Add the removed bodies back
+		add_state = broadphase.AddBodiesPrepare(removed_ids.data(), (int)removed_ids.size());
+		broadphase.AddBodiesFinalize(removed_ids.data(), (int)removed_ids.size(), add_state);
+		check_queries();
+	}
+
+	TEST_CASE("TestBroadPhaseSAPRebuildOnMove")
+	{
+		BPLayerInterfaceImpl broad_phase_layer_interface;
+
+		// Create more bodies than fit in the unsorted list so that moving them forces the layer to be rebuilt
+		const int cNumBodies = 300;
+		static_assert(cNumBodies > BroadPhaseSAP::cMinUnsortedEntries);
+		BodyManager body_manager;
+		body_manager.Init(cNumBodies, 0, broad_phase_layer_interface);
+
+		BroadPhaseSAP broadphase;
+		broadphase.Init(&body_manager, broad_phase_layer_interface);
+
+		// Add static boxes one by one
+		RefConst<Shape> box_shape = new BoxShape(Vec3::sReplicate(0.25f));
+		Array<BodyID> ids;
+		for (int i = 0; i < cNumBodies; ++i)
+		{
+			BodyCreationSettings settings(box_shape, RVec3(Real(i), 0, 0), Quat::sIdentity(), EMotionType::Static, Layers::NON_MOVING);
+			Body &body = *body_manager.AllocateBody(settings);
+			body_manager.AddBody(&body);
+			BodyID id = body.GetID();
+			BroadPhase::AddState add_state = broadphase.AddBodiesPrepare(&id, 1);
+			broadphase.AddBodiesFinalize(&id, 1, add_state);
+			ids.push_back(id);
+		}
+
+		// Move every body outside of the physics update, the bodies also move backwards along the sort axis so that a new entry sorts before the old entry of the same body
+		for (BodyID id : ids)
+		{
+			Body &body = *body_manager.GetBodies()[id.GetIndex()];
+			body.SetPositionAndRotationInternal(body.GetPosition() + RVec3(-0.5_r, 0, 10), Quat::sIdentity());
+			broadphase.NotifyBodiesAABBChanged(&id, 1, true);
+		}
+
+		// Test that every body is found at its new location only
+		auto check_moved = [&broadphase, &ids]()
+		{
+			AllHitCollisionCollector<CollideShapeBodyCollector> collector;
+			for (int i = 0; i < cNumBodies; ++i)
+			{
+				collector.Reset();
+				broadphase.CollidePoint(Vec3(float(i), 0, 0), collector, BroadPhaseLayerFilter(), ObjectLayerFilter());
+				CHECK(collector.mHits.empty());
+
+				collector.Reset();
+				broadphase.CollidePoint(Vec3(float(i) - 0.5f, 0, 10), collector, BroadPhaseLayerFilter(), ObjectLayerFilter());
+				CHECK(collector.mHits.size() == 1);
+				CHECK(collector.mHits[0] == ids[i]);
+			}
+		};
+		check_moved();
+
+		// Check again after optimizing and after an update
+		broadphase.Optimize();
+		broadphase.FrameSync();
+		check_moved();
+		broadphase.LockModifications();
+		BroadPhase::UpdateState update_state = broadphase.UpdatePrepare();
+		broadphase.UpdateFinalize(update_state);
+		broadphase.UnlockModifications();
+		broadphase.FrameSync();
+		check_moved();
+	}
+
+	TEST_CASE("TestBroadPhaseSAPAddOneByOne")
+	{
+		BPLayerInterfaceImpl broad_phase_layer_interface;
+
+		// Create a lot more bodies than fit in the initial unsorted list
+		const int cNumBodies = 20000;
+		BodyManager body_manager;
+		body_manager.Init(cNumBodies, 0, broad_phase_layer_interface);
+
+		BroadPhaseSAP broadphase;
+		broadphase.Init(&body_manager, broad_phase_layer_interface);
+
+		// Add static boxes one by one without calling FrameSync
+		RefConst<Shape> box_shape = new BoxShape(Vec3::sReplicate(0.25f));
+		Array<BodyID> ids;
+		for (int i = 0; i < cNumBodies; ++i)
+		{
+			BodyCreationSettings settings(box_shape, RVec3(Real(i), 0, 0), Quat::sIdentity(), EMotionType::Static, Layers::NON_MOVING);
+			Body &body = *body_manager.AllocateBody(settings);
+			body_manager.AddBody(&body);
+			BodyID id = body.GetID();
+			BroadPhase::AddState add_state = broadphase.AddBodiesPrepare(&id, 1);
+			broadphase.AddBodiesFinalize(&id, 1, add_state);
+			ids.push_back(id);
+		}
+
+		// The unsorted list grows with the layer, so the layers that are replaced while adding form a geometric series.
+		// If the layer was rebuilt for every body after the first cMinUnsortedEntries this would retain about cNumBodies^2 / 2 entries (~10 GB).
+		size_t retired_size = broadphase.GetRetiredDataSize();
+		CHECK(retired_size > 0);
+		CHECK(retired_size < 1024 * cNumBodies);
+
+		// Optimize should free all replaced layers
+		broadphase.Optimize();
+		CHECK(broadphase.GetRetiredDataSize() == 0);
+
+		// Check that all bodies can be found
+		AllHitCollisionCollector<CollideShapeBodyCollector> collector;
+		for (int i = 0; i < cNumBodies; i += 97)
+		{
+			collector.Reset();
+			broadphase.CollidePoint(Vec3(float(i), 0, 0), collector, BroadPhaseLayerFilter(), ObjectLayerFilter());
+			CHECK(collector.mHits.size() == 1);
+			CHECK(collector.mHits[0] == ids[i]);
+		}
+	}
+
+	TEST_CASE("TestBroadPhaseSAPSimulation")
+	{
+		for (EBroadPhaseType type : { EBroadPhaseType::QuadTree, EBroadPhaseType::SweepAndPrune })
+		{
+			PhysicsTestContext c(1.0f / 60.0f, 1, 1, 1024, 4096, 1024, type);
+			c.CreateFloor();
+
+			// Drop a grid of boxes on the floor
+			const int cGridSize = 10;
+			const Vec3 cHalfExtent = Vec3::sReplicate(0.5f);
+			Array<BodyID> ids;
+			for (int x = 0; x < cGridSize; ++x)
+				for (int z = 0; z < cGridSize; ++z)
+					ids.push_back(c.CreateBox(RVec3(2.0_r * x, 2.0_r, 2.0_r * z), Quat::sIdentity(), EMotionType::Dynamic, EMotionQuality::Discrete, Layers::MOVING, cHalfExtent).GetID());
+
+			c.Simulate(2.0f);
+
+			// Check that all boxes came to rest on the floor (within the penetration slop)
+			for (BodyID id : ids)
+				CHECK_APPROX_EQUAL(c.GetBodyInterface().GetPosition(id).GetY(), cHalfExtent.GetY(), 5.0e-2_r);
+		}
+	}
 }
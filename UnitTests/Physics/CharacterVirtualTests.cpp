@@ -9,6 +9,9 @@
 #include <Jolt/Physics/Collision/Shape/MeshShape.h>
 #include <Jolt/Physics/Collision/Shape/BoxShape.h>
 #include <Jolt/Physics/Character/CharacterVirtual.h>
+#include <Jolt/Physics/Character/CharacterVirtualBatchUpdater.h>
+#include <Jolt/Physics/Character/CharacterVsCharacterGrid.h>
+#include <Jolt/Physics/StateRecorderImpl.h>
 #include "Layers.h"
 
 TEST_SUITE("CharacterVirtualTests")
@@ -110,6 +113,9 @@ TEST_SUITE("CharacterVirtualTests")
 		// Calculated effective velocity after a step
 		Vec3					mEffectiveVelocity = Vec3::sZero();
 
+		// Number of times that OnCharacterContactAdded was called
+		int						mNumCharacterContactsAdded = 0;
+
 	private:
 		// CharacterContactListener callback
 		virtual void			OnContactSolve(const CharacterVirtual *inCharacter, const BodyID &inBodyID2, const SubShapeID &inSubShapeID2, RVec3Arg inContactPosition, Vec3Arg inContactNormal, Vec3Arg inContactVelocity, const PhysicsMaterial *inContactMaterial, Vec3Arg inCharacterVelocity, Vec3 &ioNewCharacterVelocity) override
@@ -119,6 +125,11 @@ TEST_SUITE("CharacterVirtualTests")
 				ioNewCharacterVelocity = Vec3::sZero();
 		}
 
+		virtual void			OnCharacterContactAdded(const CharacterVirtual *inCharacter, const CharacterVirtual *inOtherCharacter, const SubShapeID &inSubShapeID2, RVec3Arg inContactPosition, Vec3Arg inContactNormal, CharacterContactSettings &ioSettings) override
+		{
+			++mNumCharacterContactsAdded;
+		}
+
 		PhysicsTestContext &	mContext;
 	};
 
@@ -677,4 +688,288 @@ TEST_SUITE("CharacterVirtualTests")
 			}
 		}
 	}
+
+	TEST_CASE("TestReuseContactsWhenResting")
+	{
+		PhysicsTestContext c;
+		c.CreateFloor();
+
+		// Create character that can reuse its contacts
+		Character character(c);
+		character.mCharacterSettings.mRestingTolerance = 1.0e-3f;
+		character.Create();
+
+		// Let the character settle on the floor
+		character.Simulate(0.5f);
+		CHECK(character.mCharacter->GetGroundState() == CharacterBase::EGroundState::OnGround);
+		RVec3 resting_position = character.mCharacter->GetPosition();
+		size_t num_contacts = character.mCharacter->GetActiveContacts().size();
+
+		// While resting the contacts should be reused and nothing should change
+		for (int step = 0; step < 10; ++step)
+		{
+			character.Step();
+			CHECK(character.mCharacter->GetReusedContacts());
+			CHECK(character.mCharacter->GetGroundState() == CharacterBase::EGroundState::OnGround);
+			CHECK(character.mCharacter->GetPosition() == resting_position);
+			CHECK(character.mCharacter->GetActiveContacts().size() == num_contacts);
+		}
+
+		// Drop a box next to the character, the character should do collision queries again while the box is moving
+		BodyID box_id = c.CreateBox(RVec3(0.5f, 2.0f, 0), Quat::sIdentity(), EMotionType::Dynamic, EMotionQuality::Discrete, Layers::MOVING, Vec3::sReplicate(0.1f)).GetID();
+		character.Step();
+		CHECK(!character.mCharacter->GetReusedContacts());
+
+		// Once the box sleeps the character should reuse its contacts again
+		for (int step = 0; step < 300 && c.GetBodyInterface().IsActive(box_id); ++step)
+			character.Step();
+		CHECK(!c.GetBodyInterface().IsActive(box_id));
+		character.Step();
+		character.Step();
+		CHECK(character.mCharacter->GetReusedContacts());
+
+		// When the character starts walking it should do collision queries again
+		character.mHorizontalSpeed = Vec3(-1, 0, 0);
+		character.Step();
+		CHECK(!character.mCharacter->GetReusedContacts());
+		CHECK(character.mCharacter->GetPosition().GetX() < resting_position.GetX());
+
+		// A character that doesn't have a resting tolerance should never reuse its contacts
+		Character character2(c);
+		character2.mInitialPosition = RVec3(-5, 0, 0);
+		character2.Create();
+		character2.Simulate(0.5f);
+		CHECK(!character2.mCharacter->GetReusedContacts());
+	}
+
+	TEST_CASE("TestReuseContactsWhenCreeping")
+	{
+		PhysicsTestContext c;
+		c.CreateFloor();
+
+		// Create character that can reuse its contacts
+		Character character(c);
+		character.mCharacterSettings.mRestingTolerance = 1.0e-3f;
+		character.Create();
+
+		// Let the character settle on the floor
+		character.Simulate(0.5f);
+		CHECK(character.mCharacter->GetReusedContacts());
+		RVec3 start_position = character.mCharacter->GetPosition();
+
+		// Let the character creep so slowly that it moves less than the resting tolerance every step
+		const float cSpeed = 0.03f;
+		CHECK(cSpeed * c.GetDeltaTime() < character.mCharacterSettings.mRestingTolerance);
+		character.mHorizontalSpeed = Vec3(cSpeed, 0, 0);
+		int num_reused = 0;
+		const int cNumSteps = 60;
+		for (int step = 0; step < cNumSteps; ++step)
+		{
+			character.Step();
+			if (character.mCharacter->GetReusedContacts())
+				++num_reused;
+		}
+
+		// The character should move at the requested speed and some of the steps should have reused the contacts
+		CHECK_APPROX_EQUAL(character.mCharacter->GetPosition(), start_position + RVec3(cSpeed * cNumSteps * c.GetDeltaTime(), 0, 0), 1.0e-4f);
+		CHECK(num_reused > 0);
+		CHECK(num_reused < cNumSteps);
+
+		// When the character stops it should rest at its new position (it can drift at most the resting tolerance before the contacts are determined again)
+		character.mHorizontalSpeed = Vec3::sZero();
+		character.Step();
+		RVec3 resting_position = character.mCharacter->GetPosition();
+		character.Step();
+		character.Step();
+		CHECK(character.mCharacter->GetReusedContacts());
+		CHECK_APPROX_EQUAL(character.mCharacter->GetPosition(), resting_position, character.mCharacterSettings.mRestingTolerance);
+	}
+
+	TEST_CASE("TestCharacterVsCharacter")
+	{
+		for (bool use_grid : { false, true })
+		{
+			PhysicsTestContext c;
+			c.CreateFloor();
+
+			// Create two characters that walk towards each other
+			Character character1(c);
+			character1.mInitialPosition = RVec3(-2, 0, 0);
+			character1.mHorizontalSpeed = Vec3(1, 0, 0);
+			character1.Create();
+
+			Character character2(c);
+			character2.mInitialPosition = RVec3(2, 0, 0);
+			character2.mHorizontalSpeed = Vec3(-1, 0, 0);
+			character2.Create();
+
+			CharacterVsCharacterGrid grid;
+			if (use_grid)
+			{
+				grid.Add(character1.mCharacter);
+				grid.Add(character2.mCharacter);
+				character1.mCharacter->SetCharacterVsCharacterGrid(&grid);
+				character2.mCharacter->SetCharacterVsCharacterGrid(&grid);
+			}
+
+			for (int step = 0; step < 180; ++step)
+			{
+				grid.Update();
+				character1.Step();
+				character2.Step();
+			}
+
+			float x1 = float(character1.mCharacter->GetPosition().GetX());
+			float x2 = float(character2.mCharacter->GetPosition().GetX());
+			if (use_grid)
+			{
+				// The characters should have stopped in front of each other
+				float min_distance = character1.mRadiusStanding + character2.mRadiusStanding;
+				CHECK(x2 - x1 > min_distance - 0.05f);
+				CHECK(x2 - x1 < min_distance + 0.1f);
+				CHECK(character1.mNumCharacterContactsAdded > 0);
+				CHECK(character2.mNumCharacterContactsAdded > 0);
+			}
+			else
+			{
+				// The characters should have walked through each other
+				CHECK_APPROX_EQUAL(x1, 1.0f, 1.0e-2f);
+				CHECK_APPROX_EQUAL(x2, -1.0f, 1.0e-2f);
+				CHECK(character1.mNumCharacterContactsAdded == 0);
+			}
+		}
+	}
+
+	TEST_CASE("TestCharacterVsCharacterStateAndRemove")
+	{
+		PhysicsTestContext c;
+		c.CreateFloor();
+
+		// Create two characters that walk into each other
+		Character character1(c);
+		character1.mInitialPosition = RVec3(-1, 0, 0);
+		character1.mHorizontalSpeed = Vec3(1, 0, 0);
+		character1.Create();
+
+		Character character2(c);
+		character2.mInitialPosition = RVec3(1, 0, 0);
+		character2.Create();
+
+		// The grid assigns the IDs
+		CharacterVsCharacterGrid grid;
+		grid.Add(character1.mCharacter);
+		grid.Add(character2.mCharacter);
+		character1.mCharacter->SetCharacterVsCharacterGrid(&grid);
+		character2.mCharacter->SetCharacterVsCharacterGrid(&grid);
+		CHECK(character1.mCharacter->GetID() == 1);
+		CHECK(character2.mCharacter->GetID() == 2);
+		CHECK(grid.FindCharacter(2) == character2.mCharacter);
+
+		auto has_contact_with = [](const CharacterVirtual *inCharacter, const CharacterVirtual *inOther) {
+			for (const CharacterVirtual::Contact &contact : inCharacter->GetActiveContacts())
+				if (contact.mCharacterB == inOther)
+					return true;
+			return false;
+		};
+
+		for (int step = 0; step < 120; ++step)
+		{
+			grid.Update();
+			character1.Step();
+			character2.Step();
+		}
+		CHECK(has_contact_with(character1.mCharacter, character2.mCharacter));
+
+		// Save and restore the state, the contact with the other character should be restored
+		StateRecorderImpl state;
+		character1.mCharacter->SaveState(state);
+		state.Rewind();
+		character1.mCharacter->RestoreState(state);
+		CHECK(!state.IsFailed());
+		CHECK(has_contact_with(character1.mCharacter, character2.mCharacter));
+
+		// Removing a character from the grid removes the contacts of other characters with it
+		grid.Remove(character2.mCharacter);
+		CHECK(grid.FindCharacter(2) == nullptr);
+		CHECK(!has_contact_with(character1.mCharacter, character2.mCharacter));
+
+		// The remaining character should no longer be blocked
+		float x2 = float(character2.mCharacter->GetPosition().GetX());
+		for (int step = 0; step < 60; ++step)
+		{
+			grid.Update();
+			character1.Step();
+		}
+		CHECK(float(character1.mCharacter->GetPosition().GetX()) > x2);
+	}
+
+	TEST_CASE("TestBatchUpdater")
+	{
+		// Simulates a grid of characters that walk into dynamic boxes using the batch updater and returns the final positions of characters and boxes
+		auto simulate = [](int inWorkerThreads, uint inMaxJobs) {
+			PhysicsTestContext c(1.0f / 60.0f, 1, inWorkerThreads);
+			c.CreateFloor();
+
+			Array<BodyID> boxes;
+			Array<RVec3> box_start_positions;
+			Array<Ref<CharacterVirtual>> characters;
+			Array<CharacterVirtual *> character_ptrs;
+			RefConst<Shape> shape = RotatedTranslatedShapeSettings(Vec3(0, 1.0f, 0), Quat::sIdentity(), new CapsuleShape(0.5f, 0.3f)).Create().Get();
+			for (int x = 0; x < 8; ++x)
+				for (int z = 0; z < 8; ++z)
+				{
+					// Put a box in front of every other character
+					RVec3 position(Real(2.0f * x), 0, Real(4.0f * z));
+					if ((x + z) % 2 == 0)
+					{
+						box_start_positions.push_back(position + RVec3(0, 0.5f, 1.0f));
+						boxes.push_back(c.CreateBox(box_start_positions.back(), Quat::sIdentity(), EMotionType::Dynamic, EMotionQuality::Discrete, Layers::MOVING, Vec3::sReplicate(0.3f)).GetID());
+					}
+
+					CharacterVirtualSettings settings;
+					settings.mShape = shape;
+					settings.mMaxStrength = 1000.0f;
+					Ref<CharacterVirtual> character = new CharacterVirtual(&settings, position, Quat::sIdentity(), 0, c.GetSystem());
+					characters.push_back(character);
+					character_ptrs.push_back(character);
+				}
+
+			PhysicsSystem *system = c.GetSystem();
+			CharacterVirtualBatchUpdater updater(inMaxJobs, 1024 * 1024);
+			for (int step = 0; step < 60; ++step)
+			{
+				c.SimulateSingleStep();
+
+				for (CharacterVirtual *character : characters)
+					character->SetLinearVelocity(Vec3(0, character->GetLinearVelocity().GetY(), 2.0f) + system->GetGravity() * c.GetDeltaTime());
+
+				updater.ExtendedUpdate(character_ptrs.data(), (uint)character_ptrs.size(), c.GetDeltaTime(), system->GetGravity(), { }, system->GetDefaultBroadPhaseLayerFilter(Layers::MOVING), system->GetDefaultLayerFilter(Layers::MOVING), { }, { }, *c.GetJobSystem());
+			}
+
+			Array<RVec3> positions;
+			for (const CharacterVirtual *character : characters)
+			{
+				// Impulses should no longer be deferred after the update
+				CHECK(!character->GetDeferImpulses());
+				positions.push_back(character->GetPosition());
+			}
+			for (size_t i = 0; i < boxes.size(); ++i)
+			{
+				// Boxes should have been pushed by the characters
+				RVec3 position = c.GetBodyInterface().GetPosition(boxes[i]);
+				CHECK(position.GetZ() > box_start_positions[i].GetZ() + 0.5f);
+				positions.push_back(position);
+			}
+			return positions;
+		};
+
+		// The result should not depend on the number of threads or jobs
+		Array<RVec3> reference = simulate(0, 1);
+		for (int worker_threads : { 0, 3 })
+			for (uint max_jobs : { 1u, 4u })
+			{
+				Array<RVec3> positions = simulate(worker_threads, max_jobs);
+				CHECK(positions == reference);
+			}
+	}
 }
@@ -483,4 +483,338 @@ TEST_SUITE("CollideShapeTests")
 
 		CHECK(angle >= 2.0f * JPH_PI);
 	}
+
+	// Collide two shapes with the collision function registered in CollisionDispatch and with the generic GJK / EPA based convex vs convex collision function and check that the results match
+	static void sCompareWithGenericConvexVsConvex(const Shape *inShape1, const Shape *inShape2, Mat44Arg inTransform1, Mat44Arg inTransform2, const CollideShapeSettings &inSettings)
+	{
+		// The box vs convex hull collision function is the generic one
+		CollisionDispatch::CollideShape generic_collide_shape = CollisionDispatch::sGetCollideShape(EShapeSubType::Box, EShapeSubType::ConvexHull);
+		CHECK(generic_collide_shape != CollisionDispatch::sGetCollideShape(inShape1->GetSubType(), inShape2->GetSubType()));
+
+		ClosestHitCollisionCollector<CollideShapeCollector> specialized;
+		CollisionDispatch::sCollideShapeVsShape(inShape1, inShape2, Vec3::sReplicate(1.0f), Vec3::sReplicate(1.0f), inTransform1, inTransform2, SubShapeIDCreator(), SubShapeIDCreator(), inSettings, specialized);
+
+		ClosestHitCollisionCollector<CollideShapeCollector> generic;
+		generic_collide_shape(inShape1, inShape2, Vec3::sReplicate(1.0f), Vec3::sReplicate(1.0f), inTransform1, inTransform2, SubShapeIDCreator(), SubShapeIDCreator(), inSettings, generic, ShapeFilter());
+
+		// Shapes that are just touching can be reported as hit by one and not by the other
+		constexpr float cTolerance = 2.0e-3f;
+		if (specialized.HadHit() != generic.HadHit())
+		{
+			const CollideShapeResult &hit = specialized.HadHit()? specialized.mHit : generic.mHit;
+			CHECK(abs(hit.mPenetrationDepth + inSettings.mMaxSeparationDistance) < cTolerance);
+		}
+		else if (specialized.HadHit())
+		{
+			// Note that the penetration axis is not unique, so we only compare the penetration depth and check that the result is consistent
+			const CollideShapeResult &hit = specialized.mHit;
+			CHECK_APPROX_EQUAL(hit.mPenetrationDepth, generic.mHit.mPenetrationDepth, cTolerance);
+			CHECK_APPROX_EQUAL((hit.mContactPointOn2 - hit.mContactPointOn1).Dot(hit.mPenetrationAxis.Normalized()), -hit.mPenetrationDepth, cTolerance);
+		}
+	}
+
+	TEST_CASE("TestCollideBoxVsBox")
+	{
+		UnitTestRandom random;
+		uniform_real_distribution<float> half_extent(0.2f, 1.0f);
+		uniform_real_distribution<float> position(-1.5f, 1.5f);
+
+		CollideShapeSettings settings;
+		for (int i = 0; i < 1000; ++i)
+		{
+			// Box without convex radius so that the generic algorithm returns exact results
+			RefConst<Shape> box1 = new BoxShape(Vec3(half_extent(random), half_extent(random), half_extent(random)), 0.0f);
+			RefConst<Shape> box2 = new BoxShape(Vec3(half_extent(random), half_extent(random), half_extent(random)), 0.0f);
+			Mat44 transform1 = Mat44::sRotation(Quat::sRandom(random));
+			Mat44 transform2 = Mat44::sRotationTranslation(Quat::sRandom(random), Vec3(position(random), position(random), position(random)));
+			sCompareWithGenericConvexVsConvex(box1, box2, transform1, transform2, settings);
+		}
+
+		// Two boxes stacked with a small gap, should be reported because of the max separation distance
+		RefConst<Shape> box = new BoxShape(Vec3::sReplicate(0.5f), 0.0f);
+		settings.mMaxSeparationDistance = 0.1f;
+		ClosestHitCollisionCollector<CollideShapeCollector> collector;
+		CollisionDispatch::sCollideShapeVsShape(box, box, Vec3::sReplicate(1.0f), Vec3::sReplicate(1.0f), Mat44::sIdentity(), Mat44::sTranslation(Vec3(0.1f, 1.05f, 0.2f)), SubShapeIDCreator(), SubShapeIDCreator(), settings, collector);
+		CHECK(collector.HadHit());
+		CHECK_APPROX_EQUAL(collector.mHit.mPenetrationDepth, -0.05f);
+		CHECK_APPROX_EQUAL(collector.mHit.mPenetrationAxis.Normalized(), Vec3::sAxisY());
+		CHECK_APPROX_EQUAL(collector.mHit.mContactPointOn1.GetY(), 0.5f);
+		CHECK_APPROX_EQUAL(collector.mHit.mContactPointOn2.GetY(), 0.55f);
+	}
+
+	TEST_CASE("TestCollideBoxVsBoxMatchesGJK")
+	{
+		UnitTestRandom random;
+		uniform_real_distribution<float> half_extent(0.2f, 1.0f);
+		uniform_real_distribution<float> position(-1.5f, 1.5f);
+		uniform_real_distribution<float> offset(-0.5f, 0.5f);
+		uniform_real_distribution<float> gap(-0.1f, 0.15f);
+		uniform_real_distribution<float> tilt(-0.1f, 0.1f);
+
+		CollisionDispatch::CollideShape generic_collide_shape = CollisionDispatch::sGetCollideShape(EShapeSubType::Box, EShapeSubType::ConvexHull);
+		auto collide_generic = [generic_collide_shape](const Shape *inShape1, const Shape *inShape2, Mat44Arg inTransform1, Mat44Arg inTransform2, const CollideShapeSettings &inSettings, ClosestHitCollisionCollector<CollideShapeCollector> &ioCollector)
+		{
+			generic_collide_shape(inShape1, inShape2, Vec3::sReplicate(1.0f), Vec3::sReplicate(1.0f), inTransform1, inTransform2, SubShapeIDCreator(), SubShapeIDCreator(), inSettings, ioCollector, ShapeFilter());
+		};
+
+		CollideShapeSettings settings;
+		for (float convex_radius : { 0.0f, 0.05f })
+			for (int i = 0; i < 1000; ++i)
+			{
+				// The second box is sometimes sharp
+				settings.mMaxSeparationDistance = (i & 1)? 0.1f : 0.0f;
+				Vec3 half_extent1(half_extent(random), half_extent(random), half_extent(random));
+				Vec3 half_extent2(half_extent(random), half_extent(random), half_extent(random));
+				float convex_radius1 = convex_radius;
+				float convex_radius2 = (i & 2)? convex_radius : 0.0f;
+				RefConst<Shape> box1 = new BoxShape(half_extent1, convex_radius1);
+				RefConst<Shape> box2 = new BoxShape(half_extent2, convex_radius2);
+
+				// Test a random configuration and a configuration where box 2 rests on box 1 with a small gap or penetration (the common case in a simulation)
+				Mat44 transform1 = Mat44::sRotation(Quat::sRandom(random));
+				Mat44 random_transform2 = Mat44::sRotationTranslation(Quat::sRandom(random), Vec3(position(random), position(random), position(random)));
+				Mat44 resting_transform2 = transform1 * Mat44::sTranslation(Vec3(offset(random), half_extent1.GetY() + half_extent2.GetY() + gap(random), offset(random))) * Mat44::sRotation(Vec3::sAxisX(), tilt(random)) * Mat44::sRotation(Vec3::sAxisZ(), tilt(random));
+				for (Mat44 transform2 : { random_transform2, resting_transform2 })
+				{
+					if (convex_radius == 0.0f)
+					{
+						// Sharp boxes, GJK / EPA returns exact results
+						sCompareWithGenericConvexVsConvex(box1, box2, transform1, transform2, settings);
+						continue;
+					}
+
+					// For rounded boxes, GJK / EPA can switch between the rounded and the sharp result when the boxes that are shrunk by the convex radius are close to touching.
+					// Build an exact reference out of GJK / EPA results for sharp boxes: if the shrunk boxes overlap, the penetration depth is that of the sharp boxes (this is what EPA does for boxes),
+					// otherwise it is the convex radius minus the distance between the shrunk boxes.
+					RefConst<Shape> inner_box1 = new BoxShape(half_extent1 - Vec3::sReplicate(convex_radius1), 0.0f);
+					RefConst<Shape> inner_box2 = new BoxShape(half_extent2 - Vec3::sReplicate(convex_radius2), 0.0f);
+					ClosestHitCollisionCollector<CollideShapeCollector> inner_overlap;
+					collide_generic(inner_box1, inner_box2, transform1, transform2, CollideShapeSettings(), inner_overlap);
+					ClosestHitCollisionCollector<CollideShapeCollector> reference;
+					float reference_depth = 0.0f;
+					if (inner_overlap.HadHit() && inner_overlap.mHit.mPenetrationDepth > 1.0e-3f)
+					{
+						RefConst<Shape> sharp_box1 = new BoxShape(half_extent1, 0.0f);
+						RefConst<Shape> sharp_box2 = new BoxShape(half_extent2, 0.0f);
+						collide_generic(sharp_box1, sharp_box2, transform1, transform2, settings, reference);
+						reference_depth = reference.mHit.mPenetrationDepth;
+					}
+					else if (!inner_overlap.HadHit())
+					{
+						CollideShapeSettings inner_settings = settings;
+						inner_settings.mMaxSeparationDistance += convex_radius1 + convex_radius2;
+						collide_generic(inner_box1, inner_box2, transform1, transform2, inner_settings, reference);
+						reference_depth = reference.mHit.mPenetrationDepth + convex_radius1 + convex_radius2;
+					}
+					else
+						continue; // Shrunk boxes are touching, the result can be either one
+
+					ClosestHitCollisionCollector<CollideShapeCollector> specialized;
+					CollisionDispatch::sCollideShapeVsShape(box1, box2, Vec3::sReplicate(1.0f), Vec3::sReplicate(1.0f), transform1, transform2, SubShapeIDCreator(), SubShapeIDCreator(), settings, specialized);
+
+					// Shapes that are just touching can be reported as hit by one and not by the other
+					constexpr float cTolerance = 2.0e-3f;
+					if (specialized.HadHit() != reference.HadHit())
+						CHECK(abs((specialized.HadHit()? specialized.mHit.mPenetrationDepth : reference_depth) + settings.mMaxSeparationDistance) < cTolerance);
+					else if (specialized.HadHit())
+					{
+						const CollideShapeResult &hit = specialized.mHit;
+						CHECK_APPROX_EQUAL(hit.mPenetrationDepth, reference_depth, cTolerance);
+						CHECK_APPROX_EQUAL((hit.mContactPointOn2 - hit.mContactPointOn1).Dot(hit.mPenetrationAxis.Normalized()), -hit.mPenetrationDepth, cTolerance);
+					}
+				}
+			}
+
+		// Two rounded boxes with their edges pointing at each other. The sharp boxes would overlap by 0.02 but the rounded edges are 0.013 apart.
+		RefConst<Shape> box = new BoxShape(Vec3::sReplicate(0.5f), 0.05f);
+		settings.mMaxSeparationDistance = 0.0f;
+		ClosestHitCollisionCollector<CollideShapeCollector> collector;
+		CollisionDispatch::sCollideShapeVsShape(box, box, Vec3::sReplicate(1.0f), Vec3::sReplicate(1.0f), Mat44::sIdentity(), Mat44::sTranslation(Vec3(0.98f, 0.98f, 0.0f)), SubShapeIDCreator(), SubShapeIDCreator(), settings, collector);
+		CHECK(!collector.HadHit());
+
+		// Two stacked rounded boxes that penetrate by less than the convex radius
+		collector.Reset();
+		CollisionDispatch::sCollideShapeVsShape(box, box, Vec3::sReplicate(1.0f), Vec3::sReplicate(1.0f), Mat44::sIdentity(), Mat44::sTranslation(Vec3(0.1f, 0.99f, 0.2f)), SubShapeIDCreator(), SubShapeIDCreator(), settings, collector);
+		CHECK(collector.HadHit());
+		CHECK_APPROX_EQUAL(collector.mHit.mPenetrationDepth, 0.01f);
+		CHECK_APPROX_EQUAL(collector.mHit.mPenetrationAxis.Normalized(), Vec3::sAxisY());
+		CHECK_APPROX_EQUAL(collector.mHit.mContactPointOn1.GetY(), 0.5f);
+		CHECK_APPROX_EQUAL(collector.mHit.mContactPointOn2.GetY(), 0.49f);
+	}
+
+	TEST_CASE("TestCollideCapsuleVsCapsule")
+	{
+		UnitTestRandom random;
+		uniform_real_distribution<float> radius(0.1f, 0.5f);
+		uniform_real_distribution<float> half_height(0.1f, 1.0f);
+		uniform_real_distribution<float> position(-1.5f, 1.5f);
+
+		CollideShapeSettings settings;
+		for (int i = 0; i < 1000; ++i)
+		{
+			settings.mMaxSeparationDistance = (i & 1)? 0.1f : 0.0f;
+			RefConst<Shape> capsule1 = new CapsuleShape(half_height(random), radius(random));
+			RefConst<Shape> capsule2 = new CapsuleShape(half_height(random), radius(random));
+			Mat44 transform1 = Mat44::sRotation(Quat::sRandom(random));
+			Mat44 transform2 = Mat44::sRotationTranslation(Quat::sRandom(random), Vec3(position(random), position(random), position(random)));
+			sCompareWithGenericConvexVsConvex(capsule1, capsule2, transform1, transform2, settings);
+		}
+
+		// Two parallel capsules next to each other
+		RefConst<Shape> capsule = new CapsuleShape(1.0f, 0.5f);
+		settings.mMaxSeparationDistance = 0.0f;
+		ClosestHitCollisionCollector<CollideShapeCollector> collector;
+		CollisionDispatch::sCollideShapeVsShape(capsule, capsule, Vec3::sReplicate(1.0f), Vec3::sReplicate(1.0f), Mat44::sIdentity(), Mat44::sTranslation(Vec3(0.9f, 0.5f, 0.0f)), SubShapeIDCreator(), SubShapeIDCreator(), settings, collector);
+		CHECK(collector.HadHit());
+		CHECK_APPROX_EQUAL(collector.mHit.mPenetrationDepth, 0.1f);
+		CHECK_APPROX_EQUAL(collector.mHit.mPenetrationAxis.Normalized(), Vec3::sAxisX());
+	}
+
+	// Test that passing warm start data from query to query doesn't change the result of colliding two large convex hulls
+	TEST_CASE("TestCollideShapeWarmStart")
+	{
+		UnitTestRandom random;
+		uniform_real_distribution<float> position(-2.5f, 2.5f);
+
+		// Create a hull with many points
+		Array<Vec3> points;
+		for (int i = 0; i < 200; ++i)
+			points.push_back(Vec3(1.0f, 0.7f, 1.2f) * Vec3::sRandom(random));
+		RefConst<Shape> hull = ConvexHullShapeSettings(points).Create().Get();
+
+		CollideShapeWarmStart warm_start;
+		CollideShapeSettings settings;
+		settings.mMaxSeparationDistance = 0.1f;
+		CollideShapeSettings warm_start_settings = settings;
+		warm_start_settings.mWarmStart = &warm_start;
+
+		Mat44 transform1 = Mat44::sRotation(Quat::sRandom(random));
+		Quat rotation2 = Quat::sRandom(random);
+		Vec3 position2(position(random), position(random), position(random));
+		bool hints_updated = false;
+		for (int i = 0; i < 1000; ++i)
+		{
+			// Move the hulls a little bit every iteration, like in a simulation
+			rotation2 = (Quat::sRotation(Vec3::sRandom(random), 0.05f) * rotation2).Normalized();
+			position2 = 0.95f * position2 + 0.1f * Vec3::sRandom(random);
+			Mat44 transform2 = Mat44::sRotationTranslation(rotation2, position2);
+
+			ClosestHitCollisionCollector<CollideShapeCollector> collector, warm_start_collector;
+			CollisionDispatch::sCollideShapeVsShape(hull, hull, Vec3::sReplicate(1.0f), Vec3::sReplicate(1.0f), transform1, transform2, SubShapeIDCreator(), SubShapeIDCreator(), settings, collector);
+			CollisionDispatch::sCollideShapeVsShape(hull, hull, Vec3::sReplicate(1.0f), Vec3::sReplicate(1.0f), transform1, transform2, SubShapeIDCreator(), SubShapeIDCreator(), warm_start_settings, warm_start_collector);
+			hints_updated |= warm_start.mSupportHint1 != 0 || warm_start.mSupportHint2 != 0;
+
+			CHECK(collector.HadHit() == warm_start_collector.HadHit());
+			if (collector.HadHit() && warm_start_collector.HadHit())
+				CHECK_APPROX_EQUAL(collector.mHit.mPenetrationDepth, warm_start_collector.mHit.mPenetrationDepth, 1.0e-3f);
+		}
+		CHECK(hints_updated);
+		CHECK_APPROX_EQUAL(Vec3(warm_start.mPenetrationAxis).Length(), 1.0f);
+	}
+
+	// Convex shape that forwards everything to another convex shape and counts how often a support point is requested, GJK and EPA request one support point per iteration.
+	// It has a user sub type so that CollisionDispatch uses the generic ConvexShape::sCollideConvexVsConvex for it.
+	class CountingConvexShape final : public ConvexShape
+	{
+	public:
+							CountingConvexShape(const ConvexShape *inShape, uint &ioNumSupportCalls) : ConvexShape(EShapeSubType::UserConvex1), mShape(inShape), mNumSupportCalls(ioNumSupportCalls) { }
+
+		virtual AABox		GetLocalBounds() const override																		{ return mShape->GetLocalBounds(); }
+		virtual float		GetInnerRadius() const override																		{ return mShape->GetInnerRadius(); }
+		virtual MassProperties GetMassProperties() const override																{ return mShape->GetMassProperties(); }
+		virtual Vec3		GetSurfaceNormal(const SubShapeID &inSubShapeID, Vec3Arg inLocalSurfacePosition) const override	{ return mShape->GetSurfaceNormal(inSubShapeID, inLocalSurfacePosition); }
+		virtual void		GetSupportingFace(const SubShapeID &inSubShapeID, Vec3Arg inDirection, Vec3Arg inScale, Mat44Arg inCenterOfMassTransform, SupportingFace &outVertices) const override { mShape->GetSupportingFace(inSubShapeID, inDirection, inScale, inCenterOfMassTransform, outVertices); }
+		virtual void		CollideSoftBodyVertices(Mat44Arg inCenterOfMassTransform, Vec3Arg inScale, SoftBodyVertex *ioVertices, uint inNumVertices, float inDeltaTime, Vec3Arg inDisplacementDueToGravity, int inCollidingShapeIndex) const override { mShape->CollideSoftBodyVertices(inCenterOfMassTransform, inScale, ioVertices, inNumVertices, inDeltaTime, inDisplacementDueToGravity, inCollidingShapeIndex); }
+		virtual Stats		GetStats() const override																			{ return mShape->GetStats(); }
+		virtual float		GetVolume() const override																			{ return mShape->GetVolume(); }
+	#ifdef JPH_DEBUG_RENDERER
+		virtual void		Draw(DebugRenderer *inRenderer, RMat44Arg inCenterOfMassTransform, Vec3Arg inScale, ColorArg inColor, bool inUseMaterialColors, bool inDrawWireframe) const override { mShape->Draw(inRenderer, inCenterOfMassTransform, inScale, inColor, inUseMaterialColors, inDrawWireframe); }
+	#endif // JPH_DEBUG_RENDERER
+
+		virtual const Support *GetSupportFunction(ESupportMode inMode, SupportBuffer &inBuffer, Vec3Arg inScale) const override
+		{
+			const Support *support = mShape->GetSupportFunction(inMode, mSupportBuffers[int(inMode)], inScale);
+			return new (&inBuffer) CountingSupport(*support, mNumSupportCalls);
+		}
+
+	private:
+		class CountingSupport final : public Support
+		{
+		public:
+							CountingSupport(const Support &inSupport, uint &ioNumCalls) : mSupport(inSupport), mNumCalls(ioNumCalls) { }
+
+			virtual Vec3	GetSupport(Vec3Arg inDirection) const override												{ ++mNumCalls; return mSupport.GetSupport(inDirection); }
+			virtual float	GetConvexRadius() const override															{ return mSupport.GetConvexRadius(); }
+			virtual uint	GetSupportHint() const override																{ return mSupport.GetSupportHint(); }
+			virtual void	SetSupportHint(uint inHint) const override													{ mSupport.SetSupportHint(inHint); }
+
+		private:
+			const Support &	mSupport;
+			uint &			mNumCalls;
+		};
+
+		RefConst<ConvexShape> mShape;
+		uint &				mNumSupportCalls;
+		mutable SupportBuffer mSupportBuffers[3];															///< Buffers for the support functions of mShape, one per ESupportMode
+	};
+
+	// Test that starting GJK with the axis of the previous frame (CollideShapeSettings::mWarmStart) gives the same contacts as starting with the axis between the centers of mass, with less iterations
+	TEST_CASE("TestCollideShapeWarmStartIterations")
+	{
+		UnitTestRandom random;
+
+		// Create a hull with many points and a convex radius
+		Array<Vec3> points;
+		for (int i = 0; i < 200; ++i)
+			points.push_back(Vec3(1.0f, 0.7f, 1.2f) * Vec3::sRandom(random));
+		RefConst<Shape> hull = ConvexHullShapeSettings(points, 0.05f).Create().Get();
+
+		// Wrap the hull so that we can count the iterations of GJK / EPA in the real collision path
+		uint num_iterations = 0;
+		RefConst<Shape> shape1 = new CountingConvexShape(static_cast<const ConvexShape *>(hull.GetPtr()), num_iterations);
+		RefConst<Shape> shape2 = new CountingConvexShape(static_cast<const ConvexShape *>(hull.GetPtr()), num_iterations);
+
+		CollideShapeSettings settings;
+		settings.mMaxSeparationDistance = 0.1f;
+		CollideShapeWarmStart warm_start;
+		CollideShapeSettings warm_start_settings = settings;
+		warm_start_settings.mWarmStart = &warm_start;
+
+		// Place hull 2 on top of hull 1 so that they're touching
+		Vec3 up(0, 1.4f, 0);
+		Quat rotation2 = Quat::sIdentity();
+		uint num_cold_iterations = 0, num_warm_iterations = 0, num_hits = 0;
+		for (int i = 0; i < 1000; ++i)
+		{
+			// Let hull 2 wobble a bit on top of hull 1, like in a simulation
+			rotation2 = (Quat::sRotation(Vec3::sRandom(random), 0.01f) * rotation2).Normalized();
+			Mat44 transform2 = Mat44::sRotationTranslation(rotation2, up + 0.02f * Vec3::sRandom(random));
+
+			// Cold start uses the axis between the centers of mass
+			num_iterations = 0;
+			ClosestHitCollisionCollector<CollideShapeCollector> cold;
+			CollisionDispatch::sCollideShapeVsShape(shape1, shape2, Vec3::sReplicate(1.0f), Vec3::sReplicate(1.0f), Mat44::sIdentity(), transform2, SubShapeIDCreator(), SubShapeIDCreator(), settings, cold);
+			num_cold_iterations += num_iterations;
+
+			// Warm start uses the axis from the previous frame
+			num_iterations = 0;
+			ClosestHitCollisionCollector<CollideShapeCollector> warm;
+			CollisionDispatch::sCollideShapeVsShape(shape1, shape2, Vec3::sReplicate(1.0f), Vec3::sReplicate(1.0f), Mat44::sIdentity(), transform2, SubShapeIDCreator(), SubShapeIDCreator(), warm_start_settings, warm);
+			num_warm_iterations += num_iterations;
+
+			// Check that both find the same contact
+			CHECK(cold.HadHit() == warm.HadHit());
+			if (cold.HadHit() && warm.HadHit())
+			{
+				++num_hits;
+				CHECK_APPROX_EQUAL(cold.mHit.mPenetrationDepth, warm.mHit.mPenetrationDepth, 1.0e-3f);
+				CHECK_APPROX_EQUAL(cold.mHit.mContactPointOn1, warm.mHit.mContactPointOn1, 1.0e-2f);
+				CHECK_APPROX_EQUAL(cold.mHit.mContactPointOn2, warm.mHit.mContactPointOn2, 1.0e-2f);
+				CHECK(cold.mHit.mPenetrationAxis.Normalized().Dot(warm.mHit.mPenetrationAxis.Normalized()) > 0.99f);
+			}
+		}
+
+		CHECK(num_hits > 0);
+		CHECK(num_warm_iterations < num_cold_iterations);
+	}
 }
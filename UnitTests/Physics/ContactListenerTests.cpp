@@ -674,4 +674,246 @@ TEST_SUITE("ContactListenerTests")
 										CHECK(body2.GetLinearVelocity() == cInitialVelocity2);
 								}
 	}
+
+	// Drop a pile of boxes and check that the recorded contact events match the contact listener callbacks
+	TEST_CASE("TestContactEvents")
+	{
+		for (EMotionQuality quality : { EMotionQuality::Discrete, EMotionQuality::LinearCast })
+		{
+			PhysicsTestContext c(1.0f / 60.0f, 2);
+			c.CreateFloor();
+			c.GetSystem()->SetMaxContactEvents(4096);
+			CHECK(c.GetSystem()->GetMaxContactEvents() == 4096);
+
+			LoggingContactListener listener;
+			c.GetSystem()->SetContactListener(&listener);
+
+			// Create a pile of boxes, the last one is removed halfway through the simulation
+			BodyID last_box;
+			for (int i = 0; i < 20; ++i)
+				last_box = c.CreateBox(RVec3(0.1_r * (i % 3), 1.0_r + 1.1_r * i, 0.1_r * (i % 5)), Quat::sRotation(Vec3::sAxisY(), 0.1f * i), EMotionType::Dynamic, quality, Layers::MOVING, Vec3::sReplicate(0.5f)).GetID();
+
+			bool any_added = false, any_persisted = false, any_removed = false;
+			for (int step = 0; step < 120; ++step)
+			{
+				listener.Clear();
+				if (step == 60)
+					c.GetBodyInterface().RemoveBody(last_box);
+				CHECK(c.SimulateSingleStep() == EPhysicsUpdateError::None);
+
+				// Collect the callbacks of the listener, CCD can call OnContactPersisted multiple times for the same contact so we remove duplicates
+				using Event = std::pair<SubShapeIDPair, EContactEventType>;
+				auto less = [](const Event &inLHS, const Event &inRHS) { return inLHS.first == inRHS.first? inLHS.second < inRHS.second : inLHS.first < inRHS.first; };
+				auto equal = [](const Event &inLHS, const Event &inRHS) { return inLHS.first == inRHS.first && inLHS.second == inRHS.second; };
+				Array<Event> expected;
+				for (size_t i = 0; i < listener.GetEntryCount(); ++i)
+				{
+					const LogEntry &e = listener.GetEntry(i);
+					if (e.mType != EType::Validate)
+						expected.push_back({ SubShapeIDPair(e.mBody1, e.mManifold.mSubShapeID1, e.mBody2, e.mManifold.mSubShapeID2), e.mType == EType::Add? EContactEventType::Added : (e.mType == EType::Persist? EContactEventType::Persisted : EContactEventType::Removed) });
+				}
+				sort(expected.begin(), expected.end(), less);
+				expected.erase(unique(expected.begin(), expected.end(), equal), expected.end());
+
+				// Collect the events, these should be sorted already
+				Array<Event> actual;
+				const ContactEvent *events = c.GetSystem()->GetContactEvents();
+				uint num_events = c.GetSystem()->GetNumContactEvents();
+				for (uint i = 0; i < num_events; ++i)
+				{
+					const ContactEvent &e = events[i];
+					CHECK(e.mCollisionStep < 2);
+					if (i > 0)
+						CHECK(!(e < events[i - 1]));
+					actual.push_back({ e.mSubShapePair, e.mType });
+
+					// Contacts should be on top of the floor and pointing up
+					if (e.mType != EContactEventType::Removed)
+					{
+						CHECK(e.GetPosition().GetY() > -0.1_r);
+						CHECK(abs(e.GetWorldSpaceNormal().Length() - 1.0f) < 1.0e-4f);
+					}
+
+					any_added |= e.mType == EContactEventType::Added;
+					any_persisted |= e.mType == EContactEventType::Persisted;
+					any_removed |= e.mType == EContactEventType::Removed;
+				}
+				actual.erase(unique(actual.begin(), actual.end(), equal), actual.end());
+				CHECK(actual == expected);
+			}
+
+			CHECK(any_added);
+			CHECK(any_persisted);
+			CHECK(any_removed);
+
+			// Recording can be turned off again
+			c.GetSystem()->SetMaxContactEvents(0);
+			c.SimulateSingleStep();
+			CHECK(c.GetSystem()->GetNumContactEvents() == 0);
+			c.GetSystem()->SetContactListener(nullptr);
+		}
+	}
+
+	// Check that contact events are recorded without a contact listener
+	TEST_CASE("TestContactEventsWithoutListener")
+	{
+		PhysicsTestContext c;
+		Body &floor = c.CreateFloor();
+		c.GetSystem()->SetMaxContactEvents(64);
+
+		// Drop a sphere on the floor
+		Body &sphere = c.CreateSphere(RVec3(0, 0.5f, 0), 0.5f, EMotionType::Dynamic, EMotionQuality::Discrete, Layers::MOVING);
+		CHECK(c.SimulateSingleStep() == EPhysicsUpdateError::None);
+		CHECK(c.SimulateSingleStep() == EPhysicsUpdateError::None);
+		REQUIRE(c.GetSystem()->GetNumContactEvents() == 1);
+		const ContactEvent &persisted = c.GetSystem()->GetContactEvents()[0];
+		CHECK(persisted.mType == EContactEventType::Persisted);
+		CHECK(persisted.mSubShapePair.GetBody1ID() == floor.GetID());
+		CHECK(persisted.mSubShapePair.GetBody2ID() == sphere.GetID());
+		CHECK_APPROX_EQUAL(persisted.GetWorldSpaceNormal(), Vec3::sAxisY(), 1.0e-4f);
+
+		// Remove the sphere and check that we get a removed event (there are no active bodies left so this tests the path where the update is skipped)
+		c.GetBodyInterface().RemoveBody(sphere.GetID());
+		CHECK(c.SimulateSingleStep() == EPhysicsUpdateError::None);
+		REQUIRE(c.GetSystem()->GetNumContactEvents() == 1);
+		CHECK(c.GetSystem()->GetContactEvents()[0].mType == EContactEventType::Removed);
+	}
+
+	// Check that the amount of events passed to SetMaxContactEvents can be recorded when they are spread out over multiple jobs and collision steps
+	TEST_CASE("TestContactEventsCapacity")
+	{
+		const int cCollisionSteps = 4;
+		PhysicsTestContext c(1.0f / 60.0f, cCollisionSteps, 4);
+		c.CreateFloor();
+
+		// Create a grid of spheres resting on the floor, each of them creates a single contact
+		const int cGridSize = 4;
+		const uint cNumSpheres = cGridSize * cGridSize;
+		for (int x = 0; x < cGridSize; ++x)
+			for (int z = 0; z < cGridSize; ++z)
+				c.CreateSphere(RVec3(2.0_r * x, 0.5_r, 2.0_r * z), 0.5f, EMotionType::Dynamic, EMotionQuality::Discrete, Layers::MOVING).SetAllowSleeping(false);
+
+		// Reserve exactly enough events for all collision steps, this is less than a single block
+		const uint cNumEvents = cCollisionSteps * cNumSpheres;
+		c.GetSystem()->SetMaxContactEvents(cNumEvents);
+		CHECK(c.GetSystem()->GetMaxContactEvents() == cNumEvents);
+
+		// Every job of every collision step records events in its own blocks, check that no events are lost
+		for (int update = 0; update < 5; ++update)
+		{
+			CHECK(c.SimulateSingleStep() == EPhysicsUpdateError::None);
+			CHECK(c.GetSystem()->GetNumContactEvents() == cNumEvents);
+		}
+	}
+
+	// Drop a pile of boxes where only some of the bodies report contacts and check that the callbacks stay balanced when changing the flags
+	TEST_CASE("TestReportContacts")
+	{
+		PhysicsTestContext c;
+		Body &floor = c.CreateFloor();
+		floor.SetReportContacts(false);
+
+		LoggingContactListener listener;
+		c.GetSystem()->SetContactListener(&listener);
+
+		// Create a pile of boxes, every third box reports contacts
+		Array<Body *> boxes;
+		for (int i = 0; i < 12; ++i)
+		{
+			Body &box = c.CreateBox(RVec3(0.1_r * (i % 2), 0.5_r + 1.0_r * i, 0), Quat::sIdentity(), EMotionType::Dynamic, EMotionQuality::Discrete, Layers::MOVING, Vec3::sReplicate(0.5f));
+			box.SetReportContacts(i % 3 == 0);
+			box.SetAllowSleeping(false);
+			boxes.push_back(&box);
+		}
+
+		int num_active_contacts = 0, num_unreported_validates = 0;
+		for (int step = 0; step < 90; ++step)
+		{
+			// Toggle the reporting of some bodies while they're in contact, both through the body interface and by changing the flag directly
+			if (step == 30)
+				c.GetBodyInterface().SetReportContacts(boxes[1]->GetID(), true);
+			else if (step == 45)
+				boxes[2]->SetReportContacts(true);
+			else if (step == 60)
+				c.GetBodyInterface().SetReportContacts(boxes[0]->GetID(), false);
+			else if (step == 75)
+				boxes[3]->SetReportContacts(false);
+
+			listener.Clear();
+			c.SimulateSingleStep();
+
+			for (size_t i = 0; i < listener.GetEntryCount(); ++i)
+			{
+				const LogEntry &e = listener.GetEntry(i);
+				if (e.mType == EType::Add)
+					++num_active_contacts;
+				else if (e.mType == EType::Remove)
+					--num_active_contacts;
+				else if (e.mType == EType::Persist)
+				{
+					// Pairs for which neither body reports contacts should not receive callbacks
+					const BodyLockInterfaceNoLock &bli = c.GetSystem()->GetBodyLockInterfaceNoLock();
+					CHECK(bli.TryGetBody(e.mBody1)->GetReportContactsWithBody(*bli.TryGetBody(e.mBody2)));
+				}
+				else if (e.mType == EType::Validate)
+				{
+					// Validate is called for all pairs so that the listener can still filter contacts
+					const BodyLockInterfaceNoLock &bli = c.GetSystem()->GetBodyLockInterfaceNoLock();
+					if (!bli.TryGetBody(e.mBody1)->GetReportContactsWithBody(*bli.TryGetBody(e.mBody2)))
+						++num_unreported_validates;
+				}
+				CHECK(num_active_contacts >= 0);
+			}
+		}
+		CHECK(num_active_contacts > 0);
+		CHECK(num_unreported_validates > 0);
+
+		// Remove all boxes, all contacts that were added should be removed again
+		listener.Clear();
+		for (Body *box : boxes)
+			c.GetBodyInterface().RemoveBody(box->GetID());
+		c.SimulateSingleStep();
+		for (size_t i = 0; i < listener.GetEntryCount(); ++i)
+			if (listener.GetEntry(i).mType == EType::Remove)
+				--num_active_contacts;
+		CHECK(num_active_contacts == 0);
+	}
+
+	// Check that OnContactValidate can reject contacts between bodies that don't report contacts
+	TEST_CASE("TestReportContactsValidate")
+	{
+		PhysicsTestContext c;
+		Body &floor = c.CreateFloor();
+		floor.SetReportContacts(false);
+
+		Body &box = c.CreateBox(RVec3(0, 1, 0), Quat::sIdentity(), EMotionType::Dynamic, EMotionQuality::Discrete, Layers::MOVING, Vec3::sReplicate(0.5f));
+		box.SetReportContacts(false);
+
+		// Reject all contacts, only OnContactValidate should be called
+		class ContactListenerImpl : public ContactListener
+		{
+		public:
+			virtual ValidateResult	OnContactValidate(const Body &inBody1, const Body &inBody2, RVec3Arg inBaseOffset, const CollideShapeResult &inCollisionResult) override
+			{
+				++mNumValidates;
+				return ValidateResult::RejectAllContactsForThisBodyPair;
+			}
+
+			virtual void			OnContactAdded(const Body &inBody1, const Body &inBody2, const ContactManifold &inManifold, ContactSettings &ioSettings) override
+			{
+				++mNumAdded;
+			}
+
+			atomic<int>				mNumValidates { 0 };
+			atomic<int>				mNumAdded { 0 };
+		};
+		ContactListenerImpl listener;
+		c.GetSystem()->SetContactListener(&listener);
+
+		// The box should fall through the floor
+		c.Simulate(1.0f);
+		CHECK(listener.mNumValidates > 0);
+		CHECK(listener.mNumAdded == 0);
+		CHECK(box.GetPosition().GetY() < -1.0_r);
+	}
 }
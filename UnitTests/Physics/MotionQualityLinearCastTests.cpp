@@ -7,6 +7,7 @@
 #include "Layers.h"
 #include "LoggingContactListener.h"
 #include "LoggingBodyActivationListener.h"
+#include <Jolt/Physics/Collision/Shape/BoxShape.h>
 
 TEST_SUITE("MotionQualityLinearCastTests")
 {
@@ -376,4 +377,69 @@ TEST_SUITE("MotionQualityLinearCastTests")
 		CHECK_APPROX_EQUAL(box2.GetLinearVelocity(), new_velocity);
 		CHECK_APPROX_EQUAL(box2.GetAngularVelocity(), Vec3::sZero());
 	}
+
+	// A sphere flying along a static plank that is close enough to be found by the broadphase but is never hit, then hitting a wall
+	TEST_CASE("TestLinearCastSweptVolumeCache")
+	{
+		const Vec3 cDirection = Vec3(1, 1, 0).Normalized();
+		const Vec3 cPerpendicular = Vec3(1, -1, 0).Normalized();
+		const Quat cRotation = Quat::sRotation(Vec3::sAxisZ(), 0.25f * JPH_PI);
+		const float cWallDistance = 25.0f;
+
+		auto simulate = [&](bool inUseCache, bool inMovePlank, bool inGrowPlank, RVec3 &outPosition, bool &outHitPlank) {
+			PhysicsTestContext c(1.0f / cFrequency, 1);
+			c.ZeroGravity();
+
+			PhysicsSettings settings = c.GetSystem()->GetPhysicsSettings();
+			settings.mUseCCDSweptVolumeCache = inUseCache;
+			c.GetSystem()->SetPhysicsSettings(settings);
+
+			LoggingContactListener listener;
+			c.GetSystem()->SetContactListener(&listener);
+
+			// Plank parallel to the path of the sphere, its bounding box overlaps with the path
+			Body &plank = c.CreateBox(RVec3(10.0f * cDirection + 1.5f * cPerpendicular), cRotation, EMotionType::Static, EMotionQuality::Discrete, Layers::NON_MOVING, Vec3(10, 0.1f, 0.5f), EActivation::DontActivate);
+
+			// Wall perpendicular to the path
+			c.CreateBox(RVec3(cWallDistance * cDirection), cRotation, EMotionType::Static, EMotionQuality::Discrete, Layers::NON_MOVING, Vec3(0.5f, 5, 5), EActivation::DontActivate);
+
+			Body &sphere = c.CreateSphere(RVec3::sZero(), 0.5f, EMotionType::Dynamic, EMotionQuality::LinearCast, Layers::MOVING);
+			sphere.SetLinearVelocity(cVelocity.Length() * cDirection);
+
+			for (int i = 0; i < 20; ++i)
+			{
+				// Move the plank in front of the sphere, this should invalidate the cache
+				if (inMovePlank && i == 3)
+					c.GetBodyInterface().SetPositionAndRotation(plank.GetID(), RVec3(15.0f * cDirection), cRotation * Quat::sRotation(Vec3::sAxisZ(), 0.5f * JPH_PI), EActivation::DontActivate);
+
+				// Replace the shape of the plank by one that extends into the path of the sphere, this should invalidate the cache too
+				if (inGrowPlank && i == 3)
+					c.GetBodyInterface().SetShape(plank.GetID(), new BoxShape(Vec3(10, 2, 0.5f)), false, EActivation::DontActivate);
+
+				c.SimulateSingleStep();
+			}
+
+			outPosition = sphere.GetPosition();
+			outHitPlank = listener.Contains(LoggingContactListener::EType::Add, sphere.GetID(), plank.GetID());
+		};
+
+		// Sphere should not tunnel through the wall and the cache should not change the result
+		RVec3 position_no_cache, position_cache;
+		bool hit_plank_no_cache, hit_plank_cache;
+		simulate(false, false, false, position_no_cache, hit_plank_no_cache);
+		simulate(true, false, false, position_cache, hit_plank_cache);
+		CHECK(!hit_plank_no_cache);
+		CHECK(!hit_plank_cache);
+		CHECK(Vec3(position_no_cache).Dot(cDirection) < cWallDistance);
+		CHECK(position_cache == position_no_cache);
+
+		// Sphere should hit the plank after it has been moved in front of it
+		simulate(true, true, false, position_cache, hit_plank_cache);
+		CHECK(hit_plank_cache);
+		CHECK(Vec3(position_cache).Dot(cDirection) < 15.0f);
+
+		// Sphere should hit the plank after its shape has been replaced by a bigger one
+		simulate(true, false, true, position_cache, hit_plank_cache);
+		CHECK(hit_plank_cache);
+	}
 }
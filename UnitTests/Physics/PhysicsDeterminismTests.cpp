@@ -7,6 +7,8 @@
 #include "Layers.h"
 #include <Jolt/Physics/Constraints/SwingTwistConstraint.h>
 #include <Jolt/Physics/Collision/GroupFilterTable.h>
+#include <Jolt/Physics/Collision/Shape/BoxShape.h>
+#include <Jolt/Physics/Collision/Shape/StaticCompoundShape.h>
 
 TEST_SUITE("PhysicsDeterminismTests")
 {
@@ -108,6 +110,100 @@ TEST_SUITE("PhysicsDeterminismTests")
 		CompareSimulations(c1, c2, 5.0f);
 	}
 
+	static void CreateStackOfBoxes(PhysicsTestContext &ioContext, bool inReorderContacts, bool inUseLargeIslandSplitter)
+	{
+		PhysicsSettings settings = ioContext.GetSystem()->GetPhysicsSettings();
+		settings.mReorderContactConstraints = inReorderContacts;
+		settings.mUseLargeIslandSplitter = inUseLargeIslandSplitter;
+		ioContext.GetSystem()->SetPhysicsSettings(settings);
+
+		ioContext.CreateFloor();
+
+		// Touching boxes so that we get one large island with many contacts
+		UnitTestRandom random;
+		uniform_real_distribution<float> offset(-0.05f, 0.05f);
+		for (int y = 0; y < 4; ++y)
+			for (int x = 0; x < 6; ++x)
+				for (int z = 0; z < 6; ++z)
+					ioContext.CreateBox(RVec3(float(x) + offset(random), 0.5f + float(y), float(z) + offset(random)), Quat::sIdentity(), EMotionType::Dynamic, EMotionQuality::Discrete, Layers::MOVING, Vec3::sReplicate(0.5f));
+	}
+
+	TEST_CASE("TestReorderContactConstraints")
+	{
+		for (int use_splitter = 0; use_splitter < 2; ++use_splitter)
+		{
+			PhysicsTestContext c1(1.0f / 60.0f, 2, 0);
+			CreateStackOfBoxes(c1, false, use_splitter != 0);
+
+			PhysicsTestContext c2(1.0f / 60.0f, 2, 15);
+			CreateStackOfBoxes(c2, true, use_splitter != 0);
+
+			// Storing the contact constraints in solve order should not change the simulation
+			CompareSimulations(c1, c2, 2.0f);
+		}
+	}
+
+	static void CreateSplitCompoundScene(PhysicsTestContext &ioContext, bool inSplitLargeCompoundCollisions = true, bool inAddPlate = true)
+	{
+		PhysicsSettings settings = ioContext.GetSystem()->GetPhysicsSettings();
+		settings.mSplitLargeCompoundCollisions = inSplitLargeCompoundCollisions;
+		ioContext.GetSystem()->SetPhysicsSettings(settings);
+
+		// Floor made out of tiles
+		Ref<StaticCompoundShapeSettings> floor = new StaticCompoundShapeSettings;
+		for (int x = 0; x < 12; ++x)
+			for (int z = 0; z < 12; ++z)
+				floor->AddShape(Vec3(float(x) - 5.5f, -0.1f, float(z) - 5.5f), Quat::sIdentity(), new BoxShapeSettings(Vec3(0.5f, 0.1f, 0.5f), 0.0f));
+		ioContext.CreateBody(floor, RVec3::sZero(), Quat::sIdentity(), EMotionType::Static, EMotionQuality::Discrete, Layers::NON_MOVING, EActivation::DontActivate);
+
+		// A plate made out of small boxes, this splits the sub shapes of body 1
+		if (inAddPlate)
+		{
+			Ref<StaticCompoundShapeSettings> plate = new StaticCompoundShapeSettings;
+			for (int x = 0; x < 6; ++x)
+				for (int z = 0; z < 6; ++z)
+					plate->AddShape(Vec3(0.5f * x - 1.25f, 0, 0.5f * z - 1.25f), Quat::sIdentity(), new BoxShapeSettings(Vec3(0.25f, 0.1f, 0.25f), 0.0f));
+			ioContext.CreateBody(plate, RVec3(-2.5f, 1.0f, 0), Quat::sRotation(Vec3::sAxisX(), 0.1f), EMotionType::Dynamic, EMotionQuality::Discrete, Layers::MOVING, EActivation::Activate);
+		}
+
+		// A large box, this splits the sub shapes of the floor (body 2)
+		ioContext.CreateBody(new BoxShapeSettings(Vec3(2.0f, 0.5f, 2.0f)), RVec3(2.5f, 1.0f, 0), Quat::sRotation(Vec3::sAxisZ(), 0.1f), EMotionType::Dynamic, EMotionQuality::Discrete, Layers::MOVING, EActivation::Activate);
+	}
+
+	TEST_CASE("TestSplitLargeCompoundCollisions")
+	{
+		PhysicsTestContext c1(1.0f / 60.0f, 1, 0);
+		CreateSplitCompoundScene(c1);
+
+		PhysicsTestContext c2(1.0f / 60.0f, 1, 15);
+		CreateSplitCompoundScene(c2);
+
+		// The result should not depend on which job processes which range of sub shapes
+		CompareSimulations(c1, c2, 3.0f);
+
+		// When a compound shape collides with a convex shape, the result should be the same as when the body pairs are not split up
+		PhysicsTestContext c3(1.0f / 60.0f, 1, 15);
+		CreateSplitCompoundScene(c3, true, false);
+
+		PhysicsTestContext c4(1.0f / 60.0f, 1, 15);
+		CreateSplitCompoundScene(c4, false, false);
+
+		CompareSimulations(c3, c4, 3.0f);
+
+		// The dynamic bodies should be resting on the floor (allowing for penetration slop)
+		BodyIDVector bodies;
+		c1.GetSystem()->GetBodies(bodies);
+		for (const BodyID &id : bodies)
+			if (c1.GetBodyInterface().GetMotionType(id) == EMotionType::Dynamic)
+			{
+				BodyProperties properties;
+				GetBodyProperties(c1, id, properties);
+				CHECK(properties.mBounds.mMin.GetY() > -0.05f);
+				CHECK(properties.mBounds.mMin.GetY() < 0.1f);
+				CHECK(abs(properties.mLinearVelocity.GetY()) < 0.1f);
+			}
+	}
+
 	static void CreateGridOfBoxesLinearCast(PhysicsTestContext &ioContext)
 	{
 		UnitTestRandom random;
@@ -192,4 +288,36 @@ TEST_SUITE("PhysicsDeterminismTests")
 
 		CompareSimulations(c1, c2, 5.0f);
 	}
+
+	static void CreateProjectilesLinearCast(PhysicsTestContext &ioContext)
+	{
+		UnitTestRandom random;
+		uniform_real_distribution<float> restitution(0.0f, 1.0f);
+
+		ioContext.CreateFloor();
+
+		// Targets that are hit by multiple projectiles, this forces the projectiles that hit the same target to be resolved sequentially
+		for (int x = 0; x < 5; ++x)
+			ioContext.CreateBox(RVec3(4.0f * float(x), 0.5f, 0.0f), Quat::sIdentity(), EMotionType::Dynamic, EMotionQuality::Discrete, Layers::MOVING, Vec3::sReplicate(0.5f), EActivation::DontActivate);
+
+		// Fast projectiles flying towards the targets and the floor
+		for (int x = 0; x < 10; ++x)
+			for (int z = 0; z < 10; ++z)
+			{
+				Body &body = ioContext.CreateSphere(RVec3(2.0f * float(x), 10.0f, 2.0f * float(z) - 10.0f), 0.05f, EMotionType::Dynamic, EMotionQuality::LinearCast, Layers::MOVING);
+				body.SetRestitution(restitution(random));
+				body.SetLinearVelocity(Vec3(0, -200.0f, 0) + 10.0f * Vec3::sRandom(random));
+			}
+	}
+
+	TEST_CASE("TestProjectilesLinearCast")
+	{
+		PhysicsTestContext c1(1.0f / 60.0f, 1, 0);
+		CreateProjectilesLinearCast(c1);
+
+		PhysicsTestContext c2(1.0f / 60.0f, 1, 15);
+		CreateProjectilesLinearCast(c2);
+
+		CompareSimulations(c1, c2, 2.0f);
+	}
 }
@@ -1835,4 +1835,158 @@ TEST_SUITE("PhysicsTests")
 		CHECK(contact_listener.Contains(LoggingContactListener::EType::Remove, floor.GetID(), SubShapeID(), body_id, sub_shape_ids[1]));
 		CHECK(contact_listener.Contains(LoggingContactListener::EType::Remove, floor.GetID(), SubShapeID(), body_id, sub_shape_ids[2]));
 	}
+
+	// Test that the contact cache grows and shrinks with PhysicsSettings::mUseAdaptiveContactCache
+	TEST_CASE("TestAdaptiveContactCache")
+	{
+		const uint cInitialCapacity = 256;
+		PhysicsTestContext c(1.0f / 60.0f, 1, 0, 1024, cInitialCapacity, cInitialCapacity);
+
+		PhysicsSettings settings = c.GetSystem()->GetPhysicsSettings();
+		settings.mUseAdaptiveContactCache = true;
+		settings.mContactCacheShrinkDelay = 10;
+		c.GetSystem()->SetPhysicsSettings(settings);
+
+		c.CreateFloor();
+
+		ContactCacheStats initial_stats = c.GetSystem()->GetContactCacheStats();
+		CHECK(initial_stats.mMaxBodyPairs == cInitialCapacity);
+		CHECK(initial_stats.mMaxManifolds == cInitialCapacity);
+		CHECK(initial_stats.mMaxContactConstraints == cInitialCapacity);
+		CHECK(initial_stats.mNumResizes == 0);
+
+		// Add boxes in batches, every box touches the floor only so it adds 1 body pair, manifold and contact constraint
+		const int cNumBatches = 10;
+		const int cBoxesPerBatch = 40;
+		const int cNumBoxes = cNumBatches * cBoxesPerBatch;
+		BodyIDVector boxes;
+		for (int batch = 0; batch < cNumBatches; ++batch)
+		{
+			for (int i = 0; i < cBoxesPerBatch; ++i)
+			{
+				int idx = batch * cBoxesPerBatch + i;
+				Body &box = c.CreateBox(RVec3(-20.0f + 2.0f * (idx % 20), 0.5f, -20.0f + 2.0f * (idx / 20)), Quat::sIdentity(), EMotionType::Dynamic, EMotionQuality::Discrete, Layers::MOVING, Vec3::sReplicate(0.5f));
+				box.SetAllowSleeping(false);
+				boxes.push_back(box.GetID());
+			}
+
+			// The cache should grow before it overflows
+			for (int step = 0; step < 5; ++step)
+				CHECK(c.SimulateSingleStep() == EPhysicsUpdateError::None);
+
+			ContactCacheStats stats = c.GetSystem()->GetContactCacheStats();
+			uint num_boxes = uint(boxes.size());
+			CHECK(stats.mPeakNumBodyPairs == num_boxes);
+			CHECK(stats.mPeakNumManifolds == num_boxes);
+			CHECK(stats.mPeakNumContactConstraints == num_boxes);
+			CHECK(stats.mMaxBodyPairs > num_boxes);
+			CHECK(stats.mMaxManifolds > num_boxes);
+			CHECK(stats.mMaxContactConstraints > num_boxes);
+		}
+
+		ContactCacheStats grown_stats = c.GetSystem()->GetContactCacheStats();
+		CHECK(grown_stats.mMaxContactConstraints >= uint(cNumBoxes));
+		CHECK(grown_stats.mNumResizes > 0);
+		CHECK(grown_stats.mCacheMemory > initial_stats.mCacheMemory);
+		CHECK(grown_stats.mConstraintBufferMemory > initial_stats.mConstraintBufferMemory);
+
+		// Nothing changes while the usage stays the same
+		for (int step = 0; step < 25; ++step)
+			CHECK(c.SimulateSingleStep() == EPhysicsUpdateError::None);
+		CHECK(c.GetSystem()->GetContactCacheStats().mNumResizes == grown_stats.mNumResizes);
+
+		// Remove most boxes
+		const int cNumRemaining = 10;
+		BodyInterface &bi = c.GetBodyInterface();
+		bi.RemoveBodies(boxes.data() + cNumRemaining, cNumBoxes - cNumRemaining);
+		bi.DestroyBodies(boxes.data() + cNumRemaining, cNumBoxes - cNumRemaining);
+
+		// After mContactCacheShrinkDelay updates the cache should shrink back to the minimum capacity
+		for (int step = 0; step < 25; ++step)
+			CHECK(c.SimulateSingleStep() == EPhysicsUpdateError::None);
+		ContactCacheStats shrunk_stats = c.GetSystem()->GetContactCacheStats();
+		CHECK(shrunk_stats.mPeakNumContactConstraints == cNumRemaining);
+		CHECK(shrunk_stats.mMaxBodyPairs == cInitialCapacity);
+		CHECK(shrunk_stats.mMaxManifolds == cInitialCapacity);
+		CHECK(shrunk_stats.mMaxContactConstraints == cInitialCapacity);
+		CHECK(shrunk_stats.mCacheMemory == initial_stats.mCacheMemory);
+		CHECK(shrunk_stats.mNumResizes > grown_stats.mNumResizes);
+
+		// Add more boxes at once than fit in the cache
+		const int cNumOverflowBoxes = 400 - cNumRemaining;
+		for (int i = 0; i < cNumOverflowBoxes; ++i)
+		{
+			int idx = cNumRemaining + i;
+			Body &box = c.CreateBox(RVec3(-20.0f + 2.0f * (idx % 20), 0.5f, -20.0f + 2.0f * (idx / 20)), Quat::sIdentity(), EMotionType::Dynamic, EMotionQuality::Discrete, Layers::MOVING, Vec3::sReplicate(0.5f));
+			box.SetAllowSleeping(false);
+		}
+		const uint cNumBoxesAfterOverflow = uint(cNumRemaining + cNumOverflowBoxes);
+		static_assert(cNumRemaining + cNumOverflowBoxes > cInitialCapacity);
+
+		// The first step overflows the cache, this is reported but doesn't assert because the cache grows
+		EPhysicsUpdateError errors = c.SimulateSingleStep();
+		CHECK((errors & EPhysicsUpdateError::BodyPairCacheFull) != EPhysicsUpdateError::None);
+		CHECK((errors & EPhysicsUpdateError::ManifoldCacheFull) != EPhysicsUpdateError::None);
+		ContactCacheStats overflow_stats = c.GetSystem()->GetContactCacheStats();
+		CHECK(overflow_stats.mNumResizes > shrunk_stats.mNumResizes);
+		CHECK(overflow_stats.mMaxBodyPairs > cNumBoxesAfterOverflow);
+		CHECK(overflow_stats.mMaxManifolds > cNumBoxesAfterOverflow);
+		CHECK(overflow_stats.mMaxContactConstraints > cNumBoxesAfterOverflow);
+
+		// The next step fits in the grown cache
+		CHECK(c.SimulateSingleStep() == EPhysicsUpdateError::None);
+		ContactCacheStats recovered_stats = c.GetSystem()->GetContactCacheStats();
+		CHECK(recovered_stats.mPeakNumBodyPairs == cNumBoxesAfterOverflow);
+		CHECK(recovered_stats.mPeakNumManifolds == cNumBoxesAfterOverflow);
+		CHECK(recovered_stats.mPeakNumContactConstraints == cNumBoxesAfterOverflow);
+
+		// Changing the settings in between updates should not change the reported size of the buffer that was used during the last update
+		settings.mReorderContactConstraints = !settings.mReorderContactConstraints;
+		c.GetSystem()->SetPhysicsSettings(settings);
+		CHECK(c.GetSystem()->GetContactCacheStats().mConstraintBufferMemory == recovered_stats.mConstraintBufferMemory);
+	}
+
+	// Test the stats that are gathered during an update
+	TEST_CASE("TestPhysicsUpdateStats")
+	{
+		PhysicsTestContext c(1.0f / 60.0f, 2);
+		c.CreateFloor();
+
+		// Nothing is active, only the broadphase is updated
+		CHECK(c.SimulateSingleStep() == EPhysicsUpdateError::None);
+		const PhysicsUpdateStats &idle_stats = c.GetSystem()->GetUpdateStats();
+		CHECK(idle_stats.mNumCollisionSteps == 0);
+		CHECK(idle_stats.mNumActiveBodies == 0);
+		CHECK(idle_stats.mUpdateTimeNs > 0);
+
+		// Two stacks of two boxes resting on the floor that are connected by a constraint
+		const Vec3 cHalfExtent(0.5f, 0.5f, 0.5f);
+		Body *boxes[4];
+		for (int i = 0; i < 4; ++i)
+			boxes[i] = &c.CreateBox(RVec3(i < 2? -5.0f : 5.0f, 0.5f + (i & 1), 0), Quat::sIdentity(), EMotionType::Dynamic, EMotionQuality::Discrete, Layers::MOVING, cHalfExtent);
+		PointConstraintSettings constraint;
+		constraint.mPoint1 = constraint.mPoint2 = RVec3(-5.0f, 1.0f, 0);
+		c.GetSystem()->AddConstraint(constraint.Create(*boxes[0], *boxes[1]));
+
+		CHECK(c.SimulateSingleStep() == EPhysicsUpdateError::None);
+		const PhysicsUpdateStats &stats = c.GetSystem()->GetUpdateStats();
+		CHECK(stats.mNumCollisionSteps == 2);
+		CHECK(stats.mNumActiveBodies == 2 * 4);
+		CHECK(stats.mNumActiveConstraints == 2 * 1);
+		CHECK(stats.mNumBodyPairs == 2 * 4); // Floor vs bottom boxes and bottom vs top boxes
+		CHECK(stats.mNumManifolds == 2 * 4);
+		CHECK(stats.mNumContactConstraints == 2 * 4);
+		CHECK(stats.mNumIslands == 2 * 2);
+		CHECK(stats.mNumCCDBodies == 0);
+
+		// All phases that do work were timed and the phases can't take longer than the update on a single thread
+		uint64 total_phase_time = 0;
+		for (uint p = 0; p < uint(EPhysicsUpdatePhase::Count); ++p)
+			total_phase_time += stats.mPhaseTimeNs[p];
+		CHECK(stats.mPhaseTimeNs[uint(EPhysicsUpdatePhase::FindCollisions)] > 0);
+		CHECK(stats.mPhaseTimeNs[uint(EPhysicsUpdatePhase::SolveVelocityConstraints)] > 0);
+		CHECK(total_phase_time <= stats.mUpdateTimeNs);
+		CHECK(stats.GetUpdateTime() > 0.0f);
+		CHECK(strcmp(PhysicsUpdateStats::sGetPhaseName(EPhysicsUpdatePhase::CCD), "CCD") == 0);
+	}
 }
@@ -0,0 +1,256 @@
+// Jolt Physics Library (https://github.com/jrouwe/JoltPhysics)
+// SPDX-FileCopyrightText: 2024 Jorrit Rouwe
+// SPDX-License-Identifier: MIT
+
+#include "UnitTestFramework.h"
+#include "PhysicsTestContext.h"
+#include <Jolt/Physics/Ragdoll/Ragdoll.h>
+#include <Jolt/Physics/Constraints/SwingTwistConstraint.h>
+#include <Jolt/Physics/Collision/Shape/BoxShape.h>
+#include "Layers.h"
+
+TEST_SUITE("RagdollTests")
+{
+	// Create a ragdoll with a root, a chain of 2 bodies attached to the right and a single body attached to the left of the root
+	static Ref<RagdollSettings> sCreateRagdollSettings(EMotionType inMotionType)
+	{
+		Ref<Skeleton> skeleton = new Skeleton;
+		skeleton->AddJoint("Root", -1);
+		skeleton->AddJoint("Right1", 0);
+		skeleton->AddJoint("Right2", 1);
+		skeleton->AddJoint("Left", 0);
+
+		const RVec3 cPositions[] = { RVec3::sZero(), RVec3(1.5f, 0, 0), RVec3(3.0f, 0, 0), RVec3(-1.5f, 0, 0) };
+		const Vec3 cHalfExtents[] = { Vec3(0.5f, 0.5f, 0.5f), Vec3(0.5f, 0.2f, 0.2f), Vec3(0.5f, 0.3f, 0.1f), Vec3(0.5f, 0.2f, 0.4f) };
+
+		Ref<RagdollSettings> settings = new RagdollSettings;
+		settings->mSkeleton = skeleton;
+		settings->mParts.resize(skeleton->GetJointCount());
+		for (int i = 0; i < skeleton->GetJointCount(); ++i)
+		{
+			RagdollSettings::Part &part = settings->mParts[i];
+			part.SetShape(new BoxShape(cHalfExtents[i]));
+			part.mPosition = cPositions[i];
+			part.mMotionType = inMotionType;
+			part.mObjectLayer = Layers::MOVING;
+
+			int parent = skeleton->GetJoint(i).mParentJointIndex;
+			if (parent >= 0)
+			{
+				Ref<SwingTwistConstraintSettings> constraint = new SwingTwistConstraintSettings;
+				constraint->mPosition1 = constraint->mPosition2 = 0.5f * (cPositions[i] + cPositions[parent]);
+				constraint->mNormalHalfConeAngle = constraint->mPlaneHalfConeAngle = 0.5f * JPH_PI;
+				constraint->mTwistMinAngle = -0.5f * JPH_PI;
+				constraint->mTwistMaxAngle = 0.5f * JPH_PI;
+				part.mToParent = constraint;
+			}
+		}
+		settings->CalculateBodyIndexToConstraintIndex();
+		settings->CalculateConstraintIndexToBodyIdxPair();
+		settings->DisableParentChildCollisions();
+		return settings;
+	}
+
+	TEST_CASE("TestFreezeBodies")
+	{
+		PhysicsTestContext c;
+		c.ZeroGravity();
+		BodyInterface &bi = c.GetBodyInterface();
+
+		Ref<RagdollSettings> settings = sCreateRagdollSettings(EMotionType::Dynamic);
+		Ref<Ragdoll> ragdoll = settings->CreateRagdoll(0, 0, c.GetSystem());
+		ragdoll->AddToPhysicsSystem(EActivation::Activate);
+
+		// Remember the original mass properties
+		float masses[4];
+		float total_mass = 0.0f;
+		RVec3 total_com = RVec3::sZero();
+		for (int i = 0; i < 4; ++i)
+		{
+			BodyLockRead lock(c.GetSystem()->GetBodyLockInterface(), ragdoll->GetBodyID(i));
+			masses[i] = 1.0f / lock.GetBody().GetMotionProperties()->GetInverseMass();
+			if (i < 3)
+			{
+				total_mass += masses[i];
+				total_com += masses[i] * lock.GetBody().GetCenterOfMassPosition();
+			}
+		}
+		total_com /= total_mass;
+		RVec3 root_position = bi.GetPosition(ragdoll->GetBodyID(0));
+
+		// Freeze the right chain, the child of the frozen body should be frozen too
+		ragdoll->SetFrozenBodies({ 1 });
+		CHECK(!ragdoll->IsBodyFrozen(0));
+		CHECK(ragdoll->IsBodyFrozen(1));
+		CHECK(ragdoll->IsBodyFrozen(2));
+		CHECK(!ragdoll->IsBodyFrozen(3));
+		CHECK(bi.IsAdded(ragdoll->GetBodyID(0)));
+		CHECK(!bi.IsAdded(ragdoll->GetBodyID(1)));
+		CHECK(!bi.IsAdded(ragdoll->GetBodyID(2)));
+		CHECK(bi.IsAdded(ragdoll->GetBodyID(3)));
+		CHECK(!ragdoll->GetConstraint(settings->GetConstraintIndexForBodyIndex(1))->GetEnabled());
+		CHECK(!ragdoll->GetConstraint(settings->GetConstraintIndexForBodyIndex(2))->GetEnabled());
+		CHECK(ragdoll->GetConstraint(settings->GetConstraintIndexForBodyIndex(3))->GetEnabled());
+
+		// The root now carries the mass of the frozen bodies and its center of mass moved to the combined center of mass without moving the body
+		{
+			BodyLockRead lock(c.GetSystem()->GetBodyLockInterface(), ragdoll->GetBodyID(0));
+			const Body &root = lock.GetBody();
+			CHECK_APPROX_EQUAL(1.0f / root.GetMotionProperties()->GetInverseMass(), total_mass, 1.0e-3f);
+			CHECK_APPROX_EQUAL(root.GetCenterOfMassPosition(), total_com, 1.0e-5f);
+			CHECK_APPROX_EQUAL(root.GetPosition(), root_position, 1.0e-5f);
+		}
+
+		// Spin the ragdoll
+		bi.SetAngularVelocity(ragdoll->GetBodyID(0), Vec3(0, 0, 1));
+		c.Simulate(0.5f);
+
+		// The frozen chain should have moved rigidly with the root
+		SkeletonPose pose;
+		pose.SetSkeleton(settings->GetSkeleton());
+		ragdoll->GetPose(pose);
+		Mat44 root_transform = pose.GetJointMatrix(0);
+		CHECK_APPROX_EQUAL(root_transform.Inversed() * pose.GetJointMatrix(1), Mat44::sTranslation(Vec3(1.5f, 0, 0)), 1.0e-5f);
+		CHECK_APPROX_EQUAL(root_transform.Inversed() * pose.GetJointMatrix(2), Mat44::sTranslation(Vec3(3.0f, 0, 0)), 1.0e-5f);
+		Vec3 angular_velocity = bi.GetAngularVelocity(ragdoll->GetBodyID(0));
+		RVec3 root_com = bi.GetCenterOfMassPosition(ragdoll->GetBodyID(0));
+		Vec3 linear_velocity = bi.GetLinearVelocity(ragdoll->GetBodyID(0));
+
+		// Unfreeze the ragdoll
+		ragdoll->SetFrozenBodies({ });
+		for (int i = 0; i < 4; ++i)
+		{
+			CHECK(!ragdoll->IsBodyFrozen(i));
+			CHECK(bi.IsAdded(ragdoll->GetBodyID(i)));
+			CHECK(bi.IsActive(ragdoll->GetBodyID(i)));
+		}
+		for (size_t i = 0; i < ragdoll->GetConstraintCount(); ++i)
+			CHECK(ragdoll->GetConstraint((int)i)->GetEnabled());
+
+		// The bodies should have been restored in the pose they had while frozen and with the velocity of the root
+		for (int i = 0; i < 3; ++i)
+		{
+			BodyLockRead lock(c.GetSystem()->GetBodyLockInterface(), ragdoll->GetBodyID(i));
+			const Body &body = lock.GetBody();
+			CHECK_APPROX_EQUAL(1.0f / body.GetMotionProperties()->GetInverseMass(), masses[i], 1.0e-3f);
+			CHECK_APPROX_EQUAL(body.GetPosition(), pose.GetRootOffset() + pose.GetJointMatrix(i).GetTranslation(), 1.0e-5f);
+			CHECK_APPROX_EQUAL(Mat44::sRotation(body.GetRotation()), pose.GetJointMatrix(i).GetRotation(), 1.0e-5f);
+			CHECK_APPROX_EQUAL(body.GetAngularVelocity(), angular_velocity, 1.0e-5f);
+			CHECK_APPROX_EQUAL(body.GetLinearVelocity(), linear_velocity + angular_velocity.Cross(Vec3(body.GetCenterOfMassPosition() - root_com)), 1.0e-5f);
+		}
+
+		// Freeze again and remove the ragdoll, this should put all bodies back
+		ragdoll->SetFrozenBodies({ 2, 3 });
+		CHECK(!bi.IsAdded(ragdoll->GetBodyID(2)));
+		CHECK(!bi.IsAdded(ragdoll->GetBodyID(3)));
+		ragdoll->RemoveFromPhysicsSystem();
+		for (int i = 0; i < 4; ++i)
+		{
+			CHECK(!ragdoll->IsBodyFrozen(i));
+			CHECK(!bi.IsAdded(ragdoll->GetBodyID(i)));
+		}
+	}
+
+	TEST_CASE("TestFreezeBodiesRestrictedDOFs")
+	{
+		PhysicsTestContext c;
+		c.ZeroGravity();
+
+		// Only allow the bodies to rotate, their inverse mass is zero
+		Ref<RagdollSettings> settings = sCreateRagdollSettings(EMotionType::Dynamic);
+		for (RagdollSettings::Part &part : settings->mParts)
+			part.mAllowedDOFs = EAllowedDOFs::RotationX | EAllowedDOFs::RotationY | EAllowedDOFs::RotationZ;
+		Ref<Ragdoll> ragdoll = settings->CreateRagdoll(0, 0, c.GetSystem());
+		ragdoll->AddToPhysicsSystem(EActivation::Activate);
+
+		// Freeze the right chain, the mass properties of the root should still be valid
+		ragdoll->SetFrozenBodies({ 1 });
+		{
+			BodyLockRead lock(c.GetSystem()->GetBodyLockInterface(), ragdoll->GetBodyID(0));
+			const Body &root = lock.GetBody();
+			Vec3 inv_inertia = root.GetMotionProperties()->GetInverseInertiaDiagonal();
+			CHECK(!inv_inertia.IsNaN());
+			CHECK(inv_inertia.ReduceMin() > 0.0f);
+			CHECK(!root.GetCenterOfMassPosition().IsNaN());
+		}
+
+		// Spin the ragdoll, nothing should become invalid
+		c.GetBodyInterface().SetAngularVelocity(ragdoll->GetBodyID(0), Vec3(0, 0, 1));
+		c.Simulate(0.5f);
+		CHECK(!c.GetBodyInterface().GetAngularVelocity(ragdoll->GetBodyID(0)).IsNaN());
+
+		// Unfreeze, the bodies should be valid again
+		ragdoll->SetFrozenBodies({ });
+		for (int i = 0; i < 4; ++i)
+			CHECK(!c.GetBodyInterface().GetPosition(ragdoll->GetBodyID(i)).IsNaN());
+		ragdoll->RemoveFromPhysicsSystem();
+	}
+
+	TEST_CASE("TestBatchedDriveToPoseUsingKinematics")
+	{
+		PhysicsTestContext c;
+		BodyInterface &bi = c.GetBodyInterface();
+
+		// Create a number of kinematic ragdolls that are not active
+		Ref<RagdollSettings> settings = sCreateRagdollSettings(EMotionType::Kinematic);
+		constexpr int cNumRagdolls = 5;
+		Array<Ref<Ragdoll>> ragdolls;
+		for (int r = 0; r < cNumRagdolls; ++r)
+		{
+			Ref<Ragdoll> ragdoll = settings->CreateRagdoll(r, 0, c.GetSystem());
+			ragdoll->AddToPhysicsSystem(EActivation::DontActivate);
+			ragdoll->SetPose(RVec3(0, 0, 5.0f * r), Array<Mat44>(4, Mat44::sIdentity()).data());
+			ragdolls.push_back(ragdoll);
+		}
+
+		// Freeze a body of one of the ragdolls, it should follow the root
+		ragdolls[1]->SetFrozenBodies({ 3 });
+
+		// Create a pose per ragdoll
+		Array<SkeletonPose> poses(cNumRagdolls);
+		for (int r = 0; r < cNumRagdolls; ++r)
+		{
+			SkeletonPose &pose = poses[r];
+			pose.SetSkeleton(settings->GetSkeleton());
+			pose.SetRootOffset(RVec3(0, 1.0f, 5.0f * r));
+			for (int i = 0; i < 4; ++i)
+				pose.GetJointMatrices()[i] = Mat44::sRotationTranslation(Quat::sRotation(Vec3::sAxisY(), 0.1f * (r + i)), Vec3(float(i), 0, 0));
+		}
+
+		// Drive the first 4 ragdolls in a single batch and the last one individually
+		Array<Ragdoll *> batch;
+		Array<const SkeletonPose *> batch_poses;
+		for (int r = 0; r < cNumRagdolls - 1; ++r)
+		{
+			batch.push_back(ragdolls[r]);
+			batch_poses.push_back(&poses[r]);
+		}
+		Ragdoll::sDriveToPoseUsingKinematics(batch.data(), batch_poses.data(), (uint)batch.size(), c.GetDeltaTime());
+		ragdolls.back()->DriveToPoseUsingKinematics(poses.back(), c.GetDeltaTime());
+		CHECK(!ragdolls[1]->IsBodyFrozen(0));
+		CHECK(ragdolls[1]->IsBodyFrozen(3));
+
+		// All bodies that are simulated should have woken up
+		for (int r = 0; r < cNumRagdolls; ++r)
+			for (int i = 0; i < 4; ++i)
+				CHECK(bi.IsActive(ragdolls[r]->GetBodyID(i)) == !ragdolls[r]->IsBodyFrozen(i));
+
+		// After a step all ragdolls should be in their pose
+		c.SimulateSingleStep();
+		for (int r = 0; r < cNumRagdolls; ++r)
+		{
+			SkeletonPose pose;
+			pose.SetSkeleton(settings->GetSkeleton());
+			ragdolls[r]->GetPose(pose);
+			for (int i = 0; i < 4; ++i)
+				if (!ragdolls[r]->IsBodyFrozen(i))
+				{
+					CHECK_APPROX_EQUAL(pose.GetRootOffset() + pose.GetJointMatrix(i).GetTranslation(), poses[r].GetRootOffset() + poses[r].GetJointMatrix(i).GetTranslation(), 1.0e-5f);
+					CHECK_APPROX_EQUAL(pose.GetJointMatrix(i).GetRotation(), poses[r].GetJointMatrix(i).GetRotation(), 1.0e-5f);
+				}
+		}
+
+		for (Ragdoll *ragdoll : ragdolls)
+			ragdoll->RemoveFromPhysicsSystem();
+	}
+}
@@ -117,6 +117,66 @@ TEST_SUITE("ShapeTests")
 			}
 	}
 
+	// Test that the support function of a convex hull with many points (which walks over the edges of the hull) returns the same as testing all points
+	TEST_CASE("TestConvexHullShapeLargeHullSupport")
+	{
+		UnitTestRandom random;
+		uniform_real_distribution<float> zero_to_one(0.0f, 1.0f);
+		uniform_int_distribution<uint> any_hint(0, 1000);
+
+		// Create a hull of random points on the surface and inside of an ellipsoid
+		Array<Vec3> points;
+		for (int i = 0; i < 300; ++i)
+			points.push_back(Vec3(2.0f, 1.0f, 1.5f) * Vec3::sRandom(random) * (zero_to_one(random) < 0.8f? 1.0f : zero_to_one(random)));
+		RefConst<ConvexHullShape> hull = static_cast<const ConvexHullShape *>(ConvexHullShapeSettings(points).Create().Get().GetPtr());
+		CHECK(hull->GetNumPoints() >= 100);
+		CHECK(hull->GetConvexRadius() > 0.0f);
+
+		// Same hull after a save / restore
+		stringstream data;
+		StreamOutWrapper stream_out(data);
+		hull->SaveBinaryState(stream_out);
+		StreamInWrapper stream_in(data);
+		RefConst<Shape> restored_hull = Shape::sRestoreFromBinaryState(stream_in).Get();
+
+		for (Vec3 scale : { Vec3::sReplicate(1.0f), Vec3(1.0f, 2.0f, -0.5f) })
+			for (const Shape *shape : { (const Shape *)hull.GetPtr(), restored_hull.GetPtr() })
+			{
+				const ConvexShape *convex = static_cast<const ConvexShape *>(shape);
+
+				ConvexShape::SupportBuffer buffer_incl, buffer_default, buffer_excl1, buffer_excl2;
+				const ConvexShape::Support *support_incl = convex->GetSupportFunction(ConvexShape::ESupportMode::IncludeConvexRadius, buffer_incl, scale);
+				const ConvexShape::Support *support_default = convex->GetSupportFunction(ConvexShape::ESupportMode::Default, buffer_default, scale);
+				const ConvexShape::Support *support_excl1 = convex->GetSupportFunction(ConvexShape::ESupportMode::ExcludeConvexRadius, buffer_excl1, scale);
+				const ConvexShape::Support *support_excl2 = convex->GetSupportFunction(ConvexShape::ESupportMode::ExcludeConvexRadius, buffer_excl2, scale);
+
+				for (int i = 0; i < 1000; ++i)
+				{
+					// Move the start of the search to a random vertex, the result should not depend on where the search starts
+					(void)support_incl->GetSupport(Vec3::sRandom(random));
+					(void)support_default->GetSupport(Vec3::sRandom(random));
+					(void)support_excl1->GetSupport(Vec3::sRandom(random));
+
+					// Any hint should be accepted, including ones from a different hull
+					support_incl->SetSupportHint(any_hint(random));
+					support_default->SetSupportHint(any_hint(random));
+					CHECK(support_incl->GetSupportHint() < hull->GetNumPoints());
+					CHECK(support_excl1->GetSupportHint() == ConvexShape::Support::cNoSupportHint);
+
+					// Compare with the brute force maximum over all points
+					Vec3 direction = Vec3::sRandom(random);
+					float best_dot = -FLT_MAX;
+					for (uint p = 0; p < hull->GetNumPoints(); ++p)
+						best_dot = max(best_dot, (scale * hull->GetPoint(p)).Dot(direction));
+					CHECK(support_incl->GetSupport(direction).Dot(direction) == best_dot);
+					CHECK(support_default->GetSupport(direction).Dot(direction) == best_dot);
+
+					// The hull without convex radius doesn't have the original points, it should not depend on previous calls either
+					CHECK(support_excl1->GetSupport(direction) == support_excl2->GetSupport(direction));
+				}
+			}
+	}
+
 	// Test IsValidScale function
 	TEST_CASE("TestIsValidScale")
 	{
@@ -39,6 +39,7 @@ TEST_SUITE("WheeledVehicleTests")
 		float		mFrontBackLimitedSlipRatio = 1.4f;
 		float		mLeftRightLimitedSlipRatio = 1.4f;
 		bool		mAntiRollbar = true;
+		bool		mBatchWheelCollisionTests = false;
 	};
 
 	// Helper function to create a vehicle
@@ -129,6 +130,7 @@ TEST_SUITE("WheeledVehicleTests")
 		else
 			tester = new VehicleCollisionTesterRay(Layers::MOVING);
 		constraint->SetVehicleCollisionTester(tester);
+		constraint->SetBatchWheelCollisionTests(inSettings.mBatchWheelCollisionTests);
 
 		// Add to the world
 		inContext.GetSystem()->AddConstraint(constraint);
@@ -344,4 +346,114 @@ TEST_SUITE("WheeledVehicleTests")
 				CHECK_APPROX_EQUAL(body->GetPosition().GetZ(), 0, 0.06_r);
 		}
 	}
+
+	TEST_CASE("TestBatchWheelCollisionTests")
+	{
+		for (bool use_cast_sphere : { false, true })
+		{
+			// Create the same scene twice, once with batched wheel collision tests
+			PhysicsTestContext c1, c2;
+			PhysicsTestContext *contexts[] = { &c1, &c2 };
+			VehicleConstraint *constraints[2];
+			for (int i = 0; i < 2; ++i)
+			{
+				PhysicsTestContext &c = *contexts[i];
+				c.CreateFloor();
+				c.CreateBox(RVec3(1, 0, 4), Quat::sRotation(Vec3::sAxisZ(), 0.2f), EMotionType::Static, EMotionQuality::Discrete, Layers::NON_MOVING, Vec3(0.5f, 0.2f, 0.5f));
+
+				VehicleSettings settings;
+				settings.mUseCastSphere = use_cast_sphere;
+				settings.mBatchWheelCollisionTests = i == 1;
+				constraints[i] = AddVehicle(c, settings);
+				static_cast<WheeledVehicleController *>(constraints[i]->GetController())->SetDriverInput(1.0f, 0.2f, 0.0f, 0.0f);
+			}
+
+			// Drive over the box, the wheels should find the same contacts
+			for (int step = 0; step < 180; ++step)
+			{
+				c1.SimulateSingleStep();
+				c2.SimulateSingleStep();
+
+				CHECK(constraints[0]->GetVehicleBody()->GetPosition() == constraints[1]->GetVehicleBody()->GetPosition());
+				for (uint w = 0; w < 4; ++w)
+				{
+					const Wheel *w1 = constraints[0]->GetWheel(w);
+					const Wheel *w2 = constraints[1]->GetWheel(w);
+					CHECK(w1->GetContactBodyID() == w2->GetContactBodyID());
+					CHECK(w1->GetSuspensionLength() == w2->GetSuspensionLength());
+				}
+			}
+
+			// Check that the vehicle actually drove over the box
+			CHECK(constraints[1]->GetVehicleBody()->GetPosition().GetZ() > 5.0f);
+		}
+	}
+
+	TEST_CASE("TestVehicleLOD")
+	{
+		// Create two vehicles that drive forward, one of them switches to low LOD for a while
+		PhysicsTestContext c1, c2;
+		PhysicsTestContext *contexts[] = { &c1, &c2 };
+		VehicleConstraint *constraints[2];
+		for (int i = 0; i < 2; ++i)
+		{
+			PhysicsTestContext &c = *contexts[i];
+			c.CreateFloor();
+
+			VehicleSettings settings;
+			constraints[i] = AddVehicle(c, settings);
+			static_cast<WheeledVehicleController *>(constraints[i]->GetController())->SetDriverInput(1.0f, 0.0f, 0.0f, 0.0f);
+		}
+
+		VehicleConstraint *lod_vehicle = constraints[1];
+		WheeledVehicleController *lod_controller = static_cast<WheeledVehicleController *>(lod_vehicle->GetController());
+		MotionProperties *lod_mp = lod_vehicle->GetVehicleBody()->GetMotionProperties();
+		lod_vehicle->SetLowLODVehicleCollisionTester(new VehicleCollisionTesterRay(Layers::MOVING));
+
+		// Switch to low LOD, this should override the number of solver steps
+		lod_vehicle->SetLOD(EVehicleLOD::Low);
+		CHECK(lod_vehicle->GetLOD() == EVehicleLOD::Low);
+		CHECK(lod_vehicle->GetNumVelocityStepsOverride() == 2);
+		CHECK(lod_vehicle->GetNumPositionStepsOverride() == 1);
+		CHECK(lod_mp->GetNumVelocityStepsOverride() == 2);
+		CHECK(lod_mp->GetNumPositionStepsOverride() == 1);
+
+		for (int step = 0; step < 300; ++step)
+		{
+			c1.SimulateSingleStep();
+			c2.SimulateSingleStep();
+		}
+
+		// The vehicle in low LOD should behave similar to the full simulation
+		float speed1 = constraints[0]->GetVehicleBody()->GetLinearVelocity().Length();
+		float speed2 = lod_vehicle->GetVehicleBody()->GetLinearVelocity().Length();
+		CHECK(speed1 > 5.0f);
+		CHECK(abs(speed2 - speed1) < 0.25f * speed1);
+
+		// The engine RPM should follow the wheels (the RPM is updated before the wheels are accelerated, so allow some tolerance)
+		const VehicleEngine &engine = lod_controller->GetEngine();
+		CHECK_APPROX_EQUAL(engine.GetCurrentRPM(), Clamp(abs(lod_controller->GetWheelSpeedAtClutch()), engine.mMinRPM, engine.mMaxRPM), 150.0f);
+
+		// Switch back to full LOD, this should restore the number of solver steps
+		lod_vehicle->SetLOD(EVehicleLOD::Full);
+		CHECK(lod_vehicle->GetNumVelocityStepsOverride() == 0);
+		CHECK(lod_vehicle->GetNumPositionStepsOverride() == 0);
+		CHECK(lod_mp->GetNumVelocityStepsOverride() == 0);
+		CHECK(lod_mp->GetNumPositionStepsOverride() == 0);
+
+		// Check that there is no jump in engine RPM or vehicle speed when switching
+		float prev_rpm = engine.GetCurrentRPM();
+		float prev_speed = speed2;
+		for (int step = 0; step < 10; ++step)
+		{
+			c2.SimulateSingleStep();
+
+			float rpm = engine.GetCurrentRPM();
+			float speed = lod_vehicle->GetVehicleBody()->GetLinearVelocity().Length();
+			CHECK(abs(rpm - prev_rpm) < 100.0f);
+			CHECK(abs(speed - prev_speed) < 0.1f);
+			prev_rpm = rpm;
+			prev_speed = speed;
+		}
+	}
 }
@@ -0,0 +1,133 @@
+// Jolt Physics Library (https://github.com/jrouwe/JoltPhysics)
+// SPDX-FileCopyrightText: 2024 Jorrit Rouwe
+// SPDX-License-Identifier: MIT
+
+#include "UnitTestFramework.h"
+#include <Jolt/Skeleton/SkeletalAnimationSampler.h>
+#include <Jolt/Skeleton/SkeletonPose.h>
+#include <Jolt/Core/StringTools.h>
+#include <random>
+
+TEST_SUITE("SkeletalAnimationTests")
+{
+	// Create a skeleton with a chain of joints and an animation with random keyframes for it
+	static void sCreateAnimation(int inNumJoints, Ref<Skeleton> &outSkeleton, Ref<SkeletalAnimation> &outAnimation)
+	{
+		UnitTestRandom random;
+		uniform_real_distribution<float> time_step(0.01f, 0.1f);
+		uniform_real_distribution<float> angle(-JPH_PI, JPH_PI);
+
+		outSkeleton = new Skeleton;
+		outAnimation = new SkeletalAnimation;
+		for (int j = 0; j < inNumJoints; ++j)
+		{
+			String name = "Joint" + ConvertToString(j);
+			outSkeleton->AddJoint(name, j - 1);
+
+			SkeletalAnimation::AnimatedJoint &aj = outAnimation->GetAnimatedJoints().emplace_back();
+			aj.mJointName = name;
+
+			// All joints except the last one have the same duration so that the animation loops properly
+			float time = 0.0f;
+			for (int k = 0; k < 20; ++k)
+			{
+				SkeletalAnimation::Keyframe &keyframe = aj.mKeyframes.emplace_back();
+				keyframe.mTime = time;
+				keyframe.mRotation = Quat::sRotation(Vec3::sRandom(random), angle(random));
+				keyframe.mTranslation = Vec3::sRandom(random);
+				time += time_step(random);
+			}
+			if (j < inNumJoints - 1)
+				aj.mKeyframes.back().mTime = 2.0f;
+
+			// Let the first joint interpolate between two nearly identical and two opposite keyframes
+			if (j == 0)
+			{
+				aj.mKeyframes[1].mRotation = aj.mKeyframes[0].mRotation * Quat::sRotation(Vec3::sAxisX(), 1.0e-3f);
+				aj.mKeyframes[2].mRotation = -aj.mKeyframes[1].mRotation * Quat::sRotation(Vec3::sAxisY(), 1.0f);
+			}
+		}
+		outSkeleton->CalculateParentJointIndices();
+	}
+
+	static void sCheckPosesEqual(const SkeletonPose &inPose1, const SkeletonPose &inPose2)
+	{
+		for (uint j = 0; j < inPose1.GetJointCount(); ++j)
+		{
+			const SkeletalAnimation::JointState &state1 = inPose1.GetJoint(j);
+			const SkeletalAnimation::JointState &state2 = inPose2.GetJoint(j);
+			CHECK(state1.mTranslation == state2.mTranslation);
+			CHECK(state1.mRotation.IsNormalized());
+			CHECK_APPROX_EQUAL(state1.mRotation, state2.mRotation, 1.0e-5f);
+		}
+	}
+
+	TEST_CASE("TestSamplerMatchesSample")
+	{
+		// Use an odd number of joints so that the last interpolation batch is partially filled
+		Ref<Skeleton> skeleton;
+		Ref<SkeletalAnimation> animation;
+		sCreateAnimation(7, skeleton, animation);
+
+		SkeletonPose expected, actual;
+		expected.SetSkeleton(skeleton);
+		actual.SetSkeleton(skeleton);
+
+		// Sample at increasing times, with a couple of big jumps, a jump backwards and looping
+		SkeletalAnimationSampler sampler(animation, skeleton);
+		const float cTimes[] = { 0.0f, 0.001f, 0.01f, 0.1f, 0.11f, 0.5f, 0.2f, 0.21f, 1.5f, 1.9f, 1.99f, 2.0f, 2.05f, 2.5f, 4.1f, 0.0f, 7.3f };
+		for (float time : cTimes)
+		{
+			animation->Sample(time, expected);
+			sampler.Sample(time, actual);
+			sCheckPosesEqual(expected, actual);
+		}
+
+		// Play the animation at a normal frame rate
+		for (float time = 0.0f; time < 5.0f; time += 1.0f / 60.0f)
+		{
+			animation->Sample(time, expected);
+			sampler.Sample(time, actual);
+			sCheckPosesEqual(expected, actual);
+		}
+	}
+
+	TEST_CASE("TestSampleMultiplePoses")
+	{
+		Ref<Skeleton> skeleton;
+		Ref<SkeletalAnimation> animation;
+		sCreateAnimation(5, skeleton, animation);
+
+		// Create a sampler and a pose for a number of instances of the animation that all play at a different time
+		constexpr uint cNumPoses = 7;
+		Array<SkeletalAnimationSampler *> samplers;
+		Array<SkeletonPose> poses(cNumPoses);
+		Array<SkeletonPose *> pose_ptrs;
+		for (SkeletonPose &pose : poses)
+		{
+			pose.SetSkeleton(skeleton);
+			pose_ptrs.push_back(&pose);
+			samplers.push_back(new SkeletalAnimationSampler(animation, skeleton));
+		}
+
+		SkeletonPose expected;
+		expected.SetSkeleton(skeleton);
+		for (int frame = 0; frame < 100; ++frame)
+		{
+			float times[cNumPoses];
+			for (uint i = 0; i < cNumPoses; ++i)
+				times[i] = 0.3f * i + frame / 30.0f;
+
+			SkeletalAnimationSampler::sSample(samplers.data(), times, pose_ptrs.data(), cNumPoses);
+
+			for (uint i = 0; i < cNumPoses; ++i)
+			{
+				animation->Sample(times[i], expected);
+				sCheckPosesEqual(expected, poses[i]);
+			}
+		}
+
+		for (SkeletalAnimationSampler *sampler : samplers)
+			delete sampler;
+	}
+}